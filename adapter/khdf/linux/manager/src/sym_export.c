@@ -28,6 +28,7 @@
 
 EXPORT_SYMBOL(HdfDeviceSendEvent);
 EXPORT_SYMBOL(HdfDeviceSendEventToClient);
+EXPORT_SYMBOL(HdfDeviceGetClientSharedBuf);
 EXPORT_SYMBOL(HdfDeviceGetServiceName);
 EXPORT_SYMBOL(HdfPmRegisterPowerListener);
 EXPORT_SYMBOL(HdfDeviceObjectAlloc);
@@ -31,6 +31,12 @@ extern "C" {
 #define OsalAtomicIncRetWrapper(v) atomic_inc_return((atomic_t *)(v))
 #define OsalAtomicDecWrapper(v) atomic_dec((atomic_t *)(v))
 #define OsalAtomicDecRetWrapper(v) atomic_dec_return((atomic_t *)(v))
+#define OsalAtomicReadAcquireWrapper(v) atomic_read_acquire((const atomic_t *)(v))
+#define OsalAtomicSetReleaseWrapper(v, value) atomic_set_release((atomic_t *)(v), value)
+#define OsalAtomicCmpXchgWrapper(v, oldValue, newValue) atomic_cmpxchg((atomic_t *)(v), oldValue, newValue)
+#define OsalAtomicPtrXchgWrapper(p, newPtr) xchg((p), (newPtr))
+#define OsalAtomicPtrReadAcquireWrapper(p) smp_load_acquire(p)
+#define OsalAtomicPtrSetReleaseWrapper(p, newPtr) smp_store_release((p), (newPtr))
 
 #define OsalTestBitWrapper(nr, addr) test_bit(nr, addr)
 #define OsalTestSetBitWrapper(nr, addr) test_and_change_bit(nr, addr)
@@ -18,6 +18,8 @@
 #include <linux/cdev.h>
 #include <linux/device.h>
 #include <linux/fs.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
 #include "osal_cdev.h"
 #include "hdf_log.h"
 #include "osal_file.h"
@@ -178,6 +180,18 @@ static long OsalCdevIoctl(struct file* filep, unsigned int cmd, unsigned long ar
     return dev->opsImpl->ioctl(filep, cmd, arg);
 }
 
+static int OsalCdevMmap(struct file* filep, struct vm_area_struct* vma)
+{
+    struct OsalCdev* dev = container_of(filep->f_inode->i_cdev, struct OsalCdev, cdev);
+    void* shared = NULL;
+
+    shared = dev->opsImpl->mmap(filep, (uint64_t)vma->vm_pgoff << PAGE_SHIFT, vma->vm_end - vma->vm_start);
+    if (shared == NULL) {
+        return -ENOMEM;
+    }
+    return remap_vmalloc_range(vma, shared, 0);
+}
+
 static int OsalCdevOpen(struct inode* inode, struct file* filep)
 {
     struct OsalCdev* dev = container_of(inode->i_cdev, struct OsalCdev, cdev);
@@ -199,6 +213,7 @@ static void AssignFileOps(struct file_operations* fops, const struct OsalCdevOps
     fops->unlocked_ioctl = src->ioctl != NULL ? OsalCdevIoctl : NULL;
     fops->open = src->open != NULL ? OsalCdevOpen : NULL;
     fops->release = src->release != NULL ? OsalCdevRelease : NULL;
+    fops->mmap = src->mmap != NULL ? OsalCdevMmap : NULL;
 #ifdef CONFIG_COMPAT
     fops->compat_ioctl = src->ioctl != NULL ? OsalCdevIoctl : NULL;
 #endif
@@ -257,6 +272,16 @@ void* OsalGetCdevPriv(struct OsalCdev* cdev)
     return cdev != NULL ? cdev->priv : NULL;
 }
 
+void* OsalCdevAllocShared(size_t size)
+{
+    return vmalloc_user(PAGE_ALIGN(size));
+}
+
+void OsalCdevFreeShared(void* addr)
+{
+    vfree(addr);
+}
+
 void OsalSetFilePriv(struct file* filep, void* priv)
 {
     if (filep != NULL) {
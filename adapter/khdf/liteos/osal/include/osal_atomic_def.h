@@ -44,6 +44,13 @@ extern "C" {
 #define OsalAtomicIncRetWrapper(v) LOS_AtomicIncRet((Atomic *)&(v)->counter)
 #define OsalAtomicDecWrapper(v) LOS_AtomicDec((Atomic *)&(v)->counter)
 #define OsalAtomicDecRetWrapper(v) LOS_AtomicDecRet((Atomic *)&(v)->counter)
+#define OsalAtomicReadAcquireWrapper(v) __atomic_load_n(&(v)->counter, __ATOMIC_ACQUIRE)
+#define OsalAtomicSetReleaseWrapper(v, value) __atomic_store_n(&(v)->counter, (value), __ATOMIC_RELEASE)
+#define OsalAtomicCmpXchgWrapper(v, oldValue, newValue) \
+    __sync_val_compare_and_swap(&(v)->counter, (oldValue), (newValue))
+#define OsalAtomicPtrXchgWrapper(p, newPtr) __atomic_exchange_n((p), (newPtr), __ATOMIC_SEQ_CST)
+#define OsalAtomicPtrReadAcquireWrapper(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define OsalAtomicPtrSetReleaseWrapper(p, newPtr) __atomic_store_n((p), (newPtr), __ATOMIC_RELEASE)
 
 #define OSAL_BITS_PER_LONG 32
 #define OSAL_BIT_MASK(nr) (1UL << ((nr) % OSAL_BITS_PER_LONG))
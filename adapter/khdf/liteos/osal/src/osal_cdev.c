@@ -173,6 +173,18 @@ void* OsalGetCdevPriv(struct OsalCdev* cdev)
     return cdev != NULL ? cdev->priv : NULL;
 }
 
+/* mapping driver memory into user space is not supported here, callers fall back to copying */
+void* OsalCdevAllocShared(size_t size)
+{
+    (void)size;
+    return NULL;
+}
+
+void OsalCdevFreeShared(void* addr)
+{
+    (void)addr;
+}
+
 void OsalSetFilePriv(struct file* filep, void* priv)
 {
     if (filep != NULL) {
@@ -83,3 +83,20 @@ void DeviceNodeExtRelease(struct HdfObject *object)
     }
 }
 
+/* services are not published as nodes here, so there are no user space listeners and no shared buffers */
+int32_t HdfDeviceSendEvent(const struct HdfDeviceObject *deviceObject, uint32_t id, const struct HdfSBuf *data)
+{
+    (void)deviceObject;
+    (void)id;
+    (void)data;
+    return HDF_ERR_NOT_SUPPORT;
+}
+
+void *HdfDeviceGetClientSharedBuf(const struct HdfDeviceIoClient *client, uint32_t *size)
+{
+    (void)client;
+    if (size != NULL) {
+        *size = 0;
+    }
+    return NULL;
+}
@@ -44,6 +44,10 @@ extern "C" {
 #define OsalAtomicIncRetWrapper(v)      (++((v)->counter))
 #define OsalAtomicDecWrapper(v)         (((v)->counter)--)
 #define OsalAtomicDecRetWrapper(v)      (--((v)->counter))
+#define OsalAtomicReadAcquireWrapper(v) ((v)->counter)
+#define OsalAtomicSetReleaseWrapper(v, value) ((v)->counter = (value))
+#define OsalAtomicPtrReadAcquireWrapper(p) (*(p))
+#define OsalAtomicPtrSetReleaseWrapper(p, newPtr) (*(p) = (newPtr))
 
 #define OSAL_BITS_PER_LONG 32
 #define OSAL_BIT_MASK(nr) (1UL << ((nr) % OSAL_BITS_PER_LONG))
@@ -92,6 +96,30 @@ static inline void OsalClearBitWrapper(unsigned long nr, volatile unsigned long
     LOS_IntRestore(intSave);
 }
 
+static inline int32_t OsalAtomicCmpXchgWrapper(volatile void *v, int32_t oldValue, int32_t newValue)
+{
+    uint32_t intSave = LOS_IntLock();
+    volatile int32_t *counter = (volatile int32_t *)v;
+    int32_t old = *counter;
+
+    if (old == oldValue) {
+        *counter = newValue;
+    }
+    LOS_IntRestore(intSave);
+    return old;
+}
+
+static inline void *OsalAtomicPtrXchgWrapper(volatile void *p, void *newPtr)
+{
+    uint32_t intSave = LOS_IntLock();
+    void *volatile *ptr = (void *volatile *)p;
+    void *old = *ptr;
+
+    *ptr = newPtr;
+    LOS_IntRestore(intSave);
+    return old;
+}
+
 
 #ifdef __cplusplus
 }
@@ -9,12 +9,17 @@
 #include <securec.h>
 
 #include "can/can_core.h"
+#include "can/can_filter.h"
 #include "device_resource_if.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
 
 #define HDF_LOG_TAG             can_virtual_c
 #define CAN_VIRTUAL_BUS_NUM_DFT 31
+#define CAN_VIRTUAL_FILTER_MAX  8 // acceptance filters of the emulated hardware
+#define CAN_VIRTUAL_BURST_MAX   32 // frames looped back per dispatch
+#define CAN_VIRTUAL_ID_STD_MASK 0x7FF
+#define CAN_VIRTUAL_ID_EXT_MASK 0x1FFFFFFF
 
 struct VirtualCanCntlr {
     struct CanCntlr cntlr;
@@ -25,6 +30,8 @@ struct VirtualCanCntlr {
     uint32_t timeSeg2;
     uint32_t prescaler;
     int32_t busState;
+    uint32_t filterCount;
+    struct CanFilter filters[CAN_VIRTUAL_FILTER_MAX];
 };
 
 enum VIRTUAL_CAN_SPEED {
@@ -79,10 +86,46 @@ static int32_t VirtualReadConfigFromHcs(struct VirtualCanCntlr *virtualCan)
     return HDF_SUCCESS;
 }
 
+static bool VirtualCanFilterMatch(const struct CanFilter *filter, const struct CanMsg *msg)
+{
+    uint32_t mask;
+
+    if (filter->rtrMask == 1 && filter->rtr != msg->rtr) {
+        return false;
+    }
+    if (filter->ideMask == 1 && filter->ide != msg->ide) {
+        return false;
+    }
+    mask = (msg->ide == 1) ? CAN_VIRTUAL_ID_STD_MASK : CAN_VIRTUAL_ID_EXT_MASK;
+    mask &= filter->idMask;
+    return (msg->id & mask) == (filter->id & mask);
+}
+
+// like a controller with acceptance filters, no filter accepts all frames
+static bool VirtualCanAcceptMsg(const struct VirtualCanCntlr *virtualCan, const struct CanMsg *msg)
+{
+    uint32_t i;
+
+    if (virtualCan->filterCount == 0) {
+        return true;
+    }
+    for (i = 0; i < virtualCan->filterCount; i++) {
+        if (VirtualCanFilterMatch(&virtualCan->filters[i], msg)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static int32_t VirtualCanMsgLoopBack(struct VirtualCanCntlr *virtualCan, const struct CanMsg *msg)
 {
     struct CanMsg *new = NULL;
 
+    if (!VirtualCanAcceptMsg(virtualCan, msg)) {
+        virtualCan->busState = CAN_BUS_READY;
+        return HDF_SUCCESS; // filtered out by hardware
+    }
+
     new = CanMsgObtain();
     if (new == NULL) {
         return HDF_ERR_MALLOC_FAIL;
@@ -116,6 +159,63 @@ static int32_t VirtualCanSendMsg(struct CanCntlr *cntlr, const struct CanMsg *ms
     return VirtualCanMsgLoopBack(virtualCan, msg);
 }
 
+/*
+ * Loop a batch back in bursts, each dispatched to the rx boxes at once. A frame the acceptance filters reject
+ * is sent all the same, as on a bus, so the count returned is always of the frames before the first one failed.
+ */
+static int32_t VirtualCanMsgsLoopBack(struct VirtualCanCntlr *virtualCan, const struct CanMsg *msgs, uint32_t count)
+{
+    uint32_t i;
+    uint32_t burst = 0;
+    struct CanMsg *news[CAN_VIRTUAL_BURST_MAX];
+
+    for (i = 0; i < count; i++) {
+        if (!VirtualCanAcceptMsg(virtualCan, &msgs[i])) {
+            continue; // filtered out by hardware
+        }
+        news[burst] = CanMsgObtain();
+        if (news[burst] == NULL) {
+            break;
+        }
+        *news[burst] = msgs[i];
+        if (++burst == CAN_VIRTUAL_BURST_MAX) {
+            (void)CanCntlrOnNewMsgs(&virtualCan->cntlr, news, burst);
+            burst = 0;
+        }
+    }
+    if (burst > 0) {
+        (void)CanCntlrOnNewMsgs(&virtualCan->cntlr, news, burst);
+    }
+
+    virtualCan->busState = CAN_BUS_READY;
+    if (i < count) {
+        return (i == 0) ? HDF_ERR_MALLOC_FAIL : (int32_t)i;
+    }
+    return (int32_t)count;
+}
+
+static int32_t VirtualCanSendMsgs(struct CanCntlr *cntlr, const struct CanMsg *msgs, uint32_t count)
+{
+    struct VirtualCanCntlr *virtualCan = NULL;
+
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (msgs == NULL || count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    virtualCan = (struct VirtualCanCntlr *)cntlr->device.priv;
+    if (virtualCan == NULL) {
+        HDF_LOGE("%s: private data is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    virtualCan->busState = CAN_BUS_BUSY;
+
+    return VirtualCanMsgsLoopBack(virtualCan, msgs, count);
+}
+
 struct VirtualSpeedConfigMap {
     uint32_t speed;
     uint32_t sjw;
@@ -230,10 +330,46 @@ static int32_t VirtualCanGetCfg(struct CanCntlr *cntlr, struct CanConfig *cfg)
     return HDF_SUCCESS;
 }
 
+static int32_t VirtualCanAddFilter(struct CanCntlr *cntlr, struct CanFilter *filter)
+{
+    struct VirtualCanCntlr *virtualCan = (struct VirtualCanCntlr *)cntlr->device.priv;
+
+    if (virtualCan == NULL) {
+        HDF_LOGE("%s: private data is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (virtualCan->filterCount >= CAN_VIRTUAL_FILTER_MAX) {
+        return HDF_PLT_OUT_OF_RSC;
+    }
+    virtualCan->filters[virtualCan->filterCount++] = *filter;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualCanDelFilter(struct CanCntlr *cntlr, struct CanFilter *filter)
+{
+    uint32_t i;
+    struct VirtualCanCntlr *virtualCan = (struct VirtualCanCntlr *)cntlr->device.priv;
+
+    if (virtualCan == NULL) {
+        HDF_LOGE("%s: private data is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    for (i = 0; i < virtualCan->filterCount; i++) {
+        if (CanFilterEquals(&virtualCan->filters[i], filter)) {
+            virtualCan->filters[i] = virtualCan->filters[--virtualCan->filterCount];
+            return HDF_SUCCESS;
+        }
+    }
+    return HDF_ERR_NOT_SUPPORT;
+}
+
 struct CanCntlrMethod g_virtualCanMethod = {
     .sendMsg = VirtualCanSendMsg,
+    .sendMsgs = VirtualCanSendMsgs,
     .setCfg = VirtualCanSetCfg,
     .getCfg = VirtualCanGetCfg,
+    .addFilter = VirtualCanAddFilter,
+    .delFilter = VirtualCanDelFilter,
 };
 
 /*
@@ -25,7 +25,7 @@ using namespace OHOS;
 static void MParcelImplInterfaceAssign(struct HdfSBufImpl *inf);
 
 struct SBufMParcelImpl {
-    SBufMParcelImpl(OHOS::MessageParcel *parcel, bool owned = true): realParcel_(parcel), owned_(owned)
+    SBufMParcelImpl(OHOS::MessageParcel *parcel, bool owned = true): infImpl(), realParcel_(parcel), owned_(owned)
     {
         MParcelImplInterfaceAssign(&infImpl);
     }
@@ -353,12 +353,12 @@ static struct HdfRemoteService *SbufMParcelImplReadRemoteService(struct HdfSBufI
     return HdfRemoteAdapterBind(remote);
 }
 
-static const uint8_t *SbufMParcelImplGetData(const struct HdfSBufImpl *sbuf)
+static const uint8_t *SbufMParcelImplGetData(struct HdfSBufImpl *sbuf)
 {
     if (sbuf == nullptr) {
         return nullptr;
     }
-    return reinterpret_cast<const uint8_t *>(MParcelCast(const_cast<struct HdfSBufImpl *>(sbuf))->GetData());
+    return reinterpret_cast<const uint8_t *>(MParcelCast(sbuf)->GetData());
 }
 
 static void SbufMParcelImplFlush(struct HdfSBufImpl *sbuf)
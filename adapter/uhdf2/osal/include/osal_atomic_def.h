@@ -25,7 +25,16 @@ extern "C" {
 #define OsalAtomicReadWrapper(v) (*(volatile int *)&(v)->counter)
 #define OsalAtomicSetWrapper(v, value) ((v)->counter = (value))
 #define OsalAtomicIncWrapper(v) __sync_fetch_and_add(&(v)->counter, 1)
+#define OsalAtomicIncRetWrapper(v) __sync_add_and_fetch(&(v)->counter, 1)
 #define OsalAtomicDecWrapper(v) __sync_sub_and_fetch(&(v)->counter, 1)
+#define OsalAtomicDecRetWrapper(v) __sync_sub_and_fetch(&(v)->counter, 1)
+#define OsalAtomicReadAcquireWrapper(v) __atomic_load_n(&(v)->counter, __ATOMIC_ACQUIRE)
+#define OsalAtomicSetReleaseWrapper(v, value) __atomic_store_n(&(v)->counter, (value), __ATOMIC_RELEASE)
+#define OsalAtomicCmpXchgWrapper(v, oldValue, newValue) \
+    __sync_val_compare_and_swap(&(v)->counter, (oldValue), (newValue))
+#define OsalAtomicPtrXchgWrapper(p, newPtr) __atomic_exchange_n((p), (newPtr), __ATOMIC_SEQ_CST)
+#define OsalAtomicPtrReadAcquireWrapper(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define OsalAtomicPtrSetReleaseWrapper(p, newPtr) __atomic_store_n((p), (newPtr), __ATOMIC_RELEASE)
 static inline int32_t BitDoNotSupport(int nr, unsigned long *addr)
 {
     (void)nr;
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdf_log.h"
+#include "hdf_map.h"
+
+#define HDF_LOG_TAG   hdf_map_test_cpp
+
+namespace OHOS {
+using namespace testing::ext;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+static constexpr int MAP_TEST_COUNT = 1000;
+static constexpr int MAP_BENCH_COUNT = 20000;
+static constexpr int MAP_BENCH_ROUNDS = 10;
+static constexpr int MAP_CHURN_LIVE = 1000;
+static constexpr int MAP_CHURN_OPS = 200000;
+static constexpr int MAP_CHURN_KEY_PAD_MAX = 64;
+static constexpr int MAP_CHURN_VALUE_MAX = 256;
+static constexpr uint32_t MAP_CHURN_GROWTH_MAX = 2;
+
+class HdfMapTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() {}
+    void TearDown() {}
+};
+
+static std::vector<std::string> MapTestKeys(int count)
+{
+    std::vector<std::string> keys;
+    for (int i = 0; i < count; i++) {
+        keys.push_back("device_service_" + std::to_string(i));
+    }
+    return keys;
+}
+
+/*
+* @tc.name: MapSetGetTest001
+* @tc.desc: set, update, get and erase many keys
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfMapTest, MapSetGetTest001, TestSize.Level1)
+{
+    Map map;
+    MapInit(&map);
+    std::vector<std::string> keys = MapTestKeys(MAP_TEST_COUNT);
+    for (int i = 0; i < MAP_TEST_COUNT; i++) {
+        EXPECT_EQ(HDF_SUCCESS, MapSet(&map, keys[i].c_str(), &i, sizeof(i)));
+    }
+    EXPECT_EQ((uint32_t)MAP_TEST_COUNT, map.nodeSize);
+    int updated = -1;
+    EXPECT_EQ(HDF_SUCCESS, MapSet(&map, keys[0].c_str(), &updated, sizeof(updated)));
+    EXPECT_EQ(HDF_ERR_INVALID_OBJECT, MapSet(&map, keys[0].c_str(), &updated, sizeof(char)));
+
+    for (int i = 0; i < MAP_TEST_COUNT; i += 2) {
+        EXPECT_EQ(HDF_SUCCESS, MapErase(&map, keys[i].c_str()));
+    }
+    EXPECT_EQ(HDF_FAILURE, MapErase(&map, keys[0].c_str()));
+    for (int i = 0; i < MAP_TEST_COUNT; i++) {
+        int *value = (int *)MapGet(&map, keys[i].c_str());
+        if (i % 2 == 0) {
+            EXPECT_TRUE(value == nullptr);
+        } else {
+            ASSERT_TRUE(value != nullptr);
+            EXPECT_EQ(i, *value);
+        }
+    }
+    EXPECT_TRUE(MapGet(&map, "not_exist") == nullptr);
+    MapDelete(&map);
+    EXPECT_EQ(0u, map.nodeSize);
+}
+
+/*
+* @tc.name: MapWithHashTest001
+* @tc.desc: precomputed hash variants match the plain API
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfMapTest, MapWithHashTest001, TestSize.Level1)
+{
+    Map map;
+    MapInit(&map);
+    const char *key = "hash_key";
+    uint32_t hash = MapHash(key);
+    uint64_t value = 0x1234;
+    EXPECT_EQ(HDF_SUCCESS, MapSetWithHash(&map, key, hash, &value, sizeof(value)));
+    uint64_t *got = (uint64_t *)MapGet(&map, key);
+    ASSERT_TRUE(got != nullptr);
+    EXPECT_EQ(value, *got);
+    EXPECT_EQ(got, MapGetWithHash(&map, key, hash));
+    EXPECT_EQ(HDF_SUCCESS, MapEraseWithHash(&map, key, hash));
+    EXPECT_TRUE(MapGetWithHash(&map, key, hash) == nullptr);
+    MapDelete(&map);
+}
+
+/*
+* @tc.name: MapBenchmark001
+* @tc.desc: insert, lookup and erase throughput
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(HdfMapTest, MapBenchmark001, TestSize.Level3)
+{
+    Map map;
+    MapInit(&map);
+    std::vector<std::string> keys = MapTestKeys(MAP_BENCH_COUNT);
+    std::vector<uint32_t> hashes;
+    for (auto &key : keys) {
+        hashes.push_back(MapHash(key.c_str()));
+    }
+
+    auto start = steady_clock::now();
+    for (int i = 0; i < MAP_BENCH_COUNT; i++) {
+        ASSERT_EQ(HDF_SUCCESS, MapSet(&map, keys[i].c_str(), &i, sizeof(i)));
+    }
+    auto inserted = steady_clock::now();
+    int hits = 0;
+    for (int r = 0; r < MAP_BENCH_ROUNDS; r++) {
+        for (int i = 0; i < MAP_BENCH_COUNT; i++) {
+            hits += (MapGet(&map, keys[i].c_str()) != nullptr);
+        }
+    }
+    auto looked = steady_clock::now();
+    for (int r = 0; r < MAP_BENCH_ROUNDS; r++) {
+        for (int i = 0; i < MAP_BENCH_COUNT; i++) {
+            hits += (MapGetWithHash(&map, keys[i].c_str(), hashes[i]) != nullptr);
+        }
+    }
+    auto hashLooked = steady_clock::now();
+    for (int i = 0; i < MAP_BENCH_COUNT; i++) {
+        ASSERT_EQ(HDF_SUCCESS, MapErase(&map, keys[i].c_str()));
+    }
+    auto erased = steady_clock::now();
+
+    HDF_LOGI("map bench %{public}d keys: insert %{public}lld us, %{public}d x lookup %{public}lld us, "
+        "%{public}d x hashed lookup %{public}lld us, erase %{public}lld us", MAP_BENCH_COUNT,
+        (long long)duration_cast<microseconds>(inserted - start).count(), MAP_BENCH_ROUNDS,
+        (long long)duration_cast<microseconds>(looked - inserted).count(), MAP_BENCH_ROUNDS,
+        (long long)duration_cast<microseconds>(hashLooked - looked).count(),
+        (long long)duration_cast<microseconds>(erased - hashLooked).count());
+    EXPECT_EQ(2 * MAP_BENCH_ROUNDS * MAP_BENCH_COUNT, hits);
+    EXPECT_EQ(0u, map.nodeSize);
+    MapDelete(&map);
+}
+
+/*
+* @tc.name: MapChurnBenchmark001
+* @tc.desc: erase and insert keys and values of varying sizes, the arena stays bounded by the live nodes
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(HdfMapTest, MapChurnBenchmark001, TestSize.Level3)
+{
+    Map map;
+    MapInit(&map);
+    std::vector<std::string> keys(MAP_CHURN_LIVE);
+    std::vector<uint8_t> value(MAP_CHURN_VALUE_MAX, 0);
+    uint32_t seed = 1;
+    int serial = 0;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u; // LCG, a fixed sequence across runs
+        return (seed >> 16) & 0x7FFF;
+    };
+    auto newKey = [&]() {
+        return "churn_" + std::to_string(serial++) + std::string(next() % MAP_CHURN_KEY_PAD_MAX, 'x');
+    };
+
+    for (int i = 0; i < MAP_CHURN_LIVE; i++) {
+        keys[i] = newKey();
+        ASSERT_EQ(HDF_SUCCESS, MapSet(&map, keys[i].c_str(), value.data(), 1 + next() % MAP_CHURN_VALUE_MAX));
+    }
+    uint32_t warm = MapArenaSize(&map);
+    uint32_t peak = warm;
+    auto start = steady_clock::now();
+    for (int op = 0; op < MAP_CHURN_OPS; op++) {
+        int i = next() % MAP_CHURN_LIVE;
+        ASSERT_EQ(HDF_SUCCESS, MapErase(&map, keys[i].c_str()));
+        keys[i] = newKey();
+        ASSERT_EQ(HDF_SUCCESS, MapSet(&map, keys[i].c_str(), value.data(), 1 + next() % MAP_CHURN_VALUE_MAX));
+        peak = std::max(peak, MapArenaSize(&map));
+    }
+    auto churned = steady_clock::now();
+
+    HDF_LOGI("map churn %{public}d live keys, %{public}d erase and insert in %{public}lld us, arena %{public}u "
+        "bytes after insert, %{public}u bytes at most", MAP_CHURN_LIVE, MAP_CHURN_OPS,
+        (long long)duration_cast<microseconds>(churned - start).count(), warm, peak);
+    EXPECT_EQ((uint32_t)MAP_CHURN_LIVE, map.nodeSize);
+    EXPECT_LE(peak, warm * MAP_CHURN_GROWTH_MAX);
+    for (int i = 0; i < MAP_CHURN_LIVE; i++) {
+        ASSERT_EQ(HDF_SUCCESS, MapErase(&map, keys[i].c_str()));
+    }
+    EXPECT_EQ(0u, MapArenaSize(&map));
+    MapDelete(&map);
+}
+} // namespace OHOS
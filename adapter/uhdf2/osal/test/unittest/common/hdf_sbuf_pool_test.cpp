@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include "hdf_log.h"
+#include "hdf_sbuf.h"
+
+#define HDF_LOG_TAG   hdf_sbuf_pool_test_cpp
+
+namespace OHOS {
+using namespace testing::ext;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+static constexpr size_t SBUF_POOL_EVENT_SIZE = 4096;
+static constexpr size_t SBUF_POOL_LARGE_SIZE = 128 * 1024;
+static constexpr int SBUF_POOL_BENCH_COUNT = 100000;
+
+class HdfSbufPoolTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() {}
+    void TearDown() {}
+};
+
+static void SbufPoolFillEvent(struct HdfSBuf *sbuf)
+{
+    uint8_t data[SBUF_POOL_EVENT_SIZE / 2] = {0};
+    ASSERT_TRUE(HdfSbufWriteInt32(sbuf, 1));
+    ASSERT_TRUE(HdfSbufWriteUint64(sbuf, 0x123456789ULL));
+    ASSERT_TRUE(HdfSbufWriteBuffer(sbuf, data, sizeof(data)));
+}
+
+/*
+* @tc.name: SbufPoolReuseTest001
+* @tc.desc: a recycled pooled sbuf is handed out again empty
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfSbufPoolTest, SbufPoolReuseTest001, TestSize.Level1)
+{
+    struct HdfSbufPoolStat before;
+    struct HdfSbufPoolStat after;
+    HdfSbufGetPoolStat(&before);
+
+    struct HdfSBuf *sbuf = HdfSbufObtainPooled(SBUF_POOL_EVENT_SIZE);
+    ASSERT_NE(sbuf, nullptr);
+    EXPECT_GE(HdfSbufGetCapacity(sbuf), SBUF_POOL_EVENT_SIZE);
+    SbufPoolFillEvent(sbuf);
+    HdfSbufRecycle(sbuf);
+
+    struct HdfSBuf *again = HdfSbufObtainPooled(SBUF_POOL_EVENT_SIZE);
+    ASSERT_NE(again, nullptr);
+    EXPECT_EQ(HdfSbufGetDataSize(again), 0u);
+    int32_t value = 0;
+    EXPECT_FALSE(HdfSbufReadInt32(again, &value));
+    SbufPoolFillEvent(again);
+    ASSERT_TRUE(HdfSbufReadInt32(again, &value));
+    EXPECT_EQ(value, 1);
+    HdfSbufRecycle(again);
+
+    HdfSbufGetPoolStat(&after);
+    EXPECT_EQ(after.hits, before.hits + 1);
+    EXPECT_EQ(after.misses, before.misses + 1);
+}
+
+/*
+* @tc.name: SbufPoolGrowTest001
+* @tc.desc: a pooled sbuf grown past its class is still usable and recycled
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfSbufPoolTest, SbufPoolGrowTest001, TestSize.Level1)
+{
+    struct HdfSBuf *sbuf = HdfSbufObtainPooled(0);
+    ASSERT_NE(sbuf, nullptr);
+    for (uint32_t i = 0; i < SBUF_POOL_EVENT_SIZE; i++) {
+        ASSERT_TRUE(HdfSbufWriteUint32(sbuf, i));
+    }
+    struct HdfSBuf *copy = HdfSbufCopy(sbuf);
+    ASSERT_NE(copy, nullptr);
+    HdfSbufRecycle(sbuf);
+
+    for (uint32_t i = 0; i < SBUF_POOL_EVENT_SIZE; i++) {
+        uint32_t value = 0;
+        ASSERT_TRUE(HdfSbufReadUint32(copy, &value));
+        ASSERT_EQ(value, i);
+    }
+    HdfSbufRecycle(copy);
+
+    sbuf = HdfSbufObtainPooled(SBUF_POOL_LARGE_SIZE);
+    ASSERT_NE(sbuf, nullptr);
+    HdfSbufRecycle(sbuf);
+}
+
+/*
+* @tc.name: SbufPoolThreadTest001
+* @tc.desc: every thread keeps its own pool, released when the thread exits
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfSbufPoolTest, SbufPoolThreadTest001, TestSize.Level1)
+{
+    struct HdfSbufPoolStat stat = {0};
+    std::thread worker([&stat]() {
+        for (int i = 0; i < 10; i++) {
+            struct HdfSBuf *sbuf = HdfSbufObtainPooled(SBUF_POOL_EVENT_SIZE);
+            ASSERT_NE(sbuf, nullptr);
+            SbufPoolFillEvent(sbuf);
+            HdfSbufRecycle(sbuf);
+        }
+        HdfSbufGetPoolStat(&stat);
+    });
+    worker.join();
+    EXPECT_EQ(stat.misses, 1u);
+    EXPECT_EQ(stat.hits, 9u);
+}
+
+/*
+* @tc.name: SbufPoolBenchTest001
+* @tc.desc: compare pooled and plain obtain/recycle of event sized sbufs
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(HdfSbufPoolTest, SbufPoolBenchTest001, TestSize.Level3)
+{
+    auto start = steady_clock::now();
+    for (int i = 0; i < SBUF_POOL_BENCH_COUNT; i++) {
+        struct HdfSBuf *sbuf = HdfSbufObtain(SBUF_POOL_EVENT_SIZE);
+        ASSERT_NE(sbuf, nullptr);
+        ASSERT_TRUE(HdfSbufWriteInt32(sbuf, i));
+        HdfSbufRecycle(sbuf);
+    }
+    auto plainCost = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+    start = steady_clock::now();
+    for (int i = 0; i < SBUF_POOL_BENCH_COUNT; i++) {
+        struct HdfSBuf *sbuf = HdfSbufObtainPooled(SBUF_POOL_EVENT_SIZE);
+        ASSERT_NE(sbuf, nullptr);
+        ASSERT_TRUE(HdfSbufWriteInt32(sbuf, i));
+        HdfSbufRecycle(sbuf);
+    }
+    auto pooledCost = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+    HDF_LOGI("sbuf %{public}d obtain/recycle: plain %{public}lld us, pooled %{public}lld us",
+        SBUF_POOL_BENCH_COUNT, static_cast<long long>(plainCost), static_cast<long long>(pooledCost));
+}
+} // namespace OHOS
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdf_base.h"
+#include "hdf_log.h"
+#include "hdf_sbuf.h"
+
+#define HDF_LOG_TAG   hdf_sbuf_ref_test_cpp
+
+namespace OHOS {
+using namespace testing::ext;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+static constexpr uint32_t SBUF_REF_SMALL_SIZE = 4 * 1024 + 1;
+static constexpr uint32_t SBUF_REF_LARGE_SIZE = 64 * 1024;
+static constexpr uint32_t SBUF_MAX_SIZE = 512 * 1024;
+static constexpr int32_t SBUF_REF_MAGIC = 0x5aa5;
+
+class HdfSbufRefTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() {}
+    void TearDown() {}
+};
+
+static std::vector<uint8_t> SbufRefPayload(uint32_t size, uint8_t seed)
+{
+    std::vector<uint8_t> payload(size);
+    for (uint32_t i = 0; i < size; i++) {
+        payload[i] = static_cast<uint8_t>(seed + i * 7);
+    }
+    return payload;
+}
+
+static bool SbufRefWriteAll(struct HdfSBuf *sbuf, const std::vector<uint8_t> &small,
+    const std::vector<uint8_t> &large, bool byRef)
+{
+    auto write = byRef ? HdfSbufWriteBufferRef : HdfSbufWriteBuffer;
+    return HdfSbufWriteInt32(sbuf, SBUF_REF_MAGIC) && write(sbuf, small.data(), small.size()) &&
+        HdfSbufWriteInt32(sbuf, SBUF_REF_MAGIC + 1) && write(sbuf, large.data(), large.size()) &&
+        HdfSbufWriteString(sbuf, "tail");
+}
+
+static int32_t SbufRefGather(void *priv, const uint8_t *data, size_t size)
+{
+    auto out = static_cast<std::vector<uint8_t> *>(priv);
+    out->insert(out->end(), data, data + size);
+    return HDF_SUCCESS;
+}
+
+/*
+* @tc.name: SbufRefReadTest001
+* @tc.desc: segments written by reference are read back in place
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfSbufRefTest, SbufRefReadTest001, TestSize.Level1)
+{
+    auto small = SbufRefPayload(SBUF_REF_SMALL_SIZE, 1);
+    auto large = SbufRefPayload(SBUF_REF_LARGE_SIZE, 2);
+    struct HdfSBuf *sbuf = HdfSbufObtainDefaultSize();
+    ASSERT_NE(sbuf, nullptr);
+    ASSERT_TRUE(SbufRefWriteAll(sbuf, small, large, true));
+    EXPECT_LT(HdfSbufGetCapacity(sbuf), small.size());
+
+    int32_t value = 0;
+    const void *data = nullptr;
+    uint32_t size = 0;
+    ASSERT_TRUE(HdfSbufReadInt32(sbuf, &value));
+    EXPECT_EQ(value, SBUF_REF_MAGIC);
+    ASSERT_TRUE(HdfSbufReadBufferRef(sbuf, &data, &size));
+    EXPECT_EQ(data, small.data());
+    EXPECT_EQ(size, small.size());
+    ASSERT_TRUE(HdfSbufReadInt32(sbuf, &value));
+    EXPECT_EQ(value, SBUF_REF_MAGIC + 1);
+    ASSERT_TRUE(HdfSbufReadBufferRef(sbuf, &data, &size));
+    EXPECT_EQ(data, large.data());
+    EXPECT_EQ(size, large.size());
+    EXPECT_STREQ(HdfSbufReadString(sbuf), "tail");
+    HdfSbufRecycle(sbuf);
+}
+
+/*
+* @tc.name: SbufRefFlattenTest001
+* @tc.desc: flattened and gathered data match a sbuf written by copy
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfSbufRefTest, SbufRefFlattenTest001, TestSize.Level1)
+{
+    auto small = SbufRefPayload(SBUF_REF_SMALL_SIZE, 3);
+    auto large = SbufRefPayload(SBUF_REF_LARGE_SIZE, 4);
+    struct HdfSBuf *copied = HdfSbufObtainDefaultSize();
+    struct HdfSBuf *referenced = HdfSbufObtainDefaultSize();
+    ASSERT_NE(copied, nullptr);
+    ASSERT_NE(referenced, nullptr);
+    ASSERT_TRUE(SbufRefWriteAll(copied, small, large, false));
+    ASSERT_TRUE(SbufRefWriteAll(referenced, small, large, true));
+    size_t size = HdfSbufGetDataSize(copied);
+    ASSERT_EQ(HdfSbufGetDataSize(referenced), size);
+
+    std::vector<uint8_t> gathered;
+    ASSERT_EQ(HdfSbufForEachSegment(referenced, SbufRefGather, &gathered), HDF_SUCCESS);
+    ASSERT_EQ(gathered.size(), size);
+    EXPECT_EQ(memcmp(gathered.data(), HdfSbufGetData(copied), size), 0);
+
+    // reading one referenced segment before flattening keeps the read position consistent
+    int32_t value = 0;
+    const void *data = nullptr;
+    uint32_t readSize = 0;
+    ASSERT_TRUE(HdfSbufReadInt32(referenced, &value));
+    ASSERT_TRUE(HdfSbufReadBufferRef(referenced, &data, &readSize));
+    EXPECT_EQ(data, small.data());
+    ASSERT_EQ(memcmp(HdfSbufGetData(referenced), HdfSbufGetData(copied), size), 0);
+    ASSERT_TRUE(HdfSbufReadInt32(referenced, &value));
+    EXPECT_EQ(value, SBUF_REF_MAGIC + 1);
+    ASSERT_TRUE(HdfSbufReadBufferRef(referenced, &data, &readSize));
+    ASSERT_EQ(readSize, large.size());
+    EXPECT_NE(data, large.data());
+    EXPECT_EQ(memcmp(data, large.data(), readSize), 0);
+    EXPECT_STREQ(HdfSbufReadString(referenced), "tail");
+
+    HdfSbufRecycle(copied);
+    HdfSbufRecycle(referenced);
+}
+
+/*
+* @tc.name: SbufRefCopyTest001
+* @tc.desc: a copied sbuf owns its data and plain reads see the payload
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfSbufRefTest, SbufRefCopyTest001, TestSize.Level1)
+{
+    auto small = SbufRefPayload(SBUF_REF_SMALL_SIZE, 5);
+    auto large = SbufRefPayload(SBUF_REF_LARGE_SIZE, 6);
+    auto expect = large;
+    struct HdfSBuf *sbuf = HdfSbufObtainDefaultSize();
+    ASSERT_NE(sbuf, nullptr);
+    ASSERT_TRUE(SbufRefWriteAll(sbuf, small, large, true));
+    struct HdfSBuf *copy = HdfSbufCopy(sbuf);
+    ASSERT_NE(copy, nullptr);
+    HdfSbufRecycle(sbuf);
+    large.assign(large.size(), 0);
+
+    int32_t value = 0;
+    const void *data = nullptr;
+    uint32_t size = 0;
+    ASSERT_TRUE(HdfSbufReadInt32(copy, &value));
+    ASSERT_TRUE(HdfSbufReadBuffer(copy, &data, &size));
+    ASSERT_TRUE(HdfSbufReadInt32(copy, &value));
+    ASSERT_TRUE(HdfSbufReadBuffer(copy, &data, &size));
+    ASSERT_EQ(size, expect.size());
+    EXPECT_EQ(memcmp(data, expect.data(), size), 0);
+    HdfSbufRecycle(copy);
+}
+
+/*
+* @tc.name: SbufRefLimitTest001
+* @tc.desc: referenced payloads count against the sbuf size limit like copied ones
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfSbufRefTest, SbufRefLimitTest001, TestSize.Level1)
+{
+    auto half = SbufRefPayload(SBUF_MAX_SIZE / 2, 8);
+    struct HdfSBuf *sbuf = HdfSbufObtainDefaultSize();
+    ASSERT_NE(sbuf, nullptr);
+    ASSERT_TRUE(HdfSbufWriteBufferRef(sbuf, half.data(), half.size()));
+    size_t size = HdfSbufGetDataSize(sbuf);
+    EXPECT_FALSE(HdfSbufWriteBufferRef(sbuf, half.data(), half.size()));
+    EXPECT_EQ(HdfSbufGetDataSize(sbuf), size);
+    HdfSbufRecycle(sbuf);
+}
+
+static int32_t SbufRefCopyOut(void *priv, const uint8_t *data, size_t size)
+{
+    auto dst = static_cast<uint8_t **>(priv);
+    (void)memcpy(*dst, data, size);
+    *dst += size;
+    return HDF_SUCCESS;
+}
+
+/*
+* @tc.name: SbufRefBenchTest001
+* @tc.desc: compare copy and reference write/read of 4 KB, 64 KB and 256 KB payloads
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(HdfSbufRefTest, SbufRefBenchTest001, TestSize.Level3)
+{
+    static constexpr uint32_t benchSizes[] = { 4 * 1024, 64 * 1024, SBUF_MAX_SIZE / 2 };
+    static constexpr int benchRounds = 200;
+    for (uint32_t payloadSize : benchSizes) {
+        auto payload = SbufRefPayload(payloadSize, 7);
+        std::vector<uint8_t> out(payloadSize + sizeof(uint32_t));
+        auto start = steady_clock::now();
+        for (int i = 0; i < benchRounds; i++) {
+            struct HdfSBuf *sbuf = HdfSbufObtainDefaultSize();
+            ASSERT_TRUE(HdfSbufWriteBuffer(sbuf, payload.data(), payloadSize));
+            const void *data = nullptr;
+            uint32_t size = 0;
+            ASSERT_TRUE(HdfSbufReadBuffer(sbuf, &data, &size));
+            (void)memcpy(out.data(), data, size);
+            HdfSbufRecycle(sbuf);
+        }
+        auto copyCost = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+        start = steady_clock::now();
+        for (int i = 0; i < benchRounds; i++) {
+            struct HdfSBuf *sbuf = HdfSbufObtainDefaultSize();
+            ASSERT_TRUE(HdfSbufWriteBufferRef(sbuf, payload.data(), payloadSize));
+            const void *data = nullptr;
+            uint32_t size = 0;
+            ASSERT_TRUE(HdfSbufReadBufferRef(sbuf, &data, &size));
+            ASSERT_EQ(data, payload.data());
+            HdfSbufRecycle(sbuf);
+        }
+        auto refCost = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+        // a single gather into the destination models the copy made at the ioctl boundary
+        start = steady_clock::now();
+        for (int i = 0; i < benchRounds; i++) {
+            struct HdfSBuf *sbuf = HdfSbufObtainDefaultSize();
+            ASSERT_TRUE(HdfSbufWriteBufferRef(sbuf, payload.data(), payloadSize));
+            uint8_t *dst = out.data();
+            ASSERT_EQ(HdfSbufForEachSegment(sbuf, SbufRefCopyOut, &dst), HDF_SUCCESS);
+            HdfSbufRecycle(sbuf);
+        }
+        auto gatherCost = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+        HDF_LOGI("sbuf %{public}u bytes x %{public}d: copy %{public}lld us, ref %{public}lld us, "
+            "ref+gather %{public}lld us", payloadSize, benchRounds, static_cast<long long>(copyCost),
+            static_cast<long long>(refCost),
+            static_cast<long long>(gatherCost));
+    }
+}
+} // namespace OHOS
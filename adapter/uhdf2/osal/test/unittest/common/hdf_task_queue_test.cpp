@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdf_log.h"
+#include "hdf_task_queue.h"
+#include "osal_mem.h"
+#include "osal_time.h"
+
+#define HDF_LOG_TAG   hdf_task_queue_test_cpp
+
+namespace OHOS {
+using namespace testing::ext;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+static constexpr int PRODUCER_COUNT = 4;
+static constexpr int TASKS_PER_PRODUCER = 2000;
+static constexpr int TASK_BUSY_US = 20;
+static constexpr int ORDER_TASK_COUNT = 100;
+static constexpr uint32_t POOL_WORKER_COUNT = 4;
+static constexpr uint32_t WAIT_STEP_MS = 1;
+
+class HdfTaskQueueTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() {}
+    void TearDown() {}
+};
+
+struct TestTask {
+    struct HdfTaskType task;
+    int index;
+};
+
+static std::atomic<int> g_doneCount;
+static std::vector<int> g_runOrder;
+
+static int32_t BusyTaskFunc(struct HdfTaskType *para)
+{
+    auto start = steady_clock::now();
+    while (duration_cast<microseconds>(steady_clock::now() - start).count() < TASK_BUSY_US) {
+    }
+    OsalMemFree(CONTAINER_OF(para, struct TestTask, task));
+    g_doneCount++;
+    return HDF_SUCCESS;
+}
+
+static int32_t OrderTaskFunc(struct HdfTaskType *para)
+{
+    struct TestTask *task = CONTAINER_OF(para, struct TestTask, task);
+    g_runOrder.push_back(task->index);
+    OsalMemFree(task);
+    g_doneCount++;
+    return HDF_SUCCESS;
+}
+
+static void WaitTasksDone(int expected)
+{
+    while (g_doneCount.load() < expected) {
+        OsalMSleep(WAIT_STEP_MS);
+    }
+}
+
+static void RunContentionBench(struct HdfTaskQueue *queue, const char *name)
+{
+    std::vector<std::thread> producers;
+    std::atomic<int64_t> maxEnqueueUs(0);
+
+    g_doneCount = 0;
+    auto start = steady_clock::now();
+    for (int p = 0; p < PRODUCER_COUNT; p++) {
+        producers.emplace_back([queue, &maxEnqueueUs]() {
+            for (int i = 0; i < TASKS_PER_PRODUCER; i++) {
+                struct TestTask *task = (struct TestTask *)OsalMemCalloc(sizeof(struct TestTask));
+                ASSERT_TRUE(task != nullptr);
+                auto begin = steady_clock::now();
+                HdfTaskEnqueue(queue, &task->task);
+                int64_t cost = duration_cast<microseconds>(steady_clock::now() - begin).count();
+                int64_t prev = maxEnqueueUs.load();
+                while (cost > prev && !maxEnqueueUs.compare_exchange_weak(prev, cost)) {
+                }
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    auto produced = steady_clock::now();
+    WaitTasksDone(PRODUCER_COUNT * TASKS_PER_PRODUCER);
+    auto done = steady_clock::now();
+
+    HDF_LOGI("%{public}s: %{public}d producers x %{public}d tasks, produce %{public}lld us, "
+        "drain %{public}lld us, max enqueue %{public}lld us", name, PRODUCER_COUNT, TASKS_PER_PRODUCER,
+        (long long)duration_cast<microseconds>(produced - start).count(),
+        (long long)duration_cast<microseconds>(done - start).count(), (long long)maxEnqueueUs.load());
+    EXPECT_EQ(PRODUCER_COUNT * TASKS_PER_PRODUCER, g_doneCount.load());
+}
+
+/*
+* @tc.name: TaskQueueOrderTest001
+* @tc.desc: single worker queue runs tasks in enqueue order
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfTaskQueueTest, TaskQueueOrderTest001, TestSize.Level1)
+{
+    struct HdfTaskQueue *queue = HdfTaskQueueCreate(OrderTaskFunc, "task_order_test");
+    ASSERT_TRUE(queue != nullptr);
+    g_doneCount = 0;
+    g_runOrder.clear();
+    for (int i = 0; i < ORDER_TASK_COUNT; i++) {
+        struct TestTask *task = (struct TestTask *)OsalMemCalloc(sizeof(struct TestTask));
+        ASSERT_TRUE(task != nullptr);
+        task->index = i;
+        HdfTaskEnqueue(queue, &task->task);
+    }
+    WaitTasksDone(ORDER_TASK_COUNT);
+    ASSERT_EQ((size_t)ORDER_TASK_COUNT, g_runOrder.size());
+    for (int i = 0; i < ORDER_TASK_COUNT; i++) {
+        EXPECT_EQ(i, g_runOrder[i]);
+    }
+    HdfTaskQueueDestroy(queue);
+}
+
+/*
+* @tc.name: TaskQueuePoolTest001
+* @tc.desc: invalid pool size is rejected
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfTaskQueueTest, TaskQueuePoolTest001, TestSize.Level1)
+{
+    EXPECT_TRUE(HdfTaskQueueCreatePool(BusyTaskFunc, "task_pool_test", 0) == nullptr);
+}
+
+/*
+* @tc.name: TaskQueueBenchmark001
+* @tc.desc: multi-producer contention on single worker and worker pool queues
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(HdfTaskQueueTest, TaskQueueBenchmark001, TestSize.Level3)
+{
+    struct HdfTaskQueue *queue = HdfTaskQueueCreate(BusyTaskFunc, "task_bench_single");
+    ASSERT_TRUE(queue != nullptr);
+    RunContentionBench(queue, "single worker");
+    HdfTaskQueueDestroy(queue);
+
+    queue = HdfTaskQueueCreatePool(BusyTaskFunc, "task_bench_pool", POOL_WORKER_COUNT);
+    ASSERT_TRUE(queue != nullptr);
+    RunContentionBench(queue, "worker pool");
+    HdfTaskQueueDestroy(queue);
+}
+} // namespace OHOS
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <gtest/gtest.h>
+#include "hdf_log.h"
+#include "hdf_message_looper.h"
+#include "hdf_message_task.h"
+#include "osal_message.h"
+#include "osal_msg_queue.h"
+#include "osal_time.h"
+
+#define HDF_LOG_TAG   osal_msg_queue_test_cpp
+
+namespace OHOS {
+using namespace testing::ext;
+
+static constexpr int BENCH_MSG_COUNT = 10000;
+static constexpr int BENCH_MAX_DELAY_MS = 60000;
+static constexpr int DELAY_SAMPLE_COUNT = 10;
+static constexpr long DELAY_MS = 20;
+static constexpr uint64_t DELAY_JITTER_LIMIT_MS = 15;
+
+class HdfOsalMsgQueueTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() {}
+    void TearDown() {}
+};
+
+static struct HdfMessage *MsgQueueTestObtain(int16_t id)
+{
+    struct HdfMessage *msg = HdfMessageObtain(0);
+    if (msg != nullptr) {
+        msg->messageId = id;
+    }
+    return msg;
+}
+
+struct DelayTestContext {
+    uint64_t sendTime;
+    uint64_t maxJitter;
+    int early;
+    int received;
+};
+
+static DelayTestContext g_delayContext;
+
+static int32_t DelayTestDispatch(struct HdfMessageTask *task, struct HdfMessage *msg)
+{
+    (void)task;
+    (void)msg;
+    uint64_t elapsed = OsalGetSysTimeMs() - g_delayContext.sendTime;
+    if (elapsed < (uint64_t)DELAY_MS) {
+        g_delayContext.early++;
+    } else if (elapsed - DELAY_MS > g_delayContext.maxJitter) {
+        g_delayContext.maxJitter = elapsed - DELAY_MS;
+    }
+    g_delayContext.received++;
+    return HDF_SUCCESS;
+}
+
+/*
+* @tc.name: MsgQueueOrderTest001
+* @tc.desc: messages are dequeued by deadline, FIFO for equal deadlines
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfOsalMsgQueueTest, MsgQueueOrderTest001, TestSize.Level1)
+{
+    struct HdfMessageQueue queue;
+    OsalMessageQueueInit(&queue);
+    HdfMessageQueueEnqueue(&queue, MsgQueueTestObtain(1), 0);
+    HdfMessageQueueEnqueue(&queue, MsgQueueTestObtain(2), BENCH_MAX_DELAY_MS);
+    HdfMessageQueueEnqueue(&queue, MsgQueueTestObtain(3), 0);
+    HdfMessageQueueEnqueue(&queue, MsgQueueTestObtain(4), 0);
+
+    const int16_t expected[] = {1, 3, 4};
+    for (int16_t id : expected) {
+        struct HdfMessage *msg = HdfMessageQueueNext(&queue);
+        ASSERT_TRUE(msg != nullptr);
+        EXPECT_EQ(id, msg->messageId);
+        HdfMessageRecycle(msg);
+    }
+    EXPECT_EQ(1u, queue.count);
+    OsalMessageQueueDestroy(&queue);
+}
+
+/*
+* @tc.name: MsgQueueDelayTest001
+* @tc.desc: delayed messages are delivered by the looper on time
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(HdfOsalMsgQueueTest, MsgQueueDelayTest001, TestSize.Level1)
+{
+    struct HdfMessageLooper looper;
+    struct HdfMessageTask task;
+    struct IHdfMessageHandler handler = { DelayTestDispatch };
+    HdfMessageLooperConstruct(&looper);
+    HdfMessageTaskConstruct(&task, &looper, &handler);
+    std::thread loopThread([&looper]() { looper.Start(&looper); });
+    while (!looper.isRunning) {
+        std::this_thread::yield();
+    }
+
+    g_delayContext = {0, 0, 0, 0};
+    for (int i = 0; i < DELAY_SAMPLE_COUNT; i++) {
+        int received = g_delayContext.received;
+        g_delayContext.sendTime = OsalGetSysTimeMs();
+        EXPECT_EQ(HDF_SUCCESS, HdfMessageTaskSendMessageLater(&task, MsgQueueTestObtain(i), false, DELAY_MS));
+        while (g_delayContext.received == received) {
+            OsalMSleep(1);
+        }
+    }
+    HDF_LOGI("delayed delivery: %{public}d samples, max jitter %{public}u ms",
+        DELAY_SAMPLE_COUNT, (uint32_t)g_delayContext.maxJitter);
+    EXPECT_EQ(0, g_delayContext.early);
+    EXPECT_LE(g_delayContext.maxJitter, DELAY_JITTER_LIMIT_MS);
+
+    looper.Stop(&looper);
+    loopThread.join();
+}
+
+/*
+* @tc.name: MsgQueueBenchmark001
+* @tc.desc: enqueue/dequeue throughput with many pending delayed messages
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(HdfOsalMsgQueueTest, MsgQueueBenchmark001, TestSize.Level3)
+{
+    struct HdfMessageQueue queue;
+    OsalMessageQueueInit(&queue);
+    srand(0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_MSG_COUNT; i++) {
+        HdfMessageQueueEnqueue(&queue, MsgQueueTestObtain(0), BENCH_MAX_DELAY_MS + rand() % BENCH_MAX_DELAY_MS);
+    }
+    auto delayedEnd = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_MSG_COUNT; i++) {
+        HdfMessageQueueEnqueue(&queue, MsgQueueTestObtain(1), 0);
+    }
+    auto enqueueEnd = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_MSG_COUNT; i++) {
+        struct HdfMessage *msg = HdfMessageQueueNext(&queue);
+        ASSERT_TRUE(msg != nullptr);
+        EXPECT_EQ(1, msg->messageId);
+        HdfMessageRecycle(msg);
+    }
+    auto dequeueEnd = std::chrono::steady_clock::now();
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    HDF_LOGI("msg queue bench: %{public}d delayed enqueue %{public}lld us, %{public}d ready enqueue %{public}lld us, "
+        "dequeue %{public}lld us", BENCH_MSG_COUNT,
+        (long long)duration_cast<microseconds>(delayedEnd - start).count(), BENCH_MSG_COUNT,
+        (long long)duration_cast<microseconds>(enqueueEnd - delayedEnd).count(),
+        (long long)duration_cast<microseconds>(dequeueEnd - enqueueEnd).count());
+    EXPECT_EQ((uint32_t)BENCH_MSG_COUNT, queue.count);
+    OsalMessageQueueDestroy(&queue);
+}
+} // namespace OHOS
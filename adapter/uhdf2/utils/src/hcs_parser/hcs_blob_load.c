@@ -14,9 +14,14 @@
  */
 
 #include "hcs_blob_load.h"
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "hcs_blob_if.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
@@ -74,3 +79,64 @@ uint32_t OpenHcsBlobFile(const char *hcsBlobPath, char **hcsBlob)
     }
     return (length > 0) ? length : 0;
 }
+
+/*
+ * The parser reads the names and string values of the blob with strlen(), the copy is followed by a NUL
+ * to bound a string left unterminated by a malformed blob. A mapping is bounded the same way when the blob
+ * ends inside a page, the rest of that page reads as zeros, or when its last byte is a NUL itself.
+ */
+static bool IsHcsBlobMapTerminated(const char *blob, size_t length)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if ((pageSize > 0) && ((length % (size_t)pageSize) != 0)) {
+        return true;
+    }
+    return blob[length - 1] == '\0';
+}
+
+uint32_t MapHcsBlobFile(const char *hcsBlobPath, const char **hcsBlob)
+{
+    struct stat st;
+    void *blob = NULL;
+    int fd;
+    if ((hcsBlobPath == NULL) || (hcsBlob == NULL) || !IsHcbFile(hcsBlobPath)) {
+        HDF_LOGE("%{public}s failed, pls check the param", __func__);
+        return 0;
+    }
+
+    char path[PATH_MAX] = { 0 };
+    if (realpath(hcsBlobPath, path) == NULL) {
+        HDF_LOGE("file %{public}s is invalid", hcsBlobPath);
+        return 0;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        HDF_LOGE("%{public}s failed, pls check the path of %{public}s", __func__, hcsBlobPath);
+        return 0;
+    }
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0) || (st.st_size >= HBC_BLOB_MAX_LENGTH)) {
+        HDF_LOGE("%{public}s failed, the HcsBlob file length is %{public}lld", __func__, (long long)st.st_size);
+        close(fd);
+        return 0;
+    }
+    blob = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (blob == MAP_FAILED) {
+        HDF_LOGE("%{public}s failed, mmap error %{public}d", __func__, errno);
+        return 0;
+    }
+    if (!IsHcsBlobMapTerminated((const char *)blob, (size_t)st.st_size)) {
+        HDF_LOGW("%{public}s: blob strings may run past the mapping, load a copy", __func__);
+        (void)munmap(blob, (size_t)st.st_size);
+        return 0;
+    }
+    *hcsBlob = (const char *)blob;
+    return (uint32_t)st.st_size;
+}
+
+void UnmapHcsBlobFile(const char *hcsBlob, uint32_t length)
+{
+    if ((hcsBlob != NULL) && (length > 0)) {
+        (void)munmap((void *)hcsBlob, length);
+    }
+}
@@ -18,6 +18,25 @@
 
 #include "hdf_base.h"
 
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
 uint32_t OpenHcsBlobFile(const char *hcsBlobPath, char **hcsBlob);
+/*
+ * Maps the blob read-only instead of copying it, the pages are shared by every process using the same file.
+ * Returns the blob length, 0 on failure or if a string of the blob could run past the mapping, the caller
+ * then loads a copy with OpenHcsBlobFile(). The mapping is released with UnmapHcsBlobFile().
+ */
+uint32_t MapHcsBlobFile(const char *hcsBlobPath, const char **hcsBlob);
+void UnmapHcsBlobFile(const char *hcsBlob, uint32_t length);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
 
 #endif // HCS_BLOB_LOAD_H
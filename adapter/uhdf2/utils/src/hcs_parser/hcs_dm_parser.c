@@ -22,17 +22,25 @@
 #include "osal_mem.h"
 
 #define HDF_LOG_TAG hcs_dm_parser
-static char *g_hcsBlob = NULL;
+static const char *g_hcsBlob = NULL;
+static uint32_t g_hcsBlobLength = 0;
+static bool g_hcsBlobMapped = false;
 static struct DeviceResourceNode *g_hcsTreeRoot = NULL;
 static const char *g_hcsBlobPath = NULL;
 static pthread_mutex_t g_getDmRootMutex = PTHREAD_MUTEX_INITIALIZER;
 
 void ReleaseHcsTree(void)
 {
-    OsalMemFree(g_hcsTreeRoot);
+    HcsTreeRelease(g_hcsTreeRoot);
     g_hcsTreeRoot = NULL;
-    OsalMemFree(g_hcsBlob);
+    if (g_hcsBlobMapped) {
+        UnmapHcsBlobFile(g_hcsBlob, g_hcsBlobLength);
+    } else {
+        OsalMemFree((void *)g_hcsBlob);
+    }
     g_hcsBlob = NULL;
+    g_hcsBlobLength = 0;
+    g_hcsBlobMapped = false;
 }
 
 void SetHcsBlobPath(const char *path)
@@ -47,12 +55,19 @@ static bool CreateHcsToTree(void)
 {
     bool ret = true;
     do {
-        uint32_t length = OpenHcsBlobFile(g_hcsBlobPath, &g_hcsBlob);
-        if (length == 0) {
+        // the tree points into the blob, a read-only mapping lets all hosts share its pages
+        g_hcsBlobLength = MapHcsBlobFile(g_hcsBlobPath, &g_hcsBlob);
+        g_hcsBlobMapped = (g_hcsBlobLength != 0);
+        if (!g_hcsBlobMapped) {
+            char *blob = NULL;
+            g_hcsBlobLength = OpenHcsBlobFile(g_hcsBlobPath, &blob);
+            g_hcsBlob = blob;
+        }
+        if (g_hcsBlobLength == 0) {
             ret = false;
             break;
         }
-        if (!HcsCheckBlobFormat(g_hcsBlob, length)) {
+        if (!HcsCheckBlobFormat(g_hcsBlob, g_hcsBlobLength)) {
             ret = false;
             break;
         }
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "hcs_blob_if.h"
+#include "hcs_blob_load.h"
+#include "hcs_blob_writer.h"
+#include "hcs_parser.h"
+#include "hcs_tree_if.h"
+#include "osal_mem.h"
+
+namespace OHOS {
+using namespace testing::ext;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+static constexpr const char *HCS_BLOB_LOAD_TEST_FILE = "/data/local/tmp/hcs_blob_load_test.hcb";
+static constexpr uint32_t HCS_BLOB_LOAD_DEVICE_COUNT = 2000;
+static constexpr uint32_t HCS_BLOB_LOAD_ARRAY_SIZE = 64;
+
+struct HcsLoadCost {
+    int64_t startupUs;
+    int64_t privateKb;
+    int64_t sharedKb;
+    bool passed;
+};
+
+class HcsBlobLoadTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp() {}
+    void TearDown() {}
+};
+
+void HcsBlobLoadTest::SetUpTestCase()
+{
+    HcsTest::HcbWriter writer;
+    writer.BeginNode(HBC_ROOT_NAME);
+    for (uint32_t i = 0; i < HCS_BLOB_LOAD_DEVICE_COUNT; i++) {
+        writer.BeginNode("device_" + std::to_string(i));
+        writer.AttrString(HCS_MATCH_ATTR, "hcs_blob_load_" + std::to_string(i));
+        writer.AttrDword("reg", i);
+        writer.AttrMixedArray("regs", HCS_BLOB_LOAD_ARRAY_SIZE, i);
+        writer.EndNode();
+    }
+    writer.EndNode();
+    std::vector<char> &blob = writer.Finish();
+
+    FILE *fp = fopen(HCS_BLOB_LOAD_TEST_FILE, "wb");
+    ASSERT_NE(fp, nullptr);
+    EXPECT_EQ(1u, fwrite(blob.data(), blob.size(), 1, fp));
+    fclose(fp);
+}
+
+void HcsBlobLoadTest::TearDownTestCase()
+{
+    (void)unlink(HCS_BLOB_LOAD_TEST_FILE);
+}
+
+// resident memory of this process in kB, split into file backed shared pages and private pages
+static void GetResidentKb(int64_t &privateKb, int64_t &sharedKb)
+{
+    long size = 0;
+    long resident = 0;
+    long shared = 0;
+    privateKb = 0;
+    sharedKb = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (fp == nullptr) {
+        return;
+    }
+    if (fscanf(fp, "%ld %ld %ld", &size, &resident, &shared) == 3) { // size, resident and shared pages
+        long pageKb = sysconf(_SC_PAGESIZE) / 1024;
+        privateKb = (resident - shared) * pageKb;
+        sharedKb = shared * pageKb;
+    }
+    fclose(fp);
+}
+
+// reads every device the way drivers do at probe time, touching all of the blob
+static void ReadAllDevices(const struct DeviceResourceNode *root)
+{
+    uint32_t count = 0;
+    for (const struct DeviceResourceNode *node = root->child; node != nullptr; node = node->sibling) {
+        uint32_t reg = 0;
+        uint64_t regs[HCS_BLOB_LOAD_ARRAY_SIZE] = {0};
+        EXPECT_EQ(HDF_SUCCESS, HcsGetUint32(node, "reg", &reg, 0));
+        EXPECT_EQ(count, reg);
+        EXPECT_EQ(HDF_SUCCESS, HcsGetUint64Array(node, "regs", regs, HCS_BLOB_LOAD_ARRAY_SIZE, 0));
+        count++;
+    }
+    EXPECT_EQ(HCS_BLOB_LOAD_DEVICE_COUNT, count);
+}
+
+static void LoadAndRead(bool mapped, struct HcsLoadCost &cost)
+{
+    const char *blob = nullptr;
+    uint32_t length;
+    struct DeviceResourceNode *root = nullptr;
+    int64_t privateKb;
+    int64_t sharedKb;
+
+    GetResidentKb(privateKb, sharedKb);
+    auto start = steady_clock::now();
+    if (mapped) {
+        length = MapHcsBlobFile(HCS_BLOB_LOAD_TEST_FILE, &blob);
+    } else {
+        char *copy = nullptr;
+        length = OpenHcsBlobFile(HCS_BLOB_LOAD_TEST_FILE, &copy);
+        blob = copy;
+    }
+    ASSERT_NE(0u, length);
+    ASSERT_TRUE(HcsCheckBlobFormat(blob, length));
+    ASSERT_TRUE(HcsDecompile(blob, HBC_HEADER_LENGTH, &root));
+    ReadAllDevices(root);
+    cost.startupUs = duration_cast<microseconds>(steady_clock::now() - start).count();
+    GetResidentKb(cost.privateKb, cost.sharedKb);
+    cost.privateKb -= privateKb;
+    cost.sharedKb -= sharedKb;
+
+    HcsTreeRelease(root);
+    if (mapped) {
+        UnmapHcsBlobFile(blob, length);
+    } else {
+        OsalMemFree(const_cast<char *>(blob));
+    }
+}
+
+// loads the config in a fresh process, like a host starting up, so the heap of earlier loads is not reused
+static bool LoadInChild(bool mapped, struct HcsLoadCost &cost)
+{
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        LoadAndRead(mapped, cost);
+        cost.passed = !testing::Test::HasFailure();
+        ssize_t ret = write(fds[1], &cost, sizeof(cost));
+        close(fds[1]);
+        _exit((ret == static_cast<ssize_t>(sizeof(cost))) ? 0 : 1);
+    }
+    close(fds[1]);
+    bool ret = (pid > 0) && (read(fds[0], &cost, sizeof(cost)) == static_cast<ssize_t>(sizeof(cost)));
+    close(fds[0]);
+    if (pid > 0) {
+        int status = 0;
+        (void)waitpid(pid, &status, 0);
+    }
+    return ret && cost.passed;
+}
+
+/**
+ * @tc.name: HcsBlobLoadTest001
+ * @tc.desc: a mapped blob decodes and serves queries like a copied one
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsBlobLoadTest, HcsBlobLoadTest001, TestSize.Level1)
+{
+    const char *blob = nullptr;
+    uint32_t length = MapHcsBlobFile(HCS_BLOB_LOAD_TEST_FILE, &blob);
+    ASSERT_NE(0u, length);
+    struct DeviceResourceNode *root = nullptr;
+    ASSERT_TRUE(HcsCheckBlobFormat(blob, length));
+    ASSERT_TRUE(HcsDecompile(blob, HBC_HEADER_LENGTH, &root));
+    ReadAllDevices(root);
+    const struct DeviceResourceNode *node = HcsGetNodeByMatchAttr(root, "hcs_blob_load_100");
+    ASSERT_NE(node, nullptr);
+    EXPECT_STREQ("device_100", node->name);
+    HcsTreeRelease(root);
+    UnmapHcsBlobFile(blob, length);
+
+    EXPECT_EQ(0u, MapHcsBlobFile("/data/local/tmp/not_exist.hcb", &blob));
+    EXPECT_EQ(0u, MapHcsBlobFile(nullptr, &blob));
+    EXPECT_EQ(0u, MapHcsBlobFile(HCS_BLOB_LOAD_TEST_FILE, nullptr));
+}
+
+/**
+ * @tc.name: HcsBlobLoadTest002
+ * @tc.desc: startup time and resident memory of a host loading its config by copy and by mapping
+ * @tc.type: PERF
+ */
+HWTEST_F(HcsBlobLoadTest, HcsBlobLoadTest002, TestSize.Level1)
+{
+    struct HcsLoadCost copied = {0, 0, 0, false};
+    struct HcsLoadCost mapped = {0, 0, 0, false};
+    ASSERT_TRUE(LoadInChild(false, copied));
+    ASSERT_TRUE(LoadInChild(true, mapped));
+    printf("HcsBlobLoadTest: copy   startup %lld us, private %lld kB, shared %lld kB\n",
+        static_cast<long long>(copied.startupUs), static_cast<long long>(copied.privateKb),
+        static_cast<long long>(copied.sharedKb));
+    printf("HcsBlobLoadTest: mapped startup %lld us, private %lld kB, shared %lld kB\n",
+        static_cast<long long>(mapped.startupUs), static_cast<long long>(mapped.privateKb),
+        static_cast<long long>(mapped.sharedKb));
+}
+
+static bool WriteTestFile(const char *path, size_t size, char fill)
+{
+    std::string data(size, fill);
+    FILE *fp = fopen(path, "wb");
+    if (fp == nullptr) {
+        return false;
+    }
+    bool ret = (fwrite(data.data(), data.size(), 1, fp) == 1);
+    fclose(fp);
+    return ret;
+}
+
+/**
+ * @tc.name: HcsBlobLoadTest003
+ * @tc.desc: a blob is only mapped if no string of it can run past the mapping
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsBlobLoadTest, HcsBlobLoadTest003, TestSize.Level1)
+{
+    static constexpr const char *path = "/data/local/tmp/hcs_blob_load_unterminated.hcb";
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const char *blob = nullptr;
+
+    // the zeros after the end of the file terminate the last string
+    ASSERT_TRUE(WriteTestFile(path, pageSize - 1, 'x'));
+    uint32_t length = MapHcsBlobFile(path, &blob);
+    EXPECT_EQ(pageSize - 1, length);
+    EXPECT_EQ('\0', blob[length]);
+    UnmapHcsBlobFile(blob, length);
+
+    // a page aligned blob without a NUL at its end has to be copied
+    ASSERT_TRUE(WriteTestFile(path, pageSize, 'x'));
+    EXPECT_EQ(0u, MapHcsBlobFile(path, &blob));
+    char *copy = nullptr;
+    length = OpenHcsBlobFile(path, &copy);
+    ASSERT_EQ(pageSize, length);
+    EXPECT_EQ('\0', copy[length]);
+    OsalMemFree(copy);
+
+    (void)unlink(path);
+}
+} // namespace OHOS
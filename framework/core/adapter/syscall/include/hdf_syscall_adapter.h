@@ -38,6 +38,8 @@ struct HdfDevListenerThread {
     bool shouldStop;
     struct DListHead *listenerListPtr;
     uint8_t status;
+    int epollFd; /* invalid if epoll is unavailable or not built in, the thread then polls pfds */
+    int wakeFd;
 };
 
 struct HdfSyscallAdapter {
@@ -48,6 +50,10 @@ struct HdfSyscallAdapter {
     struct DListHead listNode;
     struct HdfDevListenerThread *thread;
     struct HdfSyscallAdapterGroup *group;
+    struct HdfDevEventRing *eventRing;
+    uint32_t eventRingSize;
+    void *sharedBuf;
+    uint32_t sharedBufSize;
 };
 
 struct HdfSyscallAdapterGroup {
@@ -13,8 +13,13 @@
 #include <poll.h>
 #include <securec.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef HDF_EVENT_LISTENER_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
 #include "hdf_base.h"
 #include "hdf_log.h"
@@ -24,7 +29,7 @@
 #include "hdf_syscall_adapter.h"
 
 #define HDF_LOG_TAG                 hdf_syscall_adapter
-#define EPOLL_MAX_EVENT_SIZE        4
+#define EPOLL_MAX_EVENT_SIZE        16
 #define HDF_DEFAULT_BWR_READ_SIZE   1024
 #define EVENT_READ_BUFF_GROWTH_RATE 2
 #define EVENT_READ_BUFF_MAX         (20 * 1024) // 20k
@@ -33,6 +38,9 @@
 #define TIMEOUT_US                  100000 // 100ms
 #define LOAD_IOSERVICE_WAIT_TIME    10     // ms
 #define LOAD_IOSERVICE_WAIT_COUNT   20     // ms
+#define EVENT_RING_MAP_SIZE         (64 * 1024 + HDF_DEV_EVENT_RING_HEADER_SIZE)
+#define EVENT_RING_ALIGN_SIZE(size) \
+    (((size) + HDF_DEV_EVENT_RING_ALIGN - 1) & ~((uint64_t)HDF_DEV_EVENT_RING_ALIGN - 1))
 
 static bool HaveOnlyOneElement(const struct DListHead *head)
 {
@@ -43,14 +51,27 @@ static bool HaveOnlyOneElement(const struct DListHead *head)
     return false;
 }
 
-static int32_t HdfDevEventGrowReadBuffer(struct HdfWriteReadBuf *buffer)
+/* Read buffer owned by one listener thread, grown on demand and kept across wakeups. */
+struct HdfDevEventReadBuffer {
+    uint8_t *data;
+    uint32_t size;
+    bool batchUnsupported;
+};
+
+static int32_t HdfDevEventGrowReadBuffer(struct HdfDevEventReadBuffer *buffer, uint32_t needSize)
 {
-    size_t newSize = buffer->readSize;
+    const uint32_t maxSize = EVENT_READ_BUFF_MAX + sizeof(struct HdfDevEventHeader);
+    uint32_t newSize = buffer->size * EVENT_READ_BUFF_GROWTH_RATE;
 
-    if (newSize > EVENT_READ_BUFF_MAX) {
+    if (needSize > maxSize) {
         HDF_LOGE("%s: report event size out of max limit", __func__);
         return HDF_DEV_ERR_NORANGE;
     }
+    if (newSize < HDF_DEFAULT_BWR_READ_SIZE) {
+        newSize = HDF_DEFAULT_BWR_READ_SIZE;
+    }
+    newSize = (newSize > maxSize) ? maxSize : newSize;
+    newSize = (newSize < needSize) ? needSize : newSize;
 
     void *newBuff = OsalMemAlloc(newSize);
     if (newBuff == NULL) {
@@ -58,8 +79,9 @@ static int32_t HdfDevEventGrowReadBuffer(struct HdfWriteReadBuf *buffer)
         return HDF_DEV_ERR_NO_MEMORY;
     }
 
-    OsalMemFree((void *)(uintptr_t)buffer->readBuffer);
-    buffer->readBuffer = (uintptr_t)newBuff;
+    OsalMemFree(buffer->data);
+    buffer->data = newBuff;
+    buffer->size = newSize;
     return HDF_SUCCESS;
 }
 
@@ -83,14 +105,14 @@ static struct HdfSyscallAdapter *HdfFdToAdapterLocked(const struct HdfDevListene
     return NULL;
 }
 
-static int32_t HdfDevEventDispatchLocked(
-    const struct HdfDevListenerThread *thread, struct HdfSyscallAdapter *adapter, const struct HdfWriteReadBuf *bwr)
+static int32_t HdfDevEventDispatchLocked(const struct HdfDevListenerThread *thread,
+    struct HdfSyscallAdapter *adapter, int32_t cmdCode, uint8_t *data, uint32_t size)
 {
     struct HdfDevEventlistener *listener = NULL;
     struct HdfSBuf *sbuf = NULL;
 
-    if (bwr->readConsumed > 0) {
-        sbuf = HdfSbufBind(bwr->readBuffer, bwr->readConsumed);
+    if (size > 0) {
+        sbuf = HdfSbufBind((uintptr_t)data, size);
     } else {
         sbuf = HdfSbufObtain(sizeof(int));
     }
@@ -104,11 +126,11 @@ static int32_t HdfDevEventDispatchLocked(
     if (thread->listenerListPtr != NULL) {
         DLIST_FOR_EACH_ENTRY(listener, thread->listenerListPtr, struct HdfDevEventlistener, listNode) {
             if (listener->onReceive != NULL) {
-                (void)listener->onReceive(listener, &adapter->super, bwr->cmdCode, sbuf);
+                (void)listener->onReceive(listener, &adapter->super, cmdCode, sbuf);
             } else if (listener->callBack != NULL) {
-                (void)listener->callBack(listener->priv, bwr->cmdCode, sbuf);
+                (void)listener->callBack(listener->priv, cmdCode, sbuf);
             }
-            HdfSbufSetDataSize(sbuf, bwr->readConsumed);
+            HdfSbufSetDataSize(sbuf, size);
         }
     }
 
@@ -116,11 +138,11 @@ static int32_t HdfDevEventDispatchLocked(
     /* Dispatch events to the service (SyscallAdapter) listener */
     DLIST_FOR_EACH_ENTRY(listener, &adapter->listenerList, struct HdfDevEventlistener, listNode) {
         if (listener->onReceive != NULL) {
-            (void)listener->onReceive(listener, &adapter->super, bwr->cmdCode, sbuf);
+            (void)listener->onReceive(listener, &adapter->super, cmdCode, sbuf);
         } else if (listener->callBack != NULL) {
-            (void)listener->callBack(listener->priv, bwr->cmdCode, sbuf);
+            (void)listener->callBack(listener->priv, cmdCode, sbuf);
         }
-        HdfSbufSetDataSize(sbuf, bwr->readConsumed);
+        HdfSbufSetDataSize(sbuf, size);
     }
     OsalMutexUnlock(&adapter->mutex);
 
@@ -128,19 +150,142 @@ static int32_t HdfDevEventDispatchLocked(
     return HDF_SUCCESS;
 }
 
-static int32_t HdfDevEventReadAndDispatch(struct HdfDevListenerThread *thread, int32_t fd)
+static int32_t HdfDevEventDispatchBatchLocked(const struct HdfDevListenerThread *thread,
+    struct HdfSyscallAdapter *adapter, const struct HdfWriteReadBuf *bwr)
+{
+    uint8_t *data = (uint8_t *)(uintptr_t)bwr->readBuffer;
+    uint32_t pos = 0;
+
+    for (int32_t i = 0; i < bwr->cmdCode; i++) {
+        struct HdfDevEventHeader header;
+        if (bwr->readConsumed - pos < sizeof(header)) {
+            HDF_LOGE("%s: truncated event batch", __func__);
+            return HDF_FAILURE;
+        }
+        (void)memcpy_s(&header, sizeof(header), data + pos, sizeof(header));
+        pos += sizeof(header);
+        if (bwr->readConsumed - pos < header.size) {
+            HDF_LOGE("%s: truncated event batch", __func__);
+            return HDF_FAILURE;
+        }
+        int32_t ret = HdfDevEventDispatchLocked(thread, adapter, header.cmdCode, data + pos, header.size);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+        pos += (header.size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+    }
+
+    return HDF_SUCCESS;
+}
+
+/*
+ * A vnode without batch read fails it as any unknown command: with HDF_FAILURE from older ones, seen as EPERM,
+ * or with ENOTTY/EINVAL from the kernel itself. Falling back on a real batch read error is harmless, since the
+ * single read fails the same way then.
+ */
+static bool HdfDevEventBatchUnsupported(int err)
+{
+    return err == -HDF_ERR_NOT_SUPPORT || err == EPERM || err == ENOTTY || err == EINVAL;
+}
+
+static int32_t HdfDevEventReadLocked(
+    struct HdfSyscallAdapter *adapter, struct HdfDevEventReadBuffer *buffer, struct HdfWriteReadBuf *bwr)
+{
+    while (true) {
+        bwr->readBuffer = (uintptr_t)buffer->data;
+        bwr->readSize = buffer->size;
+        bwr->readConsumed = 0;
+        bwr->cmdCode = -1;
+        int32_t ret = ioctl(adapter->fd, buffer->batchUnsupported ? HDF_READ_DEV_EVENT : HDF_READ_DEV_EVENTS, bwr);
+        if (ret == 0) {
+            return HDF_SUCCESS;
+        }
+        ret = errno;
+        if (ret == -HDF_DEV_ERR_NORANGE) {
+            if (HdfDevEventGrowReadBuffer(buffer, bwr->readSize) == HDF_SUCCESS) {
+                /* The read buffer is insufficient. Expand the buffer and try again. */
+                continue;
+            }
+        }
+        if (ret == -HDF_DEV_ERR_NODATA) {
+            return ret;
+        }
+        if (HdfDevEventBatchUnsupported(ret) && !buffer->batchUnsupported) {
+            /* driver side without batch read, fall back to one event per call */
+            buffer->batchUnsupported = true;
+            continue;
+        }
+        HDF_LOGE("%s:ioctl failed, errno=%d", __func__, ret);
+        return ret;
+    }
+}
+
+static bool HdfDevEventRingConsume(struct HdfDevEventRing *ring, uint32_t *head, uint32_t size)
+{
+    /* another consumer of the same ring may have taken the record, the caller then starts over */
+    return __atomic_compare_exchange_n(&ring->head, head, *head + size, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+static int32_t HdfDevEventRingDispatchLocked(const struct HdfDevListenerThread *thread,
+    struct HdfSyscallAdapter *adapter, struct HdfDevEventRing *ring, struct HdfDevEventReadBuffer *buffer,
+    uint32_t *count)
+{
+    const uint8_t *records = (const uint8_t *)ring + HDF_DEV_EVENT_RING_HEADER_SIZE;
+    const uint32_t ringSize = adapter->eventRingSize;
+    struct HdfDevEventHeader header;
+
+    while (true) {
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            return HDF_SUCCESS;
+        }
+        uint32_t offset = head & (ringSize - 1);
+        if (tail - head > ringSize || ringSize - offset < sizeof(header)) {
+            HDF_LOGE("%s: broken event ring", __func__);
+            return HDF_FAILURE;
+        }
+        (void)memcpy_s(&header, sizeof(header), records + offset, sizeof(header));
+        if (header.size == HDF_DEV_EVENT_RING_PAD) {
+            (void)HdfDevEventRingConsume(ring, &head, ringSize - offset);
+            continue;
+        }
+        uint64_t recordSize = EVENT_RING_ALIGN_SIZE(sizeof(header) + (uint64_t)header.size);
+        if (recordSize > ringSize - offset || recordSize > (uint32_t)(tail - head)) {
+            if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) != head) {
+                continue;
+            }
+            HDF_LOGE("%s: broken event record", __func__);
+            return HDF_FAILURE;
+        }
+        if (header.size > buffer->size && HdfDevEventGrowReadBuffer(buffer, header.size) != HDF_SUCCESS) {
+            (void)HdfDevEventRingConsume(ring, &head, (uint32_t)recordSize);
+            continue;
+        }
+        if (header.size > 0) {
+            (void)memcpy_s(buffer->data, buffer->size, records + offset + sizeof(header), header.size);
+        }
+        if (!HdfDevEventRingConsume(ring, &head, (uint32_t)recordSize)) {
+            continue;
+        }
+        int32_t ret = HdfDevEventDispatchLocked(thread, adapter, header.cmdCode, buffer->data, header.size);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+        (*count)++;
+    }
+}
+
+static int32_t HdfDevEventReadAndDispatch(
+    struct HdfDevListenerThread *thread, int32_t fd, struct HdfDevEventReadBuffer *buffer)
 {
     struct HdfWriteReadBuf bwr = {0};
     int32_t ret = HDF_SUCCESS;
 
-    bwr.readBuffer = (uintptr_t)OsalMemAlloc(HDF_DEFAULT_BWR_READ_SIZE);
-    if (bwr.readBuffer == (uintptr_t)NULL) {
+    if (buffer->data == NULL && HdfDevEventGrowReadBuffer(buffer, HDF_DEFAULT_BWR_READ_SIZE) != HDF_SUCCESS) {
         HDF_LOGE("%s: oom", __func__);
         return HDF_DEV_ERR_NO_MEMORY;
     }
-    bwr.cmdCode = -1;
-    bwr.readConsumed = 0;
-    bwr.readSize = HDF_DEFAULT_BWR_READ_SIZE;
 
     OsalMutexLock(&thread->mutex);
 
@@ -148,35 +293,32 @@ static int32_t HdfDevEventReadAndDispatch(struct HdfDevListenerThread *thread, i
     if (adapter == NULL) {
         HDF_LOGI("%s: invalid adapter", __func__);
         OsalMSleep(1); // yield to sync adapter list
-        goto FINISH;
+        OsalMutexUnlock(&thread->mutex);
+        return HDF_SUCCESS;
     }
 
-    while (true) {
-        ret = ioctl(adapter->fd, HDF_READ_DEV_EVENT, &bwr);
-        if (ret == 0) {
-            break;
-        }
-        ret = errno;
-        if (ret == -HDF_DEV_ERR_NORANGE) {
-            if (HdfDevEventGrowReadBuffer(&bwr) == HDF_SUCCESS) {
-                /* read buffer may not enough, grow read buffer and try again--The read buffere is insufficient.
-                Expand the buffer and try again. */
-                continue;
-            }
+    /* published by HdfIoServiceMapEventRingLocked under the adapter mutex, which this thread does not hold */
+    struct HdfDevEventRing *ring = __atomic_load_n(&adapter->eventRing, __ATOMIC_ACQUIRE);
+    if (ring != NULL) {
+        uint32_t count = 0;
+        ret = HdfDevEventRingDispatchLocked(thread, adapter, ring, buffer, &count);
+        if (count > 0 || ret != HDF_SUCCESS) {
+            OsalMutexUnlock(&thread->mutex);
+            return ret;
         }
-        if (ret == -HDF_DEV_ERR_NODATA) {
-            ret = HDF_SUCCESS;
+    }
+
+    ret = HdfDevEventReadLocked(adapter, buffer, &bwr);
+    if (ret == HDF_SUCCESS) {
+        if (buffer->batchUnsupported) {
+            ret = HdfDevEventDispatchLocked(thread, adapter, bwr.cmdCode, buffer->data, bwr.readConsumed);
         } else {
-            HDF_LOGE("%s:ioctl failed, errno=%d", __func__, ret);
+            ret = HdfDevEventDispatchBatchLocked(thread, adapter, &bwr);
         }
-
-        goto FINISH;
+    } else if (ret == -HDF_DEV_ERR_NODATA) {
+        ret = HDF_SUCCESS;
     }
 
-    ret = HdfDevEventDispatchLocked(thread, adapter, &bwr);
-
-FINISH:
-    OsalMemFree((void *)(uintptr_t)bwr.readBuffer);
     OsalMutexUnlock(&thread->mutex);
     return ret;
 }
@@ -215,15 +357,132 @@ static int32_t AssignPfds(struct HdfDevListenerThread *thread, struct pollfd **p
 }
 
 #define POLL_WAIT_TIME_MS 100
+
+#ifdef HDF_EVENT_LISTENER_EPOLL
+static bool HdfListenThreadHasPollFdLocked(const struct HdfDevListenerThread *thread)
+{
+    for (uint16_t i = 0; i < thread->pfdSize; i++) {
+        if (thread->pfds[i].fd != SYSCALL_INVALID_FD) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void HdfListenThreadEpollInit(struct HdfDevListenerThread *thread)
+{
+    thread->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    thread->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    struct epoll_event event = {
+        .events = EPOLLIN,
+        .data.fd = thread->wakeFd,
+    };
+    if (thread->epollFd < 0 || thread->wakeFd < 0 ||
+        epoll_ctl(thread->epollFd, EPOLL_CTL_ADD, thread->wakeFd, &event) != 0) {
+        HDF_LOGI("%s: epoll unavailable, use poll, errno=%d", __func__, errno);
+        if (thread->epollFd >= 0) {
+            close(thread->epollFd);
+        }
+        if (thread->wakeFd >= 0) {
+            close(thread->wakeFd);
+        }
+        thread->epollFd = SYSCALL_INVALID_FD;
+        thread->wakeFd = SYSCALL_INVALID_FD;
+    }
+}
+
+static void HdfListenThreadEpollDeinit(struct HdfDevListenerThread *thread)
+{
+    if (thread->epollFd >= 0) {
+        close(thread->epollFd);
+        close(thread->wakeFd);
+        thread->epollFd = SYSCALL_INVALID_FD;
+        thread->wakeFd = SYSCALL_INVALID_FD;
+    }
+}
+
+static int32_t HdfListenThreadEpollAdd(struct HdfDevListenerThread *thread, int fd)
+{
+    struct epoll_event event = {
+        .events = EPOLLIN,
+        .data.fd = fd,
+    };
+    if (thread->epollFd < 0 || epoll_ctl(thread->epollFd, EPOLL_CTL_ADD, fd, &event) == 0 || errno == EEXIST) {
+        return HDF_SUCCESS;
+    }
+    HDF_LOGE("%s: failed to add fd to epoll %d %{public}s", __func__, errno, strerror(errno));
+    return HDF_ERR_IO;
+}
+
+static void HdfListenThreadEpollDel(struct HdfDevListenerThread *thread, int fd)
+{
+    if (thread->epollFd >= 0) {
+        (void)epoll_ctl(thread->epollFd, EPOLL_CTL_DEL, fd, NULL);
+    }
+}
+
+static void HdfListenThreadEpollWakeup(const struct HdfDevListenerThread *thread)
+{
+    uint64_t value = 1;
+    if (write(thread->wakeFd, &value, sizeof(value)) != sizeof(value)) {
+        HDF_LOGE("%s: failed to wakeup listener thread %d", __func__, errno);
+    }
+}
+
+/* Waits on the epoll set and handles only the ready fds, returns false when the thread should exit. */
+static bool HdfDevEventEpollDispatch(struct HdfDevListenerThread *thread, struct HdfDevEventReadBuffer *buffer)
+{
+    struct epoll_event events[EPOLL_MAX_EVENT_SIZE];
+    int32_t readyCount = epoll_wait(thread->epollFd, events, EPOLL_MAX_EVENT_SIZE, -1);
+    if (readyCount < 0) {
+        if (errno != EINTR) {
+            HDF_LOGE("%s: epoll fail (%d)%s", __func__, errno, strerror(errno));
+            OsalMSleep(POLL_WAIT_TIME_MS);
+        }
+        return true;
+    }
+
+    for (int32_t i = 0; i < readyCount; i++) {
+        uint32_t revents = events[i].events;
+        int32_t fd = events[i].data.fd;
+        if (fd == thread->wakeFd) {
+            uint64_t value = 0;
+            (void)read(thread->wakeFd, &value, sizeof(value));
+            OsalMutexLock(&thread->mutex);
+            bool hasFd = HdfListenThreadHasPollFdLocked(thread);
+            OsalMutexUnlock(&thread->mutex);
+            if (!hasFd) {
+                return false;
+            }
+        } else if ((revents & EPOLLIN) && HdfDevEventReadAndDispatch(thread, fd, buffer) != HDF_SUCCESS) {
+            return false;
+        } else if (revents & EPOLLHUP) {
+            HDF_LOGI("event listener task received exit event");
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 static int32_t HdfDevEventListenTask(void *para)
 {
     struct HdfDevListenerThread *thread = (struct HdfDevListenerThread *)para;
     struct pollfd *pfds = NULL;
     uint16_t pfdSize = 0;
     int32_t pollCount = 0;
+    struct HdfDevEventReadBuffer readBuffer = {0};
 
     thread->status = LISTENER_RUNNING;
     while (!thread->shouldStop) {
+#ifdef HDF_EVENT_LISTENER_EPOLL
+        if (thread->epollFd >= 0) {
+            if (!HdfDevEventEpollDispatch(thread, &readBuffer)) {
+                goto EXIT;
+            }
+            continue;
+        }
+#endif
         if (thread->pollChanged) {
             pollCount = AssignPfds(thread, &pfds, &pfdSize);
         }
@@ -241,7 +500,7 @@ static int32_t HdfDevEventListenTask(void *para)
                 continue;
             }
             if ((((uint32_t)pfds[i].revents) & POLLIN) &&
-                HdfDevEventReadAndDispatch(thread, pfds[i].fd) != HDF_SUCCESS) {
+                HdfDevEventReadAndDispatch(thread, pfds[i].fd, &readBuffer) != HDF_SUCCESS) {
                 goto EXIT;
             } else if (((uint32_t)pfds[i].revents) & POLLHUP) {
                 HDF_LOGI("event listener task received exit event");
@@ -255,13 +514,22 @@ static int32_t HdfDevEventListenTask(void *para)
 EXIT:
     HDF_LOGI("event listener task exit");
 
-    thread->status = LISTENER_EXITED;
     OsalMemFree(pfds);
+    OsalMemFree(readBuffer.data);
+
+    // an async stopper sets shouldStop and wakes the thread under the mutex, after that the thread owns itself
+    OsalMutexLock(&thread->mutex);
+    bool shouldFree = thread->shouldStop;
+    thread->status = LISTENER_EXITED;
+    OsalMutexUnlock(&thread->mutex);
 
-    if (thread->shouldStop) {
+    if (shouldFree) {
         /* Exit due to async call and free the thread struct. */
         OsalMutexDestroy(&thread->mutex);
         OsalThreadDestroy(&thread->thread);
+#ifdef HDF_EVENT_LISTENER_EPOLL
+        HdfListenThreadEpollDeinit(thread);
+#endif
         OsalMemFree(thread->pfds);
         OsalMemFree(thread);
     }
@@ -317,6 +585,12 @@ static int32_t HdfDevListenerThreadDoInit(struct HdfDevListenerThread *thread)
         return HDF_ERR_THREAD_CREATE_FAIL;
     }
 
+#ifdef HDF_EVENT_LISTENER_EPOLL
+    HdfListenThreadEpollInit(thread);
+#else
+    thread->epollFd = SYSCALL_INVALID_FD;
+    thread->wakeFd = SYSCALL_INVALID_FD;
+#endif
     thread->status = LISTENER_INITED;
     thread->shouldStop = false;
     thread->pollChanged = true;
@@ -389,6 +663,11 @@ static int32_t HdfAddAdapterToPfds(struct HdfDevListenerThread *thread, struct H
         return HDF_ERR_MALLOC_FAIL;
     }
 
+#ifdef HDF_EVENT_LISTENER_EPOLL
+    if (HdfListenThreadEpollAdd(thread, adapter->fd) != HDF_SUCCESS) {
+        return HDF_ERR_IO;
+    }
+#endif
     thread->pfds[index].fd = adapter->fd;
     thread->pfds[index].events = POLLIN;
     thread->pfds[index].revents = 0;
@@ -529,6 +808,17 @@ static int32_t HdfListenThreadPollAdd(struct HdfDevListenerThread *thread, struc
         thread->pfds[index].events = POLLIN;
         thread->pfds[index].revents = 0;
 
+#ifdef HDF_EVENT_LISTENER_EPOLL
+        if (thread->epollFd >= 0) {
+            /* the epoll set is updated in place, no need to wake the thread to rebuild its poll list */
+            headAdapter = NULL;
+            if (HdfListenThreadEpollAdd(thread, adapter->fd) != HDF_SUCCESS) {
+                thread->pfds[index].fd = SYSCALL_INVALID_FD;
+                ret = HDF_ERR_IO;
+                break;
+            }
+        }
+#endif
         if (headAdapter != NULL) {
             if (ioctl(headAdapter->fd, HDF_LISTEN_EVENT_WAKEUP, 0) != 0) {
                 HDF_LOGE("%s: failed to wakeup drv to add poll %d %{public}s", __func__, errno, strerror(errno));
@@ -570,9 +860,21 @@ static void HdfListenThreadPollDel(struct HdfDevListenerThread *thread, struct H
     }
 
     HdfAdapterStopListenIoctl(adapter->fd);
+#ifdef HDF_EVENT_LISTENER_EPOLL
+    if (thread->epollFd >= 0) {
+        HdfListenThreadEpollDel(thread, adapter->fd);
+        if (!HdfListenThreadHasPollFdLocked(thread)) {
+            /* let the thread exit as the poll backend does when its list runs empty */
+            HdfListenThreadEpollWakeup(thread);
+        }
+    } else if (ioctl(adapter->fd, HDF_LISTEN_EVENT_WAKEUP, 0) != 0) {
+        HDF_LOGE("%s: failed to wakeup drv to del poll %d %s", __func__, errno, strerror(errno));
+    }
+#else
     if (ioctl(adapter->fd, HDF_LISTEN_EVENT_WAKEUP, 0) != 0) {
         HDF_LOGE("%s: failed to wakeup drv to del poll %d %s", __func__, errno, strerror(errno));
     }
+#endif
     DListRemove(&adapter->listNode);
     adapter->group = NULL;
     thread->pollChanged = true;
@@ -581,12 +883,42 @@ static void HdfListenThreadPollDel(struct HdfDevListenerThread *thread, struct H
 
 static void HdfDevListenerThreadFree(struct HdfDevListenerThread *thread)
 {
+#ifdef HDF_EVENT_LISTENER_EPOLL
+    HdfListenThreadEpollDeinit(thread);
+#endif
     OsalMutexDestroy(&thread->mutex);
     OsalMemFree(thread->pfds);
     OsalThreadDestroy(&thread->thread);
     OsalMemFree(thread);
 }
 
+static bool HdfDevListenerThreadIsExited(struct HdfDevListenerThread *thread)
+{
+    OsalMutexLock(&thread->mutex);
+    bool exited = (thread->status == LISTENER_EXITED);
+    OsalMutexUnlock(&thread->mutex);
+    return exited;
+}
+
+/* Leaves the thread to free itself when it exits, or frees it here if it has already exited. */
+static void HdfDevListenerThreadStopAsync(struct HdfDevListenerThread *thread)
+{
+    OsalMutexLock(&thread->mutex);
+    if (thread->status == LISTENER_EXITED) {
+        OsalMutexUnlock(&thread->mutex);
+        HdfDevListenerThreadFree(thread);
+        return;
+    }
+    thread->shouldStop = true;
+#ifdef HDF_EVENT_LISTENER_EPOLL
+    if (thread->epollFd >= 0) {
+        // epoll_wait() blocks without timeout, no driver event would ever let the thread see shouldStop
+        HdfListenThreadEpollWakeup(thread);
+    }
+#endif
+    OsalMutexUnlock(&thread->mutex);
+}
+
 static void HdfDevListenerThreadDestroy(struct HdfDevListenerThread *thread)
 {
     if (thread == NULL) {
@@ -611,25 +943,25 @@ static void HdfDevListenerThreadDestroy(struct HdfDevListenerThread *thread)
             }
 
             if (stopCount == 0) {
-                thread->shouldStop = true;
                 HDF_LOGE("%s:failed to exit listener thread with ioctl, will go async way", __func__);
+                HdfDevListenerThreadStopAsync(thread);
                 return;
             }
-            while (thread->status != LISTENER_EXITED && count <= TIMEOUT_US) {
+            while (!HdfDevListenerThreadIsExited(thread) && count <= TIMEOUT_US) {
                 OsalUSleep(1);
                 count++;
             }
-            if (thread->status == LISTENER_EXITED) {
+            if (HdfDevListenerThreadIsExited(thread)) {
                 HDF_LOGI("poll thread exited");
                 HdfDevListenerThreadFree(thread);
             } else {
-                thread->shouldStop = true;
                 HDF_LOGE("wait poll thread exit timeout, async exit");
+                HdfDevListenerThreadStopAsync(thread);
             }
             return;
         }
         case LISTENER_STARTED:
-            thread->shouldStop = true;
+            HdfDevListenerThreadStopAsync(thread);
             break;
         case LISTENER_EXITED: // fall-through
         case LISTENER_INITED:
@@ -657,8 +989,13 @@ static int32_t HdfSyscallAdapterDispatch(
         wrBuf.readSize = 0;
     }
     if (data != NULL) {
+        // segments written by reference are gathered into the sbuf here, right before entering the kernel
         wrBuf.writeBuffer = (uintptr_t)HdfSbufGetData(data);
         wrBuf.writeSize = HdfSbufGetDataSize(data);
+        if (wrBuf.writeBuffer == 0 && wrBuf.writeSize != 0) {
+            HDF_LOGE("Failed to flatten dispatch data");
+            return HDF_ERR_MALLOC_FAIL;
+        }
     } else {
         wrBuf.writeBuffer = 0;
         wrBuf.writeSize = 0;
@@ -763,6 +1100,14 @@ void HdfIoServiceAdapterRecycle(struct HdfIoService *service)
     if (adapter != NULL) {
         HdfDevListenerThreadDestroy(adapter->thread);
         adapter->thread = NULL;
+        if (adapter->eventRing != NULL) {
+            (void)munmap(adapter->eventRing, EVENT_RING_MAP_SIZE);
+            adapter->eventRing = NULL;
+        }
+        if (adapter->sharedBuf != NULL) {
+            (void)munmap(adapter->sharedBuf, adapter->sharedBufSize);
+            adapter->sharedBuf = NULL;
+        }
         if (adapter->fd >= 0) {
             close(adapter->fd);
             adapter->fd = -1;
@@ -808,7 +1153,63 @@ static bool AddListenerToAdapterLocked(struct HdfSyscallAdapter *adapter, struct
     return true;
 }
 
+static void HdfIoServiceMapEventRingLocked(struct HdfSyscallAdapter *adapter)
+{
+    if (adapter->eventRing != NULL) {
+        return;
+    }
+
+    void *addr = mmap(NULL, EVENT_RING_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, adapter->fd, 0);
+    if (addr == MAP_FAILED) {
+        HDF_LOGI("%s: event ring not supported, errno=%d", __func__, errno);
+        return;
+    }
+
+    struct HdfDevEventRing *ring = (struct HdfDevEventRing *)addr;
+    if (ring->magic != HDF_DEV_EVENT_RING_MAGIC || ring->size == 0 || (ring->size & (ring->size - 1)) != 0 ||
+        ring->size > EVENT_RING_MAP_SIZE - HDF_DEV_EVENT_RING_HEADER_SIZE) {
+        HDF_LOGE("%s: invalid event ring", __func__);
+        (void)munmap(addr, EVENT_RING_MAP_SIZE);
+        return;
+    }
+    adapter->eventRingSize = ring->size;
+    __atomic_store_n(&adapter->eventRing, ring, __ATOMIC_RELEASE);
+}
+
+void *HdfIoServiceMapSharedBuffer(struct HdfIoService *service, uint32_t size)
+{
+    if (service == NULL || size == 0 || size > HDF_IO_SHARED_BUF_MAX_SIZE) {
+        return NULL;
+    }
+
+    struct HdfSyscallAdapter *adapter = CONTAINER_OF(service, struct HdfSyscallAdapter, super);
+    void *buf = NULL;
+
+    OsalMutexLock(&adapter->mutex);
+    if (adapter->sharedBuf != NULL) {
+        buf = (size <= adapter->sharedBufSize) ? adapter->sharedBuf : NULL;
+        OsalMutexUnlock(&adapter->mutex);
+        return buf;
+    }
+    buf = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, adapter->fd, HDF_IO_SHARED_BUF_OFFSET);
+    if (buf == MAP_FAILED) {
+        HDF_LOGI("%s: shared buffer not supported, errno=%d", __func__, errno);
+        OsalMutexUnlock(&adapter->mutex);
+        return NULL;
+    }
+    adapter->sharedBufSize = size;
+    adapter->sharedBuf = buf;
+    OsalMutexUnlock(&adapter->mutex);
+    return buf;
+}
+
 int32_t HdfDeviceRegisterEventListener(struct HdfIoService *target, struct HdfDevEventlistener *listener)
+{
+    return HdfDeviceRegisterEventListenerWithFlags(target, listener, 0);
+}
+
+int32_t HdfDeviceRegisterEventListenerWithFlags(
+    struct HdfIoService *target, struct HdfDevEventlistener *listener, uint32_t flags)
 {
     if (target == NULL || listener == NULL) {
         return HDF_ERR_INVALID_PARAM;
@@ -828,6 +1229,10 @@ int32_t HdfDeviceRegisterEventListener(struct HdfIoService *target, struct HdfDe
         return HDF_ERR_INVALID_PARAM;
     }
 
+    if ((flags & HDF_EVENT_LISTENER_SHARED_RING) != 0) {
+        HdfIoServiceMapEventRingLocked(adapter);
+    }
+
     if (adapter->group != NULL) {
         /* Do not bind any service in a service goup to its own thread or start the group thread. */
         ret = HdfIoServiceGroupThreadStart(adapter->group);
@@ -7,6 +7,7 @@
  */
 
 #include "hdf_vnode_adapter.h"
+#include <osal_atomic.h>
 #include <osal_cdev.h>
 #include <osal_mem.h>
 #include <osal_sem.h>
@@ -21,6 +22,7 @@
 #define VOID_DATA_SIZE 4
 #define EVENT_QUEUE_MAX 100
 #define MAX_RW_SIZE (1024 * 1204) // 1M
+#define EVENT_RING_MAX_SIZE (1024 * 1024)
 
 enum HdfVNodeClientStatus {
     VNODE_CLIENT_RUNNING,
@@ -40,6 +42,14 @@ struct HdfVNodeAdapterClient {
     int32_t eventQueueSize;
     int32_t wakeup;
     uint32_t status;
+    struct HdfDevEventRing *ring; /* shared with user space, NULL unless mapped */
+    size_t ringMapSize;
+    uint32_t ringSize;            /* kernel copy of ring->size, user space may scribble on the header */
+    uint32_t ringTail;            /* kernel copy of ring->tail */
+    uint32_t ringDropped;         /* ring->dropped when the ring last overflowed */
+    bool ringFull;
+    void *sharedBuf;              /* data shared with user space, NULL unless mapped */
+    uint32_t sharedBufSize;
 };
 
 struct HdfIoServiceKClient {
@@ -160,8 +170,19 @@ static struct HdfSBuf *HdfSbufCopyFromUser(uintptr_t data, size_t size)
     return sbuf;
 }
 
-static int HdfSbufCopyToUser(const struct HdfSBuf *sbuf, void *dstUser, size_t dstUserSize)
+static int32_t HdfSbufSegmentCopyToUser(void *priv, const uint8_t *data, size_t size)
 {
+    uint8_t **dstUser = (uint8_t **)priv;
+    if (CopyToUser(*dstUser, data, size) != 0) {
+        return HDF_ERR_IO;
+    }
+    *dstUser += size;
+    return HDF_SUCCESS;
+}
+
+static int HdfSbufCopyToUser(struct HdfSBuf *sbuf, void *dstUser, size_t dstUserSize)
+{
+    uint8_t *dstPos = (uint8_t *)dstUser;
     size_t sbufSize = HdfSbufGetDataSize(sbuf);
     if (sbufSize == 0) {
         return HDF_SUCCESS;
@@ -171,7 +192,8 @@ static int HdfSbufCopyToUser(const struct HdfSBuf *sbuf, void *dstUser, size_t d
         return HDF_DEV_ERR_NORANGE;
     }
 
-    if (CopyToUser(dstUser, HdfSbufGetData(sbuf), sbufSize) != 0) {
+    // gather segments written by reference straight into user memory instead of flattening them first
+    if (HdfSbufForEachSegment(sbuf, HdfSbufSegmentCopyToUser, &dstPos) != HDF_SUCCESS) {
         HDF_LOGE("%s: failed to copy buff data", __func__);
         return HDF_ERR_IO;
     }
@@ -301,6 +323,91 @@ static int HdfVNodeAdapterReadDevEvent(struct HdfVNodeAdapterClient *client, uns
     return ret;
 }
 
+#define DEV_EVENT_ALIGN_SIZE(size) (((size) + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1))
+
+static int HdfDevEventCopyToUserLocked(struct HdfDevEvent *event, uint8_t *dstUser, size_t eventSize)
+{
+    struct HdfDevEventHeader header = {
+        .cmdCode = (int32_t)event->id,
+        .size = (uint32_t)eventSize,
+    };
+
+    if (CopyToUser(dstUser, &header, sizeof(header)) != 0) {
+        return HDF_ERR_IO;
+    }
+    return HdfSbufCopyToUser(event->data, dstUser + sizeof(header), eventSize);
+}
+
+/* Drain as many queued events as fit in the user buffer with one call, in queue order. */
+static int HdfVNodeAdapterReadDevEvents(struct HdfVNodeAdapterClient *client, unsigned long arg)
+{
+    struct HdfWriteReadBuf bwr;
+    struct HdfWriteReadBuf *bwrUser = (struct HdfWriteReadBuf *)((uintptr_t)arg);
+    struct HdfDevEvent *event = NULL;
+    struct HdfDevEvent *eventTemp = NULL;
+    uint8_t *dstUser = NULL;
+    size_t pos = 0;
+    int32_t count = 0;
+    int ret = HDF_SUCCESS;
+
+    if (bwrUser == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (CopyFromUser(&bwr, (void*)bwrUser, sizeof(bwr)) != 0) {
+        HDF_LOGE("Copy from user failed");
+        return HDF_FAILURE;
+    }
+    if (bwr.readSize > MAX_RW_SIZE) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    dstUser = (uint8_t *)(uintptr_t)bwr.readBuffer;
+
+    OsalMutexLock(&client->mutex);
+    if (DListIsEmpty(&client->eventQueue)) {
+        OsalMutexUnlock(&client->mutex);
+        return HDF_DEV_ERR_NODATA;
+    }
+
+    DLIST_FOR_EACH_ENTRY(event, &client->eventQueue, struct HdfDevEvent, listNode) {
+        size_t eventSize = HdfSbufGetDataSize(event->data);
+        size_t recordSize = sizeof(struct HdfDevEventHeader) + DEV_EVENT_ALIGN_SIZE(eventSize);
+        if (recordSize > bwr.readSize - pos) {
+            if (count == 0) {
+                bwr.readSize = recordSize;
+                ret = HDF_DEV_ERR_NORANGE;
+            }
+            break;
+        }
+        if (HdfDevEventCopyToUserLocked(event, dstUser + pos, eventSize) != HDF_SUCCESS) {
+            OsalMutexUnlock(&client->mutex);
+            return HDF_ERR_IO;
+        }
+        pos += recordSize;
+        count++;
+    }
+    bwr.readConsumed = pos;
+    bwr.cmdCode = count;
+
+    if (CopyToUser(bwrUser, &bwr, sizeof(struct HdfWriteReadBuf)) != 0) {
+        HDF_LOGE("%s: failed to copy bwr", __func__);
+        ret = HDF_ERR_IO;
+    }
+    // events leave the queue only once user space has been told about them
+    if (ret == HDF_SUCCESS) {
+        DLIST_FOR_EACH_ENTRY_SAFE(event, eventTemp, &client->eventQueue, struct HdfDevEvent, listNode) {
+            if (count-- == 0) {
+                break;
+            }
+            DListRemove(&event->listNode);
+            DevEventFree(event);
+            client->eventQueueSize--;
+        }
+    }
+
+    OsalMutexUnlock(&client->mutex);
+    return ret;
+}
+
 static void HdfVnodeAdapterDropOldEventLocked(struct HdfVNodeAdapterClient *client)
 {
     struct HdfDevEvent *dropEvent = CONTAINER_OF(client->eventQueue.next, struct HdfDevEvent, listNode);
@@ -311,6 +418,171 @@ static void HdfVnodeAdapterDropOldEventLocked(struct HdfVNodeAdapterClient *clie
     client->eventQueueSize--;
 }
 
+#define DEV_EVENT_RING_ALIGN_SIZE(size) \
+    (((size) + HDF_DEV_EVENT_RING_ALIGN - 1) & ~((size_t)HDF_DEV_EVENT_RING_ALIGN - 1))
+
+// head, tail and dropped of the shared ring header are used as OsalAtomic counters
+#define DEV_EVENT_RING_COUNTER(ring, field) ((OsalAtomic *)&(ring)->field)
+
+static bool VNodeAdapterRingIsEmptyLocked(const struct HdfVNodeAdapterClient *client)
+{
+    return (uint32_t)OsalAtomicReadAcquire(DEV_EVENT_RING_COUNTER(client->ring, head)) == client->ringTail;
+}
+
+static void VNodeAdapterRingDropLocked(struct HdfVNodeAdapterClient *client)
+{
+    OsalAtomicInc(DEV_EVENT_RING_COUNTER(client->ring, dropped));
+    if (!client->ringFull) {
+        // logged once per overflow, the dropped counter keeps the exact number
+        client->ringFull = true;
+        client->ringDropped = (uint32_t)OsalAtomicRead(DEV_EVENT_RING_COUNTER(client->ring, dropped)) - 1;
+        HDF_LOGE("dev event ring full, drop new events");
+    }
+}
+
+static void VNodeAdapterRingResumeLocked(struct HdfVNodeAdapterClient *client)
+{
+    if (client->ringFull) {
+        client->ringFull = false;
+        HDF_LOGW("dev event ring resumed, %u events dropped",
+            (uint32_t)OsalAtomicRead(DEV_EVENT_RING_COUNTER(client->ring, dropped)) - client->ringDropped);
+    }
+}
+
+static int VNodeAdapterRingPutLocked(struct HdfVNodeAdapterClient *client, uint32_t id, const struct HdfSBuf *data)
+{
+    struct HdfDevEventRing *ring = client->ring;
+    uint8_t *records = (uint8_t *)ring + HDF_DEV_EVENT_RING_HEADER_SIZE;
+    size_t dataSize = HdfSbufGetDataSize(data);
+    size_t recordSize = DEV_EVENT_RING_ALIGN_SIZE(sizeof(struct HdfDevEventHeader) + dataSize);
+    uint32_t head = (uint32_t)OsalAtomicReadAcquire(DEV_EVENT_RING_COUNTER(ring, head));
+    uint32_t tail = client->ringTail;
+    uint32_t used = tail - head;
+    size_t offset = tail & (client->ringSize - 1);
+    size_t contiguous = client->ringSize - offset;
+    size_t need = recordSize + ((contiguous < recordSize) ? contiguous : 0);
+    struct HdfDevEventHeader header;
+    const uint8_t *payload = NULL;
+
+    if (used > client->ringSize || need > client->ringSize - used) {
+        VNodeAdapterRingDropLocked(client);
+        return HDF_DEV_ERR_NORANGE;
+    }
+    payload = HdfSbufGetData(data);
+    if (payload == NULL && dataSize > 0) {
+        return HDF_DEV_ERR_NO_MEMORY;
+    }
+
+    if (contiguous < recordSize) {
+        header.cmdCode = 0;
+        header.size = HDF_DEV_EVENT_RING_PAD;
+        (void)memcpy_s(records + offset, contiguous, &header, sizeof(header));
+        tail += (uint32_t)contiguous;
+        offset = 0;
+    }
+    header.cmdCode = (int32_t)id;
+    header.size = (uint32_t)dataSize;
+    (void)memcpy_s(records + offset, recordSize, &header, sizeof(header));
+    if (dataSize > 0) {
+        (void)memcpy_s(records + offset + sizeof(header), recordSize - sizeof(header), payload, dataSize);
+    }
+
+    client->ringTail = tail + (uint32_t)recordSize;
+    OsalAtomicSetRelease(DEV_EVENT_RING_COUNTER(ring, tail), (int32_t)client->ringTail);
+    VNodeAdapterRingResumeLocked(client);
+    return HDF_SUCCESS;
+}
+
+static void *VNodeAdapterMapSharedBuf(struct HdfVNodeAdapterClient *client, size_t size)
+{
+    void *buf = NULL;
+
+    if (size == 0 || size > HDF_IO_SHARED_BUF_MAX_SIZE) {
+        return NULL;
+    }
+
+    OsalMutexLock(&client->mutex);
+    if (client->sharedBuf != NULL) {
+        // mapped again after munmap, or into a second address, always the same memory
+        buf = (client->sharedBufSize == size) ? client->sharedBuf : NULL;
+        OsalMutexUnlock(&client->mutex);
+        return buf;
+    }
+    buf = OsalCdevAllocShared(size);
+    if (buf != NULL) {
+        client->sharedBufSize = (uint32_t)size;
+        client->sharedBuf = buf;
+    }
+    OsalMutexUnlock(&client->mutex);
+    return buf;
+}
+
+static void *VNodeAdapterMapEventRing(struct HdfVNodeAdapterClient *client, size_t size)
+{
+    struct HdfDevEvent *event = NULL;
+    struct HdfDevEvent *eventTemp = NULL;
+    struct HdfDevEventRing *ring = NULL;
+    uint32_t ringSize = HDF_DEV_EVENT_RING_ALIGN;
+
+    if (size < HDF_DEV_EVENT_RING_HEADER_SIZE + HDF_DEV_EVENT_RING_ALIGN || size > EVENT_RING_MAX_SIZE) {
+        return NULL;
+    }
+    // positions wrap at 2^32, so the ring takes the largest power of two that fits behind the header
+    while (ringSize <= (size - HDF_DEV_EVENT_RING_HEADER_SIZE) / 2) {
+        ringSize <<= 1;
+    }
+
+    OsalMutexLock(&client->mutex);
+    if (client->ring != NULL) {
+        ring = (client->ringMapSize == size) ? client->ring : NULL;
+        OsalMutexUnlock(&client->mutex);
+        return ring;
+    }
+    ring = OsalCdevAllocShared(size);
+    if (ring == NULL) {
+        OsalMutexUnlock(&client->mutex);
+        return NULL;
+    }
+    client->ringMapSize = size;
+    client->ringSize = ringSize;
+    client->ringTail = 0;
+    client->ringFull = false;
+    ring->magic = HDF_DEV_EVENT_RING_MAGIC;
+    ring->size = ringSize;
+    OsalAtomicSet(DEV_EVENT_RING_COUNTER(ring, head), 0);
+    OsalAtomicSet(DEV_EVENT_RING_COUNTER(ring, tail), 0);
+    OsalAtomicSet(DEV_EVENT_RING_COUNTER(ring, dropped), 0);
+    client->ring = ring;
+
+    // events queued before the ring existed go first, so that listeners see them in order
+    DLIST_FOR_EACH_ENTRY_SAFE(event, eventTemp, &client->eventQueue, struct HdfDevEvent, listNode) {
+        if (VNodeAdapterRingPutLocked(client, event->id, event->data) != HDF_SUCCESS) {
+            break;
+        }
+        DListRemove(&event->listNode);
+        DevEventFree(event);
+        client->eventQueueSize--;
+    }
+    OsalMutexUnlock(&client->mutex);
+    return ring;
+}
+
+static void *HdfVNodeAdapterMmap(struct file *filep, uint64_t offset, size_t size)
+{
+    struct HdfVNodeAdapterClient *client = (struct HdfVNodeAdapterClient *)OsalGetFilePriv(filep);
+
+    if (client == NULL) {
+        return NULL;
+    }
+    if (offset == 0) {
+        return VNodeAdapterMapEventRing(client, size);
+    }
+    if (offset == HDF_IO_SHARED_BUF_OFFSET) {
+        return VNodeAdapterMapSharedBuf(client, size);
+    }
+    return NULL;
+}
+
 static int VNodeAdapterSendDevEventToClient(struct HdfVNodeAdapterClient *vnodeClient,
     uint32_t id, const struct HdfSBuf *data)
 {
@@ -321,6 +593,13 @@ static int VNodeAdapterSendDevEventToClient(struct HdfVNodeAdapterClient *vnodeC
         OsalMutexUnlock(&vnodeClient->mutex);
         return HDF_SUCCESS;
     }
+    if (vnodeClient->ring != NULL) {
+        (void)VNodeAdapterRingPutLocked(vnodeClient, id, data);
+        // poll is only the doorbell here, listeners take the data from the ring
+        wake_up_interruptible(&vnodeClient->pollWait);
+        OsalMutexUnlock(&vnodeClient->mutex);
+        return HDF_SUCCESS;
+    }
     if (vnodeClient->eventQueueSize >= EVENT_QUEUE_MAX) {
         HdfVnodeAdapterDropOldEventLocked(vnodeClient);
     }
@@ -426,6 +705,8 @@ static long HdfVNodeAdapterIoctl(struct file *filep,  unsigned int cmd, unsigned
             return HdfVNodeAdapterServCall(client, arg);
         case HDF_READ_DEV_EVENT:
             return HdfVNodeAdapterReadDevEvent(client, arg);
+        case HDF_READ_DEV_EVENTS:
+            return HdfVNodeAdapterReadDevEvents(client, arg);
         case HDF_LISTEN_EVENT_START:
             HdfVNodeAdapterClientStartListening(client);
             break;
@@ -439,7 +720,7 @@ static long HdfVNodeAdapterIoctl(struct file *filep,  unsigned int cmd, unsigned
             HdfVNodeAdapterClientExitListening(client);
             break;
         default:
-            return HDF_FAILURE;
+            return HDF_ERR_NOT_SUPPORT;
     }
 
     return HDF_SUCCESS;
@@ -492,6 +773,14 @@ static void HdfDestoryVNodeAdapterClient(struct HdfVNodeAdapterClient *client)
     }
     OsalMutexUnlock(&client->mutex);
     OsalMutexDestroy(&client->mutex);
+    if (client->ring != NULL) {
+        OsalCdevFreeShared(client->ring);
+        client->ring = NULL;
+    }
+    if (client->sharedBuf != NULL) {
+        OsalCdevFreeShared(client->sharedBuf);
+        client->sharedBuf = NULL;
+    }
     OsalMemFree(client);
 }
 
@@ -536,6 +825,8 @@ static unsigned int HdfVNodeAdapterPoll(struct file *filep, poll_table *wait)
         mask |= POLLHUP;
     } else if (!DListIsEmpty(&client->eventQueue)) {
         mask |= POLLIN;
+    } else if (client->ring != NULL && !VNodeAdapterRingIsEmptyLocked(client)) {
+        mask |= POLLIN;
     } else if (client->wakeup > 0) {
         mask |= POLLIN;
         client->wakeup--;
@@ -596,6 +887,7 @@ struct HdfIoService *HdfIoServiceAdapterPublish(const char *serviceName, uint32_
         .release = HdfVNodeAdapterClose,
         .ioctl = HdfVNodeAdapterIoctl,
         .poll = HdfVNodeAdapterPoll,
+        .mmap = HdfVNodeAdapterMmap,
     };
 
     if ((serviceName == NULL) || (mode > MAX_MODE_SIZE)) {
@@ -672,3 +964,20 @@ int32_t HdfDeviceSendEventToClient(const struct HdfDeviceIoClient *client, uint3
 
     return HdfVNodeAdapterSendDevEvent(vnodeClient->adapter, vnodeClient, id, data);
 }
+
+void *HdfDeviceGetClientSharedBuf(const struct HdfDeviceIoClient *client, uint32_t *size)
+{
+    void *buf = NULL;
+    struct HdfVNodeAdapterClient *vnodeClient = NULL;
+
+    if (client == NULL || client->device == NULL || size == NULL) {
+        return NULL;
+    }
+
+    vnodeClient = CONTAINER_OF(client, struct HdfVNodeAdapterClient, ioServiceClient);
+    OsalMutexLock(&vnodeClient->mutex);
+    buf = vnodeClient->sharedBuf;
+    *size = (buf == NULL) ? 0 : vnodeClient->sharedBufSize;
+    OsalMutexUnlock(&vnodeClient->mutex);
+    return buf;
+}
@@ -11,11 +11,13 @@
 #include "hcs_tree_if.h"
 #include "hdf_host_info.h"
 #include "hdf_log.h"
+#include "osal_mem.h"
 #ifdef LOSCFG_DRIVERS_HDF_USB_PNP_NOTIFY
 #include "usb_pnp_manager.h"
 #endif
 
 #define ATTR_HOST_NAME "hostName"
+#define ATTR_HOST_LAUNCH_WORKERS "launchWorkers"
 #define ATTR_DEV_POLICY "policy"
 #define ATTR_DEV_PRIORITY "priority"
 #define ATTR_DEV_PRELOAD "preload"
@@ -23,6 +25,7 @@
 #define ATTR_DEV_MODULENAME "moduleName"
 #define ATTR_DEV_SVCNAME "serviceName"
 #define ATTR_DEV_MATCHATTR "deviceMatchAttr"
+#define ATTR_DEV_DEPENDS "depends"
 #define MANAGER_NODE_MATCH_ATTR "hdf_manager"
 
 #define DEFATLT_DEV_PRIORITY 100
@@ -156,6 +159,36 @@ static bool CheckDeviceInfo(const struct HdfDeviceInfo *deviceNodeInfo)
     return (strcmp(deviceNodeInfo->moduleName, "") != 0);
 }
 
+static bool GetDeviceNodeDepends(const struct DeviceResourceNode *deviceNode, struct HdfDeviceInfo *deviceNodeInfo)
+{
+    int32_t num;
+    int32_t i;
+    const char **depends = NULL;
+
+    num = HcsGetElemNum(deviceNode, ATTR_DEV_DEPENDS);
+    if (num <= 0) {
+        return true;
+    }
+    if (num > UINT16_MAX) {
+        HDF_LOGE("%s: %s has too many depends", __func__, deviceNodeInfo->svcName);
+        return false;
+    }
+    depends = (const char **)OsalMemCalloc(sizeof(*depends) * num);
+    if (depends == NULL) {
+        return false;
+    }
+    for (i = 0; i < num; i++) {
+        if (HcsGetStringArrayElem(deviceNode, ATTR_DEV_DEPENDS, i, &depends[i], NULL) != HDF_SUCCESS) {
+            HDF_LOGE("%s: depends of %s should be service names", __func__, deviceNodeInfo->svcName);
+            OsalMemFree(depends);
+            return false;
+        }
+    }
+    deviceNodeInfo->depends = depends;
+    deviceNodeInfo->dependNum = (uint16_t)num;
+    return true;
+}
+
 static bool GetDeviceNodeInfo(const struct DeviceResourceNode *deviceNode, struct HdfDeviceInfo *deviceNodeInfo)
 {
     HcsGetUint16(deviceNode, ATTR_DEV_POLICY, &deviceNodeInfo->policy, 0);
@@ -174,6 +207,10 @@ static bool GetDeviceNodeInfo(const struct DeviceResourceNode *deviceNode, struc
         return false;
     }
 
+    if (!GetDeviceNodeDepends(deviceNode, deviceNodeInfo)) {
+        return false;
+    }
+
     return CheckDeviceInfo(deviceNodeInfo);
 }
 
@@ -212,6 +249,17 @@ static bool GetDevcieNodeList(const struct DeviceResourceNode *device,
     return deviceNodeIdx > 1;
 }
 
+uint16_t HdfAttributeManagerGetHostLaunchWorkers(const char *hostName)
+{
+    uint16_t launchWorkers = 1;
+    const struct DeviceResourceNode *hostNode = GetHostNode(hostName);
+
+    if (hostNode != NULL) {
+        HcsGetUint16(hostNode, ATTR_HOST_LAUNCH_WORKERS, &launchWorkers, 1);
+    }
+    return (launchWorkers == 0) ? 1 : launchWorkers;
+}
+
 int HdfAttributeManagerGetDeviceList(struct DevHostServiceClnt *hostClnt)
 {
     uint16_t deviceIdx = 1;
@@ -227,6 +275,13 @@ int HdfAttributeManagerGetDeviceList(struct DevHostServiceClnt *hostClnt)
     if (hostNode == NULL) {
         return ret;
     }
+#ifndef __USER__
+    HcsGetUint16(hostNode, ATTR_HOST_LAUNCH_WORKERS, &hostClnt->launchWorkers, 1);
+#else
+    // AddDevice of a user space host is a synchronous message served by its single looper,
+    // so more launch workers would only add devmgr threads waiting on it
+    hostClnt->launchWorkers = 1;
+#endif
 
     for (device = hostNode->child; device != NULL; device = device->sibling, deviceIdx++) {
         if (!GetDevcieNodeList(device, hostClnt, deviceIdx)) {
@@ -225,4 +225,9 @@ int HdfAttributeManagerGetDeviceList(struct DevHostServiceClnt *hostClnt)
     }
     AttributeManagerFreeHost(host);
     return HDF_SUCCESS;
-}
\ No newline at end of file
+}
+uint16_t HdfAttributeManagerGetHostLaunchWorkers(const char *hostName)
+{
+    (void)hostName;
+    return 1; // no launchWorkers in the macro config, drivers are launched one by one
+}
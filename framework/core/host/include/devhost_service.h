@@ -20,6 +20,8 @@ struct DevHostService {
     uint16_t hostId;
     const char *hostName;
     struct DListHead devices;
+    struct OsalMutex devMutex;      // guards devices, drivers of a host may be added concurrently
+    uint16_t pmWorkers;             // threads changing the power state of devices, 1 changes it one by one
     struct HdfServiceObserver observer;
     struct HdfSysEventNotifyNode sysEventNotifyNode;
 };
@@ -42,6 +42,7 @@ struct HdfDeviceNode {
     devid_t devId;
     uint16_t policy;
     uint16_t permission;
+    uint32_t launchLevel;   // priority and depends depth it was launched at, power transitions follow it
     uint8_t devStatus;
     bool servStatus;
     char *interfaceDesc;
@@ -14,8 +14,10 @@
 #include "hdf_driver_loader.h"
 #include "hdf_log.h"
 #include "hdf_object_manager.h"
+#include "hdf_power_transition.h"
 #include "osal_mem.h"
 #include "power_state_token.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG devhost_service
 
@@ -45,19 +47,33 @@ static void DevHostServiceFreeDevice(struct DevHostService *hostService, struct
 
 static struct HdfDevice *DevHostServiceQueryOrAddDevice(struct DevHostService *inst, uint16_t deviceId)
 {
-    struct HdfDevice *device = DevHostServiceFindDevice(inst, deviceId);
+    struct HdfDevice *device = NULL;
+
+    (void)OsalMutexLock(&inst->devMutex);
+    device = DevHostServiceFindDevice(inst, deviceId);
     if (device == NULL) {
         device = HdfDeviceNewInstance();
         if (device == NULL) {
+            (void)OsalMutexUnlock(&inst->devMutex);
             HDF_LOGE("Dev host service failed to create driver instance");
             return NULL;
         }
         device->deviceId = MK_DEVID(inst->hostId, deviceId, 0);
         DListInsertHead(&device->node, &inst->devices);
     }
+    (void)OsalMutexUnlock(&inst->devMutex);
     return device;
 }
 
+static void DevHostServiceFreeIdleDevice(struct DevHostService *hostService, struct HdfDevice *device)
+{
+    (void)OsalMutexLock(&hostService->devMutex);
+    if (DListIsEmpty(&device->devNodes)) {
+        DevHostServiceFreeDevice(hostService, device);
+    }
+    (void)OsalMutexUnlock(&hostService->devMutex);
+}
+
 int DevHostServiceAddDevice(struct IDevHostService *inst, const struct HdfDeviceInfo *deviceInfo)
 {
     int ret = HDF_FAILURE;
@@ -104,10 +120,7 @@ int DevHostServiceAddDevice(struct IDevHostService *inst, const struct HdfDevice
     return HDF_SUCCESS;
 
 ERROR:
-    if (DListIsEmpty(&device->devNodes)) {
-        DevHostServiceFreeDevice(hostService, device);
-    }
-
+    DevHostServiceFreeIdleDevice(hostService, device);
     return ret;
 }
 
@@ -117,7 +130,9 @@ int DevHostServiceDelDevice(struct IDevHostService *inst, devid_t devId)
     struct DevHostService *hostService = (struct DevHostService *)inst;
     struct HdfDeviceNode *devNode = NULL;
 
+    (void)OsalMutexLock(&hostService->devMutex);
     device = DevHostServiceFindDevice(hostService, DEVICEID(devId));
+    (void)OsalMutexUnlock(&hostService->devMutex);
     if (device == NULL) {
         HDF_LOGW("failed to del device, device is not exist");
         return HDF_SUCCESS;
@@ -140,9 +155,7 @@ int DevHostServiceDelDevice(struct IDevHostService *inst, devid_t devId)
     }
     HdfDeviceNodeFreeInstance(devNode);
 
-    if (DListIsEmpty(&device->devNodes)) {
-        DevHostServiceFreeDevice(hostService, device);
-    }
+    DevHostServiceFreeIdleDevice(hostService, device);
     return HDF_SUCCESS;
 }
 
@@ -186,17 +199,11 @@ static int ApplyDevicesPowerState(struct HdfDevice *device, uint32_t state)
     return HDF_SUCCESS;
 }
 
-static int DevHostServicePmNotify(struct IDevHostService *service, uint32_t state)
+static int DevHostServicePmNotifyInOrder(struct DevHostService *hostService, uint32_t state)
 {
     struct HdfDevice *device = NULL;
     int ret = HDF_SUCCESS;
-    struct DevHostService *hostService = CONTAINER_OF(service, struct DevHostService, super);
-    if (hostService == NULL) {
-        HDF_LOGE("failed to start device service, hostService is null");
-        return HDF_FAILURE;
-    }
 
-    HDF_LOGD("host(%s) set power state=%u", hostService->hostName, state);
     if (IsPowerWakeState(state)) {
         DLIST_FOR_EACH_ENTRY_REVERSE(device, &hostService->devices, struct HdfDevice, node) {
             if (ApplyDevicesPowerState(device, state) != HDF_SUCCESS) {
@@ -214,6 +221,109 @@ static int DevHostServicePmNotify(struct IDevHostService *service, uint32_t stat
     return ret;
 }
 
+static int DevHostServiceDevicePmNotify(struct HdfPmJob *job, uint32_t state)
+{
+    return ApplyDevicesPowerState((struct HdfDevice *)job->priv, state);
+}
+
+static void DevHostServiceSetDevicePmJob(struct HdfPmJob *job, struct HdfDevice *device)
+{
+    struct HdfDeviceNode *deviceNode = NULL;
+
+    job->func = DevHostServiceDevicePmNotify;
+    job->priv = device;
+    job->level = UINT32_MAX;
+    DLIST_FOR_EACH_ENTRY(deviceNode, &device->devNodes, struct HdfDeviceNode, entry) {
+        if (job->name == NULL && deviceNode->driver != NULL && deviceNode->driver->entry != NULL) {
+            job->name = deviceNode->driver->entry->moduleName;
+        }
+        if (deviceNode->launchLevel < job->level) {
+            job->level = deviceNode->launchLevel;
+        }
+    }
+    if (job->name == NULL) {
+        job->name = "unknown";
+    }
+}
+
+// stable, so that devices launched at the same level keep the order they were added in
+static void DevHostServiceSortPmJobs(struct HdfPmJob *jobs, uint32_t jobNum)
+{
+    uint32_t i;
+    uint32_t j;
+    struct HdfPmJob job;
+
+    for (i = 1; i < jobNum; i++) {
+        job = jobs[i];
+        for (j = i; j > 0 && jobs[j - 1].level > job.level; j--) {
+            jobs[j] = jobs[j - 1];
+        }
+        jobs[j] = job;
+    }
+}
+
+static void DevHostServiceReversePmJobs(struct HdfPmJob *jobs, uint32_t jobNum)
+{
+    uint32_t i;
+    struct HdfPmJob job;
+
+    for (i = 0; i < jobNum / 2; i++) {
+        job = jobs[i];
+        jobs[i] = jobs[jobNum - 1 - i];
+        jobs[jobNum - 1 - i] = job;
+    }
+}
+
+/*
+ * Devices wake up in the order they were launched in and suspend in the reverse one. Those launched at the
+ * same level change their power state concurrently if the host has more than one pmWorkers, which it only
+ * has when set by the kernel driver installer from the launchWorkers of the host.
+ */
+static int DevHostServicePmNotify(struct IDevHostService *service, uint32_t state)
+{
+    int ret;
+    uint32_t deviceNum = 0;
+    struct HdfDevice *device = NULL;
+    struct HdfPmTransition transition;
+    struct DevHostService *hostService = CONTAINER_OF(service, struct DevHostService, super);
+    if (hostService == NULL) {
+        HDF_LOGE("failed to start device service, hostService is null");
+        return HDF_FAILURE;
+    }
+
+    HDF_LOGD("host(%s) set power state=%u", hostService->hostName, state);
+    (void)memset_s(&transition, sizeof(transition), 0, sizeof(transition));
+    (void)OsalMutexLock(&hostService->devMutex);
+    DLIST_FOR_EACH_ENTRY(device, &hostService->devices, struct HdfDevice, node) {
+        deviceNum++;
+    }
+    if (deviceNum > 0) {
+        transition.jobs = (struct HdfPmJob *)OsalMemCalloc(sizeof(struct HdfPmJob) * deviceNum);
+    }
+    if (transition.jobs == NULL) {
+        ret = DevHostServicePmNotifyInOrder(hostService, state);
+        (void)OsalMutexUnlock(&hostService->devMutex);
+        return ret;
+    }
+    DLIST_FOR_EACH_ENTRY_REVERSE(device, &hostService->devices, struct HdfDevice, node) {
+        DevHostServiceSetDevicePmJob(&transition.jobs[transition.jobNum++], device);
+    }
+    (void)OsalMutexUnlock(&hostService->devMutex);
+
+    DevHostServiceSortPmJobs(transition.jobs, transition.jobNum);
+    if (!IsPowerWakeState(state)) {
+        DevHostServiceReversePmJobs(transition.jobs, transition.jobNum);
+    }
+    transition.name = hostService->hostName;
+    transition.powerState = state;
+    transition.workers = (hostService->pmWorkers > HDF_PM_TRANSITION_WORKERS_MAX) ?
+        HDF_PM_TRANSITION_WORKERS_MAX : hostService->pmWorkers;
+    transition.timeoutMs = HDF_PM_TRANSITION_TIMEOUT_MS;
+    ret = HdfPmTransitionRun(&transition);
+    OsalMemFree(transition.jobs);
+    return ret;
+}
+
 void DevHostServiceConstruct(struct DevHostService *service)
 {
     struct IDevHostService *hostServiceIf = &service->super;
@@ -223,6 +333,10 @@ void DevHostServiceConstruct(struct DevHostService *service)
         hostServiceIf->StartService = DevHostServiceStartService;
         hostServiceIf->PmNotify = DevHostServicePmNotify;
         DListHeadInit(&service->devices);
+        service->pmWorkers = 1;
+        if (OsalMutexInit(&service->devMutex) != HDF_SUCCESS) {
+            HDF_LOGE("failed to init device mutex of host service");
+        }
         HdfServiceObserverConstruct(&service->observer);
     }
 }
@@ -238,6 +352,7 @@ void DevHostServiceDestruct(struct DevHostService *service)
     DLIST_FOR_EACH_ENTRY_SAFE(device, tmp, &service->devices, struct HdfDevice, node) {
         HdfDeviceFreeInstance(device);
     }
+    (void)OsalMutexDestroy(&service->devMutex);
     HdfServiceObserverDestruct(&service->observer);
 }
 
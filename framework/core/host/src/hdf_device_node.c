@@ -25,6 +25,8 @@
 
 #define HDF_LOG_TAG device_node
 
+#define DEVNODE_LAUNCH_PRIORITY_SHIFT 16
+
 static int HdfDeviceNodePublishLocalService(struct HdfDeviceNode *devNode)
 {
     if (devNode == NULL) {
@@ -261,6 +263,7 @@ struct HdfDeviceNode *HdfDeviceNodeNewInstance(const struct HdfDeviceInfo *devic
     devNode->devId = deviceInfo->deviceId;
     devNode->permission = deviceInfo->permission;
     devNode->policy = deviceInfo->policy;
+    devNode->launchLevel = ((uint32_t)deviceInfo->priority << DEVNODE_LAUNCH_PRIORITY_SHIFT) | deviceInfo->launchDepth;
     devNode->token->devid = deviceInfo->deviceId;
     devNode->servName = HdfStringCopy(deviceInfo->svcName);
     if (devNode->servName == NULL) {
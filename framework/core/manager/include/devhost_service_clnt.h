@@ -12,16 +12,20 @@
 #include "devhost_service_if.h"
 #include "hdf_slist.h"
 #include "hdf_map.h"
+#include "osal_mutex.h"
 
 struct DevHostServiceClnt {
     struct DListHead node;
     struct HdfSList devices;
+    struct OsalMutex devMutex;  // guards devices, drivers of the host may attach concurrently
     struct HdfSList unloadDevInfos;
     struct HdfSList dynamicDevInfos;
     Map *deviceHashMap;
     struct IDevHostService *hostService;
     uint16_t devCount;
     uint16_t hostId;
+    uint16_t priority;
+    uint16_t launchWorkers;     // threads initializing the drivers of the host, always 1 for user space hosts
     int hostPid;
     const char *hostName;
     bool stopFlag;
@@ -12,6 +12,7 @@
 #include "devsvc_manager_if.h"
 #include "hdf_service_observer.h"
 #include "hdf_dlist.h"
+#include "osal_atomic.h"
 #include "osal_mutex.h"
 
 struct DevSvcManager {
@@ -20,6 +21,12 @@ struct DevSvcManager {
     struct HdfServiceObserver observer;
     struct DListHead svcstatListeners;
     struct OsalMutex mutex;
+    /* service index by key, read without the mutex; writers also hold the mutex */
+    struct DListHead *serviceBuckets;
+    uint32_t bucketCount;
+    uint32_t serviceCount;
+    OsalAtomic readers;
+    OsalAtomic writers;
 };
 
 struct HdfObject *DevSvcManagerCreate(void);
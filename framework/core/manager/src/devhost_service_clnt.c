@@ -12,38 +12,94 @@
 #include "hdf_base.h"
 #include "hdf_driver_installer.h"
 #include "hdf_log.h"
+#include "hdf_task_queue.h"
 #include "osal_mem.h"
+#include "osal_time.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG devhost_service_clnt
 
-int DevHostServiceClntInstallDriver(struct DevHostServiceClnt *hostClnt)
+#define DEVHOST_LAUNCH_WORKERS_MAX 16
+#define DEVHOST_US_PER_SECOND      1000000
+#define DEVHOST_WAIT_RETRY_MAX     3
+#define DEVHOST_POLL_MS            10
+
+enum DevLaunchState {
+    DEV_LAUNCH_WAITING,
+    DEV_LAUNCH_RUNNING,
+    DEV_LAUNCH_DONE,
+};
+
+struct DevLaunchGraph;
+
+struct DevLaunchNode {
+    struct HdfTaskType task;
+    struct DevLaunchGraph *graph;
+    struct HdfDeviceInfo *deviceInfo;
+    uint16_t *depends;      // nodes of the same priority to launch before this one
+    uint16_t dependNum;
+    uint16_t state;
+    int ret;
+    uint32_t costUs;
+};
+
+/*
+ * Drivers of a host are launched priority by priority: a node starts once every node of a smaller priority
+ * is done, and inside a priority once the nodes it depends on are done. Nodes of the same device depend on
+ * the one before them, as they attach to the same HdfDevice of the host.
+ */
+struct DevLaunchGraph {
+    struct IDevHostService *hostService;
+    struct DevLaunchNode *nodes;
+    uint16_t nodeNum;
+    uint16_t first;         // first node not done yet
+    struct OsalMutex mutex;
+    struct OsalSem done;
+};
+
+static bool DevHostServiceClntNeedLaunch(const struct HdfDeviceInfo *deviceInfo)
+{
+    if ((deviceInfo == NULL) || (deviceInfo->preload == DEVICE_PRELOAD_DISABLE)) {
+        return false;
+    }
+    /*
+     * If quick start feature enable, the device which 'preload' attribute set as
+     * DEVICE_PRELOAD_ENABLE_STEP2 will be loaded later
+     */
+    if (DeviceManagerIsQuickLoad() == DEV_MGR_QUICK_LOAD &&
+        deviceInfo->preload == DEVICE_PRELOAD_ENABLE_STEP2) {
+        return false;
+    }
+    return true;
+}
+
+static void DevHostServiceClntLaunchDone(struct DevHostServiceClnt *hostClnt, struct HdfDeviceInfo *deviceInfo,
+    int ret)
+{
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("failed to install driver %s, ret = %d", deviceInfo->svcName, ret);
+        return;
+    }
+    deviceInfo->status = HDF_SERVICE_USABLE;
+#ifndef __USER__
+    HdfSListRemove(&hostClnt->unloadDevInfos, &deviceInfo->node);
+    HdfDeviceInfoFreeInstance(deviceInfo);
+#else
+    (void)hostClnt;
+#endif
+}
+
+static int DevHostServiceClntInstallInOrder(struct DevHostServiceClnt *hostClnt)
 {
     int ret;
     struct HdfSListIterator it;
     struct HdfDeviceInfo *deviceInfo = NULL;
-    struct IDevHostService *devHostSvcIf = NULL;
-    if (hostClnt == NULL) {
-        HDF_LOGE("failed to install driver, hostClnt is null");
-        return HDF_FAILURE;
-    }
+    struct IDevHostService *devHostSvcIf = hostClnt->hostService;
 
-    devHostSvcIf = (struct IDevHostService *)hostClnt->hostService;
-    if (devHostSvcIf == NULL || devHostSvcIf->AddDevice == NULL) {
-        HDF_LOGE("devHostSvcIf or devHostSvcIf->AddDevice is null");
-        return HDF_FAILURE;
-    }
     HdfSListIteratorInit(&it, &hostClnt->unloadDevInfos);
     while (HdfSListIteratorHasNext(&it)) {
         deviceInfo = (struct HdfDeviceInfo *)HdfSListIteratorNext(&it);
-        if ((deviceInfo == NULL) || (deviceInfo->preload == DEVICE_PRELOAD_DISABLE)) {
-            continue;
-        }
-        /*
-         * If quick start feature enable, the device which 'preload' attribute set as
-         * DEVICE_PRELOAD_ENABLE_STEP2 will be loaded later
-         */
-        if (DeviceManagerIsQuickLoad() == DEV_MGR_QUICK_LOAD &&
-            deviceInfo->preload == DEVICE_PRELOAD_ENABLE_STEP2) {
+        if (!DevHostServiceClntNeedLaunch(deviceInfo)) {
             continue;
         }
         ret = devHostSvcIf->AddDevice(devHostSvcIf, deviceInfo);
@@ -60,9 +116,346 @@ int DevHostServiceClntInstallDriver(struct DevHostServiceClnt *hostClnt)
     return HDF_SUCCESS;
 }
 
+static uint16_t DevLaunchFindService(const struct DevLaunchGraph *graph, const char *svcName)
+{
+    uint16_t i;
+
+    for (i = 0; i < graph->nodeNum; i++) {
+        if (graph->nodes[i].deviceInfo->svcName != NULL && strcmp(graph->nodes[i].deviceInfo->svcName, svcName) == 0) {
+            return i;
+        }
+    }
+    return graph->nodeNum;
+}
+
+static uint16_t DevLaunchNodeSetDepends(struct DevLaunchGraph *graph, uint16_t index, uint16_t *depends)
+{
+    uint16_t i;
+    uint16_t j;
+    uint16_t num = 0;
+    const struct HdfDeviceInfo *deviceInfo = graph->nodes[index].deviceInfo;
+    const struct HdfDeviceInfo *dependInfo = NULL;
+
+    for (j = index; j > 0; j--) {
+        dependInfo = graph->nodes[j - 1].deviceInfo;
+        if (DEVICEID(dependInfo->deviceId) == DEVICEID(deviceInfo->deviceId)) {
+            if (dependInfo->priority == deviceInfo->priority) {
+                depends[num++] = j - 1;
+            }
+            break;
+        }
+    }
+    for (i = 0; i < deviceInfo->dependNum; i++) {
+        j = DevLaunchFindService(graph, deviceInfo->depends[i]);
+        if (j == graph->nodeNum) {
+            HDF_LOGW("%s depends on %s which is not launched with it, ignore", deviceInfo->svcName,
+                deviceInfo->depends[i]);
+            continue;
+        }
+        dependInfo = graph->nodes[j].deviceInfo;
+        if (dependInfo->priority < deviceInfo->priority) {
+            continue;
+        }
+        if (dependInfo->priority > deviceInfo->priority || j == index) {
+            HDF_LOGE("%s depends on %s which is launched after it, ignore", deviceInfo->svcName,
+                deviceInfo->depends[i]);
+            continue;
+        }
+        depends[num++] = j;
+    }
+    return num;
+}
+
+static int DevLaunchGraphInit(struct DevLaunchGraph *graph, struct DevHostServiceClnt *hostClnt)
+{
+    uint16_t i;
+    uint32_t dependSize = 0;
+    uint16_t *depends = NULL;
+    struct HdfSListIterator it;
+    struct HdfDeviceInfo *deviceInfo = NULL;
+
+    HdfSListIteratorInit(&it, &hostClnt->unloadDevInfos);
+    while (HdfSListIteratorHasNext(&it)) {
+        deviceInfo = (struct HdfDeviceInfo *)HdfSListIteratorNext(&it);
+        if (DevHostServiceClntNeedLaunch(deviceInfo) && graph->nodeNum < UINT16_MAX) {
+            graph->nodeNum++;
+            dependSize += deviceInfo->dependNum + 1;
+        }
+    }
+    if (graph->nodeNum == 0) {
+        return HDF_SUCCESS;
+    }
+
+    graph->nodes = (struct DevLaunchNode *)OsalMemCalloc(sizeof(struct DevLaunchNode) * graph->nodeNum +
+        sizeof(uint16_t) * dependSize);
+    if (graph->nodes == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    depends = (uint16_t *)(graph->nodes + graph->nodeNum);
+
+    i = 0;
+    HdfSListIteratorInit(&it, &hostClnt->unloadDevInfos);
+    while (HdfSListIteratorHasNext(&it) && i < graph->nodeNum) {
+        deviceInfo = (struct HdfDeviceInfo *)HdfSListIteratorNext(&it);
+        if (DevHostServiceClntNeedLaunch(deviceInfo)) {
+            graph->nodes[i].graph = graph;
+            graph->nodes[i].deviceInfo = deviceInfo;
+            graph->nodes[i].state = DEV_LAUNCH_WAITING;
+            i++;
+        }
+    }
+    for (i = 0; i < graph->nodeNum; i++) {
+        graph->nodes[i].depends = depends;
+        graph->nodes[i].dependNum = DevLaunchNodeSetDepends(graph, i, depends);
+        depends += graph->nodes[i].dependNum;
+    }
+
+    graph->hostService = hostClnt->hostService;
+    if (OsalMutexInit(&graph->mutex) != HDF_SUCCESS) {
+        OsalMemFree(graph->nodes);
+        return HDF_FAILURE;
+    }
+    if (OsalSemInit(&graph->done, 0) != HDF_SUCCESS) {
+        (void)OsalMutexDestroy(&graph->mutex);
+        OsalMemFree(graph->nodes);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+static void DevLaunchGraphDeinit(struct DevLaunchGraph *graph)
+{
+    (void)OsalSemDestroy(&graph->done);
+    (void)OsalMutexDestroy(&graph->mutex);
+    OsalMemFree(graph->nodes);
+    graph->nodes = NULL;
+}
+
+static int32_t DevLaunchNodeRun(struct HdfTaskType *task)
+{
+    OsalTimespec start = {0};
+    OsalTimespec end = {0};
+    OsalTimespec diff = {0};
+    struct DevLaunchNode *node = CONTAINER_OF(task, struct DevLaunchNode, task);
+    struct DevLaunchGraph *graph = node->graph;
+
+    (void)OsalGetTime(&start);
+    node->ret = graph->hostService->AddDevice(graph->hostService, node->deviceInfo);
+    (void)OsalGetTime(&end);
+    if (OsalDiffTime(&start, &end, &diff) == HDF_SUCCESS) {
+        node->costUs = (uint32_t)(diff.sec * DEVHOST_US_PER_SECOND + diff.usec);
+    }
+
+    // posted under the mutex, so that a node seen done by DevLaunchGraphPoll no longer uses the semaphore
+    (void)OsalMutexLock(&graph->mutex);
+    node->state = DEV_LAUNCH_DONE;
+    (void)OsalSemPost(&graph->done);
+    (void)OsalMutexUnlock(&graph->mutex);
+    return HDF_SUCCESS;
+}
+
+static bool DevLaunchNodeReady(const struct DevLaunchGraph *graph, const struct DevLaunchNode *node)
+{
+    uint16_t i;
+
+    if (node->state != DEV_LAUNCH_WAITING) {
+        return false;
+    }
+    for (i = 0; i < node->dependNum; i++) {
+        if (graph->nodes[node->depends[i]].state != DEV_LAUNCH_DONE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// called with the graph mutex held
+static struct DevLaunchNode *DevLaunchGraphNext(struct DevLaunchGraph *graph, bool idle)
+{
+    uint16_t i;
+    uint16_t priority;
+
+    while (graph->first < graph->nodeNum && graph->nodes[graph->first].state == DEV_LAUNCH_DONE) {
+        graph->first++;
+    }
+    if (graph->first == graph->nodeNum) {
+        return NULL;
+    }
+    priority = graph->nodes[graph->first].deviceInfo->priority;
+    for (i = graph->first; i < graph->nodeNum && graph->nodes[i].deviceInfo->priority == priority; i++) {
+        if (DevLaunchNodeReady(graph, &graph->nodes[i])) {
+            return &graph->nodes[i];
+        }
+    }
+    if (!idle) {
+        return NULL;
+    }
+    // nothing runs and nothing is ready: the depends of this priority have a cycle
+    for (i = graph->first; i < graph->nodeNum && graph->nodes[i].deviceInfo->priority == priority; i++) {
+        if (graph->nodes[i].state == DEV_LAUNCH_WAITING) {
+            HDF_LOGE("depends of %s are in a cycle, launch it anyway", graph->nodes[i].deviceInfo->svcName);
+            return &graph->nodes[i];
+        }
+    }
+    return NULL;
+}
+
+static void DevLaunchNodeSetDepth(const struct DevLaunchGraph *graph, struct DevLaunchNode *node)
+{
+    uint16_t i;
+    uint16_t depth = 0;
+    const struct HdfDeviceInfo *dependInfo = NULL;
+
+    for (i = 0; i < node->dependNum; i++) {
+        dependInfo = graph->nodes[node->depends[i]].deviceInfo;
+        if (dependInfo->launchDepth >= depth) {
+            depth = dependInfo->launchDepth + 1;
+        }
+    }
+    node->deviceInfo->launchDepth = depth;
+}
+
+// waits for the running nodes by their state, once the semaphore can not be waited on any more
+static void DevLaunchGraphPoll(struct DevLaunchGraph *graph)
+{
+    uint16_t i = 0;
+
+    while (i < graph->nodeNum) {
+        (void)OsalMutexLock(&graph->mutex);
+        while (i < graph->nodeNum && graph->nodes[i].state != DEV_LAUNCH_RUNNING) {
+            i++;
+        }
+        (void)OsalMutexUnlock(&graph->mutex);
+        if (i < graph->nodeNum) {
+            OsalMSleep(DEVHOST_POLL_MS);
+        }
+    }
+}
+
+/*
+ * Nodes launched inline are done when they return, queued ones are counted by the semaphore. A failed wait,
+ * such as an interrupted one, is retried a few times, then the running nodes are polled to their end, the
+ * workers are destroyed and the rest of the graph is launched inline.
+ */
+static void DevLaunchGraphRun(struct DevLaunchGraph *graph, struct HdfTaskQueue **queue)
+{
+    int32_t ret;
+    uint16_t running = 0;
+    uint16_t failures = 0;
+    struct DevLaunchNode *node = NULL;
+
+    while (true) {
+        (void)OsalMutexLock(&graph->mutex);
+        node = DevLaunchGraphNext(graph, running == 0);
+        if (node != NULL) {
+            node->state = DEV_LAUNCH_RUNNING;
+            DevLaunchNodeSetDepth(graph, node);
+        }
+        (void)OsalMutexUnlock(&graph->mutex);
+
+        if (node != NULL) {
+            if (*queue != NULL) {
+                running++;
+                HdfTaskEnqueue(*queue, &node->task);
+            } else {
+                (void)DevLaunchNodeRun(&node->task);
+            }
+            continue;
+        }
+        if (running == 0) {
+            break;
+        }
+        ret = OsalSemWait(&graph->done, HDF_WAIT_FOREVER);
+        if (ret == HDF_SUCCESS) {
+            running--;
+            failures = 0;
+        } else if (++failures >= DEVHOST_WAIT_RETRY_MAX) {
+            HDF_LOGE("wait for launch workers failed: %d, launch the rest inline", ret);
+            DevLaunchGraphPoll(graph);
+            HdfTaskQueueDestroy(*queue);
+            *queue = NULL;
+            running = 0;
+        }
+    }
+}
+
+static void DevLaunchGraphTrace(const struct DevHostServiceClnt *hostClnt, const struct DevLaunchGraph *graph,
+    uint16_t workers, uint32_t totalUs)
+{
+    uint16_t i;
+    uint32_t sumUs = 0;
+
+    for (i = 0; i < graph->nodeNum; i++) {
+        HDF_LOGI("host %s: driver %s launched in %u us, ret = %d", hostClnt->hostName,
+            graph->nodes[i].deviceInfo->moduleName, graph->nodes[i].costUs, graph->nodes[i].ret);
+        sumUs += graph->nodes[i].costUs;
+    }
+    HDF_LOGI("host %s: %u drivers launched by %u workers in %u us, %u us spent in drivers", hostClnt->hostName,
+        graph->nodeNum, workers, totalUs, sumUs);
+}
+
+int DevHostServiceClntInstallDriver(struct DevHostServiceClnt *hostClnt)
+{
+    uint16_t i;
+    uint16_t workers;
+    OsalTimespec start = {0};
+    OsalTimespec end = {0};
+    OsalTimespec diff = {0};
+    struct DevLaunchGraph graph;
+    struct HdfTaskQueue *queue = NULL;
+    struct IDevHostService *devHostSvcIf = NULL;
+    if (hostClnt == NULL) {
+        HDF_LOGE("failed to install driver, hostClnt is null");
+        return HDF_FAILURE;
+    }
+
+    devHostSvcIf = (struct IDevHostService *)hostClnt->hostService;
+    if (devHostSvcIf == NULL || devHostSvcIf->AddDevice == NULL) {
+        HDF_LOGE("devHostSvcIf or devHostSvcIf->AddDevice is null");
+        return HDF_FAILURE;
+    }
+    (void)memset_s(&graph, sizeof(graph), 0, sizeof(graph));
+    if (DevLaunchGraphInit(&graph, hostClnt) != HDF_SUCCESS) {
+        HDF_LOGW("failed to build launch graph of host %s, launch in order", hostClnt->hostName);
+        return DevHostServiceClntInstallInOrder(hostClnt);
+    }
+    if (graph.nodeNum == 0) {
+        return HDF_SUCCESS;
+    }
+
+    workers = (hostClnt->launchWorkers > DEVHOST_LAUNCH_WORKERS_MAX) ?
+        DEVHOST_LAUNCH_WORKERS_MAX : hostClnt->launchWorkers;
+    workers = (workers > graph.nodeNum) ? graph.nodeNum : workers;
+    if (workers > 1) {
+        queue = HdfTaskQueueCreatePool(DevLaunchNodeRun, hostClnt->hostName, workers);
+        if (queue == NULL) {
+            HDF_LOGW("failed to create launch workers of host %s, launch one by one", hostClnt->hostName);
+        }
+    }
+    workers = (queue == NULL) ? 1 : workers;
+
+    (void)OsalGetTime(&start);
+    DevLaunchGraphRun(&graph, &queue);
+    (void)OsalGetTime(&end);
+    if (queue != NULL) {
+        HdfTaskQueueDestroy(queue);
+    }
+    (void)OsalDiffTime(&start, &end, &diff);
+    DevLaunchGraphTrace(hostClnt, &graph, workers, (uint32_t)(diff.sec * DEVHOST_US_PER_SECOND + diff.usec));
+
+    for (i = 0; i < graph.nodeNum; i++) {
+        DevHostServiceClntLaunchDone(hostClnt, graph.nodes[i].deviceInfo, graph.nodes[i].ret);
+    }
+    DevLaunchGraphDeinit(&graph);
+    return HDF_SUCCESS;
+}
+
 static void DevHostServiceClntConstruct(struct DevHostServiceClnt *hostClnt)
 {
     HdfSListInit(&hostClnt->devices);
+    if (OsalMutexInit(&hostClnt->devMutex) != HDF_SUCCESS) {
+        HDF_LOGE("%s:failed to init device mutex", __func__);
+    }
     hostClnt->deviceHashMap = (Map *)OsalMemCalloc(sizeof(Map));
     if (hostClnt->deviceHashMap == NULL) {
         HDF_LOGE("%s:failed to malloc deviceHashMap", __func__);
@@ -79,6 +472,7 @@ struct DevHostServiceClnt *DevHostServiceClntNewInstance(uint16_t hostId, const
         hostClnt->hostId = hostId;
         hostClnt->hostName = hostName;
         hostClnt->devCount = 0;
+        hostClnt->launchWorkers = 1;
         hostClnt->hostPid = -1;
         hostClnt->stopFlag = false;
         DevHostServiceClntConstruct(hostClnt);
@@ -92,6 +486,7 @@ void DevHostServiceClntFreeInstance(struct DevHostServiceClnt *hostClnt)
         HdfSListFlush(&hostClnt->devices, DeviceTokenClntDelete);
         HdfSListFlush(&hostClnt->unloadDevInfos, HdfDeviceInfoDelete);
         HdfSListFlush(&hostClnt->dynamicDevInfos, HdfDeviceInfoDelete);
+        (void)OsalMutexDestroy(&hostClnt->devMutex);
         OsalMemFree(hostClnt->deviceHashMap);
         OsalMemFree(hostClnt);
     }
@@ -16,7 +16,10 @@
 #include "hdf_host_info.h"
 #include "hdf_log.h"
 #include "hdf_object_manager.h"
+#include "hdf_power_transition.h"
+#include "osal_mem.h"
 #include "osal_time.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG devmgr_service
 
@@ -222,7 +225,9 @@ static int DevmgrServiceAttachDevice(struct IDevmgrService *inst, struct IHdfDev
         return HDF_FAILURE;
     }
 
+    (void)OsalMutexLock(&hostClnt->devMutex);
     HdfSListAdd(&hostClnt->devices, &tokenClnt->node);
+    (void)OsalMutexUnlock(&hostClnt->devMutex);
     return HDF_SUCCESS;
 }
 
@@ -243,13 +248,16 @@ static int DevmgrServiceDetachDevice(struct IDevmgrService *inst, devid_t devid)
         HDF_LOGE("failed to attach device, hostClnt is null");
         return HDF_FAILURE;
     }
+    (void)OsalMutexLock(&hostClnt->devMutex);
     tokenClntNode = HdfSListSearch(&hostClnt->devices, devid, HdfSListHostSearchDeviceTokenComparer);
     if (tokenClntNode == NULL) {
+        (void)OsalMutexUnlock(&hostClnt->devMutex);
         HDF_LOGE("devmgr detach device %x not found", devid);
         return HDF_DEV_ERR_NO_DEVICE;
     }
     tokenClnt = CONTAINER_OF(tokenClntNode, struct DeviceTokenClnt, node);
     HdfSListRemove(&hostClnt->devices, &tokenClnt->node);
+    (void)OsalMutexUnlock(&hostClnt->devMutex);
     return HDF_SUCCESS;
 }
 
@@ -277,6 +285,7 @@ static int DevmgrServiceStartDeviceHost(struct DevmgrService *devmgr, struct Hdf
         HDF_LOGW("failed to create new device host client");
         return HDF_FAILURE;
     }
+    hostClnt->priority = hostAttr->priority;
 
     if (HdfAttributeManagerGetDeviceList(hostClnt) != HDF_SUCCESS) {
         HDF_LOGW("failed to get device list for host %s", hostClnt->hostName);
@@ -338,6 +347,7 @@ static int32_t DevmgrServiceListAllDevice(struct IDevmgrService *inst, struct Hd
     DLIST_FOR_EACH_ENTRY(hostClnt, &devMgrSvc->hosts, struct DevHostServiceClnt, node) {
         HdfSbufWriteString(reply, hostClnt->hostName);
         HdfSbufWriteUint32(reply, hostClnt->hostId);
+        (void)OsalMutexLock(&hostClnt->devMutex);
         HdfSbufWriteUint32(reply, HdfSListCount(&hostClnt->devices));
         HdfSListIteratorInit(&iterator, &hostClnt->devices);
         while (HdfSListIteratorHasNext(&iterator)) {
@@ -349,6 +359,7 @@ static int32_t DevmgrServiceListAllDevice(struct IDevmgrService *inst, struct Hd
                 HDF_LOGI("%{public}s host:%{public}s token null", __func__, hostClnt->hostName);
             }
         }
+        (void)OsalMutexUnlock(&hostClnt->devMutex);
     }
     return HDF_SUCCESS;
 }
@@ -368,11 +379,75 @@ int DevmgrServiceStartService(struct IDevmgrService *inst)
     return DevmgrServiceStartDeviceHosts(dmService);
 }
 
+static int DevmgrServicePowerStateChangeInOrder(struct DevmgrService *devmgr, enum HdfPowerState powerState)
+{
+    struct DevHostServiceClnt *hostClient = NULL;
+    int result = HDF_SUCCESS;
+
+    if (IsPowerWakeState(powerState)) {
+        DLIST_FOR_EACH_ENTRY(hostClient, &devmgr->hosts, struct DevHostServiceClnt, node) {
+            if (hostClient->hostService != NULL) {
+                if (hostClient->hostService->PmNotify(hostClient->hostService, powerState) != HDF_SUCCESS) {
+                    result = HDF_FAILURE;
+                }
+            }
+        }
+    } else {
+        DLIST_FOR_EACH_ENTRY_REVERSE(hostClient, &devmgr->hosts, struct DevHostServiceClnt, node) {
+            if (hostClient->hostService != NULL) {
+                if (hostClient->hostService->PmNotify(hostClient->hostService, powerState) != HDF_SUCCESS) {
+                    result = HDF_FAILURE;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static int DevmgrServiceHostPmNotify(struct HdfPmJob *job, uint32_t powerState)
+{
+    struct DevHostServiceClnt *hostClient = (struct DevHostServiceClnt *)job->priv;
+
+    return hostClient->hostService->PmNotify(hostClient->hostService, powerState);
+}
+
+static uint32_t DevmgrServicePmWorkers(struct DevmgrService *devmgr)
+{
+    uint32_t workers = 1;
+    struct DevHostServiceClnt *hostClient = NULL;
+
+    DLIST_FOR_EACH_ENTRY(hostClient, &devmgr->hosts, struct DevHostServiceClnt, node) {
+        if (hostClient->launchWorkers > workers) {
+            workers = hostClient->launchWorkers;
+        }
+    }
+    return (workers > HDF_PM_TRANSITION_WORKERS_MAX) ? HDF_PM_TRANSITION_WORKERS_MAX : workers;
+}
+
+static void DevmgrServiceAddHostPmJob(struct HdfPmTransition *transition, struct DevHostServiceClnt *hostClient)
+{
+    struct HdfPmJob *job = &transition->jobs[transition->jobNum++];
+
+    job->func = DevmgrServiceHostPmNotify;
+    job->priv = hostClient;
+    job->name = hostClient->hostName;
+    job->level = hostClient->priority;
+    job->serial = (hostClient->launchWorkers <= 1);
+}
+
+/*
+ * Hosts of a priority wake up after the ones of smaller priorities and suspend before them. Hosts of the same
+ * priority change their power state concurrently only if they launch their drivers concurrently, the others
+ * one by one in list order as before.
+ */
 int DevmgrServicePowerStateChange(struct IDevmgrService *devmgrService, enum HdfPowerState powerState)
 {
+    uint32_t hostNum = 0;
+    int result;
     struct DevHostServiceClnt *hostClient = NULL;
     struct DevmgrService *devmgr = NULL;
-    int result = HDF_SUCCESS;
+    struct HdfPmTransition transition;
 
     if (devmgrService == NULL) {
         return HDF_ERR_INVALID_OBJECT;
@@ -383,27 +458,38 @@ int DevmgrServicePowerStateChange(struct IDevmgrService *devmgrService, enum Hdf
         return HDF_ERR_INVALID_PARAM;
     }
     devmgr = CONTAINER_OF(devmgrService, struct DevmgrService, super);
+    HDF_LOGI("%s:%s state %u", __func__, IsPowerWakeState(powerState) ? "wake" : "suspend", powerState);
 
+    DLIST_FOR_EACH_ENTRY(hostClient, &devmgr->hosts, struct DevHostServiceClnt, node) {
+        hostNum++;
+    }
+    if (hostNum == 0) {
+        return HDF_SUCCESS;
+    }
+    (void)memset_s(&transition, sizeof(transition), 0, sizeof(transition));
+    transition.jobs = (struct HdfPmJob *)OsalMemCalloc(sizeof(struct HdfPmJob) * hostNum);
+    if (transition.jobs == NULL) {
+        return DevmgrServicePowerStateChangeInOrder(devmgr, powerState);
+    }
     if (IsPowerWakeState(powerState)) {
-        HDF_LOGI("%s:wake state %u", __func__, powerState);
         DLIST_FOR_EACH_ENTRY(hostClient, &devmgr->hosts, struct DevHostServiceClnt, node) {
-            if (hostClient->hostService != NULL) {
-                if (hostClient->hostService->PmNotify(hostClient->hostService, powerState) != HDF_SUCCESS) {
-                    result = HDF_FAILURE;
-                }
+            if (hostClient->hostService != NULL && transition.jobNum < hostNum) {
+                DevmgrServiceAddHostPmJob(&transition, hostClient);
             }
         }
     } else {
-        HDF_LOGI("%s:suspend state %u", __func__, powerState);
         DLIST_FOR_EACH_ENTRY_REVERSE(hostClient, &devmgr->hosts, struct DevHostServiceClnt, node) {
-            if (hostClient->hostService != NULL) {
-                if (hostClient->hostService->PmNotify(hostClient->hostService, powerState) != HDF_SUCCESS) {
-                    result = HDF_FAILURE;
-                }
+            if (hostClient->hostService != NULL && transition.jobNum < hostNum) {
+                DevmgrServiceAddHostPmJob(&transition, hostClient);
             }
         }
     }
-
+    transition.name = "devmgr_pm";
+    transition.powerState = powerState;
+    transition.workers = DevmgrServicePmWorkers(devmgr);
+    transition.timeoutMs = HDF_PM_TRANSITION_TIMEOUT_MS;
+    result = HdfPmTransitionRun(&transition);
+    OsalMemFree(transition.jobs);
     return result;
 }
 
@@ -15,28 +15,151 @@
 #include "hdf_object_manager.h"
 #include "hdf_service_record.h"
 #include "osal_mem.h"
+#include "osal_time.h"
 
 #define HDF_LOG_TAG devsvc_manager
 
-static struct DevSvcRecord *DevSvcManagerSearchService(struct IDevSvcManager *inst, uint32_t serviceKey)
+#define SERVICE_BUCKET_INIT_COUNT 16
+#define SERVICE_BUCKET_GROW_RATE  2
+#define SERVICE_LOCK_SPIN_COUNT   128
+
+/*
+ * Lookups only announce themselves in the readers counter, so they never wait for the mutex, which is held
+ * while service status listeners are notified. Writers hold the mutex and drain the lookups in flight only
+ * for the few instructions that change the index. The counters are only changed by compare and exchange, which
+ * is atomic on every OSAL, unlike the plain increment of some.
+ */
+static void DevSvcManagerAtomicAdd(OsalAtomic *counter, int32_t delta)
+{
+    int32_t value = OsalAtomicRead(counter);
+    int32_t seen;
+
+    while ((seen = OsalAtomicCmpXchg(counter, value, value + delta)) != value) {
+        value = seen;
+    }
+}
+
+static void DevSvcManagerWaitForZero(OsalAtomic *counter)
+{
+    uint32_t spinCount = 0;
+    while (OsalAtomicRead(counter) != 0) {
+        if (++spinCount > SERVICE_LOCK_SPIN_COUNT) {
+            OsalMSleep(1);
+            spinCount = 0;
+        }
+    }
+}
+
+static void DevSvcManagerReadLock(struct DevSvcManager *devSvcManager)
+{
+    while (true) {
+        DevSvcManagerAtomicAdd(&devSvcManager->readers, 1);
+        if (OsalAtomicRead(&devSvcManager->writers) == 0) {
+            return;
+        }
+        DevSvcManagerAtomicAdd(&devSvcManager->readers, -1);
+        DevSvcManagerWaitForZero(&devSvcManager->writers);
+    }
+}
+
+static void DevSvcManagerReadUnlock(struct DevSvcManager *devSvcManager)
+{
+    DevSvcManagerAtomicAdd(&devSvcManager->readers, -1);
+}
+
+static void DevSvcManagerWriteLockLocked(struct DevSvcManager *devSvcManager)
+{
+    DevSvcManagerAtomicAdd(&devSvcManager->writers, 1);
+    DevSvcManagerWaitForZero(&devSvcManager->readers);
+}
+
+static void DevSvcManagerWriteUnlockLocked(struct DevSvcManager *devSvcManager)
+{
+    DevSvcManagerAtomicAdd(&devSvcManager->writers, -1);
+}
+
+static inline struct DListHead *DevSvcManagerBucket(struct DListHead *buckets, uint32_t bucketCount, uint32_t key)
+{
+    key ^= key >> 16; // 16: fold the high bits, the key is a string hash
+    return &buckets[key & (bucketCount - 1)];
+}
+
+static struct DevSvcRecord *DevSvcManagerFindService(const struct DevSvcManager *devSvcManager, uint32_t serviceKey)
 {
     struct DevSvcRecord *record = NULL;
-    struct DevSvcRecord *searchResult = NULL;
-    struct DevSvcManager *devSvcManager = (struct DevSvcManager *)inst;
-    if (devSvcManager == NULL) {
-        HDF_LOGE("failed to search service, devSvcManager is null");
+    struct DListHead *bucket = NULL;
+    if (devSvcManager->bucketCount == 0) {
         return NULL;
     }
 
-    OsalMutexLock(&devSvcManager->mutex);
-    DLIST_FOR_EACH_ENTRY(record, &devSvcManager->services, struct DevSvcRecord, entry) {
+    bucket = DevSvcManagerBucket(devSvcManager->serviceBuckets, devSvcManager->bucketCount, serviceKey);
+    DLIST_FOR_EACH_ENTRY(record, bucket, struct DevSvcRecord, hashEntry) {
         if (record->key == serviceKey) {
-            searchResult = record;
-            break;
+            return record;
         }
     }
-    OsalMutexUnlock(&devSvcManager->mutex);
-    return searchResult;
+    return NULL;
+}
+
+static int32_t DevSvcManagerGrowIndexLocked(struct DevSvcManager *devSvcManager)
+{
+    struct DevSvcRecord *record = NULL;
+    struct DListHead *oldBuckets = devSvcManager->serviceBuckets;
+    uint32_t newCount;
+    struct DListHead *newBuckets = NULL;
+
+    if (devSvcManager->serviceCount < devSvcManager->bucketCount) {
+        return HDF_SUCCESS;
+    }
+    newCount = (devSvcManager->bucketCount == 0) ? SERVICE_BUCKET_INIT_COUNT :
+        devSvcManager->bucketCount * SERVICE_BUCKET_GROW_RATE;
+    newBuckets = (struct DListHead *)OsalMemCalloc(sizeof(struct DListHead) * newCount);
+    if (newBuckets == NULL) {
+        // longer chains are still correct, only fail if there is no index at all
+        return (devSvcManager->bucketCount == 0) ? HDF_ERR_MALLOC_FAIL : HDF_SUCCESS;
+    }
+    for (uint32_t i = 0; i < newCount; i++) {
+        DListHeadInit(&newBuckets[i]);
+    }
+
+    DevSvcManagerWriteLockLocked(devSvcManager);
+    DLIST_FOR_EACH_ENTRY(record, &devSvcManager->services, struct DevSvcRecord, entry) {
+        DListInsertTail(&record->hashEntry, DevSvcManagerBucket(newBuckets, newCount, record->key));
+    }
+    devSvcManager->serviceBuckets = newBuckets;
+    devSvcManager->bucketCount = newCount;
+    DevSvcManagerWriteUnlockLocked(devSvcManager);
+
+    OsalMemFree(oldBuckets);
+    return HDF_SUCCESS;
+}
+
+static void DevSvcManagerInsertServiceLocked(struct DevSvcManager *devSvcManager, struct DevSvcRecord *record)
+{
+    DevSvcManagerWriteLockLocked(devSvcManager);
+    DListInsertTail(&record->entry, &devSvcManager->services);
+    DListInsertTail(&record->hashEntry,
+        DevSvcManagerBucket(devSvcManager->serviceBuckets, devSvcManager->bucketCount, record->key));
+    devSvcManager->serviceCount++;
+    DevSvcManagerWriteUnlockLocked(devSvcManager);
+}
+
+static void DevSvcManagerRemoveServiceLocked(struct DevSvcManager *devSvcManager, struct DevSvcRecord *record)
+{
+    DevSvcManagerWriteLockLocked(devSvcManager);
+    DListRemove(&record->entry);
+    DListRemove(&record->hashEntry);
+    devSvcManager->serviceCount--;
+    DevSvcManagerWriteUnlockLocked(devSvcManager);
+}
+
+static void DevSvcManagerSetServiceLocked(
+    struct DevSvcManager *devSvcManager, struct DevSvcRecord *record, struct HdfDeviceObject *service)
+{
+    // lookups read the value of indexed records without the mutex
+    DevSvcManagerWriteLockLocked(devSvcManager);
+    record->value = service;
+    DevSvcManagerWriteUnlockLocked(devSvcManager);
 }
 
 static void NotifyServiceStatusLocked(
@@ -91,16 +214,23 @@ int DevSvcManagerAddService(struct IDevSvcManager *inst, const char *servName, u
         HDF_LOGE("failed to add service, input param is null");
         return HDF_FAILURE;
     }
-    record = DevSvcManagerSearchService(inst, HdfStringMakeHashKey(servName, 0));
+    OsalMutexLock(&devSvcManager->mutex);
+    record = DevSvcManagerFindService(devSvcManager, HdfStringMakeHashKey(servName, 0));
     if (record != NULL) {
         HDF_LOGI("%s:add service %s exist, only update value", __func__, servName);
         // on service died will release old service object
-        record->value = service;
+        DevSvcManagerSetServiceLocked(devSvcManager, record, service);
+        OsalMutexUnlock(&devSvcManager->mutex);
         return HDF_SUCCESS;
     }
+    if (DevSvcManagerGrowIndexLocked(devSvcManager) != HDF_SUCCESS) {
+        OsalMutexUnlock(&devSvcManager->mutex);
+        return HDF_ERR_MALLOC_FAIL;
+    }
     record = DevSvcRecordNewInstance();
     if (record == NULL) {
         HDF_LOGE("failed to add service , record is null");
+        OsalMutexUnlock(&devSvcManager->mutex);
         return HDF_FAILURE;
     }
 
@@ -111,10 +241,10 @@ int DevSvcManagerAddService(struct IDevSvcManager *inst, const char *servName, u
     record->servInfo = HdfStringCopy(servInfo);
     if (record->servName == NULL) {
         DevSvcRecordFreeInstance(record);
+        OsalMutexUnlock(&devSvcManager->mutex);
         return HDF_ERR_MALLOC_FAIL;
     }
-    OsalMutexLock(&devSvcManager->mutex);
-    DListInsertTail(&record->entry, &devSvcManager->services);
+    DevSvcManagerInsertServiceLocked(devSvcManager, record);
     NotifyServiceStatusLocked(devSvcManager, record, SERVIE_STATUS_START);
     OsalMutexUnlock(&devSvcManager->mutex);
     return HDF_SUCCESS;
@@ -131,23 +261,25 @@ int DevSvcManagerUpdateService(struct IDevSvcManager *inst, const char *servName
         return HDF_FAILURE;
     }
 
-    record = DevSvcManagerSearchService(inst, HdfStringMakeHashKey(servName, 0));
+    OsalMutexLock(&devSvcManager->mutex);
+    record = DevSvcManagerFindService(devSvcManager, HdfStringMakeHashKey(servName, 0));
     if (record == NULL) {
+        OsalMutexUnlock(&devSvcManager->mutex);
         return HDF_DEV_ERR_NO_DEVICE;
     }
 
     if (servInfo != NULL) {
         servInfoStr = HdfStringCopy(servInfo);
         if (servInfoStr == NULL) {
+            OsalMutexUnlock(&devSvcManager->mutex);
             return HDF_ERR_MALLOC_FAIL;
         }
         OsalMemFree((char *)record->servInfo);
         record->servInfo = servInfoStr;
     }
 
-    record->value = service;
+    DevSvcManagerSetServiceLocked(devSvcManager, record, service);
     record->devClass = devClass;
-    OsalMutexLock(&devSvcManager->mutex);
     NotifyServiceStatusLocked(devSvcManager, record, SERVIE_STATUS_CHANGE);
     OsalMutexUnlock(&devSvcManager->mutex);
     return HDF_SUCCESS;
@@ -181,13 +313,14 @@ void DevSvcManagerRemoveService(struct IDevSvcManager *inst, const char *svcName
     if (svcName == NULL || devSvcManager == NULL) {
         return;
     }
-    serviceRecord = DevSvcManagerSearchService(inst, serviceKey);
+    OsalMutexLock(&devSvcManager->mutex);
+    serviceRecord = DevSvcManagerFindService(devSvcManager, serviceKey);
     if (serviceRecord == NULL) {
+        OsalMutexUnlock(&devSvcManager->mutex);
         return;
     }
-    OsalMutexLock(&devSvcManager->mutex);
     NotifyServiceStatusLocked(devSvcManager, serviceRecord, SERVIE_STATUS_STOP);
-    DListRemove(&serviceRecord->entry);
+    DevSvcManagerRemoveServiceLocked(devSvcManager, serviceRecord);
     OsalMutexUnlock(&devSvcManager->mutex);
 
     DevSvcRecordFreeInstance(serviceRecord);
@@ -195,17 +328,21 @@ void DevSvcManagerRemoveService(struct IDevSvcManager *inst, const char *svcName
 
 struct HdfDeviceObject *DevSvcManagerGetObject(struct IDevSvcManager *inst, const char *svcName)
 {
+    struct DevSvcManager *devSvcManager = (struct DevSvcManager *)inst;
     uint32_t serviceKey = HdfStringMakeHashKey(svcName, 0);
     struct DevSvcRecord *serviceRecord = NULL;
-    if (svcName == NULL) {
+    struct HdfDeviceObject *deviceObject = NULL;
+    if (svcName == NULL || devSvcManager == NULL) {
         HDF_LOGE("Get service failed, svcName is null");
         return NULL;
     }
-    serviceRecord = DevSvcManagerSearchService(inst, serviceKey);
+    DevSvcManagerReadLock(devSvcManager);
+    serviceRecord = DevSvcManagerFindService(devSvcManager, serviceKey);
     if (serviceRecord != NULL) {
-        return serviceRecord->value;
+        deviceObject = serviceRecord->value;
     }
-    return NULL;
+    DevSvcManagerReadUnlock(devSvcManager);
+    return deviceObject;
 }
 
 // only use for kernel space
@@ -305,6 +442,11 @@ bool DevSvcManagerConstruct(struct DevSvcManager *inst)
     }
     DListHeadInit(&inst->services);
     DListHeadInit(&inst->svcstatListeners);
+    inst->serviceBuckets = NULL;
+    inst->bucketCount = 0;
+    inst->serviceCount = 0;
+    OsalAtomicSet(&inst->readers, 0);
+    OsalAtomicSet(&inst->writers, 0);
     return true;
 }
 
@@ -352,6 +494,10 @@ void DevSvcManagerRelease(struct IDevSvcManager *inst)
     DLIST_FOR_EACH_ENTRY_SAFE(record, tmp, &devSvcManager->services, struct DevSvcRecord, entry) {
         DevSvcRecordFreeInstance(record);
     }
+    OsalMemFree(devSvcManager->serviceBuckets);
+    devSvcManager->serviceBuckets = NULL;
+    devSvcManager->bucketCount = 0;
+    devSvcManager->serviceCount = 0;
     OsalMutexDestroy(&devSvcManager->mutex);
 }
 
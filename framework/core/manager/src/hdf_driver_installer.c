@@ -8,6 +8,7 @@
 
 #include "hdf_driver_installer.h"
 #include "devhost_service.h"
+#include "hdf_attribute_manager.h"
 #include "hdf_log.h"
 #include "hdf_object_manager.h"
 
@@ -16,12 +17,16 @@
 static int DriverInstallerStartDeviceHost(uint32_t devHostId, const char *devHostName, bool dynamic)
 {
     struct IDevHostService *hostServiceIf = DevHostServiceNewInstance(devHostId, devHostName);
+    struct DevHostService *hostService = NULL;
     int ret;
     (void)dynamic;
     if ((hostServiceIf == NULL) || (hostServiceIf->StartService == NULL)) {
         HDF_LOGE("hostServiceIf or hostServiceIf->StartService is null");
         return HDF_FAILURE;
     }
+    // a host launching its drivers concurrently changes their power state concurrently too
+    hostService = CONTAINER_OF(hostServiceIf, struct DevHostService, super);
+    hostService->pmWorkers = HdfAttributeManagerGetHostLaunchWorkers(devHostName);
     ret = hostServiceIf->StartService(hostServiceIf);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("failed to start host service, ret: %d", ret);
@@ -7,12 +7,14 @@
  */
 
 #include <unistd.h>
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <fcntl.h>
 #include <cinttypes>
 #include <string>
+#include <vector>
 #include <gtest/gtest.h>
 #include "hdf_io_service.h"
 #include "hdf_log.h"
@@ -905,3 +907,215 @@ HWTEST_F(IoServiceTest, HdfIoService017, TestSize.Level0)
     SvcMgrIoserviceRelease(servmgr);
     HdfSbufRecycle(data);
 }
+
+struct EventOrderListener {
+    struct HdfDevEventlistener listener;
+    std::vector<std::string> received;
+};
+
+static int OnOrderedEventReceived(
+    struct HdfDevEventlistener *listener, struct HdfIoService *service, uint32_t id, struct HdfSBuf *data)
+{
+    (void)service;
+    (void)id;
+    struct EventOrderListener *orderListener = CONTAINER_OF(listener, struct EventOrderListener, listener);
+    const char *string = HdfSbufReadString(data);
+    if (string != nullptr) {
+        orderListener->received.push_back(string);
+    }
+    return 0;
+}
+
+/* *
+ * @tc.name: HdfIoService018
+ * @tc.desc: a burst of events queued before the listener wakes up is delivered completely and in order
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService018, TestSize.Level0)
+{
+    constexpr int burstCount = 64;
+    struct EventOrderListener orderListener;
+    orderListener.listener.onReceive = OnOrderedEventReceived;
+    orderListener.listener.callBack = nullptr;
+    orderListener.listener.priv = nullptr;
+
+    struct HdfIoService *serv = HdfIoServiceBind(testSvcName);
+    ASSERT_NE(serv, nullptr);
+    serv->priv = (void *)"serv";
+    int ret = HdfDeviceRegisterEventListener(serv, &orderListener.listener);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+
+    std::vector<std::string> sent;
+    for (int i = 0; i < burstCount; i++) {
+        sent.push_back("burst_event_" + std::to_string(i));
+        ret = SendEvent(serv, sent.back().c_str(), false);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+
+    usleep(eventWaitTimeUs);
+    ret = HdfDeviceUnregisterEventListener(serv, &orderListener.listener);
+    EXPECT_EQ(ret, HDF_SUCCESS);
+    EXPECT_EQ(orderListener.received, sent);
+    HdfIoServiceRecycle(serv);
+}
+
+/* *
+ * @tc.name: HdfIoService019
+ * @tc.desc: a listener using the shared event ring receives a burst completely and in order
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService019, TestSize.Level0)
+{
+    constexpr int burstCount = 64;
+    struct EventOrderListener orderListener;
+    orderListener.listener.onReceive = OnOrderedEventReceived;
+    orderListener.listener.callBack = nullptr;
+    orderListener.listener.priv = nullptr;
+
+    struct HdfIoService *serv = HdfIoServiceBind(testSvcName);
+    ASSERT_NE(serv, nullptr);
+    serv->priv = (void *)"serv";
+    int ret = HdfDeviceRegisterEventListenerWithFlags(serv, &orderListener.listener, HDF_EVENT_LISTENER_SHARED_RING);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+
+    std::vector<std::string> sent;
+    for (int i = 0; i < burstCount; i++) {
+        sent.push_back("ring_event_" + std::to_string(i));
+        ret = SendEvent(serv, sent.back().c_str(), false);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+
+    usleep(eventWaitTimeUs);
+    ret = HdfDeviceUnregisterEventListener(serv, &orderListener.listener);
+    EXPECT_EQ(ret, HDF_SUCCESS);
+    EXPECT_EQ(orderListener.received, sent);
+    HdfIoServiceRecycle(serv);
+}
+
+struct EventLatencyListener {
+    struct HdfDevEventlistener listener;
+    std::vector<uint64_t> latencyUs;
+    uint64_t lastRecvUs;
+};
+
+static uint64_t NowUs()
+{
+    OsalTimespec time;
+    OsalGetTime(&time);
+    return time.sec * HDF_KILO_UNIT * HDF_KILO_UNIT + time.usec;
+}
+
+static int OnBurstEventReceived(
+    struct HdfDevEventlistener *listener, struct HdfIoService *service, uint32_t id, struct HdfSBuf *data)
+{
+    (void)service;
+    uint32_t seq = 0;
+    uint64_t sendUs = 0;
+    if (id != SAMPLE_DRIVER_SENDEVENT_BURST || !HdfSbufReadUint32(data, &seq) || !HdfSbufReadUint64(data, &sendUs)) {
+        return 0;
+    }
+    struct EventLatencyListener *latency = CONTAINER_OF(listener, struct EventLatencyListener, listener);
+    latency->lastRecvUs = NowUs();
+    latency->latencyUs.push_back(latency->lastRecvUs - sendUs);
+    return 0;
+}
+
+static void RunEventBurstBenchmark(const char *svcName, uint32_t flags, const char *tag)
+{
+    constexpr uint32_t rounds = 50;
+    constexpr uint32_t burstCount = 64;
+    constexpr int waitTimeUs = 200 * 1000;
+    constexpr uint32_t percentile = 99;
+    constexpr uint32_t percent = 100;
+    struct EventLatencyListener latency;
+    latency.listener.onReceive = OnBurstEventReceived;
+    latency.listener.callBack = nullptr;
+    latency.listener.priv = nullptr;
+    latency.lastRecvUs = 0;
+    latency.latencyUs.reserve(rounds * burstCount);
+
+    struct HdfIoService *serv = HdfIoServiceBind(svcName);
+    ASSERT_NE(serv, nullptr);
+    ASSERT_EQ(HdfDeviceRegisterEventListenerWithFlags(serv, &latency.listener, flags), HDF_SUCCESS);
+    struct HdfSBuf *data = HdfSbufObtainDefaultSize();
+    ASSERT_NE(data, nullptr);
+
+    uint64_t startUs = NowUs();
+    for (uint32_t i = 0; i < rounds; i++) {
+        HdfSbufFlush(data);
+        HdfSbufWriteUint32(data, burstCount);
+        EXPECT_EQ(serv->dispatcher->Dispatch(&serv->object, SAMPLE_DRIVER_SENDEVENT_BURST, data, nullptr), HDF_SUCCESS);
+    }
+    usleep(waitTimeUs);
+    EXPECT_EQ(HdfDeviceUnregisterEventListener(serv, &latency.listener), HDF_SUCCESS);
+    HdfSbufRecycle(data);
+    HdfIoServiceRecycle(serv);
+
+    ASSERT_FALSE(latency.latencyUs.empty());
+    std::sort(latency.latencyUs.begin(), latency.latencyUs.end());
+    uint64_t elapsedUs = std::max<uint64_t>(latency.lastRecvUs - startUs, 1);
+    printf("%s: %zu/%u events, %" PRIu64 " events/s, p50 %" PRIu64 " us, p99 %" PRIu64 " us\n", tag,
+        latency.latencyUs.size(), rounds * burstCount,
+        (uint64_t)latency.latencyUs.size() * HDF_KILO_UNIT * HDF_KILO_UNIT / elapsedUs,
+        latency.latencyUs[latency.latencyUs.size() / 2],
+        latency.latencyUs[latency.latencyUs.size() * percentile / percent]);
+}
+
+/* *
+ * @tc.name: HdfIoService020
+ * @tc.desc: event throughput and delivery latency, ioctl reads against the shared event ring
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService020, TestSize.Level1)
+{
+    RunEventBurstBenchmark(testSvcName, 0, "ioctl");
+    RunEventBurstBenchmark(testSvcName, HDF_EVENT_LISTENER_SHARED_RING, "ring");
+}
+
+/* *
+ * @tc.name: HdfIoService021
+ * @tc.desc: services added to and removed from a listening group keep delivering events
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService021, TestSize.Level0)
+{
+    constexpr int servCount = 16;
+    struct HdfIoServiceGroup *group = HdfIoServiceGroupObtain();
+    ASSERT_NE(group, nullptr);
+    struct HdfIoService *serv[servCount] = { nullptr };
+    serv[0] = HdfIoServiceBind(testSvcName);
+    ASSERT_NE(serv[0], nullptr);
+    serv[0]->priv = (void *)"serv0";
+    int ret = HdfIoServiceGroupAddService(group, serv[0]);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    ret = HdfIoServiceGroupRegisterListener(group, &listener0.listener);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+
+    for (int i = 1; i < servCount; i++) {
+        serv[i] = HdfIoServiceBind(testSvcName);
+        ASSERT_NE(serv[i], nullptr);
+        serv[i]->priv = (void *)"servN";
+        ret = HdfIoServiceGroupAddService(group, serv[i]);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+    ret = SendEvent(serv[servCount - 1], testSvcName, false);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    usleep(eventWaitTimeUs);
+    EXPECT_EQ(1, listener0.eventCount);
+
+    for (int i = servCount - 1; i > 0; i--) {
+        HdfIoServiceGroupRemoveService(group, serv[i]);
+        HdfIoServiceRecycle(serv[i]);
+    }
+    ret = SendEvent(serv[0], testSvcName, false);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    usleep(eventWaitTimeUs);
+    EXPECT_EQ(2, listener0.eventCount);
+
+    HdfIoServiceGroupRecycle(group);
+    HdfIoServiceRecycle(serv[0]);
+}
@@ -15,5 +15,6 @@
 const struct DeviceResourceNode *HdfGetHcsRootNode(void);
 bool HdfAttributeManagerGetHostList(struct HdfSList *hostList);
 int HdfAttributeManagerGetDeviceList(struct DevHostServiceClnt *hostClnt);
+uint16_t HdfAttributeManagerGetHostLaunchWorkers(const char *hostName);
 
 #endif /* HDF_ATTRIBUTE_MANAGER_H */
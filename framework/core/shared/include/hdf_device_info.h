@@ -35,6 +35,9 @@ struct HdfDeviceInfo {
     const char *moduleName;
     const char *svcName;
     const char *deviceMatchAttr;
+    const char **depends;       // services of the same host to launch before this device
+    uint16_t dependNum;
+    uint16_t launchDepth;       // length of the depends chain launched before it inside its priority
 };
 
 struct HdfPrivateInfo {
@@ -26,6 +26,7 @@ extern "C" {
 #define HDF_LISTEN_EVENT_STOP _IO('b', 4)
 #define HDF_LISTEN_EVENT_WAKEUP _IO('b', 5)
 #define HDF_LISTEN_EVENT_EXIT _IO('b', 6)
+#define HDF_READ_DEV_EVENTS _IO('b', 7)
 
 typedef enum {
     DEVMGR_LOAD_SERVICE = 0,
@@ -45,6 +46,45 @@ struct HdfWriteReadBuf {
     int32_t cmdCode;
 };
 
+/*
+ * HDF_READ_DEV_EVENTS fills readBuffer with as many queued events as fit, each one a header followed by
+ * its data padded to 4 bytes. readConsumed is the number of bytes filled and cmdCode the number of events.
+ */
+struct HdfDevEventHeader {
+    int32_t cmdCode;
+    uint32_t size;
+};
+
+#define HDF_DEV_EVENT_RING_MAGIC       0x48524e47 // "HRNG"
+#define HDF_DEV_EVENT_RING_HEADER_SIZE 64
+#define HDF_DEV_EVENT_RING_ALIGN       8
+#define HDF_DEV_EVENT_RING_PAD         0xFFFFFFFFU
+
+/*
+ * Event ring shared with listeners by mmap() at offset 0 of a service node, records start
+ * HDF_DEV_EVENT_RING_HEADER_SIZE bytes after this header. The driver appends records (HdfDevEventHeader
+ * followed by the event data, padded to HDF_DEV_EVENT_RING_ALIGN) at tail, listeners consume them from head.
+ * A record with size HDF_DEV_EVENT_RING_PAD fills the end of the ring before it wraps around.
+ *
+ * Positions run freely and wrap at 2^32, a multiple of the size, which is a power of two. The driver accesses
+ * head, tail and dropped as OsalAtomic counters: tail is set with release order after the record is written,
+ * and head is read with acquire order before the space it frees is reused.
+ */
+struct HdfDevEventRing {
+    uint32_t magic;
+    uint32_t size;    // bytes available for records, a power of two
+    uint32_t head;    // consumed position, advanced by listeners
+    uint32_t tail;    // produced position, advanced by the driver
+    uint32_t dropped; // events dropped because the ring was full
+};
+
+/*
+ * Data buffer shared with one client by mmap() at HDF_IO_SHARED_BUF_OFFSET of a service node. Requests of
+ * the client may refer to bytes in it by offset, so that the driver reads and writes them in place.
+ */
+#define HDF_IO_SHARED_BUF_OFFSET   0x40000000
+#define HDF_IO_SHARED_BUF_MAX_SIZE (4 * 1024 * 1024)
+
 struct HdfIoService *HdfIoServicePublish(const char *serviceName, uint32_t mode);
 void HdfIoServiceRemove(struct HdfIoService *service);
 
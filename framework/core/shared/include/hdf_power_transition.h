@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HDF_POWER_TRANSITION_H
+#define HDF_POWER_TRANSITION_H
+
+#include "hdf_task_queue.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+
+#define HDF_PM_TRANSITION_WORKERS_MAX 4
+#define HDF_PM_TRANSITION_TIMEOUT_MS 1000
+
+struct HdfPmJob;
+struct HdfPmTransition;
+typedef int (*HdfPmJobFunc)(struct HdfPmJob *job, uint32_t powerState);
+
+struct HdfPmJob {
+    struct HdfTaskType task;
+    struct HdfPmTransition *transition;
+    HdfPmJobFunc func;
+    void *priv;
+    const char *name;
+    uint32_t level;
+    bool serial;        // runs alone in its place of the array, whatever the levels around it
+    int ret;
+    uint32_t costUs;
+    bool done;
+};
+
+/*
+ * A power state change of a set of jobs, each one a host or a device. Jobs run in the order of the array,
+ * a job whose level differs from the one before it starts once all the jobs before it are done, and jobs
+ * of the same level run concurrently on up to workers threads, but for serial ones. The caller orders the
+ * array: levels ascending to wake up, descending to suspend. With one worker the jobs run in array order.
+ *
+ * A level still running after timeoutMs has its pending jobs reported, and again each time timeoutMs
+ * elapses, but the transition keeps waiting for them as a job cannot be cancelled. When all levels are
+ * done the slowest job of every level, which is the critical path of the transition, is reported.
+ */
+struct HdfPmTransition {
+    const char *name;
+    uint32_t powerState;
+    struct HdfPmJob *jobs;
+    uint32_t jobNum;
+    uint32_t workers;
+    uint32_t timeoutMs;
+    struct OsalMutex mutex;
+    struct OsalSem done;
+};
+
+int HdfPmTransitionRun(struct HdfPmTransition *transition);
+
+#endif /* HDF_POWER_TRANSITION_H */
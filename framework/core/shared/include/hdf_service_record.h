@@ -14,6 +14,7 @@
 
 struct DevSvcRecord {
     struct DListHead entry;
+    struct DListHead hashEntry;
     uint32_t key;
     struct HdfDeviceObject *value;
     const char *servName;
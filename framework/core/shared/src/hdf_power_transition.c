@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_power_transition.h"
+#include "hdf_log.h"
+#include "osal_time.h"
+
+#define HDF_LOG_TAG hdf_power_transition
+
+#define HDF_PM_US_PER_SECOND  1000000
+#define HDF_PM_WAIT_RETRY_MAX 3
+#define HDF_PM_POLL_MS        10
+
+static uint32_t HdfPmTimeDiffUs(const OsalTimespec *start, const OsalTimespec *end)
+{
+    OsalTimespec diff = {0};
+
+    if (OsalDiffTime(start, end, &diff) != HDF_SUCCESS) {
+        return 0;
+    }
+    return (uint32_t)(diff.sec * HDF_PM_US_PER_SECOND + diff.usec);
+}
+
+static int32_t HdfPmJobRun(struct HdfTaskType *task)
+{
+    OsalTimespec start = {0};
+    OsalTimespec end = {0};
+    struct HdfPmJob *job = CONTAINER_OF(task, struct HdfPmJob, task);
+    struct HdfPmTransition *transition = job->transition;
+
+    (void)OsalGetTime(&start);
+    job->ret = job->func(job, transition->powerState);
+    (void)OsalGetTime(&end);
+    job->costUs = HdfPmTimeDiffUs(&start, &end);
+
+    // posted under the mutex, so that a job seen done by HdfPmTransitionPollLevel no longer uses the semaphore
+    (void)OsalMutexLock(&transition->mutex);
+    job->done = true;
+    (void)OsalSemPost(&transition->done);
+    (void)OsalMutexUnlock(&transition->mutex);
+    return HDF_SUCCESS;
+}
+
+static void HdfPmTransitionReportPending(struct HdfPmTransition *transition, uint32_t begin, uint32_t end,
+    uint32_t waitMs)
+{
+    uint32_t i;
+
+    (void)OsalMutexLock(&transition->mutex);
+    for (i = begin; i < end; i++) {
+        if (!transition->jobs[i].done) {
+            HDF_LOGW("%s: %s still in power state %u after %u ms", transition->name, transition->jobs[i].name,
+                transition->powerState, waitMs);
+        }
+    }
+    (void)OsalMutexUnlock(&transition->mutex);
+}
+
+// waits for the jobs of a level by their done flags, once the semaphore can not be waited on any more
+static void HdfPmTransitionPollLevel(struct HdfPmTransition *transition, uint32_t begin, uint32_t end)
+{
+    uint32_t i = begin;
+
+    while (i < end) {
+        (void)OsalMutexLock(&transition->mutex);
+        while (i < end && transition->jobs[i].done) {
+            i++;
+        }
+        (void)OsalMutexUnlock(&transition->mutex);
+        if (i < end) {
+            OsalMSleep(HDF_PM_POLL_MS);
+        }
+    }
+}
+
+/*
+ * Jobs run inline are done when they return, queued ones are counted by the semaphore. A failed wait, such as
+ * an interrupted one, is retried a few times, then the level is polled to its end and HDF_FAILURE returned.
+ */
+static int32_t HdfPmTransitionRunLevel(struct HdfPmTransition *transition, struct HdfTaskQueue *queue,
+    uint32_t begin, uint32_t end)
+{
+    int32_t ret;
+    uint32_t i;
+    uint32_t waitMs = 0;
+    uint32_t failures = 0;
+    uint32_t pending = (queue != NULL) ? (end - begin) : 0;
+    uint32_t timeoutMs = (transition->timeoutMs == 0) ? HDF_WAIT_FOREVER : transition->timeoutMs;
+
+    for (i = begin; i < end; i++) {
+        if (queue != NULL) {
+            HdfTaskEnqueue(queue, &transition->jobs[i].task);
+        } else {
+            (void)HdfPmJobRun(&transition->jobs[i].task);
+        }
+    }
+    while (pending > 0) {
+        ret = OsalSemWait(&transition->done, timeoutMs);
+        if (ret == HDF_SUCCESS) {
+            pending--;
+            failures = 0;
+        } else if (ret == HDF_ERR_TIMEOUT) {
+            waitMs += timeoutMs;
+            HdfPmTransitionReportPending(transition, begin, end, waitMs);
+        } else if (++failures >= HDF_PM_WAIT_RETRY_MAX) {
+            HDF_LOGE("%s: wait for power state %u failed: %d, poll the jobs", transition->name,
+                transition->powerState, ret);
+            HdfPmTransitionPollLevel(transition, begin, end);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+static uint32_t HdfPmTransitionSlowest(const struct HdfPmTransition *transition, uint32_t begin, uint32_t end)
+{
+    uint32_t i;
+    uint32_t slowest = begin;
+
+    for (i = begin; i < end; i++) {
+        if (transition->jobs[i].costUs > transition->jobs[slowest].costUs) {
+            slowest = i;
+        }
+    }
+    return slowest;
+}
+
+int HdfPmTransitionRun(struct HdfPmTransition *transition)
+{
+    uint32_t begin;
+    uint32_t end;
+    uint32_t slowest;
+    uint32_t criticalUs = 0;
+    uint32_t workers;
+    int ret = HDF_SUCCESS;
+    OsalTimespec start = {0};
+    OsalTimespec stop = {0};
+    struct HdfTaskQueue *queue = NULL;
+
+    if (transition == NULL || (transition->jobs == NULL && transition->jobNum > 0)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (OsalMutexInit(&transition->mutex) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    if (OsalSemInit(&transition->done, 0) != HDF_SUCCESS) {
+        (void)OsalMutexDestroy(&transition->mutex);
+        return HDF_FAILURE;
+    }
+    workers = (transition->workers > transition->jobNum) ? transition->jobNum : transition->workers;
+    if (workers > 1) {
+        queue = HdfTaskQueueCreatePool(HdfPmJobRun, transition->name, workers);
+        if (queue == NULL) {
+            HDF_LOGW("%s: failed to create workers, change power state one by one", transition->name);
+        }
+    }
+
+    (void)OsalGetTime(&start);
+    for (begin = 0; begin < transition->jobNum; begin = end) {
+        for (end = begin; end < transition->jobNum && transition->jobs[end].level == transition->jobs[begin].level;
+            end++) {
+            if (end > begin && (transition->jobs[end].serial || transition->jobs[begin].serial)) {
+                break;
+            }
+            transition->jobs[end].transition = transition;
+            transition->jobs[end].done = false;
+        }
+        if (HdfPmTransitionRunLevel(transition, queue, begin, end) != HDF_SUCCESS) {
+            // the workers are idle, the rest runs inline without the semaphore
+            HdfTaskQueueDestroy(queue);
+            queue = NULL;
+            ret = HDF_FAILURE;
+        }
+        slowest = HdfPmTransitionSlowest(transition, begin, end);
+        criticalUs += transition->jobs[slowest].costUs;
+        HDF_LOGI("%s: level %u of power state %u held by %s for %u us", transition->name,
+            transition->jobs[begin].level, transition->powerState, transition->jobs[slowest].name,
+            transition->jobs[slowest].costUs);
+    }
+    (void)OsalGetTime(&stop);
+    if (queue != NULL) {
+        HdfTaskQueueDestroy(queue);
+    }
+    HDF_LOGI("%s: power state %u of %u jobs done in %u us, critical path %u us", transition->name,
+        transition->powerState, transition->jobNum, HdfPmTimeDiffUs(&start, &stop), criticalUs);
+
+    for (begin = 0; begin < transition->jobNum; begin++) {
+        if (transition->jobs[begin].ret != HDF_SUCCESS) {
+            ret = HDF_FAILURE;
+        }
+    }
+    (void)OsalSemDestroy(&transition->done);
+    (void)OsalMutexDestroy(&transition->mutex);
+    return ret;
+}
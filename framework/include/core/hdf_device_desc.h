@@ -312,6 +312,19 @@ int32_t HdfDeviceSendEvent(const struct HdfDeviceObject *deviceObject, uint32_t
  * @since 1.0 */
 int32_t HdfDeviceSendEventToClient(const struct HdfDeviceIoClient *client, uint32_t id, const struct HdfSBuf *data);
 
+/**
+ * @brief Obtains the data buffer a user-level client object has mapped from its service node.
+ *
+ * The buffer is mapped with {@link HdfIoServiceMapSharedBuffer}. Requests of the client may refer to data in it
+ * by offset, which the driver must check against the returned size. The buffer stays valid as long as the client.
+ *
+ * @param client Indicates the pointer to the client object of the driver service.
+ * @param size Indicates the pointer to receive the size of the buffer.
+ *
+ * @return Returns the address of the buffer; returns <b>NULL</b> if the client has not mapped one.
+ * @since 1.0 */
+void *HdfDeviceGetClientSharedBuf(const struct HdfDeviceIoClient *client, uint32_t *size);
+
 /**
  * @brief Sets the driver device class.
  *
@@ -233,6 +233,22 @@ struct HdfIoService *HdfIoServiceBind(const char *serviceName);
  */
 void HdfIoServiceRecycle(struct HdfIoService *service);
 
+/**
+ * @brief Maps a data buffer shared with a driver service object.
+ *
+ * Requests to the service may refer to data in the buffer by offset instead of carrying a copy of it,
+ * if the service supports that. The buffer is mapped by the first call, later calls return it if it is
+ * large enough, and it is unmapped by {@link HdfIoServiceRecycle}.
+ *
+ * @param service Indicates the pointer to the driver service object obtained through {@link HdfIoServiceBind}.
+ * @param size Indicates the size of the buffer, which is at most 4 MB.
+ * @return Returns the address of the buffer; returns <b>NULL</b> if the service node cannot share memory,
+ * requests then carry copies of the data as before.
+ *
+ * @since 1.0
+ */
+void *HdfIoServiceMapSharedBuffer(struct HdfIoService *service, uint32_t size);
+
 /**
  * @brief Registers a custom {@link HdfDevEventlistener} for listening for events reported
  * by a specified driver service object.
@@ -246,6 +262,31 @@ void HdfIoServiceRecycle(struct HdfIoService *service);
  */
 int HdfDeviceRegisterEventListener(struct HdfIoService *target, struct HdfDevEventlistener *listener);
 
+/**
+ * @brief Enumerates the options of {@link HdfDeviceRegisterEventListenerWithFlags}.
+ *
+ * @since 1.0
+ */
+enum HdfEventListenerFlag {
+    /** Receives events through a ring buffer shared with the driver instead of one ioctl per event.
+     * The listener falls back to the ioctl path if the driver side cannot map the ring. */
+    HDF_EVENT_LISTENER_SHARED_RING = 1 << 0,
+};
+
+/**
+ * @brief Registers a custom {@link HdfDevEventlistener} like {@link HdfDeviceRegisterEventListener},
+ * with options selecting how events are transferred from the driver service.
+ *
+ * @param target Indicates the pointer to the driver service object to listen.
+ * @param listener Indicates the pointer to the listener to register.
+ * @param flags Indicates a combination of {@link HdfEventListenerFlag} values.
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ */
+int HdfDeviceRegisterEventListenerWithFlags(
+    struct HdfIoService *target, struct HdfDevEventlistener *listener, uint32_t flags);
+
 /**
  * @brief Unregisters a previously registered {@link HdfDevEventlistener} to release resources
  * if it is no longer required.
@@ -122,6 +122,87 @@ typedef struct {
  */
 #define OsalAtomicDecReturn(v) OsalAtomicDecRetWrapper(v)
 
+/**
+ * @brief Reads the counter of an atomic. Memory accesses after the read are not reordered before it.
+ *
+ * Pairs with {@link OsalAtomicSetRelease}, so that data written before the counter was set is seen after
+ * the counter is read.
+ *
+ * @param v Indicates the pointer to the atomic {@link OsalAtomic}.
+ *
+ * @return Returns the counter.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+#define OsalAtomicReadAcquire(v) OsalAtomicReadAcquireWrapper(v)
+
+/**
+ * @brief Sets the counter for an atomic. Memory accesses before the set are not reordered after it.
+ *
+ * @param v Indicates the pointer to the atomic {@link OsalAtomic}.
+ * @param counter Indicates the counter to set.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+#define OsalAtomicSetRelease(v, counter) OsalAtomicSetReleaseWrapper(v, counter)
+
+/**
+ * @brief Sets the counter of an atomic to newCounter if it equals oldCounter, as one atomic operation that
+ * is fully ordered against other memory accesses.
+ *
+ * @param v Indicates the pointer to the atomic {@link OsalAtomic}.
+ * @param oldCounter Indicates the counter the atomic is expected to have.
+ * @param newCounter Indicates the counter to set.
+ *
+ * @return Returns the counter before the operation, the set took place if it equals oldCounter.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+#define OsalAtomicCmpXchg(v, oldCounter, newCounter) OsalAtomicCmpXchgWrapper(v, oldCounter, newCounter)
+
+/**
+ * @brief Sets a pointer to newPtr and returns its previous value, as one atomic operation that is fully
+ * ordered against other memory accesses.
+ *
+ * @param p Indicates the address of the pointer.
+ * @param newPtr Indicates the pointer value to set.
+ *
+ * @return Returns the pointer value before the operation.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+#define OsalAtomicPtrXchg(p, newPtr) OsalAtomicPtrXchgWrapper(p, newPtr)
+
+/**
+ * @brief Reads a pointer. Memory accesses after the read are not reordered before it.
+ *
+ * Pairs with {@link OsalAtomicPtrSetRelease} and {@link OsalAtomicPtrXchg}, so that the data a pointer was
+ * set to refer to is seen after the pointer is read.
+ *
+ * @param p Indicates the address of the pointer.
+ *
+ * @return Returns the pointer value.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+#define OsalAtomicPtrReadAcquire(p) OsalAtomicPtrReadAcquireWrapper(p)
+
+/**
+ * @brief Sets a pointer. Memory accesses before the set are not reordered after it.
+ *
+ * @param p Indicates the address of the pointer.
+ * @param newPtr Indicates the pointer value to set.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+#define OsalAtomicPtrSetRelease(p, newPtr) OsalAtomicPtrSetReleaseWrapper(p, newPtr)
+
 /**
  * @brief Tests the value of a specified bit of a variable.
  *
@@ -30,6 +30,8 @@ struct OsalCdevOps {
     long (*ioctl)(struct file* filep, unsigned int cmd, unsigned long arg);
     int (*open)(struct OsalCdev* cdev, struct file* filep);
     int (*release)(struct OsalCdev* cdev, struct file* filep);
+    /* returns memory from OsalCdevAllocShared() to map at the page aligned offset, or NULL to refuse the mapping */
+    void *(*mmap)(struct file* filep, uint64_t offset, size_t size);
 };
 
 struct OsalCdev* OsalAllocCdev(const struct OsalCdevOps* fops);
@@ -39,6 +41,9 @@ void OsalFreeCdev(struct OsalCdev* cdev);
 
 void* OsalGetCdevPriv(struct OsalCdev* cdev);
 
+void* OsalCdevAllocShared(size_t size);
+void OsalCdevFreeShared(void* addr);
+
 void OsalSetFilePriv(struct file* filep, void *priv);
 void* OsalGetFilePriv(struct file* filep);
 
@@ -80,6 +80,12 @@ int32_t CanBusSendMsg(DevHandle handle, const struct CanMsg *msg);
 
 int32_t CanBusReadMsg(DevHandle handle, struct CanMsg *msg, uint32_t tms);
 
+/* Send count frames under one bus lock, returns the number of frames sent or a negative error if none was. */
+int32_t CanBusSendMsgs(DevHandle handle, const struct CanMsg *msgs, uint32_t count);
+
+/* Read up to count frames within tms in total, returns the number of frames read or an error if none was. */
+int32_t CanBusReadMsgs(DevHandle handle, struct CanMsg *msgs, uint32_t count, uint32_t tms);
+
 int32_t CanBusAddFilter(DevHandle handle, const struct CanFilter *filter);
 
 int32_t CanBusDelFilter(DevHandle handle, const struct CanFilter *filter);
@@ -78,6 +78,8 @@ enum GpioIrqType {
     GPIO_IRQ_TRIGGER_LOW = OSAL_IRQF_TRIGGER_LOW,
     /** execute interrupt service routine in thread context */
     GPIO_IRQ_USING_THREAD = (0x1 << 8),
+    /** with GPIO_IRQ_USING_THREAD, execute in the normal priority threads instead of the highest priority ones */
+    GPIO_IRQ_THREAD_NORMAL_PRIORITY = (0x1 << 9),
 };
 
 /**
@@ -121,6 +123,37 @@ int32_t GpioRead(uint16_t gpio, uint16_t *val);
  */
 int32_t GpioWrite(uint16_t gpio, uint16_t val);
 
+/**
+ * @brief Reads the level values of several GPIO pins of a controller at a time.
+ *
+ * Bit n of the mask selects the GPIO pin numbered gpio + n. All selected pins must belong to the controller of
+ * the pin gpio, and must have been set to input by {@link GpioSetDir}.
+ *
+ * @param gpio Indicates the GPIO pin number of bit 0.
+ * @param mask Indicates the mask of the pins to read.
+ * @param val Indicates the pointer to the read level values, bit n is set if the pin gpio + n is {@link GPIO_VAL_HIGH}.
+ *
+ * @return Returns <b>0</b> if the GPIO pin level values are successfully read; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t GpioReadMulti(uint16_t gpio, uint32_t mask, uint32_t *val);
+
+/**
+ * @brief Writes the level values for several GPIO pins of a controller at a time.
+ *
+ * Bit n of the mask selects the GPIO pin numbered gpio + n. All selected pins must belong to the controller of
+ * the pin gpio, and must have been set to output by {@link GpioSetDir}. The pins are written in one operation
+ * if the controller supports it, otherwise one by one.
+ *
+ * @param gpio Indicates the GPIO pin number of bit 0.
+ * @param mask Indicates the mask of the pins to write.
+ * @param val Indicates the level values to be written, bit n set for {@link GPIO_VAL_HIGH} of the pin gpio + n.
+ *
+ * @return Returns <b>0</b> if the GPIO pin level values are successfully written; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t GpioWriteMulti(uint16_t gpio, uint32_t mask, uint32_t val);
+
 /**
  * @brief Sets the input/output direction for a GPIO pin.
  *
@@ -136,6 +136,87 @@ void I2cClose(DevHandle handle);
  */
 int32_t I2cTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t count);
 
+/**
+ * @brief Enumerates the priorities of asynchronous I2C transfers.
+ *
+ * Queued transfers of a higher priority are executed before any of a lower priority.
+ *
+ * @since 1.0
+ */
+enum I2cTransferPriority {
+    I2C_TRANSFER_PRI_HIGH = 0,    /**< For latency sensitive devices such as touch panels. */
+    I2C_TRANSFER_PRI_NORMAL,      /**< Default priority. */
+    I2C_TRANSFER_PRI_LOW,         /**< For background accesses such as calibration or logging. */
+    I2C_TRANSFER_PRI_MAX,
+};
+
+struct I2cTransferReq;
+
+/**
+ * @brief Defines the function called when an asynchronous I2C transfer completes.
+ *
+ * @param req Indicates the pointer to the submitted request.
+ * @param ret Indicates the number of transferred messages on success, or a negative value on failure.
+ *
+ * @since 1.0
+ */
+typedef void (*I2cTransferCallback)(struct I2cTransferReq *req, int32_t ret);
+
+/**
+ * @brief Defines an asynchronous I2C transfer request.
+ *
+ * The request and the messages it points to belong to the I2C controller from a successful
+ * {@link I2cTransferAsync} until its callback is called, and must not be changed or freed in between.
+ *
+ * @since 1.0
+ */
+struct I2cTransferReq {
+    /** Pointer to the I2C transfer message structure array */
+    struct I2cMsg *msgs;
+    /** Length of the message structure array */
+    int16_t count;
+    /** Priority of the transfer, see {@link I2cTransferPriority} */
+    uint16_t priority;
+    /** Called in the worker thread of the controller when the transfer completes, must not block long */
+    I2cTransferCallback callback;
+    /** Private data of the caller */
+    void *data;
+};
+
+/**
+ * @brief Queues a transfer to an I2C device and returns without waiting for it.
+ *
+ * The requests of a controller are executed in priority order by a worker thread of the controller, a few
+ * of them in a row under one hold of the controller, so drivers sharing a bus can have register accesses
+ * in flight instead of blocking their own threads. Only available in kernel space.
+ *
+ * @param handle Indicates the pointer to the device handle of the I2C controller obtained via {@link I2cOpen}.
+ * @param req Indicates the pointer to the transfer request, see {@link I2cTransferReq}.
+ *
+ * @return Returns <b>0</b> if the request is queued, its callback will be called once; returns a negative
+ * value otherwise, and the callback will not be called.
+ *
+ * @since 1.0
+ */
+int32_t I2cTransferAsync(DevHandle handle, struct I2cTransferReq *req);
+
+/**
+ * @brief Maps a buffer shared with the I2C service, to transfer large messages without copying them.
+ *
+ * Messages whose buffers lie in the shared buffer are read and written in place by the service, other messages
+ * are copied as usual. The buffer is mapped once for the process, later calls return it if it is large enough.
+ * This function is meaningful in user space only, drivers in kernel space transfer their own buffers directly.
+ *
+ * @param handle Indicates the handle of the I2C controller obtained via {@link I2cOpen}.
+ * @param size Indicates the size of the buffer, which is at most 4 MB.
+ *
+ * @return Returns the address of the buffer; returns <b>NULL</b> if it cannot be mapped, messages are then
+ * copied as before.
+ *
+ * @since 1.0
+ */
+void *I2cMapSharedBuffer(DevHandle handle, uint32_t size);
+
 /**
  * @brief Enumerates I2C I/O commands.
  *
@@ -145,8 +226,16 @@ enum I2cIoCmd {
     I2C_IO_TRANSFER = 0,      /**< Execute one or more I2C messages. */
     I2C_IO_OPEN = 1,          /**< Open the I2C device. */
     I2C_IO_CLOSE = 2,         /**< Close the I2C device. */
+    I2C_IO_TRANSFER_SHARED = 3, /**< Execute I2C messages referring to the shared buffer by offset. */
 };
 
+/**
+ * @brief Offset of a message which does not use the shared buffer in {@link I2C_IO_TRANSFER_SHARED}.
+ *
+ * @since 1.0
+ */
+#define I2C_IO_NOT_SHARED 0xFFFFFFFFU
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -250,6 +250,23 @@ int32_t SpiSetCfg(DevHandle handle, struct SpiCfg *cfg);
  */
 int32_t SpiGetCfg(DevHandle handle, struct SpiCfg *cfg);
 
+/**
+ * @brief Maps a buffer shared with the SPI service, to transfer large messages without copying them.
+ *
+ * Message buffers which lie in the shared buffer are read and written in place by the service, other buffers
+ * are copied as usual. The buffer is mapped once for the handle, later calls return it if it is large enough.
+ * This function is meaningful in user space only, drivers in kernel space transfer their own buffers directly.
+ *
+ * @param handle Indicates the pointer to the SPI device handle obtained via {@link SpiOpen}.
+ * @param size Indicates the size of the buffer, which is at most 4 MB.
+ *
+ * @return Returns the address of the buffer; returns <b>NULL</b> if it cannot be mapped, messages are then
+ * copied as before.
+ *
+ * @since 1.0
+ */
+void *SpiMapSharedBuffer(DevHandle handle, uint32_t size);
+
 /**
  * @brief Enumerates SPI I/O commands.
  *
@@ -261,8 +278,16 @@ enum SpiIoCmd {
     SPI_IO_TRANSFER,        /**< Execute one or more SPI messages. */
     SPI_IO_SET_CONFIG,      /**< Set the configurations. */
     SPI_IO_GET_CONFIG,      /**< Get the configurations. */
+    SPI_IO_TRANSFER_SHARED, /**< Execute SPI messages referring to the shared buffer by offset. */
 };
 
+/**
+ * @brief Offset of a message buffer which does not use the shared buffer in {@link SPI_IO_TRANSFER_SHARED}.
+ *
+ * @since 1.0
+ */
+#define SPI_IO_NOT_SHARED 0xFFFFFFFFU
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -256,6 +256,7 @@ enum UartIoCmd {
     UART_IO_GET_ATTRIBUTE,   /**< Obtain the device attributes. */
     UART_IO_SET_ATTRIBUTE,   /**< Set the device attributes. */
     UART_IO_SET_TRANSMODE,   /**< Set the transmission mode. */
+    UART_IO_READ_STREAM,     /**< Take the data buffered in the receive ring. */
 };
 
 /**
@@ -294,6 +295,23 @@ void UartClose(DevHandle handle);
  */
 int32_t UartRead(DevHandle handle, uint8_t *data, uint32_t size);
 
+/**
+ * @brief Reads the data already received by a UART device, without waiting for more.
+ *
+ * The data is taken from the receive ring of the UART controller, so that streams read in small chunks do not
+ * go down to the controller for every read. A reader may wait for data by listening to the events of the UART
+ * service, which reports new data with {@link PLATFORM_LISTENER_EVENT_UART_RX_NOTIFY}.
+ *
+ * @param handle Indicates the pointer to the UART device handle, which is obtained via {@link UartOpen}.
+ * @param data Indicates the pointer to the buffer for receiving the data.
+ * @param size Indicates the size of the buffer.
+ *
+ * @return Returns the size of the data read, which is <b>0</b> if nothing has been received; returns a negative
+ * number if the reading fails or the UART controller has no receive ring.
+ * @since 1.0
+ */
+int32_t UartReadStream(DevHandle handle, uint8_t *data, uint32_t size);
+
 /**
  * @brief Writes data of a specified size into a UART device.
  *
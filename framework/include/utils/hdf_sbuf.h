@@ -311,6 +311,67 @@ const char16_t *HdfSbufReadString16(struct HdfSBuf *sbuf);
  */
 bool HdfSbufReadBuffer(struct HdfSBuf *sbuf, const void **data, uint32_t *readSize);
 
+/**
+ * @brief Defines the function called for every contiguous segment of a <b>SBuf</b>.
+ *
+ * @param priv Indicates the private data passed to {@link HdfSbufForEachSegment}.
+ * @param data Indicates the pointer to the segment.
+ * @param size Indicates the size of the segment.
+ * @return Returns <b>0</b> to continue with the next segment; returns any other value to stop.
+ *
+ * @since 1.0
+ */
+typedef int32_t (*HdfSbufSegmentFunc)(void *priv, const uint8_t *data, size_t size);
+
+/**
+ * @brief Writes a data segment to a <b>SBuf</b> by reference, without copying it.
+ *
+ * The <b>SBuf</b> records a pointer to the caller's memory, which must stay valid and unchanged until the
+ * <b>SBuf</b> is flushed or recycled. The data is copied only when the <b>SBuf</b> has to be contiguous,
+ * for example when it is passed to the kernel, copied, or read with {@link HdfSbufReadBuffer}.
+ * Readers can still use {@link HdfSbufReadBuffer}; {@link HdfSbufReadBufferRef} returns the caller's
+ * memory directly. Small segments, and <b>SBuf</b>s that do not support references, are copied immediately.
+ *
+ * @param sbuf Indicates the pointer to the target <b>SBuf</b>.
+ * @param data Indicates the pointer to the data segment to reference.
+ * @param writeSize Indicates the size of the data segment.
+ * @return Returns <b>true</b> if the operation is successful; returns <b>false</b> otherwise.
+ *
+ * @since 1.0
+ */
+bool HdfSbufWriteBufferRef(struct HdfSBuf *sbuf, const void *data, uint32_t writeSize);
+
+/**
+ * @brief Reads a data segment from a <b>SBuf</b> without flattening it.
+ *
+ * If the segment was written with {@link HdfSbufWriteBufferRef} and has not been copied yet, the returned
+ * pointer refers to the writer's memory. Otherwise this function behaves the same as {@link HdfSbufReadBuffer}.
+ *
+ * @param sbuf Indicates the pointer to the target <b>SBuf</b>.
+ * @param data Indicates the double pointer to the data segment read.
+ * @param readSize Indicates the pointer to the size of the data segment read.
+ * @return Returns <b>true</b> if the operation is successful; returns <b>false</b> otherwise.
+ *
+ * @since 1.0
+ */
+bool HdfSbufReadBufferRef(struct HdfSBuf *sbuf, const void **data, uint32_t *readSize);
+
+/**
+ * @brief Visits the data of a <b>SBuf</b> as a sequence of contiguous segments, in order.
+ *
+ * Segments written by reference are visited in place, so the data can be gathered into its destination
+ * without flattening the <b>SBuf</b> first.
+ *
+ * @param sbuf Indicates the pointer to the target <b>SBuf</b>.
+ * @param func Indicates the function called for every segment.
+ * @param priv Indicates the private data passed to <b>func</b>.
+ * @return Returns <b>0</b> if all segments are visited; returns the value returned by <b>func</b> or a negative
+ * value otherwise.
+ *
+ * @since 1.0
+ */
+int32_t HdfSbufForEachSegment(struct HdfSBuf *sbuf, HdfSbufSegmentFunc func, void *priv);
+
 /**
  * @brief Reads unpadded data from a <b>SBuf</b>.
  *
@@ -481,6 +542,39 @@ void HdfSbufSetDataSize(struct HdfSBuf *sbuf, size_t size);
  */
 struct HdfSBuf *HdfSbufObtain(size_t capacity);
 
+/**
+ * @brief Defines the hit and miss counters of the calling thread's <b>SBuf</b> pool.
+ *
+ * @since 1.0
+ */
+struct HdfSbufPoolStat {
+    uint32_t hits;   /**< Number of obtains served from the pool */
+    uint32_t misses; /**< Number of obtains that had to allocate a new <b>SBuf</b> */
+};
+
+/**
+ * @brief Obtains a <b>SBuf</b> instance from the calling thread's size-classed pool.
+ *
+ * The returned <b>SBuf</b> is released with {@link HdfSbufRecycle}, which puts it back into the pool of the
+ * recycling thread when that pool has room. On builds without thread-local pools this is the same as
+ * {@link HdfSbufObtain}.
+ *
+ * @param capacity Indicates the minimum initial capacity of the <b>SBuf</b>.
+ * @return Returns the <b>SBuf</b> instance.
+ *
+ * @since 1.0
+ */
+struct HdfSBuf *HdfSbufObtainPooled(size_t capacity);
+
+/**
+ * @brief Obtains the pool counters of the calling thread.
+ *
+ * @param stat Indicates the pointer to the counters to fill in.
+ *
+ * @since 1.0
+ */
+void HdfSbufGetPoolStat(struct HdfSbufPoolStat *stat);
+
 /**
  * @brief Obtains a <b>SBuf</b> instance of the default capacity (256 bytes).
  *
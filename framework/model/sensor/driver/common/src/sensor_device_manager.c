@@ -97,7 +97,7 @@ int32_t ReportSensorEvent(const struct SensorReportEvent *events)
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_ERR_INVALID_PARAM);
 
     (void)OsalMutexLock(&manager->eventMutex);
-    msg = HdfSbufObtain(HDF_SENSOR_EVENT_MAX_BUF);
+    msg = HdfSbufObtainPooled(HDF_SENSOR_EVENT_MAX_BUF);
     if (msg == NULL) {
         (void)OsalMutexUnlock(&manager->eventMutex);
         return HDF_ERR_INVALID_PARAM;
@@ -26,6 +26,10 @@ int32_t CanClientWriteMsg(struct CanClient *client, const struct CanMsg *msg);
 
 int32_t CanClientReadMsg(struct CanClient *client, struct CanMsg *msg, uint32_t tms);
 
+int32_t CanClientWriteMsgs(struct CanClient *client, const struct CanMsg *msgs, uint32_t count);
+
+int32_t CanClientReadMsgs(struct CanClient *client, struct CanMsg *msgs, uint32_t count, uint32_t tms);
+
 int32_t CanClientAddFilter(struct CanClient *client, const struct CanFilter *filter);
 
 int32_t CanClientDelFilter(struct CanClient *client, const struct CanFilter *filter);
@@ -25,6 +25,7 @@ extern "C" {
 
 struct CanCntlr;
 struct CanRxBox;
+struct CanFilterTable;
 
 struct CanCntlrMethod {
     int32_t (*open)(struct CanCntlr *cntlr);
@@ -32,9 +33,12 @@ struct CanCntlrMethod {
     int32_t (*lock)(struct CanCntlr *cntlr);
     int32_t (*unlock)(struct CanCntlr *cntlr);
     int32_t (*sendMsg)(struct CanCntlr *cntlr, const struct CanMsg *msg);
+    // optional, returns the number of messages sent, or a negative error if none was
+    int32_t (*sendMsgs)(struct CanCntlr *cntlr, const struct CanMsg *msgs, uint32_t count);
     int32_t (*setCfg)(struct CanCntlr *cntlr, const struct CanConfig *cfg);
     int32_t (*getCfg)(struct CanCntlr *cntlr, struct CanConfig *cfg);
     int32_t (*getState)(struct CanCntlr *cntlr);
+    // HDF_PLT_OUT_OF_RSC tells that the hardware holds no more filters
     int32_t (*addFilter)(struct CanCntlr *cntlr, struct CanFilter *filter);
     int32_t (*delFilter)(struct CanCntlr *cntlr, struct CanFilter *filter);
 };
@@ -47,9 +51,12 @@ struct CanCntlr {
     int32_t state;                // bus status
     int32_t mode;                 // work mode
     struct CanCntlrMethod *ops;
-    struct DListHead filters;
+    struct DListHead filters;     // filters pushed down to hardware
+    struct DListHead cntlrFilters; // filters added with CanCntlrAddFilter, pushed down along with the boxes' ones
+    uint32_t hwFilterMax;         // filters the hardware holds, 0 until it ran out of them
     struct DListHead rxBoxList;
     struct OsalMutex rboxListLock;
+    struct CanFilterTable *filterTable; // filters of all rx boxes, NULL to match box by box
 };
 
 struct CanFilterNode {
@@ -85,6 +92,8 @@ static inline struct CanCntlr *CanCntlrFromHdfDev(struct HdfDeviceObject *device
 // CAN BUS operations
 int32_t CanCntlrWriteMsg(struct CanCntlr *cntlr, const struct CanMsg *msg);
 
+int32_t CanCntlrWriteMsgs(struct CanCntlr *cntlr, const struct CanMsg *msgs, uint32_t count);
+
 int32_t CanCntlrAddFilter(struct CanCntlr *cntlr, struct CanFilter *filter);
 
 int32_t CanCntlrDelFilter(struct CanCntlr *cntlr, struct CanFilter *filter);
@@ -97,10 +106,16 @@ int32_t CanCntlrGetState(struct CanCntlr *cntlr);
 
 int32_t CanCntlrOnNewMsg(struct CanCntlr *cntlr, struct CanMsg *msg);
 
+int32_t CanCntlrOnNewMsgs(struct CanCntlr *cntlr, struct CanMsg **msgs, uint32_t count);
+
 int32_t CanCntlrAddRxBox(struct CanCntlr *cntlr, struct CanRxBox *rxBox);
 
 int32_t CanCntlrDelRxBox(struct CanCntlr *cntlr, struct CanRxBox *rxBox);
 
+int32_t CanCntlrUpdateFilters(struct CanCntlr *cntlr);
+
+void CanCntlrClearFilters(struct CanCntlr *cntlr);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef CAN_FILTER_H
+#define CAN_FILTER_H
+
+#include "can_core.h"
+#include "can_mail.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * The filters of all rx boxes of a controller, compiled into one table. Filters sharing rtrMask, ideMask and
+ * idMask form a group, and each group is looked up once per frame by the masked frame id, so the cost of a
+ * frame depends on the number of distinct masks instead of the number of boxes and filters.
+ */
+struct CanFilterTable;
+
+/* Build and match with cntlr->rboxListLock held. */
+struct CanFilterTable *CanFilterTableBuild(struct DListHead *rxBoxList);
+
+void CanFilterTableDestroy(struct CanFilterTable *table);
+
+uint32_t CanFilterTableMatch(struct CanFilterTable *table, const struct CanMsg *cmsg, struct CanRxBox ***boxes);
+
+/* Whether some box accepts all frames, or there is no table and boxes are matched one by one. */
+bool CanFilterTableAcceptsAll(const struct CanFilterTable *table);
+
+/* Distinct filters of the table for the hardware, none if some box accepts all frames. */
+uint32_t CanFilterTableGetFilters(const struct CanFilterTable *table, const struct CanFilter **filters);
+
+bool CanFilterEquals(const struct CanFilter *filterA, const struct CanFilter *filterB);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CAN_FILTER_H */
@@ -11,17 +11,36 @@
 
 #include "can_core.h"
 #include "can_msg.h"
-#include "platform_queue.h"
+#include "osal_atomic.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+#define CAN_RX_BOX_DEPTH 128 // power of 2
+
+enum CanRxBoxPolicy {
+    CAN_RX_BOX_DROP_NEWEST = 0, // a full box rejects new messages
+    CAN_RX_BOX_DROP_OLDEST,     // a full box discards its oldest message for the new one
+};
+
+/*
+ * Messages are kept in a bounded ring of CanMsg references. The controller dispatch is the only producer and
+ * moves head; readers claim messages by moving tail with compare and swap, so neither side takes a lock.
+ */
 struct CanRxBox {
-    struct PlatformQueue *queue;
     struct DListHead node;
     struct DListHead filters;
     OsalSpinlock spin;
+    struct OsalSem sem; // counts the messages in ring
+    OsalAtomic head;
+    OsalAtomic tail;
+    OsalAtomic policy;
+    OsalAtomic dropOldest;
+    OsalAtomic dropNewest;
+    struct CanMsg *ring[CAN_RX_BOX_DEPTH];
 };
 
 struct CanRxBox *CanRxBoxCreate(void);
@@ -40,8 +59,16 @@ static inline void CanRxBoxUnlock(struct CanRxBox *rbox)
 
 int32_t CanRxBoxAddMsg(struct CanRxBox *rbox, struct CanMsg *cmsg);
 
+int32_t CanRxBoxEnqueueMsg(struct CanRxBox *rbox, struct CanMsg *cmsg);
+
 int32_t CanRxBoxGetMsg(struct CanRxBox *rbox, struct CanMsg **cmsg, uint32_t tms);
 
+int32_t CanRxBoxGetMsgs(struct CanRxBox *rbox, struct CanMsg *msgs, uint32_t count, uint32_t tms);
+
+void CanRxBoxSetPolicy(struct CanRxBox *rbox, enum CanRxBoxPolicy policy);
+
+void CanRxBoxGetDropCount(struct CanRxBox *rbox, uint32_t *dropOldest, uint32_t *dropNewest);
+
 int32_t CanRxBoxAddFilter(struct CanRxBox *rbox, const struct CanFilter *filter);
 
 int32_t CanRxBoxDelFilter(struct CanRxBox *rbox, const struct CanFilter *filter);
@@ -13,7 +13,11 @@
 #include "hdf_device.h"
 #include "hdf_device_desc.h"
 #include "hdf_object.h"
+#ifdef __LITEOS__
 #include "los_event.h"
+#else
+#include "osal_sem.h"
+#endif
 #include "osal_mutex.h"
 #include "osal_spinlock.h"
 
@@ -25,13 +29,70 @@ extern "C" {
 
 #define PERIPH_ADDR_INVALID               0xfff
 #define DMAC_CHAN_NUM_MAX                 100
+#define DMAC_IRQ_NONE                     0xffffffffU // no interrupt, see DmacCntlrIrqCallback
+#define DMAC_LLI_POOL_PER_CHAN_DEFAULT    16
+
+typedef void DmacCallback(void *callbackData, int status);
 
+#ifdef __LITEOS__
 #define DmaEventInit(event)               LOS_EventInit(event)
+#define DmaEventDeinit(event)             LOS_EventDestroy(event)
 #define DmaEventSignal(event, bit)        LOS_EventWrite(event, bit)
 #define DmaEventWait(event, bit, timeout) LOS_EventRead(event, bit, LOS_WAITMODE_OR + LOS_WAITMODE_CLR, timeout)
+#define DMA_EVENT_WAIT_DEF_TIME           ((LOSCFG_BASE_CORE_TICK_PER_SECOND) * 5)
+#define DMA_EVENT_WAIT_TIMEOUT            LOS_ERRNO_EVENT_READ_TIMEOUT
 
-typedef void DmacCallback(void *callbackData, int status);
 typedef EVENT_CB_S DmacEvent;
+#else
+#define DMA_EVENT_WAIT_DEF_TIME           5000 // ms
+#define DMA_EVENT_WAIT_TIMEOUT            0xffffffffU
+
+typedef struct {
+    struct OsalSem sem;
+    OsalSpinlock lock;
+    uint32_t bits;
+} DmacEvent;
+
+static inline void DmaEventInit(DmacEvent *event)
+{
+    (void)OsalSemInit(&event->sem, 0);
+    (void)OsalSpinInit(&event->lock);
+    event->bits = 0;
+}
+
+static inline void DmaEventDeinit(DmacEvent *event)
+{
+    (void)OsalSemDestroy(&event->sem);
+    (void)OsalSpinDestroy(&event->lock);
+}
+
+static inline void DmaEventSignal(DmacEvent *event, uint32_t bit)
+{
+    uint32_t flags;
+
+    (void)OsalSpinLockIrqSave(&event->lock, &flags);
+    event->bits |= bit;
+    (void)OsalSpinUnlockIrqRestore(&event->lock, &flags);
+    (void)OsalSemPost(&event->sem);
+}
+
+static inline uint32_t DmaEventWait(DmacEvent *event, uint32_t bit, uint32_t timeout)
+{
+    uint32_t flags;
+    uint32_t ret;
+
+    do {
+        if (OsalSemWait(&event->sem, timeout) != HDF_SUCCESS) {
+            return DMA_EVENT_WAIT_TIMEOUT;
+        }
+        (void)OsalSpinLockIrqSave(&event->lock, &flags);
+        ret = event->bits & bit;
+        event->bits &= ~ret;
+        (void)OsalSpinUnlockIrqRestore(&event->lock, &flags);
+    } while (ret == 0);
+    return ret;
+}
+#endif
 
 /* definition for the return value */
 enum DmacErrorNumber {
@@ -62,7 +123,6 @@ enum DmacEvent {
     DMAC_EVENT_DONE                       = 0x1,
     DMAC_EVENT_ERROR                      = 0x2,
 };
-#define DMA_EVENT_WAIT_DEF_TIME           ((LOSCFG_BASE_CORE_TICK_PER_SECOND) * 5)
 
 enum DmacTransferType {
     TRASFER_TYPE_M2M = 0x0,
@@ -81,6 +141,15 @@ struct DmacMsg {
     void *para;
 };
 
+/*
+ * One memory buffer of a scatter-gather transfer, see DmaCntlrTransferSg. An addr of 0 reads zeroes from
+ * or discards into a dummy buffer, as srcAddr and destAddr of 0 do for DmaCntlrTransfer.
+ */
+struct DmacSgEntry {
+    uintptr_t addr;           // physical address
+    size_t len;
+};
+
 static inline uintptr_t DmacMsgGetPeriphAddr(struct DmacMsg *msg)
 {
     return (msg->transType == TRASFER_TYPE_M2P) ? msg->destAddr :
@@ -102,7 +171,8 @@ struct DmacLliHead {
 };
 #define DMAC_LLI_HEAD_SIZE    (sizeof(struct DmacLliHead))
 
-#define DMAC_LLI_SIZE         64 // must be 64 Bytes aligned
+#define DMAC_LLI_ALIGN        64 // must be 64 Bytes aligned
+#define DMAC_LLI_SIZE         ((DMAC_LLI_HEAD_SIZE + DMAC_LLI_ALIGN - 1) / DMAC_LLI_ALIGN * DMAC_LLI_ALIGN)
 struct DmacLli {
     DMAC_LLI_HEAD;
     uint8_t pad[DMAC_LLI_SIZE - DMAC_LLI_HEAD_SIZE];
@@ -121,6 +191,7 @@ struct DmacChanInfo {
     DmacCallback *callback;
     void *callbackData;
     uint16_t lliCnt;
+    bool lliPooled;           // lli points into the pool of the controller
     struct DmacLli *lli;
     void *dummyPage;
 };
@@ -135,8 +206,10 @@ struct DmaCntlr {
     size_t regSize;
     size_t maxTransSize;
     uint16_t channelNum;
+    uint16_t lliPoolPerChan;  // llis kept for each channel, DMAC_LLI_POOL_PER_CHAN_DEFAULT if 0
     OsalSpinlock lock;
     struct DmacChanInfo *channelList;
+    struct DmacLli *lliPool;
     int32_t (*getChanInfo)(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo, struct DmacMsg *msg);
     int32_t (*dmaChanEnable)(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo);
     int32_t (*dmaM2mChanEnable)(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo,
@@ -151,7 +224,7 @@ struct DmaCntlr {
     void *private;
 };
 
-#ifdef LOSCFG_DRIVERS_HDF_PLATFORM_DMAC
+#if defined(LOSCFG_DRIVERS_HDF_PLATFORM_DMAC) || defined(CONFIG_DRIVERS_HDF_PLATFORM_DMAC)
 struct DmaCntlr *DmaCntlrCreate(struct HdfDeviceObject *dev);
 
 void DmaCntlrDestroy(struct DmaCntlr *cntlr);
@@ -162,7 +235,20 @@ void DmacCntlrRemove(struct DmaCntlr *cntlr);
 
 int32_t DmaCntlrTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg);
 
+/*
+ * Peripheral transfer whose memory side is the buffers of sgl in turn, chained into one lli list. The memory
+ * address of msg (destAddr of P2M, srcAddr of M2P) and transLen are ignored. M2M transfers are not supported.
+ */
+int32_t DmaCntlrTransferSg(struct DmaCntlr *cntlr, struct DmacMsg *msg,
+    const struct DmacSgEntry *sgl, uint16_t sgCount);
+
 uintptr_t DmaGetCurrChanDestAddr(struct DmaCntlr *cntlr, uint16_t chan);
+
+/*
+ * Checks the channels for finished transfers. Called by the core on the irq of the controller, and by
+ * drivers with irq DMAC_IRQ_NONE or their own handler when transfers finish.
+ */
+void DmacCntlrIrqCallback(struct DmaCntlr *cntlr);
 #else
 static inline struct DmaCntlr *DmaCntlrCreate(struct HdfDeviceObject *dev)
 {
@@ -195,12 +281,27 @@ static inline int32_t DmaCntlrTransfer(struct DmaCntlr *cntlr, struct DmacMsg *m
     return HDF_ERR_NOT_SUPPORT;
 }
 
+static inline int32_t DmaCntlrTransferSg(struct DmaCntlr *cntlr, struct DmacMsg *msg,
+    const struct DmacSgEntry *sgl, uint16_t sgCount)
+{
+    (void)cntlr;
+    (void)msg;
+    (void)sgl;
+    (void)sgCount;
+    return HDF_ERR_NOT_SUPPORT;
+}
+
 static inline uintptr_t DmaGetCurrChanDestAddr(struct DmaCntlr *cntlr, uint16_t chan)
 {
     (void)cntlr;
     (void)chan;
     return 0;
 }
+
+static inline void DmacCntlrIrqCallback(struct DmaCntlr *cntlr)
+{
+    (void)cntlr;
+}
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef PLATFORM_BH_H
+#define PLATFORM_BH_H
+
+#include "hdf_base.h"
+#include "hdf_dlist.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
+struct PlatformBhWork;
+
+enum PlatformBhPriority {
+    PLATFORM_BH_PRI_HIGH = 0,
+    PLATFORM_BH_PRI_NORMAL,
+    PLATFORM_BH_PRI_MAX,
+};
+
+typedef void (*PlatformBhFunc)(struct PlatformBhWork *work);
+
+/**
+ * @brief Defines the counters of a bottom half work.
+ *
+ * The latency is the time from the first trigger of a run to the start of that run.
+ *
+ * @since 1.0
+ */
+struct PlatformBhStat {
+    uint32_t runs;          // times the work was run
+    uint32_t coalesced;     // triggers merged into a run already pending
+    uint32_t latencyMaxUs;
+    uint64_t latencyTotalUs;
+};
+
+/**
+ * @brief Defines a bottom half work which runs in the shared worker threads of its priority.
+ *
+ * Triggers of a work already pending are merged into the pending run, and a trigger while the work runs
+ * queues it once more, so the function runs at least once after every trigger but never concurrently.
+ *
+ * @since 1.0
+ */
+struct PlatformBhWork {
+    struct DListHead node;
+    PlatformBhFunc func;
+    PlatformBhFunc release; // called once the work is released and no longer runs, optional
+    void *data;
+    uint32_t priority;
+    uint32_t state;
+    uint64_t queuedUs;
+    struct PlatformBhStat stat;
+};
+
+/**
+ * @brief Initialize a bottom half work.
+ *
+ * @param work Indicates the pointer to the work.
+ * @param func Indicates the function to run in thread context.
+ * @param data Indicates the private data of the work.
+ * @param priority Indicates the priority of the worker threads to run the work, see {@link PlatformBhPriority}.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t PlatformBhWorkInit(struct PlatformBhWork *work, PlatformBhFunc func, void *data, uint32_t priority);
+
+/**
+ * @brief Queue a bottom half work to the workers, may be called in interrupt context.
+ *
+ * @param work Indicates the pointer to the work.
+ *
+ * @return Returns <b>0</b> if the work is queued or merged into its pending run; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t PlatformBhSchedule(struct PlatformBhWork *work);
+
+/**
+ * @brief Release a bottom half work, it will not be queued again.
+ *
+ * A pending run is dropped. The release function of the work is called at once if the work does not run,
+ * or by the worker when the current run returns, so the work may be released from its own function.
+ *
+ * @param work Indicates the pointer to the work.
+ *
+ * @since 1.0
+ */
+void PlatformBhWorkRelease(struct PlatformBhWork *work);
+
+/**
+ * @brief Get the counters of a bottom half work.
+ *
+ * @param work Indicates the pointer to the work.
+ * @param stat Indicates the pointer to receive the counters.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t PlatformBhWorkGetStat(struct PlatformBhWork *work, struct PlatformBhStat *stat);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+#endif /* PLATFORM_BH_H */
@@ -34,6 +34,8 @@ struct PlatformDevice {
     const char *name;                  /* name of the device instance */
     struct HdfSRef ref;                /* used for reference count */
     struct DListHead node;             /* linked to the list of a manager */
+    struct DListHead numberNode;       /* linked to the number index of a manager */
+    struct DListHead nameNode;         /* linked to the name index of a manager */
     struct PlatformEvent event;        /* platform event obj of this device */
     OsalSpinlock spin;                 /* for member protection */
     uint32_t irqSave;                  /* for spinlock irq save */
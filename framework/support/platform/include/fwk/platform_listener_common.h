@@ -17,6 +17,7 @@ enum PlatformListenerEventID {
     PLATFORM_LISTENER_EVENT_GPIO_INT_NOTIFY,
     PLATFORM_LISTENER_EVENT_TIMER_NOTIFY,
     PLATFORM_LISTENER_EVENT_RTC_ALARM_NOTIFY,
+    PLATFORM_LISTENER_EVENT_UART_RX_NOTIFY,
 };
 
 #define LISTENER_MATCH_INFO_LEN 256
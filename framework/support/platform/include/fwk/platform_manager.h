@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021 Huawei Device Co., Ltd.
+ * Copyright (c) 2020-2022 Huawei Device Co., Ltd.
  *
  * HDF is dual licensed: you can use it either under the terms of
  * the GPL, or the BSD license, at your option.
@@ -11,6 +11,7 @@
 
 #include "hdf_base.h"
 #include "hdf_dlist.h"
+#include "osal_atomic.h"
 #include "osal_spinlock.h"
 #include "platform_device.h"
 
@@ -18,9 +19,21 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/*
+ * Devices are also indexed by number and by name in power-of-two bucket arrays. Lookups by number or name
+ * only announce themselves in the readers counter and search the indexes without the lock; adds and removes
+ * announce themselves in the writers counter, drain the lookups in flight and change the list and the
+ * indexes with the lock held. Lookups coming while a writer is announced take the lock as well.
+ */
 struct PlatformManager {
     struct PlatformDevice device;
     struct DListHead devices;  /* list to keep all it's device instances */
+    struct DListHead *numberBuckets;
+    struct DListHead *nameBuckets;
+    uint32_t bucketCount;
+    uint32_t deviceCount;
+    OsalAtomic readers;
+    OsalAtomic writers;
     int32_t (*add)(struct PlatformManager *manager, struct PlatformDevice *device);
     int32_t (*del)(struct PlatformManager *manager, struct PlatformDevice *device);
 };
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021 Huawei Device Co., Ltd.
+ * Copyright (c) 2020-2022 Huawei Device Co., Ltd.
  *
  * HDF is dual licensed: you can use it either under the terms of
  * the GPL, or the BSD license, at your option.
@@ -10,6 +10,7 @@
 #define PLATFORM_QUEUE_H
 
 #include "hdf_dlist.h"
+#include "osal_atomic.h"
 #include "osal_thread.h"
 #include "osal_sem.h"
 #include "osal_spinlock.h"
@@ -23,6 +24,7 @@ struct PlatformQueue;
 
 struct PlatformMsg {
     struct DListHead node;
+    struct PlatformMsg *next; /* link of the queue the message is added to */
     int32_t code;
     int32_t error;
     void *data;
@@ -30,17 +32,28 @@ struct PlatformMsg {
 
 typedef int32_t (*PlatformMsgHandle)(struct PlatformQueue *queue, struct PlatformMsg *msg);
 
+#define PLAT_QUEUE_DEPTH_UNBOUNDED 0
+
+/*
+ * Messages are linked into an intrusive multi-producer single-consumer list: producers only exchange the
+ * head pointer, and the single consumer, which is the worker thread once the queue is started, takes them
+ * from the tail. The semaphore is posted only when the consumer went to sleep on it, and the worker handles
+ * all the messages it finds on every wake.
+ */
 struct PlatformQueue {
     const char *name;
-    OsalSpinlock spin;
     bool start;
-    bool exited;
+    OsalAtomic stop;
+    OsalAtomic exited;
+    OsalAtomic waiting;        /* the consumer sleeps, or is about to, on sem */
     struct OsalSem sem;
-    struct DListHead msgs;
+    struct PlatformMsg *head;  /* last message added, exchanged by producers */
+    struct PlatformMsg *tail;  /* next message to take, consumer only */
+    struct PlatformMsg stub;
     struct OsalThread thread; /* the worker thread of this queue */
     PlatformMsgHandle handle;
-    uint32_t depth;
-    uint32_t depthMax;
+    OsalAtomic depth;
+    OsalAtomic depthMax;       /* PLAT_QUEUE_DEPTH_UNBOUNDED for no limit */
     void *data;
 };
 
@@ -50,8 +63,13 @@ void PlatformQueueDestroy(struct PlatformQueue *queue);
 
 int32_t PlatformQueueStart(struct PlatformQueue *queue);
 
+int32_t PlatformQueueSetDepthMax(struct PlatformQueue *queue, uint32_t depthMax);
+
 int32_t PlatformQueueAddMsg(struct PlatformQueue *queue, struct PlatformMsg *msg);
 
+/*
+ * Takes a message from a queue which is not started, the caller being its only consumer.
+ */
 int32_t PlatformQueueGetMsg(struct PlatformQueue *queue, struct PlatformMsg **msg, uint32_t tms);
 
 #ifdef __cplusplus
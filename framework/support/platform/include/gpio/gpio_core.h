@@ -15,6 +15,7 @@
 #include "hdf_dlist.h"
 #include "osal_mem.h"
 #include "osal_spinlock.h"
+#include "platform_bh.h"
 #include "platform_core.h"
 
 #ifdef __cplusplus
@@ -79,10 +80,7 @@ struct GpioIrqRecord {
     GpioIrqFunc btmFunc;
     void *irqData;
     uint16_t global;
-    OsalSpinlock spin;
-    struct OsalSem sem;
-    struct OsalThread thread;
-    bool removed;
+    struct PlatformBhWork bh; // runs btmFunc in the shared platform bottom half workers
 };
 
 static inline void GpioIrqRecordTrigger(struct GpioIrqRecord *irqRecord)
@@ -91,21 +89,16 @@ static inline void GpioIrqRecordTrigger(struct GpioIrqRecord *irqRecord)
         (void)irqRecord->irqFunc(irqRecord->global, irqRecord->irqData);
     }
     if (irqRecord->btmFunc != NULL) {
-        (void)OsalSemPost(&irqRecord->sem);
+        (void)PlatformBhSchedule(&irqRecord->bh); // merged with a run still pending
     }
 }
 
 static inline void GpioIrqRecordDestroy(struct GpioIrqRecord *irqRecord)
 {
-    uint32_t irqSave;
-
     if (irqRecord->btmFunc == NULL) {
         OsalMemFree(irqRecord);  // the last access to this record
     } else {
-        (void)OsalSpinLockIrqSave(&irqRecord->spin, &irqSave);
-        irqRecord->removed = true;
-        (void)OsalSemPost(&irqRecord->sem); // this is the last post ...
-        (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave);
+        PlatformBhWorkRelease(&irqRecord->bh); // freed once the bottom half no longer runs
     }
 }
 
@@ -137,6 +130,10 @@ struct GpioMethod {
     int32_t (*enableIrq)(struct GpioCntlr *cntlr, uint16_t local);
     /** disable a GPIO pin interrupt */
     int32_t (*disableIrq)(struct GpioCntlr *cntlr, uint16_t local);
+    /** write the pins local + n for each bit n set in mask at a time, level of each in bit n of val, optional */
+    int32_t (*writeMulti)(struct GpioCntlr *cntlr, uint16_t local, uint32_t mask, uint32_t val);
+    /** read the pins local + n for each bit n set in mask at a time, level of each into bit n of val, optional */
+    int32_t (*readMulti)(struct GpioCntlr *cntlr, uint16_t local, uint32_t mask, uint32_t *val);
 };
 
 /**
@@ -175,6 +172,10 @@ int32_t GpioCntlrWrite(struct GpioCntlr *cntlr, uint16_t local, uint16_t val);
 
 int32_t GpioCntlrRead(struct GpioCntlr *cntlr, uint16_t local, uint16_t *val);
 
+int32_t GpioCntlrWriteMulti(struct GpioCntlr *cntlr, uint16_t local, uint32_t mask, uint32_t val);
+
+int32_t GpioCntlrReadMulti(struct GpioCntlr *cntlr, uint16_t local, uint32_t mask, uint32_t *val);
+
 int32_t GpioCntlrSetDir(struct GpioCntlr *cntlr, uint16_t local, uint16_t dir);
 
 int32_t GpioCntlrGetDir(struct GpioCntlr *cntlr, uint16_t local, uint16_t *dir);
@@ -191,6 +192,8 @@ int32_t GpioCntlrDisableIrq(struct GpioCntlr *cntlr, uint16_t local);
 
 void GpioCntlrIrqCallback(struct GpioCntlr *cntlr, uint16_t local);
 
+int32_t GpioCntlrGetIrqStat(struct GpioCntlr *cntlr, uint16_t local, struct PlatformBhStat *stat);
+
 struct PlatformManager *GpioManagerGet(void);
 
 struct GpioCntlr *GpioCntlrGetByGpio(uint16_t gpio);
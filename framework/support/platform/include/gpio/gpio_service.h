@@ -24,6 +24,8 @@ enum GpioIoCmd {
     GPIO_IO_UNSETIRQ = 5,
     GPIO_IO_ENABLEIRQ = 6,
     GPIO_IO_DISABLEIRQ = 7,
+    GPIO_IO_READ_MULTI = 8,
+    GPIO_IO_WRITE_MULTI = 9,
 };
 
 #ifdef __cplusplus
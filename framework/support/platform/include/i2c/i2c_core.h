@@ -25,6 +25,7 @@ extern "C" {
 struct I2cCntlr;
 struct I2cMethod;
 struct I2cLockMethod;
+struct I2cAsyncQueue;
 
 struct I2cCntlr {
     struct OsalMutex lock;
@@ -33,6 +34,7 @@ struct I2cCntlr {
     void *priv;
     const struct I2cMethod *ops;
     const struct I2cLockMethod *lockOps;
+    struct I2cAsyncQueue *asyncQueue; /* created by the first asynchronous transfer */
 };
 
 struct I2cMethod {
@@ -123,6 +125,17 @@ void I2cCntlrPut(struct I2cCntlr *cntlr);
  */
 int32_t I2cCntlrTransfer(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count);
 
+/**
+ * @brief Queue an I2C transfer request to the worker thread of the controller.
+ *
+ * @param cntlr Indicates the I2C controller device.
+ * @param req Indicates the {@link I2cTransferReq} request, owned by the controller until its callback.
+ *
+ * @return Returns 0 if the request is queued; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t I2cCntlrTransferAsync(struct I2cCntlr *cntlr, struct I2cTransferReq *req);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
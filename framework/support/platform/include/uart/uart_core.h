@@ -19,6 +19,8 @@
 extern "C" {
 #endif /* __cplusplus */
 
+struct UartRxRing;
+
 /**
  * @brief uart device operations.
  */
@@ -29,6 +31,7 @@ struct UartHost {
     OsalAtomic atom;
     void *priv;
     struct UartHostMethod *method;
+    struct UartRxRing *rxRing;
 };
 
 struct UartHostMethod {
@@ -141,6 +144,68 @@ static inline int32_t UartHostPollEvent(struct UartHost *host, void *filep, void
     return host->method->pollEvent(host, filep, table);
 }
 
+/**
+ * @brief Set up the receive ring of an UartHost.
+ *
+ * Controller drivers which call this push the bytes they receive with {@link UartHostRecv}, and readers take
+ * whatever is buffered with {@link UartHostReadStream} without waiting for the controller.
+ *
+ * @param host Indicates the Uart host device.
+ * @param size Indicates the size of the ring in bytes, rounded up to a power of two.
+ *
+ * @return Returns 0 on success; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t UartHostRxRingInit(struct UartHost *host, uint32_t size);
+
+/**
+ * @brief Release the receive ring of an UartHost, the controller must not push bytes any more.
+ *
+ * @param host Indicates the Uart host device.
+ *
+ * @since 1.0
+ */
+void UartHostRxRingDeinit(struct UartHost *host);
+
+/**
+ * @brief Push received bytes to the receive ring, may be called in interrupt context.
+ *
+ * Bytes which do not fit are dropped and counted as overruns. Listeners of the host service are told of new
+ * data by a {@link PLATFORM_LISTENER_EVENT_UART_RX_NOTIFY} event carrying the port number and the number of
+ * bytes buffered.
+ *
+ * @param host Indicates the Uart host device.
+ * @param data Indicates the received bytes.
+ * @param size Indicates the number of received bytes.
+ *
+ * @return Returns the number of bytes stored.
+ * @since 1.0
+ */
+uint32_t UartHostRecv(struct UartHost *host, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Take up to size bytes from the receive ring without waiting.
+ *
+ * @param host Indicates the Uart host device.
+ * @param data Indicates the buffer to receive the bytes.
+ * @param size Indicates the size of the buffer.
+ *
+ * @return Returns the number of bytes taken, which is 0 if the ring is empty; returns a negative value if
+ * the host has no receive ring.
+ * @since 1.0
+ */
+int32_t UartHostReadStream(struct UartHost *host, uint8_t *data, uint32_t size);
+
+/**
+ * @brief Take up to size bytes from the receive ring into a reply without waiting.
+ *
+ * The bytes are written as two buffers, the second one holding the part wrapped around the end of the ring.
+ *
+ * @return Returns the number of bytes taken; returns a negative value if the host has no receive ring.
+ * @since 1.0
+ */
+int32_t UartHostReadStreamToSbuf(struct UartHost *host, struct HdfSBuf *reply, uint32_t size);
+
 int32_t UartIoDispatch(struct HdfDeviceIoClient *client, int cmd, struct HdfSBuf *data, struct HdfSBuf *reply);
 
 #ifdef __cplusplus
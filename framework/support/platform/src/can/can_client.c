@@ -123,20 +123,48 @@ int32_t CanClientReadMsg(struct CanClient *client, struct CanMsg *msg, uint32_t
     return (ret == EOK) ? HDF_SUCCESS : HDF_ERR_IO;
 }
 
+int32_t CanClientWriteMsgs(struct CanClient *client, const struct CanMsg *msgs, uint32_t count)
+{
+    if (client == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return CanCntlrWriteMsgs(client->cntlr, msgs, count);
+}
+
+int32_t CanClientReadMsgs(struct CanClient *client, struct CanMsg *msgs, uint32_t count, uint32_t tms)
+{
+    if (client == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return CanRxBoxGetMsgs(client->rxBox, msgs, count, tms);
+}
+
 int32_t CanClientAddFilter(struct CanClient *client, const struct CanFilter *filter)
 {
+    int32_t ret;
+
     if (client == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
-    return CanRxBoxAddFilter(client->rxBox, filter);
+    ret = CanRxBoxAddFilter(client->rxBox, filter);
+    if (ret == HDF_SUCCESS) {
+        (void)CanCntlrUpdateFilters(client->cntlr);
+    }
+    return ret;
 }
 
 int32_t CanClientDelFilter(struct CanClient *client, const struct CanFilter *filter)
 {
+    int32_t ret;
+
     if (client == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
-    return CanRxBoxDelFilter(client->rxBox, filter);
+    ret = CanRxBoxDelFilter(client->rxBox, filter);
+    if (ret == HDF_SUCCESS) {
+        (void)CanCntlrUpdateFilters(client->cntlr);
+    }
+    return ret;
 }
 
 int32_t CanClientSetCfg(struct CanClient *client, const struct CanConfig *cfg)
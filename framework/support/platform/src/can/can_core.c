@@ -7,8 +7,17 @@
  */
 
 #include "can/can_core.h"
+#include "can/can_filter.h"
 #include "can/can_mail.h"
 #include "can/can_msg.h"
+#include "osal_mem.h"
+
+struct CanHwFilter {
+    struct CanFilterNode node;
+    struct CanFilter filter;
+};
+
+static void CanCntlrSyncHwFilters(struct CanCntlr *cntlr);
 
 static int32_t CanCntlrLock(struct CanCntlr *cntlr)
 {
@@ -47,42 +56,134 @@ int32_t CanCntlrWriteMsg(struct CanCntlr *cntlr, const struct CanMsg *msg)
     return ret;
 }
 
-int32_t CanCntlrAddFilter(struct CanCntlr *cntlr, struct CanFilter *filter)
+static int32_t CanCntlrSendMsgs(struct CanCntlr *cntlr, const struct CanMsg *msgs, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+
+    if (cntlr->ops->sendMsgs != NULL) {
+        return cntlr->ops->sendMsgs(cntlr, msgs, count);
+    }
+    for (i = 0; i < count; i++) {
+        if ((ret = cntlr->ops->sendMsg(cntlr, &msgs[i])) != HDF_SUCCESS) {
+            return (i == 0) ? ret : (int32_t)i;
+        }
+    }
+    return (int32_t)count;
+}
+
+int32_t CanCntlrWriteMsgs(struct CanCntlr *cntlr, const struct CanMsg *msgs, uint32_t count)
 {
     int32_t ret;
 
     if (cntlr == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
-    if (cntlr->ops == NULL || cntlr->ops->addFilter == NULL) {
+    if (msgs == NULL || count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cntlr->ops == NULL || (cntlr->ops->sendMsg == NULL && cntlr->ops->sendMsgs == NULL)) {
         return HDF_ERR_NOT_SUPPORT;
     }
 
     if ((ret = CanCntlrLock(cntlr)) != HDF_SUCCESS) {
         return ret;
     }
-    ret = cntlr->ops->addFilter(cntlr, filter);
+    ret = CanCntlrSendMsgs(cntlr, msgs, count);
     CanCntlrUnlock(cntlr);
     return ret;
 }
 
+static struct CanHwFilter *CanCntlrNewFilter(const struct CanFilter *filter)
+{
+    struct CanHwFilter *hwFilter = (struct CanHwFilter *)OsalMemCalloc(sizeof(*hwFilter));
+
+    if (hwFilter != NULL) {
+        hwFilter->filter = *filter;
+        hwFilter->node.filter = &hwFilter->filter;
+        hwFilter->node.active = true;
+    }
+    return hwFilter;
+}
+
+static struct CanHwFilter *CanCntlrFindFilter(struct DListHead *list, const struct CanFilter *filter)
+{
+    struct CanHwFilter *hwFilter = NULL;
+
+    DLIST_FOR_EACH_ENTRY(hwFilter, list, struct CanHwFilter, node.node) {
+        if (CanFilterEquals(&hwFilter->filter, filter)) {
+            return hwFilter;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Filters added here are kept in the hardware along with the ones of the rx boxes, so the hardware accepts at
+ * least their frames. It may accept more, all frames if a box asks for them or the hardware runs out of filters.
+ */
+int32_t CanCntlrAddFilter(struct CanCntlr *cntlr, struct CanFilter *filter)
+{
+    int32_t ret;
+    struct CanHwFilter *cntlrFilter = NULL;
+
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (filter == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cntlr->ops == NULL || cntlr->ops->addFilter == NULL || cntlr->ops->delFilter == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    cntlrFilter = CanCntlrNewFilter(filter);
+    if (cntlrFilter == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    if ((ret = CanCntlrLock(cntlr)) != HDF_SUCCESS) {
+        OsalMemFree(cntlrFilter);
+        return ret;
+    }
+    if (CanCntlrFindFilter(&cntlr->cntlrFilters, filter) == NULL) {
+        DListInsertTail(&cntlrFilter->node.node, &cntlr->cntlrFilters);
+        cntlrFilter = NULL;
+    }
+    CanCntlrUnlock(cntlr);
+    OsalMemFree(cntlrFilter);
+    CanCntlrSyncHwFilters(cntlr);
+    return HDF_SUCCESS;
+}
+
 int32_t CanCntlrDelFilter(struct CanCntlr *cntlr, struct CanFilter *filter)
 {
     int32_t ret;
+    struct CanHwFilter *cntlrFilter = NULL;
 
     if (cntlr == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
-    if (cntlr->ops == NULL || cntlr->ops->delFilter == NULL) {
+    if (filter == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cntlr->ops == NULL || cntlr->ops->addFilter == NULL || cntlr->ops->delFilter == NULL) {
         return HDF_ERR_NOT_SUPPORT;
     }
 
     if ((ret = CanCntlrLock(cntlr)) != HDF_SUCCESS) {
         return ret;
     }
-    ret = cntlr->ops->delFilter(cntlr, filter);
+    cntlrFilter = CanCntlrFindFilter(&cntlr->cntlrFilters, filter);
+    if (cntlrFilter != NULL) {
+        DListRemove(&cntlrFilter->node.node);
+    }
     CanCntlrUnlock(cntlr);
-    return ret;
+    if (cntlrFilter == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    OsalMemFree(cntlrFilter);
+    CanCntlrSyncHwFilters(cntlr);
+    return HDF_SUCCESS;
 }
 
 int32_t CanCntlrSetCfg(struct CanCntlr *cntlr, const struct CanConfig *cfg)
@@ -153,6 +254,7 @@ int32_t CanCntlrAddRxBox(struct CanCntlr *cntlr, struct CanRxBox *rxBox)
     (void)OsalMutexLock(&cntlr->rboxListLock);
     DListInsertTail(&rxBox->node, &cntlr->rxBoxList);
     (void)OsalMutexUnlock(&cntlr->rboxListLock);
+    (void)CanCntlrUpdateFilters(cntlr);
     return HDF_SUCCESS;
 }
 
@@ -172,6 +274,7 @@ int32_t CanCntlrDelRxBox(struct CanCntlr *cntlr, struct CanRxBox *rxBox)
         if (toRmv == rxBox) {
             DListRemove(&toRmv->node);
             (void)OsalMutexUnlock(&cntlr->rboxListLock);
+            (void)CanCntlrUpdateFilters(cntlr);
             return HDF_SUCCESS;
         }
     }
@@ -179,21 +282,212 @@ int32_t CanCntlrDelRxBox(struct CanCntlr *cntlr, struct CanRxBox *rxBox)
     return HDF_ERR_NOT_SUPPORT;
 }
 
-static int32_t CanCntlrMsgDispatch(struct CanCntlr *cntlr, struct CanMsg *msg)
+static void CanCntlrFreeHwFilter(struct CanHwFilter *hwFilter)
 {
-    struct CanRxBox *rxBox = NULL;
+    DListRemove(&hwFilter->node.node);
+    OsalMemFree(hwFilter);
+}
+
+static void CanCntlrDelHwFilters(struct CanCntlr *cntlr, const struct CanFilter *keep, uint32_t keepCount,
+    bool keepCntlrFilters)
+{
+    uint32_t i;
+    struct CanHwFilter *hwFilter = NULL;
+    struct CanHwFilter *tmp = NULL;
+
+    DLIST_FOR_EACH_ENTRY_SAFE(hwFilter, tmp, &cntlr->filters, struct CanHwFilter, node.node) {
+        for (i = 0; i < keepCount; i++) {
+            if (CanFilterEquals(&hwFilter->filter, &keep[i])) {
+                break;
+            }
+        }
+        if (i < keepCount ||
+            (keepCntlrFilters && CanCntlrFindFilter(&cntlr->cntlrFilters, &hwFilter->filter) != NULL)) {
+            continue;
+        }
+        if (cntlr->ops->delFilter(cntlr, &hwFilter->filter) != HDF_SUCCESS) {
+            HDF_LOGW("CanCntlrDelHwFilters: del hw filter of id 0x%x failed", hwFilter->filter.id);
+        }
+        CanCntlrFreeHwFilter(hwFilter);
+    }
+}
 
+static int32_t CanCntlrAddHwFilter(struct CanCntlr *cntlr, const struct CanFilter *filter, uint32_t *added)
+{
+    int32_t ret;
+    struct CanHwFilter *hwFilter = NULL;
+
+    if (CanCntlrFindFilter(&cntlr->filters, filter) != NULL) {
+        return HDF_SUCCESS;
+    }
+    hwFilter = CanCntlrNewFilter(filter);
+    if (hwFilter == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    ret = cntlr->ops->addFilter(cntlr, &hwFilter->filter);
+    if (ret != HDF_SUCCESS) {
+        OsalMemFree(hwFilter);
+        if (ret == HDF_PLT_OUT_OF_RSC) {
+            cntlr->hwFilterMax = *added; // later updates with more filters skip the hardware
+        }
+        HDF_LOGW("CanCntlrAddHwFilter: hw holds %u filters:%d, accept all frames", *added, ret);
+        return ret;
+    }
+    DListInsertTail(&hwFilter->node.node, &cntlr->filters);
+    (*added)++;
+    return HDF_SUCCESS;
+}
+
+static int32_t CanCntlrAddHwFilters(struct CanCntlr *cntlr, const struct CanFilter *filters, uint32_t count,
+    bool addCntlrFilters)
+{
+    int32_t ret;
+    uint32_t i;
+    uint32_t added = 0;
+    uint32_t wanted = count;
+    struct CanHwFilter *hwFilter = NULL;
+
+    if (addCntlrFilters) {
+        DLIST_FOR_EACH_ENTRY(hwFilter, &cntlr->cntlrFilters, struct CanHwFilter, node.node) {
+            wanted++;
+        }
+    }
+    if (cntlr->hwFilterMax != 0 && wanted > cntlr->hwFilterMax) {
+        return HDF_PLT_OUT_OF_RSC;
+    }
+    DLIST_FOR_EACH_ENTRY(hwFilter, &cntlr->filters, struct CanHwFilter, node.node) {
+        added++;
+    }
+    for (i = 0; i < count; i++) {
+        if ((ret = CanCntlrAddHwFilter(cntlr, &filters[i], &added)) != HDF_SUCCESS) {
+            return ret;
+        }
+    }
+    if (!addCntlrFilters) {
+        return HDF_SUCCESS;
+    }
+    DLIST_FOR_EACH_ENTRY(hwFilter, &cntlr->cntlrFilters, struct CanHwFilter, node.node) {
+        if ((ret = CanCntlrAddHwFilter(cntlr, &hwFilter->filter, &added)) != HDF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+/*
+ * Mirror the compiled table and the filters added to the controller in the hardware acceptance filters, if
+ * the controller has them. A box without filters, or more filters than the hardware holds, leaves the hardware
+ * accepting all frames, and software matching still decides which boxes get them. The hardware is only taken
+ * as full when it says so with HDF_PLT_OUT_OF_RSC, other refusals are retried on the next update.
+ * Lock order is the one of the send path: cntlr, then box list.
+ */
+static void CanCntlrSyncHwFilters(struct CanCntlr *cntlr)
+{
+    int32_t ret;
+    uint32_t count = 0;
+    bool acceptAll = false;
+    const struct CanFilter *filters = NULL;
+
+    if (cntlr->ops == NULL || cntlr->ops->addFilter == NULL || cntlr->ops->delFilter == NULL) {
+        return;
+    }
+    if (CanCntlrLock(cntlr) != HDF_SUCCESS) {
+        return;
+    }
     (void)OsalMutexLock(&cntlr->rboxListLock);
-    DLIST_FOR_EACH_ENTRY(rxBox, &cntlr->rxBoxList, struct CanRxBox, node) {
-        (void)CanRxBoxAddMsg(rxBox, msg);
+    acceptAll = CanFilterTableAcceptsAll(cntlr->filterTable);
+    if (!acceptAll) {
+        count = CanFilterTableGetFilters(cntlr->filterTable, &filters);
+    }
+    CanCntlrDelHwFilters(cntlr, filters, count, !acceptAll);
+    ret = CanCntlrAddHwFilters(cntlr, filters, count, !acceptAll);
+    if (ret != HDF_SUCCESS) {
+        CanCntlrDelHwFilters(cntlr, NULL, 0, false);
     }
     (void)OsalMutexUnlock(&cntlr->rboxListLock);
-    CanMsgPut(msg);
+    CanCntlrUnlock(cntlr);
+}
 
-    return HDF_SUCCESS;
+int32_t CanCntlrUpdateFilters(struct CanCntlr *cntlr)
+{
+    int32_t ret = HDF_SUCCESS;
+
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    (void)OsalMutexLock(&cntlr->rboxListLock);
+    CanFilterTableDestroy(cntlr->filterTable);
+    cntlr->filterTable = CanFilterTableBuild(&cntlr->rxBoxList);
+    if (cntlr->filterTable == NULL) {
+        // dispatch matches frames box by box until a later update succeeds
+        ret = HDF_ERR_MALLOC_FAIL;
+    }
+    (void)OsalMutexUnlock(&cntlr->rboxListLock);
+
+    CanCntlrSyncHwFilters(cntlr);
+    return ret;
+}
+
+void CanCntlrClearFilters(struct CanCntlr *cntlr)
+{
+    struct CanHwFilter *hwFilter = NULL;
+    struct CanHwFilter *tmp = NULL;
+
+    if (cntlr == NULL) {
+        return;
+    }
+    CanFilterTableDestroy(cntlr->filterTable);
+    cntlr->filterTable = NULL;
+    DLIST_FOR_EACH_ENTRY_SAFE(hwFilter, tmp, &cntlr->filters, struct CanHwFilter, node.node) {
+        CanCntlrFreeHwFilter(hwFilter);
+    }
+    DLIST_FOR_EACH_ENTRY_SAFE(hwFilter, tmp, &cntlr->cntlrFilters, struct CanHwFilter, node.node) {
+        CanCntlrFreeHwFilter(hwFilter);
+    }
+    cntlr->hwFilterMax = 0;
+}
+
+static void CanCntlrMsgDispatch(struct CanCntlr *cntlr, struct CanMsg *msg)
+{
+    uint32_t i;
+    uint32_t count;
+    struct CanRxBox **boxes = NULL;
+    struct CanRxBox *rxBox = NULL;
+
+    if (cntlr->filterTable != NULL) {
+        count = CanFilterTableMatch(cntlr->filterTable, msg, &boxes);
+        for (i = 0; i < count; i++) {
+            (void)CanRxBoxEnqueueMsg(boxes[i], msg);
+        }
+    } else {
+        DLIST_FOR_EACH_ENTRY(rxBox, &cntlr->rxBoxList, struct CanRxBox, node) {
+            (void)CanRxBoxAddMsg(rxBox, msg);
+        }
+    }
 }
 
 int32_t CanCntlrOnNewMsg(struct CanCntlr *cntlr, struct CanMsg *msg)
 {
-    return CanCntlrMsgDispatch(cntlr, msg); // gona call in thread context later ...
+    (void)OsalMutexLock(&cntlr->rboxListLock);
+    CanCntlrMsgDispatch(cntlr, msg); // gona call in thread context later ...
+    (void)OsalMutexUnlock(&cntlr->rboxListLock);
+    CanMsgPut(msg);
+    return HDF_SUCCESS;
+}
+
+// dispatch a burst of received messages under one acquisition of the box list
+int32_t CanCntlrOnNewMsgs(struct CanCntlr *cntlr, struct CanMsg **msgs, uint32_t count)
+{
+    uint32_t i;
+
+    (void)OsalMutexLock(&cntlr->rboxListLock);
+    for (i = 0; i < count; i++) {
+        CanCntlrMsgDispatch(cntlr, msgs[i]);
+    }
+    (void)OsalMutexUnlock(&cntlr->rboxListLock);
+    for (i = 0; i < count; i++) {
+        CanMsgPut(msgs[i]);
+    }
+    return HDF_SUCCESS;
 }
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "can/can_filter.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+
+#define HDF_LOG_TAG can_filter
+
+#define CAN_FILTER_ID_STD_RANGE 0x7FF
+#define CAN_FILTER_ID_EXT_RANGE 0x1FFFFFFF
+#define CAN_FILTER_KEY_RTR_SHIFT 29
+#define CAN_FILTER_KEY_IDE_SHIFT 30
+#define CAN_FILTER_KEY_USED      (1U << 31)
+#define CAN_FILTER_HASH_MUL      0x9E3779B1U
+#define CAN_FILTER_HASH_GROUP    0x85EBCA77U
+#define CAN_FILTER_HASH_SHIFT    15
+#define CAN_FILTER_LINK_NONE     0xFFFFFFFFU
+#define CAN_FILTER_IDE_VARIANTS  2 // a filter ignoring ide is keyed once for each frame format
+
+struct CanFilterGroup {
+    uint32_t idMask;
+    uint32_t rtrMask;
+    uint32_t ideMask;
+};
+
+struct CanFilterEntry {
+    uint32_t key;       // CAN_FILTER_KEY_USED | ide | rtr | masked id, 0 for a free slot
+    uint32_t group;
+    uint32_t firstLink; // chain of boxes accepting this key
+};
+
+struct CanFilterLink {
+    uint32_t box;
+    uint32_t next;
+};
+
+struct CanFilterTable {
+    uint32_t boxCount;
+    uint32_t acceptAllCount;
+    uint32_t filterCount;
+    uint32_t groupCount;
+    uint32_t entryMask;
+    uint32_t linkCount;
+    uint32_t generation;
+    struct CanRxBox **boxes;
+    struct CanRxBox **matched;
+    uint32_t *stamps;
+    uint32_t *acceptAll;
+    struct CanFilter *filters;
+    struct CanFilterGroup *groups;
+    struct CanFilterEntry *entries;
+    struct CanFilterLink *links;
+};
+
+bool CanFilterEquals(const struct CanFilter *filterA, const struct CanFilter *filterB)
+{
+    return filterA->rtr == filterB->rtr && filterA->ide == filterB->ide && filterA->id == filterB->id &&
+        filterA->rtrMask == filterB->rtrMask && filterA->ideMask == filterB->ideMask &&
+        filterA->idMask == filterB->idMask && filterA->type == filterB->type;
+}
+
+static inline uint32_t CanFilterIdRange(uint32_t ide)
+{
+    // same id width as CanFilterMatch() of the rx box
+    return (ide == 1) ? CAN_FILTER_ID_STD_RANGE : CAN_FILTER_ID_EXT_RANGE;
+}
+
+static inline uint32_t CanFilterMakeKey(const struct CanFilterGroup *group, uint32_t id, uint32_t rtr, uint32_t ide)
+{
+    uint32_t key = CAN_FILTER_KEY_USED | (ide << CAN_FILTER_KEY_IDE_SHIFT);
+
+    key |= id & group->idMask & CanFilterIdRange(ide);
+    if (group->rtrMask == 1) {
+        key |= rtr << CAN_FILTER_KEY_RTR_SHIFT;
+    }
+    return key;
+}
+
+static inline uint32_t CanFilterHash(uint32_t key, uint32_t group)
+{
+    uint32_t hash = key * CAN_FILTER_HASH_MUL + group * CAN_FILTER_HASH_GROUP;
+    return hash ^ (hash >> CAN_FILTER_HASH_SHIFT);
+}
+
+static struct CanFilterEntry *CanFilterTableFindEntry(struct CanFilterTable *table, uint32_t key, uint32_t group)
+{
+    uint32_t i;
+    struct CanFilterEntry *entry = NULL;
+
+    if (table->entries == NULL) {
+        return NULL;
+    }
+    for (i = CanFilterHash(key, group) & table->entryMask;; i = (i + 1) & table->entryMask) {
+        entry = &table->entries[i];
+        if (entry->key == 0) {
+            return entry; // free slot, the key is not in table
+        }
+        if (entry->key == key && entry->group == group) {
+            return entry;
+        }
+    }
+}
+
+static void CanFilterTableAddKey(struct CanFilterTable *table, uint32_t key, uint32_t group, uint32_t box)
+{
+    uint32_t link;
+    struct CanFilterEntry *entry = CanFilterTableFindEntry(table, key, group);
+
+    if (entry->key == 0) {
+        entry->key = key;
+        entry->group = group;
+        entry->firstLink = CAN_FILTER_LINK_NONE;
+    }
+    for (link = entry->firstLink; link != CAN_FILTER_LINK_NONE; link = table->links[link].next) {
+        if (table->links[link].box == box) {
+            return; // another filter of the same box accepts the key
+        }
+    }
+    link = table->linkCount++;
+    table->links[link].box = box;
+    table->links[link].next = entry->firstLink;
+    entry->firstLink = link;
+}
+
+static uint32_t CanFilterTableAddGroup(struct CanFilterTable *table, const struct CanFilter *filter)
+{
+    uint32_t i;
+    struct CanFilterGroup *group = NULL;
+
+    for (i = 0; i < table->groupCount; i++) {
+        group = &table->groups[i];
+        if (group->idMask == filter->idMask && group->rtrMask == filter->rtrMask &&
+            group->ideMask == filter->ideMask) {
+            return i;
+        }
+    }
+    group = &table->groups[table->groupCount];
+    group->idMask = filter->idMask;
+    group->rtrMask = filter->rtrMask;
+    group->ideMask = filter->ideMask;
+    return table->groupCount++;
+}
+
+static void CanFilterTableAddFilter(struct CanFilterTable *table, const struct CanFilter *filter, uint32_t box)
+{
+    uint32_t i;
+    uint32_t ide;
+    uint32_t group = CanFilterTableAddGroup(table, filter);
+
+    for (ide = 0; ide < CAN_FILTER_IDE_VARIANTS; ide++) {
+        if (filter->ideMask == 1 && filter->ide != ide) {
+            continue;
+        }
+        CanFilterTableAddKey(table, CanFilterMakeKey(&table->groups[group], filter->id, filter->rtr, ide), group,
+            box);
+    }
+
+    for (i = 0; i < table->filterCount; i++) {
+        if (CanFilterEquals(&table->filters[i], filter)) {
+            return;
+        }
+    }
+    table->filters[table->filterCount++] = *filter;
+}
+
+static uint32_t CanFilterCountBoxFilters(struct CanRxBox *rbox)
+{
+    uint32_t count = 0;
+    struct CanFilterNode *cfNode = NULL;
+
+    CanRxBoxLock(rbox);
+    DLIST_FOR_EACH_ENTRY(cfNode, &rbox->filters, struct CanFilterNode, node) {
+        count++;
+    }
+    CanRxBoxUnlock(rbox);
+    return count;
+}
+
+static uint32_t CanFilterEntryCount(uint32_t linkMax)
+{
+    uint32_t count = 1;
+
+    // at most half full, so a probe for a missing key ends soon
+    while (count < linkMax * 2) {
+        count <<= 1;
+    }
+    return count;
+}
+
+static struct CanFilterTable *CanFilterTableAlloc(uint32_t boxCount, uint32_t filterMax)
+{
+    uint32_t linkMax = filterMax * CAN_FILTER_IDE_VARIANTS;
+    uint32_t entryCount = (filterMax == 0) ? 0 : CanFilterEntryCount(linkMax);
+    struct CanFilterTable *table = NULL;
+    uint8_t *mem = NULL;
+    size_t size = sizeof(*table) + (sizeof(struct CanRxBox *) * 2 + sizeof(uint32_t) * 2) * boxCount +
+        (sizeof(struct CanFilter) + sizeof(struct CanFilterGroup)) * filterMax +
+        sizeof(struct CanFilterEntry) * entryCount + sizeof(struct CanFilterLink) * linkMax;
+
+    // one block, pointer arrays first to keep every part aligned
+    mem = (uint8_t *)OsalMemCalloc(size);
+    if (mem == NULL) {
+        return NULL;
+    }
+    table = (struct CanFilterTable *)mem;
+    mem += sizeof(*table);
+    table->boxes = (struct CanRxBox **)mem;
+    mem += sizeof(struct CanRxBox *) * boxCount;
+    table->matched = (struct CanRxBox **)mem;
+    mem += sizeof(struct CanRxBox *) * boxCount;
+    table->stamps = (uint32_t *)mem;
+    mem += sizeof(uint32_t) * boxCount;
+    table->acceptAll = (uint32_t *)mem;
+    mem += sizeof(uint32_t) * boxCount;
+    table->filters = (struct CanFilter *)mem;
+    mem += sizeof(struct CanFilter) * filterMax;
+    table->groups = (struct CanFilterGroup *)mem;
+    mem += sizeof(struct CanFilterGroup) * filterMax;
+    table->entries = (entryCount == 0) ? NULL : (struct CanFilterEntry *)mem;
+    mem += sizeof(struct CanFilterEntry) * entryCount;
+    table->links = (struct CanFilterLink *)mem;
+    table->entryMask = (entryCount == 0) ? 0 : entryCount - 1;
+    return table;
+}
+
+struct CanFilterTable *CanFilterTableBuild(struct DListHead *rxBoxList)
+{
+    uint32_t box = 0;
+    uint32_t boxCount = 0;
+    uint32_t filterMax = 0;
+    uint32_t filterLeft;
+    struct CanRxBox *rbox = NULL;
+    struct CanFilterNode *cfNode = NULL;
+    struct CanFilterTable *table = NULL;
+
+    DLIST_FOR_EACH_ENTRY(rbox, rxBoxList, struct CanRxBox, node) {
+        boxCount++;
+        filterMax += CanFilterCountBoxFilters(rbox);
+    }
+
+    table = CanFilterTableAlloc(boxCount, filterMax);
+    if (table == NULL) {
+        HDF_LOGE("CanFilterTableBuild: alloc table of %u boxes, %u filters failed", boxCount, filterMax);
+        return NULL;
+    }
+
+    // a filter added after counting is left out here, and compiled by the rebuild its addition triggers
+    filterLeft = filterMax;
+    DLIST_FOR_EACH_ENTRY(rbox, rxBoxList, struct CanRxBox, node) {
+        bool hasFilter = false;
+        table->boxes[box] = rbox;
+        CanRxBoxLock(rbox);
+        DLIST_FOR_EACH_ENTRY(cfNode, &rbox->filters, struct CanFilterNode, node) {
+            if (filterLeft == 0) {
+                break;
+            }
+            CanFilterTableAddFilter(table, cfNode->filter, box);
+            filterLeft--;
+            hasFilter = true;
+        }
+        CanRxBoxUnlock(rbox);
+        if (!hasFilter) {
+            table->acceptAll[table->acceptAllCount++] = box;
+        }
+        box++;
+    }
+    table->boxCount = box;
+    return table;
+}
+
+void CanFilterTableDestroy(struct CanFilterTable *table)
+{
+    if (table != NULL) {
+        OsalMemFree(table);
+    }
+}
+
+uint32_t CanFilterTableMatch(struct CanFilterTable *table, const struct CanMsg *cmsg, struct CanRxBox ***boxes)
+{
+    uint32_t i;
+    uint32_t key;
+    uint32_t link;
+    uint32_t count = 0;
+    uint32_t generation;
+    const struct CanFilterEntry *entry = NULL;
+
+    if (table == NULL || cmsg == NULL || boxes == NULL) {
+        return 0;
+    }
+
+    // a box matched by several groups is reported once, stamps of the last generation mark it
+    generation = ++table->generation;
+    if (generation == 0) {
+        for (i = 0; i < table->boxCount; i++) {
+            table->stamps[i] = 0;
+        }
+        generation = table->generation = 1;
+    }
+
+    for (i = 0; i < table->acceptAllCount; i++) {
+        table->stamps[table->acceptAll[i]] = generation;
+        table->matched[count++] = table->boxes[table->acceptAll[i]];
+    }
+    for (i = 0; i < table->groupCount; i++) {
+        key = CanFilterMakeKey(&table->groups[i], cmsg->id, cmsg->rtr, cmsg->ide);
+        entry = CanFilterTableFindEntry(table, key, i);
+        if (entry == NULL || entry->key == 0) {
+            continue;
+        }
+        for (link = entry->firstLink; link != CAN_FILTER_LINK_NONE; link = table->links[link].next) {
+            if (table->stamps[table->links[link].box] != generation) {
+                table->stamps[table->links[link].box] = generation;
+                table->matched[count++] = table->boxes[table->links[link].box];
+            }
+        }
+    }
+    *boxes = table->matched;
+    return count;
+}
+
+bool CanFilterTableAcceptsAll(const struct CanFilterTable *table)
+{
+    return table == NULL || table->acceptAllCount > 0;
+}
+
+uint32_t CanFilterTableGetFilters(const struct CanFilterTable *table, const struct CanFilter **filters)
+{
+    if (table == NULL || filters == NULL || table->acceptAllCount > 0) {
+        return 0;
+    }
+    *filters = table->filters;
+    return table->filterCount;
+}
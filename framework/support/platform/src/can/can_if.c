@@ -37,6 +37,16 @@ int32_t CanBusReadMsg(DevHandle handle, struct CanMsg *msg, uint32_t tms)
     return CanClientReadMsg((struct CanClient *)handle, msg, tms);
 }
 
+int32_t CanBusSendMsgs(DevHandle handle, const struct CanMsg *msgs, uint32_t count)
+{
+    return CanClientWriteMsgs((struct CanClient *)handle, msgs, count);
+}
+
+int32_t CanBusReadMsgs(DevHandle handle, struct CanMsg *msgs, uint32_t count, uint32_t tms)
+{
+    return CanClientReadMsgs((struct CanClient *)handle, msgs, count, tms);
+}
+
 int32_t CanBusAddFilter(DevHandle handle, const struct CanFilter *filter)
 {
     return CanClientAddFilter((struct CanClient *)handle, filter);
@@ -7,10 +7,20 @@
  */
 
 #include "can/can_mail.h"
+#include "can/can_filter.h"
 #include "can/can_msg.h"
 #include "hdf_dlist.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_time.h"
+
+#define CAN_RX_BOX_MASK (CAN_RX_BOX_DEPTH - 1)
+
+// the box keeps its own copy, the filter passed in may be gone once the call returns
+struct CanRxBoxFilter {
+    struct CanFilterNode node;
+    struct CanFilter filter;
+};
 
 struct CanRxBox *CanRxBoxCreate()
 {
@@ -22,78 +32,224 @@ struct CanRxBox *CanRxBoxCreate()
         return NULL;
     }
 
-    rbox->queue = PlatformQueueCreate(NULL, "can_rbox", rbox);
-    if (rbox->queue == NULL) {
-        HDF_LOGE("CanRxBoxCreate: create rbox queue failed");
+    if (OsalSemInit(&rbox->sem, 0) != HDF_SUCCESS) {
+        HDF_LOGE("CanRxBoxCreate: init rbox sem failed");
         OsalMemFree(rbox);
         return NULL;
     }
 
+    OsalAtomicSet(&rbox->policy, CAN_RX_BOX_DROP_NEWEST);
     DListHeadInit(&rbox->filters);
     (void)OsalSpinInit(&rbox->spin);
     return rbox;
 }
 
+static inline bool CanRxBoxIsEmpty(struct CanRxBox *rbox)
+{
+    return OsalAtomicReadAcquire(&rbox->head) == OsalAtomicReadAcquire(&rbox->tail);
+}
+
+static struct CanMsg *CanRxBoxTake(struct CanRxBox *rbox)
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t seen;
+    struct CanMsg *cmsg = NULL;
+
+    seen = (uint32_t)OsalAtomicReadAcquire(&rbox->tail);
+    do {
+        tail = seen;
+        head = (uint32_t)OsalAtomicReadAcquire(&rbox->head);
+        if (head == tail) {
+            return NULL;
+        }
+        // the slot may be refilled once tail moves, so it is read before claiming it
+        cmsg = rbox->ring[tail & CAN_RX_BOX_MASK];
+        seen = (uint32_t)OsalAtomicCmpXchg(&rbox->tail, (int32_t)tail, (int32_t)(tail + 1));
+    } while (seen != tail);
+    return cmsg;
+}
+
 void CanRxBoxDestroy(struct CanRxBox *rbox)
 {
+    struct CanMsg *cmsg = NULL;
+    struct CanRxBoxFilter *boxFilter = NULL;
+    struct CanRxBoxFilter *tmp = NULL;
+
     if (rbox != NULL) {
-        if (rbox->queue != NULL) {
-            PlatformQueueDestroy(rbox->queue);
+        while ((cmsg = CanRxBoxTake(rbox)) != NULL) {
+            CanMsgPut(cmsg);
+        }
+        DLIST_FOR_EACH_ENTRY_SAFE(boxFilter, tmp, &rbox->filters, struct CanRxBoxFilter, node.node) {
+            DListRemove(&boxFilter->node.node);
+            OsalMemFree(boxFilter);
         }
+        (void)OsalSemDestroy(&rbox->sem);
         OsalSpinDestroy(&rbox->spin);
         OsalMemFree(rbox);
     }
 }
 
+void CanRxBoxSetPolicy(struct CanRxBox *rbox, enum CanRxBoxPolicy policy)
+{
+    if (rbox != NULL) {
+        OsalAtomicSet(&rbox->policy, (int32_t)policy);
+    }
+}
+
+void CanRxBoxGetDropCount(struct CanRxBox *rbox, uint32_t *dropOldest, uint32_t *dropNewest)
+{
+    if (rbox == NULL) {
+        return;
+    }
+    if (dropOldest != NULL) {
+        *dropOldest = (uint32_t)OsalAtomicRead(&rbox->dropOldest);
+    }
+    if (dropNewest != NULL) {
+        *dropNewest = (uint32_t)OsalAtomicRead(&rbox->dropNewest);
+    }
+}
+
 static bool CanRxBoxMsgMatch(struct CanRxBox *, const struct CanMsg *);
 
-int32_t CanRxBoxAddMsg(struct CanRxBox *rbox, struct CanMsg *cmsg)
+/*
+ * Called by the controller dispatch with rboxListLock held, which makes it the only producer of the box.
+ * A message dropped for the oldest one keeps the number of messages in ring, so the semaphore is not posted.
+ */
+int32_t CanRxBoxEnqueueMsg(struct CanRxBox *rbox, struct CanMsg *cmsg)
 {
-    int32_t ret;
-    struct PlatformMsg *pmsg = NULL;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t seen;
+    struct CanMsg *oldest = NULL;
 
     if (rbox == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    if (!CanRxBoxMsgMatch(rbox, cmsg)) {
-        return HDF_ERR_NOT_SUPPORT;
+    head = (uint32_t)OsalAtomicRead(&rbox->head);
+    tail = (uint32_t)OsalAtomicReadAcquire(&rbox->tail);
+    while (head - tail >= CAN_RX_BOX_DEPTH) {
+        if (OsalAtomicRead(&rbox->policy) != CAN_RX_BOX_DROP_OLDEST) {
+            OsalAtomicInc(&rbox->dropNewest);
+            return HDF_PLT_OUT_OF_RSC;
+        }
+        oldest = rbox->ring[tail & CAN_RX_BOX_MASK];
+        seen = (uint32_t)OsalAtomicCmpXchg(&rbox->tail, (int32_t)tail, (int32_t)(tail + 1));
+        if (seen == tail) {
+            CanMsgPut(oldest);
+            OsalAtomicInc(&rbox->dropOldest);
+            CanMsgGet(cmsg); // increase ref count before enqueue
+            rbox->ring[head & CAN_RX_BOX_MASK] = cmsg;
+            OsalAtomicSetRelease(&rbox->head, (int32_t)(head + 1));
+            return HDF_SUCCESS;
+        }
+        // a reader took a message meanwhile
+        tail = seen;
     }
 
-    pmsg = (struct PlatformMsg *)OsalMemCalloc(sizeof(*pmsg));
-    if (pmsg == NULL) {
-        return HDF_ERR_MALLOC_FAIL;
-    }
-    pmsg->data = cmsg;
     CanMsgGet(cmsg); // increase ref count before enqueue
-    ret = PlatformQueueAddMsg(rbox->queue, pmsg);
-    if (ret != HDF_SUCCESS) {
-        OsalMemFree(pmsg);
-        CanMsgPut(cmsg); // decrase ref count if enqueue failed 
+    rbox->ring[head & CAN_RX_BOX_MASK] = cmsg;
+    OsalAtomicSetRelease(&rbox->head, (int32_t)(head + 1));
+    (void)OsalSemPost(&rbox->sem);
+    return HDF_SUCCESS;
+}
+
+int32_t CanRxBoxAddMsg(struct CanRxBox *rbox, struct CanMsg *cmsg)
+{
+    if (rbox == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
     }
-    return ret;
+
+    if (!CanRxBoxMsgMatch(rbox, cmsg)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    return CanRxBoxEnqueueMsg(rbox, cmsg);
 }
 
 int32_t CanRxBoxGetMsg(struct CanRxBox *rbox, struct CanMsg **cmsg, uint32_t tms)
 {
     int32_t ret;
-    struct PlatformMsg *pmsg = NULL;
 
     if (rbox == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    ret = PlatformQueueGetMsg(rbox->queue, &pmsg, tms);
+    if (tms == 0 && CanRxBoxIsEmpty(rbox)) {
+        return HDF_PLT_ERR_NO_DATA;
+    }
+
+    ret = OsalSemWait(&rbox->sem, tms);
     if (ret != HDF_SUCCESS) {
-        HDF_LOGE("CanRxBoxGetMsg: get platform msg failed:%d", ret);
+        if (tms == 0) {
+            return HDF_PLT_ERR_NO_DATA;
+        }
+        HDF_LOGE("CanRxBoxGetMsg: wait rbox msg failed:%d", ret);
         return ret;
     }
 
-    *cmsg = (struct CanMsg *)pmsg->data;
-    OsalMemFree(pmsg);
+    /*
+     * Each semaphore count stands for a message in ring. Drop oldest replaces a message instead of removing it,
+     * so the ring may only look empty for the moment between moving tail and head.
+     */
+    do {
+        *cmsg = CanRxBoxTake(rbox);
+    } while (*cmsg == NULL);
     return HDF_SUCCESS;
 }
 
+/*
+ * Copy out up to count messages, waiting tms in total. Once the first message is in, the ones already queued are
+ * taken without sleeping, and a batch that runs out of time returns what it has so far.
+ */
+int32_t CanRxBoxGetMsgs(struct CanRxBox *rbox, struct CanMsg *msgs, uint32_t count, uint32_t tms)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t got = 0;
+    uint32_t wait = tms;
+    uint64_t now;
+    uint64_t deadline = 0;
+    struct CanMsg *cmsg = NULL;
+
+    if (rbox == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (msgs == NULL || count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (tms != 0 && tms != HDF_WAIT_FOREVER) {
+        deadline = OsalGetSysTimeMs() + tms;
+    }
+    while (got < count) {
+        if (wait == 0 && CanRxBoxIsEmpty(rbox)) {
+            ret = (tms == 0) ? HDF_PLT_ERR_NO_DATA : HDF_ERR_TIMEOUT;
+            break;
+        }
+        if ((ret = OsalSemWait(&rbox->sem, wait)) != HDF_SUCCESS) {
+            break;
+        }
+        do {
+            cmsg = CanRxBoxTake(rbox);
+        } while (cmsg == NULL);
+        msgs[got++] = *cmsg;
+        CanMsgPut(cmsg);
+
+        if (deadline != 0 && CanRxBoxIsEmpty(rbox)) {
+            now = OsalGetSysTimeMs();
+            wait = (now < deadline) ? (uint32_t)(deadline - now) : 0;
+        }
+    }
+
+    if (got == 0) {
+        if (tms == 0 && ret == HDF_ERR_TIMEOUT) {
+            return HDF_PLT_ERR_NO_DATA;
+        }
+        return ret;
+    }
+    return (int32_t)got;
+}
+
 static bool CanFilterMatch(const struct CanFilter *filter, const struct CanMsg *cmsg)
 {
     (void)filter;
@@ -136,7 +292,7 @@ static bool CanRxBoxMsgMatch(struct CanRxBox *rbox, const struct CanMsg *cmsg)
 
 int32_t CanRxBoxAddFilter(struct CanRxBox *rbox, const struct CanFilter *filter)
 {
-    struct CanFilterNode *cfNode = NULL;
+    struct CanRxBoxFilter *boxFilter = NULL;
 
     if (rbox == NULL) {
         return HDF_ERR_INVALID_OBJECT;
@@ -144,22 +300,23 @@ int32_t CanRxBoxAddFilter(struct CanRxBox *rbox, const struct CanFilter *filter)
     if (filter == NULL) {
         return HDF_ERR_INVALID_PARAM;
     }
-    cfNode = (struct CanFilterNode *)OsalMemCalloc(sizeof(*cfNode));
-    if (cfNode == NULL) {
+    boxFilter = (struct CanRxBoxFilter *)OsalMemCalloc(sizeof(*boxFilter));
+    if (boxFilter == NULL) {
         return HDF_ERR_MALLOC_FAIL;
     }
-    cfNode->filter = filter;
-    cfNode->active = true;
+    boxFilter->filter = *filter;
+    boxFilter->node.filter = &boxFilter->filter;
+    boxFilter->node.active = true;
     CanRxBoxLock(rbox);
-    DListInsertTail(&cfNode->node, &rbox->filters);
+    DListInsertTail(&boxFilter->node.node, &rbox->filters);
     CanRxBoxUnlock(rbox);
     return HDF_SUCCESS;
 }
 
 int32_t CanRxBoxDelFilter(struct CanRxBox *rbox, const struct CanFilter *filter)
 {
-    struct CanFilterNode *cfNode = NULL;
-    struct CanFilterNode *tmp = NULL;
+    struct CanRxBoxFilter *boxFilter = NULL;
+    struct CanRxBoxFilter *tmp = NULL;
 
     if (rbox == NULL) {
         return HDF_ERR_INVALID_OBJECT;
@@ -168,11 +325,11 @@ int32_t CanRxBoxDelFilter(struct CanRxBox *rbox, const struct CanFilter *filter)
         return HDF_ERR_INVALID_PARAM;
     }
     CanRxBoxLock(rbox);
-    DLIST_FOR_EACH_ENTRY_SAFE(cfNode, tmp, &rbox->filters, struct CanFilterNode, node) {
-        if (cfNode->filter == filter) {
-            DListRemove(&cfNode->node);
+    DLIST_FOR_EACH_ENTRY_SAFE(boxFilter, tmp, &rbox->filters, struct CanRxBoxFilter, node.node) {
+        if (CanFilterEquals(&boxFilter->filter, filter)) {
+            DListRemove(&boxFilter->node.node);
             CanRxBoxUnlock(rbox);
-            OsalMemFree(cfNode);
+            OsalMemFree(boxFilter);
             return HDF_SUCCESS;
         }
     }
@@ -48,6 +48,10 @@ int32_t CanCntlrAdd(struct CanCntlr *cntlr)
     }
 
     DListHeadInit(&cntlr->rxBoxList);
+    DListHeadInit(&cntlr->filters);
+    DListHeadInit(&cntlr->cntlrFilters);
+    cntlr->hwFilterMax = 0;
+    cntlr->filterTable = NULL;
 
     if (OsalMutexInit(&cntlr->lock) != HDF_SUCCESS) {
         HDF_LOGE("CanCntlrAdd: init lock failed");
@@ -94,6 +98,7 @@ int32_t CanCntlrDel(struct CanCntlr *cntlr)
 
     PlatformDeviceDel(&cntlr->device);
     PlatformDeviceClearName(&cntlr->device);
+    CanCntlrClearFilters(cntlr);
     (void)OsalMutexDestroy(&cntlr->rboxListLock);
     (void)OsalMutexDestroy(&cntlr->lock);
 
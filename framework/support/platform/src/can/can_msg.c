@@ -8,13 +8,91 @@
 
 #include "can/can_msg.h"
 #include "hdf_dlist.h"
+#include "osal_atomic.h"
 #include "osal_mem.h"
+#include "securec.h"
+
+#ifndef CAN_MSG_SLAB_SIZE
+#define CAN_MSG_SLAB_SIZE 128
+#endif
+
+#define CAN_MSG_SLAB_NONE      0xFFFFU
+#define CAN_MSG_SLAB_IDX_MASK  0xFFFFU
+#define CAN_MSG_SLAB_TAG_MASK  0xFFFF0000U
+#define CAN_MSG_SLAB_TAG_UNIT  0x10000U
+
+// holder indexes share the free list top with the tag, 16 bits each, and CAN_MSG_SLAB_NONE marks the end
+#if (CAN_MSG_SLAB_SIZE <= 0) || (CAN_MSG_SLAB_SIZE >= CAN_MSG_SLAB_NONE)
+#error "CAN_MSG_SLAB_SIZE must be in [1, 0xFFFF) to fit the 16-bit free list index"
+#endif
 
 struct CanMsgHolder {
     struct HdfSRef ref;
     struct CanMsg cmsg;
+    uint16_t slabNext; // index of the next free holder while in the slab free list
+    bool inSlab;
 };
 
+/*
+ * Messages are obtained on the receive path, often from interrupt context, and put back by readers on other
+ * threads. Holders come from a static slab so a busy bus does not allocate per frame; the free list is a
+ * lock-free stack whose top packs the holder index with a tag bumped on every change, against ABA.
+ */
+static struct CanMsgHolder g_canMsgSlab[CAN_MSG_SLAB_SIZE];
+static OsalAtomic g_canMsgSlabTop = { CAN_MSG_SLAB_NONE }; // tag << 16 | index of the first free holder
+static OsalAtomic g_canMsgSlabUsed = { 0 };                 // holders never handed out start at this index
+
+static struct CanMsgHolder *CanMsgSlabAlloc(void)
+{
+    uint32_t top;
+    uint32_t seen;
+    uint32_t next;
+    int32_t used;
+    int32_t usedSeen;
+    struct CanMsgHolder *holder = NULL;
+
+    top = (uint32_t)OsalAtomicReadAcquire(&g_canMsgSlabTop);
+    while ((top & CAN_MSG_SLAB_IDX_MASK) != CAN_MSG_SLAB_NONE) {
+        holder = &g_canMsgSlab[top & CAN_MSG_SLAB_IDX_MASK];
+        // slabNext may change under a racing pop and push, the tag then fails the exchange
+        next = ((top + CAN_MSG_SLAB_TAG_UNIT) & CAN_MSG_SLAB_TAG_MASK) | holder->slabNext;
+        seen = (uint32_t)OsalAtomicCmpXchg(&g_canMsgSlabTop, (int32_t)top, (int32_t)next);
+        if (seen == top) {
+            return holder;
+        }
+        top = seen;
+    }
+
+    used = OsalAtomicRead(&g_canMsgSlabUsed);
+    while (used < CAN_MSG_SLAB_SIZE) {
+        usedSeen = OsalAtomicCmpXchg(&g_canMsgSlabUsed, used, used + 1);
+        if (usedSeen == used) {
+            holder = &g_canMsgSlab[used];
+            holder->inSlab = true;
+            return holder;
+        }
+        used = usedSeen;
+    }
+    return NULL;
+}
+
+static void CanMsgSlabFree(struct CanMsgHolder *holder)
+{
+    uint32_t top;
+    uint32_t seen;
+    uint32_t next;
+    uint32_t index = (uint32_t)(holder - g_canMsgSlab);
+
+    seen = (uint32_t)OsalAtomicRead(&g_canMsgSlabTop);
+    do {
+        top = seen;
+        holder->slabNext = (uint16_t)(top & CAN_MSG_SLAB_IDX_MASK);
+        next = ((top + CAN_MSG_SLAB_TAG_UNIT) & CAN_MSG_SLAB_TAG_MASK) | index;
+        // the exchange is fully ordered, a holder popped from the list sees the slabNext written here
+        seen = (uint32_t)OsalAtomicCmpXchg(&g_canMsgSlabTop, (int32_t)top, (int32_t)next);
+    } while (seen != top);
+}
+
 struct CanClient {
     struct CanCntlr *cntlr;
     struct CanRxBox *rxBox; // receive message box
@@ -33,7 +111,11 @@ static void CanMsgDoRecycle(struct CanMsg *msg)
         return;
     }
     msgExt = CONTAINER_OF(msg, struct CanMsgHolder, cmsg);
-    OsalMemFree(msgExt);
+    if (msgExt->inSlab) {
+        CanMsgSlabFree(msgExt);
+    } else {
+        OsalMemFree(msgExt);
+    }
 }
 
 static void CanMsgHolderOnLastPut(struct HdfSRef *sref)
@@ -56,9 +138,15 @@ struct CanMsg *CanMsgObtain(void)
 {
     struct CanMsgHolder *msgExt = NULL;
 
-    msgExt = (struct CanMsgHolder *)OsalMemCalloc(sizeof(*msgExt));
-    if (msgExt == NULL) {
-        return NULL;
+    msgExt = CanMsgSlabAlloc();
+    if (msgExt != NULL) {
+        (void)memset_s(&msgExt->cmsg, sizeof(msgExt->cmsg), 0, sizeof(msgExt->cmsg));
+    } else {
+        // slab exhausted, readers are far behind the bus
+        msgExt = (struct CanMsgHolder *)OsalMemCalloc(sizeof(*msgExt));
+        if (msgExt == NULL) {
+            return NULL;
+        }
     }
     HdfSRefConstruct(&msgExt->ref, &g_canMsgExtListener);
     CanMsgGet(&msgExt->cmsg);
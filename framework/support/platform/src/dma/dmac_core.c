@@ -12,11 +12,21 @@
 #include "osal_io.h"
 #include "osal_irq.h"
 #include "osal_mem.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG dmac_core
 
 #define DMA_ALIGN_SIZE 256
 #define DMA_MAX_TRANS_SIZE_DEFAULT 256
+#define DMAC_LLI_NUM_MAX 2048
+
+#ifndef CACHE_ALIGNED_SIZE
+#define CACHE_ALIGNED_SIZE 64
+#endif
+
+#ifndef ALIGN
+#define ALIGN(size, align) (((size) + (align) - 1) & ~((align) - 1))
+#endif
 
 static int32_t DmacCntlrCheckOps(struct DmaCntlr *cntlr)
 {
@@ -128,9 +138,12 @@ struct DmaCntlr *DmaCntlrCreate(struct HdfDeviceObject *device)
 static void DmacFreeLli(struct DmacChanInfo *chanInfo)
 {
     if (chanInfo != NULL && chanInfo->lli != NULL) {
-        OsalMemFree(chanInfo->lli);
+        if (!chanInfo->lliPooled) {
+            OsalMemFree(chanInfo->lli);
+        }
         chanInfo->lli = NULL;
         chanInfo->lliCnt = 0;
+        chanInfo->lliPooled = false;
     }
 }
 
@@ -148,11 +161,16 @@ void DmaCntlrDestroy(struct DmaCntlr *cntlr)
     if (cntlr->channelList != NULL) {
         for (i = 0; i < cntlr->channelNum; i++) {
             DmacFreeLli(&(cntlr->channelList[i]));
+            OsalMemFree(cntlr->channelList[i].dummyPage);
         }
         OsalMemFree(cntlr->channelList);
         cntlr->channelList = NULL;
         cntlr->channelNum = 0;
     }
+    if (cntlr->lliPool != NULL) {
+        OsalMemFree(cntlr->lliPool);
+        cntlr->lliPool = NULL;
+    }
     /* Private is released by the caller */
     cntlr->private = NULL;
     OsalMemFree(cntlr);
@@ -190,7 +208,7 @@ static int32_t DmacWaitM2mSendComplete(struct DmaCntlr *cntlr, struct DmacChanIn
     if (ret == DMAC_EVENT_ERROR) {
         HDF_LOGE("%s: wait event error", __func__);
         return DMAC_CHN_ERROR;
-    } else if (ret == LOS_ERRNO_EVENT_READ_TIMEOUT) {
+    } else if (ret == DMA_EVENT_WAIT_TIMEOUT) {
         HDF_LOGE("%s: wait event timeout", __func__);
         return DMAC_CHN_TIMEOUT;
     }
@@ -199,7 +217,7 @@ static int32_t DmacWaitM2mSendComplete(struct DmaCntlr *cntlr, struct DmacChanIn
     return DMAC_CHN_SUCCESS;
 }
 
-static uint16_t DmacAllocateChannel(struct DmaCntlr *cntlr)
+static int DmacAllocateChannel(struct DmaCntlr *cntlr)
 {
     int i;
     uint32_t flags;
@@ -269,10 +287,10 @@ static struct DmacChanInfo *DmacRequestChannel(struct DmaCntlr *cntlr, struct Dm
 static uintptr_t DmacGetDummyBuf(struct DmaCntlr *cntlr, struct DmacChanInfo *chan)
 {
     if (chan->dummyPage == NULL) {
-        chan->dummyPage = OsalMemCalloc(sizeof(cntlr->maxTransSize));
+        chan->dummyPage = OsalMemCalloc(cntlr->maxTransSize);
     }
 
-    return (chan->dummyPage == NULL) ? 0 : (uintptr_t)LOS_PaddrQuery(chan->dummyPage);
+    return (chan->dummyPage == NULL) ? 0 : cntlr->dmacVaddrToPaddr(chan->dummyPage);
 }
 
 static inline size_t DmacAlignedTransMax(size_t maxSize, uint8_t srcWidth, uint8_t destWidth)
@@ -287,77 +305,98 @@ static inline size_t DmacAlignedTransMax(size_t maxSize, uint8_t srcWidth, uint8
     return ret;
 }
 
+static int32_t DmacCountLli(const struct DmacSgEntry *sgl, uint16_t sgCount, size_t alignedMax, size_t *lliNum)
+{
+    uint16_t i;
+    size_t num = 0;
+
+    if (alignedMax == 0) {
+        HDF_LOGE("%s: aligned max trans size is 0", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    for (i = 0; i < sgCount; i++) {
+        if (sgl[i].len == 0) {
+            HDF_LOGE("%s: sg entry %u is empty", __func__, i);
+            return HDF_ERR_INVALID_PARAM;
+        }
+        num += (sgl[i].len / alignedMax) + ((sgl[i].len % alignedMax) > 0 ? 1 : 0);
+        if (num > DMAC_LLI_NUM_MAX) {
+            HDF_LOGE("%s: lliNum is bigger than %d", __func__, DMAC_LLI_NUM_MAX);
+            return HDF_ERR_INVALID_PARAM;
+        }
+    }
+    *lliNum = num;
+    return HDF_SUCCESS;
+}
+
 static int32_t DmacFillLli(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo,
-    uintptr_t srcaddr, uintptr_t dstaddr, size_t length)
+    uintptr_t periphAddr, const struct DmacSgEntry *sgl, uint16_t sgCount)
 {
-    int32_t ret = HDF_SUCCESS;
     uint16_t i;
-    uint16_t lliNum;
-    struct DmacLli  *plli = NULL;
+    uint16_t n = 0;
+    size_t left;
     size_t alignedMax;
-    uintptr_t srcDummy = 0;
-    uintptr_t dstDummy = 0;
+    uintptr_t memAddr;
+    struct DmacLli *plli = NULL;
 
     if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
         return HDF_ERR_INVALID_OBJECT;
     }
-    if (chanInfo == NULL || chanInfo->lli == NULL) {
+    if (chanInfo == NULL || chanInfo->lli == NULL || chanInfo->lliCnt == 0) {
         HDF_LOGE("%s: chanInfo or lli is null", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
     alignedMax = DmacAlignedTransMax(cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth);
-    if (alignedMax == 0) {
-        HDF_LOGE("%s: maxTransSize:%zu srcWidth:%u dstWidth:%u", __func__,
-            cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth);
-        return HDF_ERR_INVALID_PARAM;
-    }
-    plli = chanInfo->lli;
-
-    if (srcaddr == 0) {
-        srcaddr = srcDummy = DmacGetDummyBuf(cntlr, chanInfo);
-    }
-    if (dstaddr == 0) {
-        dstaddr = dstDummy = DmacGetDummyBuf(cntlr, chanInfo);
-    }
-    if (srcaddr == 0 || dstaddr == 0) {
+    if (periphAddr == 0 && (periphAddr = DmacGetDummyBuf(cntlr, chanInfo)) == 0) {
         return HDF_ERR_MALLOC_FAIL;
     }
 
-    for (i = 0, lliNum = chanInfo->lliCnt; i < lliNum; i++, plli++) {
-        plli->nextLli = (uintptr_t)cntlr->dmacVaddrToPaddr((void *)plli) + (uintptr_t)sizeof(struct DmacLli);
-        plli->nextLli = (i < lliNum - 1) ? (plli->nextLli + chanInfo->lliEnFlag) : 0;
-        plli->count = ((i < lliNum - 1) || ((length % alignedMax) == 0)) ? alignedMax : (length % alignedMax);
-
-        plli->srcAddr = srcaddr;
-        plli->destAddr = dstaddr;
-        plli->config = chanInfo->config;
+    plli = chanInfo->lli;
+    for (i = 0; i < sgCount; i++) {
+        memAddr = (sgl[i].addr != 0) ? sgl[i].addr : DmacGetDummyBuf(cntlr, chanInfo);
+        if (memAddr == 0) {
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        // the buffers follow each other in one lli list, an lli never spans two of them
+        for (left = sgl[i].len; left > 0 && n < chanInfo->lliCnt; n++, plli++) {
+            plli->nextLli = cntlr->dmacVaddrToPaddr((void *)plli) + (uintptr_t)sizeof(struct DmacLli);
+            plli->nextLli = (n < chanInfo->lliCnt - 1) ? (plli->nextLli + chanInfo->lliEnFlag) : 0;
+            plli->count = (left > alignedMax) ? alignedMax : left;
+            plli->srcAddr = (chanInfo->transType == TRASFER_TYPE_M2P) ? memAddr : periphAddr;
+            plli->destAddr = (chanInfo->transType == TRASFER_TYPE_M2P) ? periphAddr : memAddr;
+            plli->config = chanInfo->config;
 
 #ifdef DMA_CORE_DEBUG
-        HDF_LOGD("plli=0x%lx, next=0x%lx, count=0x%lx, src=0x%lx, dst=0x%lx, cfg=0x%lx",
-            (uintptr_t)cntlr->dmacVaddrToPaddr(plli), plli->nextLli,
-            plli->count, plli->srcAddr, plli->destAddr, plli->config);
+            HDF_LOGD("plli=0x%lx, next=0x%lx, count=0x%lx, src=0x%lx, dst=0x%lx, cfg=0x%lx",
+                (uintptr_t)cntlr->dmacVaddrToPaddr(plli), plli->nextLli,
+                plli->count, plli->srcAddr, plli->destAddr, plli->config);
 #endif
-        dstaddr += (chanInfo->transType == TRASFER_TYPE_P2M && dstDummy == 0) ? plli->count : 0;
-        srcaddr += (chanInfo->transType == TRASFER_TYPE_M2P && srcDummy == 0) ? plli->count : 0;
+            memAddr += (sgl[i].addr != 0) ? plli->count : 0;
+            left -= plli->count;
+        }
     }
     plli = chanInfo->lli;
-    cntlr->dmacCacheFlush((uintptr_t)plli, (uintptr_t)plli + (uintptr_t)(sizeof(struct DmacLli) * lliNum));
-    return ret;
+    cntlr->dmacCacheFlush((uintptr_t)plli, (uintptr_t)plli + (uintptr_t)(sizeof(struct DmacLli) * chanInfo->lliCnt));
+    return HDF_SUCCESS;
 }
 
-static int32_t DmacAllocLli(struct DmacChanInfo *chanInfo, size_t length, size_t maxSize)
+/*
+ * Llis of a transfer come from the slice of the channel in the pool of the controller, allocated once by
+ * DmacCntlrAdd. Only transfers needing more than lliPoolPerChan llis allocate their own.
+ */
+static int32_t DmacAllocLli(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo, size_t lliNum)
 {
-    size_t lliNum;
     size_t allocLength;
     void *allocAddr = NULL;
 
-    if (chanInfo == NULL || maxSize == 0) {
+    if (chanInfo == NULL || lliNum == 0) {
         return HDF_ERR_INVALID_PARAM;
     }
-    lliNum = (length / maxSize) + ((length % maxSize) > 0 ? 1 : 0);
-    if (lliNum > 2048) {  /* 2048: lliNum is not more than 2048 */
-        HDF_LOGE("%s: lliNum %zu is bigger than 2048", __func__, lliNum);
-        return HDF_ERR_INVALID_PARAM;
+    if (cntlr->lliPool != NULL && lliNum <= cntlr->lliPoolPerChan) {
+        chanInfo->lli = cntlr->lliPool + (size_t)chanInfo->channel * cntlr->lliPoolPerChan;
+        chanInfo->lliCnt = (uint16_t)lliNum;
+        chanInfo->lliPooled = true;
+        return HDF_SUCCESS;
     }
 
     allocLength = lliNum * sizeof(struct DmacLli);
@@ -374,12 +413,37 @@ static int32_t DmacAllocLli(struct DmacChanInfo *chanInfo, size_t length, size_t
 
     chanInfo->lliCnt = (uint16_t)lliNum;
     chanInfo->lli = (struct DmacLli *)allocAddr;
+    chanInfo->lliPooled = false;
     return HDF_SUCCESS;
 }
 
-static int32_t DmacPeriphTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
+static int32_t DmacLliPoolInit(struct DmaCntlr *cntlr)
+{
+    size_t size;
+
+    if (cntlr->lliPoolPerChan == 0) {
+        cntlr->lliPoolPerChan = DMAC_LLI_POOL_PER_CHAN_DEFAULT;
+    }
+    size = sizeof(struct DmacLli) * cntlr->lliPoolPerChan * cntlr->channelNum;
+    size = ALIGN(size, CACHE_ALIGNED_SIZE);
+    cntlr->lliPool = (struct DmacLli *)OsalMemAllocAlign(DMA_ALIGN_SIZE, size);
+    if (cntlr->lliPool == NULL) {
+        HDF_LOGE("%s: alloc lli pool failed", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    if (memset_s(cntlr->lliPool, size, 0, size) != EOK) {
+        OsalMemFree(cntlr->lliPool);
+        cntlr->lliPool = NULL;
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t DmacPeriphTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg,
+    const struct DmacSgEntry *sgl, uint16_t sgCount)
 {
     int32_t ret;
+    size_t lliNum;
     struct DmacChanInfo *chanInfo = NULL;
 
     chanInfo = DmacRequestChannel(cntlr, msg);
@@ -387,28 +451,27 @@ static int32_t DmacPeriphTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
         HDF_LOGE("%s: request channel failed", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
-    if (msg->srcAddr == 0 && msg->destAddr == 0) {
-        HDF_LOGE("%s: src addr & dest addr both null", __func__);
-        return HDF_ERR_INVALID_PARAM;
-    }
     chanInfo->callbackData = msg->para;
     chanInfo->callback = (DmacCallback *)msg->cb;
-    ret = DmacAllocLli(chanInfo, msg->transLen,
-        DmacAlignedTransMax(cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth));
+    ret = DmacCountLli(sgl, sgCount,
+        DmacAlignedTransMax(cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth), &lliNum);
+    if (ret != HDF_SUCCESS) {
+        DmacFreeChannel(cntlr, chanInfo->channel);
+        return ret;
+    }
+    ret = DmacAllocLli(cntlr, chanInfo, lliNum);
     if (ret != HDF_SUCCESS) {
         DmacFreeChannel(cntlr, chanInfo->channel);
         return ret;
     }
-    ret = DmacFillLli(cntlr, chanInfo, msg->srcAddr, msg->destAddr, msg->transLen);
+    ret = DmacFillLli(cntlr, chanInfo, DmacMsgGetPeriphAddr(msg), sgl, sgCount);
     if (ret != HDF_SUCCESS) {
-        DmacFreeLli(chanInfo);
         DmacFreeChannel(cntlr, chanInfo->channel);
         return ret;
     }
     ret = cntlr->dmaChanEnable(cntlr, chanInfo);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: enable channel failed", __func__);
-        DmacFreeLli(chanInfo);
         DmacFreeChannel(cntlr, chanInfo->channel);
         return HDF_FAILURE;
     }
@@ -468,9 +531,24 @@ static int32_t DmacM2mTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
     return HDF_SUCCESS;
 }
 
+static void DmacSyncMem(struct DmaCntlr *cntlr, uint8_t transType, uintptr_t paddr, size_t len)
+{
+    uintptr_t vaddr;
+
+    if (paddr == 0) {
+        return;
+    }
+    vaddr = (uintptr_t)cntlr->dmacPaddrToVaddr(paddr);
+    if (transType == TRASFER_TYPE_P2M) {
+        cntlr->dmacCacheInv(vaddr, vaddr + len);
+    } else {
+        cntlr->dmacCacheFlush(vaddr, vaddr + len);
+    }
+}
+
 int32_t DmaCntlrTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
 {
-    uintptr_t phyAddr;
+    struct DmacSgEntry sg;
 
     if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
         return HDF_ERR_INVALID_OBJECT;
@@ -479,22 +557,47 @@ int32_t DmaCntlrTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
         return HDF_ERR_INVALID_PARAM;
     }
     if (msg->transType == TRASFER_TYPE_P2M) {
-        if (msg->destAddr != 0) {
-            phyAddr = (uintptr_t)cntlr->dmacPaddrToVaddr((paddr_t)msg->destAddr);
-            cntlr->dmacCacheInv(phyAddr, (uintptr_t)(phyAddr + msg->transLen));
-        }
+        sg.addr = msg->destAddr;
     } else if (msg->transType == TRASFER_TYPE_M2P) {
-        if (msg->srcAddr != 0) {
-            phyAddr = (uintptr_t)cntlr->dmacPaddrToVaddr((paddr_t)msg->srcAddr);
-            cntlr->dmacCacheFlush(phyAddr, (uintptr_t)(phyAddr + msg->transLen));
-        }
+        sg.addr = msg->srcAddr;
     } else if (msg->transType == TRASFER_TYPE_M2M) {
         return DmacM2mTransfer(cntlr, msg);
     } else {
         HDF_LOGE("%s: invalid transType %d", __func__, msg->transType);
         return HDF_FAILURE;
     }
-    return DmacPeriphTransfer(cntlr, msg);
+    if (msg->srcAddr == 0 && msg->destAddr == 0) {
+        HDF_LOGE("%s: src addr & dest addr both null", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    sg.len = msg->transLen;
+    DmacSyncMem(cntlr, msg->transType, sg.addr, sg.len);
+    return DmacPeriphTransfer(cntlr, msg, &sg, 1);
+}
+
+int32_t DmaCntlrTransferSg(struct DmaCntlr *cntlr, struct DmacMsg *msg,
+    const struct DmacSgEntry *sgl, uint16_t sgCount)
+{
+    uint16_t i;
+
+    if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (msg == NULL || sgl == NULL || sgCount == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (msg->transType != TRASFER_TYPE_P2M && msg->transType != TRASFER_TYPE_M2P) {
+        HDF_LOGE("%s: transType %d not support", __func__, msg->transType);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (DmacMsgGetPeriphAddr(msg) == 0) {
+        HDF_LOGE("%s: periph addr is null", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    for (i = 0; i < sgCount; i++) {
+        DmacSyncMem(cntlr, msg->transType, sgl[i].addr, sgl[i].len);
+    }
+    return DmacPeriphTransfer(cntlr, msg, sgl, sgCount);
 }
 
 uintptr_t DmaGetCurrChanDestAddr(struct DmaCntlr *cntlr, uint16_t chan)
@@ -505,28 +608,40 @@ uintptr_t DmaGetCurrChanDestAddr(struct DmaCntlr *cntlr, uint16_t chan)
     return cntlr->dmacGetCurrDestAddr(cntlr, chan);
 }
 
-static uint32_t DmacIsr(uint32_t irq, void *dev)
+void DmacCntlrIrqCallback(struct DmaCntlr *cntlr)
 {
     uint16_t i;
     int channelStatus;
-    struct DmaCntlr *cntlr = (struct DmaCntlr *)dev;
 
     if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
-        return HDF_ERR_INVALID_OBJECT;
-    }
-
-    if (irq != cntlr->irq || cntlr->channelNum > DMAC_CHAN_NUM_MAX) {
-        HDF_LOGE("%s: cntlr parm err! irq:%d, channel:%u", __func__, cntlr->irq, cntlr->channelNum);
-        return HDF_ERR_INVALID_OBJECT;
+        return;
     }
     for (i = 0; i < cntlr->channelNum; i++) {
         channelStatus = cntlr->dmacGetChanStatus(cntlr, i);
         if (channelStatus == DMAC_CHN_SUCCESS || channelStatus == DMAC_CHN_ERROR) {
             cntlr->channelList[i].status = channelStatus;
             DmacCallbackHandle(&(cntlr->channelList[i]));
-            DmacFreeChannel(cntlr, cntlr->channelList[i].channel);
+            // a m2m channel goes on with the next block, and is freed by DmacM2mTransfer
+            if (cntlr->channelList[i].transType != TRASFER_TYPE_M2M) {
+                DmacFreeChannel(cntlr, cntlr->channelList[i].channel);
+            }
         }
     }
+}
+
+static uint32_t DmacIsr(uint32_t irq, void *dev)
+{
+    struct DmaCntlr *cntlr = (struct DmaCntlr *)dev;
+
+    if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (irq != cntlr->irq || cntlr->channelNum > DMAC_CHAN_NUM_MAX) {
+        HDF_LOGE("%s: cntlr parm err! irq:%d, channel:%u", __func__, cntlr->irq, cntlr->channelNum);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    DmacCntlrIrqCallback(cntlr);
     return HDF_SUCCESS;
 }
 
@@ -540,29 +655,55 @@ int32_t DmacCntlrAdd(struct DmaCntlr *cntlr)
         return ret;
     }
 
-    (void)OsalSpinInit(&cntlr->lock);
-    ret = OsalRegisterIrq(cntlr->irq, 0, (OsalIRQHandle)DmacIsr, "PlatDmac", cntlr);
-    if (ret != HDF_SUCCESS) {
-        HDF_LOGE("%s: request irq %u failed, ret = %d", __func__, cntlr->irq, ret);
-        (void)OsalSpinDestroy(&cntlr->lock);
-        return ret;
-    }
     cntlr->channelList = (struct DmacChanInfo *)OsalMemCalloc(sizeof(struct DmacChanInfo) * cntlr->channelNum);
     if (cntlr->channelList == NULL) {
         HDF_LOGE("%s: alloc channel list failed", __func__);
-        (void)OsalUnregisterIrq(cntlr->irq, cntlr);
-        (void)OsalSpinDestroy(&cntlr->lock);
         return HDF_ERR_MALLOC_FAIL;
     }
+    ret = DmacLliPoolInit(cntlr);
+    if (ret != HDF_SUCCESS) {
+        OsalMemFree(cntlr->channelList);
+        cntlr->channelList = NULL;
+        return ret;
+    }
+    (void)OsalSpinInit(&cntlr->lock);
     for (i = 0; i < cntlr->channelNum; i++) {
         cntlr->dmacChanDisable(cntlr, i);
         DmaEventInit(&(cntlr->channelList[i].waitEvent));
         cntlr->channelList[i].useStatus = DMAC_CHN_VACANCY;
     }
+    if (cntlr->irq == DMAC_IRQ_NONE) {
+        return HDF_SUCCESS;
+    }
+    ret = OsalRegisterIrq(cntlr->irq, 0, (OsalIRQHandle)DmacIsr, "PlatDmac", cntlr);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: request irq %u failed, ret = %d", __func__, cntlr->irq, ret);
+        for (i = 0; i < cntlr->channelNum; i++) {
+            DmaEventDeinit(&(cntlr->channelList[i].waitEvent));
+        }
+        (void)OsalSpinDestroy(&cntlr->lock);
+        OsalMemFree(cntlr->lliPool);
+        cntlr->lliPool = NULL;
+        OsalMemFree(cntlr->channelList);
+        cntlr->channelList = NULL;
+        return ret;
+    }
     return HDF_SUCCESS;
 }
 
 void DmacCntlrRemove(struct DmaCntlr *cntlr)
 {
-    (void)cntlr;
+    uint16_t i;
+
+    if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
+        return;
+    }
+    if (cntlr->irq != DMAC_IRQ_NONE) {
+        (void)OsalUnregisterIrq(cntlr->irq, cntlr);
+    }
+    for (i = 0; i < cntlr->channelNum; i++) {
+        cntlr->dmacChanDisable(cntlr, i);
+        DmaEventDeinit(&(cntlr->channelList[i].waitEvent));
+    }
+    (void)OsalSpinDestroy(&cntlr->lock);
 }
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "platform_bh.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "osal_thread.h"
+#include "osal_time.h"
+#include "platform_core.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG platform_bh
+
+#define PLATFORM_BH_STACK_SIZE 10000
+#define PLATFORM_BH_WORKER_MAX 4
+#define PLATFORM_BH_US_PER_SEC 1000000
+
+#ifndef PLATFORM_BH_HIGH_WORKERS
+#define PLATFORM_BH_HIGH_WORKERS 2
+#endif
+
+#ifndef PLATFORM_BH_NORMAL_WORKERS
+#define PLATFORM_BH_NORMAL_WORKERS 1
+#endif
+
+#define PLATFORM_BH_PENDING  (0x1 << 0)
+#define PLATFORM_BH_RUNNING  (0x1 << 1)
+#define PLATFORM_BH_RELEASED (0x1 << 2)
+
+/*
+ * Works of one priority share a queue and a few worker threads running at that priority, instead of a thread
+ * for each work. The queue is locked with interrupts off, since works are scheduled from interrupt handlers.
+ */
+struct PlatformBhLevel {
+    const char *name;
+    OSAL_THREAD_PRIORITY threadPri;
+    uint32_t workerCnt;
+    bool started;
+    bool startLockReady;
+    struct OsalMutex startLock;
+    OsalSpinlock spin;
+    struct OsalSem sem;
+    struct DListHead works;
+    struct OsalThread workers[PLATFORM_BH_WORKER_MAX];
+};
+
+static struct PlatformBhLevel g_platformBhLevels[PLATFORM_BH_PRI_MAX] = {
+    { "platform_bh_high", OSAL_THREAD_PRI_HIGHEST, PLATFORM_BH_HIGH_WORKERS },
+    { "platform_bh_normal", OSAL_THREAD_PRI_DEFAULT, PLATFORM_BH_NORMAL_WORKERS },
+};
+
+static uint64_t PlatformBhNowUs(void)
+{
+    OsalTimespec time = {0};
+
+    (void)OsalGetTime(&time);
+    return time.sec * PLATFORM_BH_US_PER_SEC + time.usec;
+}
+
+static struct PlatformBhWork *PlatformBhLevelTake(struct PlatformBhLevel *level)
+{
+    uint32_t irqSave;
+    uint64_t now = PlatformBhNowUs();
+    uint64_t latency;
+    struct PlatformBhWork *work = NULL;
+
+    (void)OsalSpinLockIrqSave(&level->spin, &irqSave);
+    if (DListIsEmpty(&level->works)) {
+        (void)OsalSpinUnlockIrqRestore(&level->spin, &irqSave);
+        return NULL; // released while pending
+    }
+    work = DLIST_FIRST_ENTRY(&level->works, struct PlatformBhWork, node);
+    DListRemove(&work->node);
+    work->state = (work->state & ~PLATFORM_BH_PENDING) | PLATFORM_BH_RUNNING;
+    latency = (now > work->queuedUs) ? (now - work->queuedUs) : 0;
+    work->stat.runs++;
+    work->stat.latencyTotalUs += latency;
+    if (latency > work->stat.latencyMaxUs) {
+        work->stat.latencyMaxUs = (uint32_t)latency;
+    }
+    (void)OsalSpinUnlockIrqRestore(&level->spin, &irqSave);
+    return work;
+}
+
+static void PlatformBhWorkRun(struct PlatformBhLevel *level, struct PlatformBhWork *work)
+{
+    uint32_t irqSave;
+    bool requeue = false;
+    bool released = false;
+
+    work->func(work);
+
+    (void)OsalSpinLockIrqSave(&level->spin, &irqSave);
+    work->state &= ~PLATFORM_BH_RUNNING;
+    if ((work->state & PLATFORM_BH_PENDING) != 0) {
+        // triggered while running, queued only now so that it never runs on two workers at once
+        DListInsertTail(&work->node, &level->works);
+        requeue = true;
+    }
+    released = (work->state & PLATFORM_BH_RELEASED) != 0;
+    (void)OsalSpinUnlockIrqRestore(&level->spin, &irqSave);
+
+    if (requeue) {
+        (void)OsalSemPost(&level->sem);
+    }
+    if (released && work->release != NULL) {
+        work->release(work);
+    }
+}
+
+static int32_t PlatformBhWorker(void *data)
+{
+    struct PlatformBhLevel *level = (struct PlatformBhLevel *)data;
+    struct PlatformBhWork *work = NULL;
+
+    while (true) {
+        if (OsalSemWait(&level->sem, HDF_WAIT_FOREVER) != HDF_SUCCESS) {
+            continue;
+        }
+        work = PlatformBhLevelTake(level);
+        if (work != NULL) {
+            PlatformBhWorkRun(level, work);
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformBhLevelStartWorker(struct PlatformBhLevel *level, struct OsalThread *worker)
+{
+    int32_t ret;
+    struct OsalThreadParam cfg;
+
+    ret = OsalThreadCreate(worker, PlatformBhWorker, level);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    cfg.name = (char *)level->name;
+    cfg.priority = level->threadPri;
+    cfg.stackSize = PLATFORM_BH_STACK_SIZE;
+    ret = OsalThreadStart(worker, &cfg);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalThreadDestroy(worker);
+    }
+    return ret;
+}
+
+static int32_t PlatformBhLevelStartWorkers(struct PlatformBhLevel *level)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t i;
+    uint32_t workerCnt;
+
+    (void)OsalSpinInit(&level->spin);
+    (void)OsalSemInit(&level->sem, 0);
+    DListHeadInit(&level->works);
+    workerCnt = (level->workerCnt > PLATFORM_BH_WORKER_MAX) ? PLATFORM_BH_WORKER_MAX : level->workerCnt;
+    for (i = 0; i < workerCnt; i++) {
+        if ((ret = PlatformBhLevelStartWorker(level, &level->workers[i])) != HDF_SUCCESS) {
+            break;
+        }
+    }
+    if (i == 0) {
+        PLAT_LOGE("PlatformBhLevelStartWorkers: start %s worker failed:%d", level->name, ret);
+        (void)OsalSemDestroy(&level->sem);
+        (void)OsalSpinDestroy(&level->spin);
+        return ret;
+    }
+    if (i < workerCnt) {
+        PLAT_LOGW("PlatformBhLevelStartWorkers: %s runs with %u of %u workers", level->name, i, workerCnt);
+    }
+    level->workerCnt = i;
+    PLAT_LOGI("PlatformBhLevelStartWorkers: %s started with %u workers", level->name, i);
+    return HDF_SUCCESS;
+}
+
+/*
+ * The start lock is a sleeping one, so it is created out of the global lock, which is a spinlock, and
+ * installed by the first user of the level.
+ */
+static int32_t PlatformBhLevelGetStartLock(struct PlatformBhLevel *level)
+{
+    struct OsalMutex lock = { NULL };
+
+    PlatformGlobalLock();
+    if (level->startLockReady) {
+        PlatformGlobalUnlock();
+        return HDF_SUCCESS;
+    }
+    PlatformGlobalUnlock();
+
+    if (OsalMutexInit(&lock) != HDF_SUCCESS) {
+        PLAT_LOGE("PlatformBhLevelGetStartLock: init %s start lock failed", level->name);
+        return HDF_FAILURE;
+    }
+    PlatformGlobalLock();
+    if (!level->startLockReady) {
+        level->startLock = lock;
+        level->startLockReady = true;
+        lock.realMutex = NULL;
+    }
+    PlatformGlobalUnlock();
+    if (lock.realMutex != NULL) {
+        (void)OsalMutexDestroy(&lock); // another user installed its own first
+    }
+    return HDF_SUCCESS;
+}
+
+// workers of a priority are started by the first work of it, and kept for later ones
+static int32_t PlatformBhLevelStart(struct PlatformBhLevel *level)
+{
+    int32_t ret = HDF_SUCCESS;
+
+    if (PlatformBhLevelGetStartLock(level) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    (void)OsalMutexLock(&level->startLock);
+    if (!level->started) {
+        ret = PlatformBhLevelStartWorkers(level);
+        level->started = (ret == HDF_SUCCESS);
+    }
+    (void)OsalMutexUnlock(&level->startLock);
+    return ret;
+}
+
+int32_t PlatformBhWorkInit(struct PlatformBhWork *work, PlatformBhFunc func, void *data, uint32_t priority)
+{
+    if (work == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (func == NULL || priority >= PLATFORM_BH_PRI_MAX) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    DListHeadInit(&work->node);
+    work->func = func;
+    work->release = NULL;
+    work->data = data;
+    work->priority = priority;
+    work->state = 0;
+    work->queuedUs = 0;
+    (void)memset_s(&work->stat, sizeof(work->stat), 0, sizeof(work->stat));
+    return PlatformBhLevelStart(&g_platformBhLevels[priority]);
+}
+
+int32_t PlatformBhSchedule(struct PlatformBhWork *work)
+{
+    uint32_t irqSave;
+    uint64_t now;
+    bool post = false;
+    struct PlatformBhLevel *level = NULL;
+
+    if (work == NULL || work->priority >= PLATFORM_BH_PRI_MAX) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    now = PlatformBhNowUs();
+    level = &g_platformBhLevels[work->priority];
+    (void)OsalSpinLockIrqSave(&level->spin, &irqSave);
+    if ((work->state & PLATFORM_BH_RELEASED) != 0) {
+        (void)OsalSpinUnlockIrqRestore(&level->spin, &irqSave);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if ((work->state & PLATFORM_BH_PENDING) != 0) {
+        work->stat.coalesced++;
+        (void)OsalSpinUnlockIrqRestore(&level->spin, &irqSave);
+        return HDF_SUCCESS;
+    }
+    work->state |= PLATFORM_BH_PENDING;
+    work->queuedUs = now;
+    if ((work->state & PLATFORM_BH_RUNNING) == 0) {
+        DListInsertTail(&work->node, &level->works);
+        post = true;
+    }
+    (void)OsalSpinUnlockIrqRestore(&level->spin, &irqSave);
+
+    if (post) {
+        (void)OsalSemPost(&level->sem);
+    }
+    return HDF_SUCCESS;
+}
+
+void PlatformBhWorkRelease(struct PlatformBhWork *work)
+{
+    uint32_t irqSave;
+    bool running = false;
+    struct PlatformBhLevel *level = NULL;
+
+    if (work == NULL || work->priority >= PLATFORM_BH_PRI_MAX) {
+        return;
+    }
+
+    level = &g_platformBhLevels[work->priority];
+    (void)OsalSpinLockIrqSave(&level->spin, &irqSave);
+    work->state |= PLATFORM_BH_RELEASED;
+    running = (work->state & PLATFORM_BH_RUNNING) != 0;
+    if ((work->state & PLATFORM_BH_PENDING) != 0) {
+        if (!running) {
+            DListRemove(&work->node);
+        }
+        work->state &= ~PLATFORM_BH_PENDING;
+    }
+    (void)OsalSpinUnlockIrqRestore(&level->spin, &irqSave);
+
+    if (!running && work->release != NULL) {
+        work->release(work);
+    }
+}
+
+int32_t PlatformBhWorkGetStat(struct PlatformBhWork *work, struct PlatformBhStat *stat)
+{
+    uint32_t irqSave;
+    struct PlatformBhLevel *level = NULL;
+
+    if (work == NULL || work->priority >= PLATFORM_BH_PRI_MAX) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    level = &g_platformBhLevels[work->priority];
+    (void)OsalSpinLockIrqSave(&level->spin, &irqSave);
+    *stat = work->stat;
+    (void)OsalSpinUnlockIrqRestore(&level->spin, &irqSave);
+    return HDF_SUCCESS;
+}
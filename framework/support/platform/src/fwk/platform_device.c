@@ -125,6 +125,8 @@ int32_t PlatformDeviceInit(struct PlatformDevice *device)
         return ret;
     }
     DListHeadInit(&device->node);
+    DListHeadInit(&device->numberNode);
+    DListHeadInit(&device->nameNode);
     HdfSRefConstruct(&device->ref, &g_platObjListener);
 
     return HDF_SUCCESS;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021 Huawei Device Co., Ltd.
+ * Copyright (c) 2020-2022 Huawei Device Co., Ltd.
  *
  * HDF is dual licensed: you can use it either under the terms of
  * the GPL, or the BSD license, at your option.
@@ -7,12 +7,17 @@
  */
 
 #include "platform_manager.h"
+#include "hdf_cstring.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
 #include "osal_sem.h"
+#include "osal_time.h"
 #include "platform_core.h"
 
 #define PLATFORM_MANAGER_NAME_DEFAULT "PlatformManagerDefault"
+#define PLATFORM_MANAGER_BUCKET_INIT   8
+#define PLATFORM_MANAGER_BUCKET_GROW   2
+#define PLATFORM_MANAGER_SPIN_COUNT    128
 
 static inline void PlatformManagerLock(struct PlatformManager *manager)
 {
@@ -24,11 +29,200 @@ static inline void PlatformManagerUnlock(struct PlatformManager *manager)
     (void)OsalSpinUnlockIrqRestore(&manager->device.spin, &manager->device.irqSave);
 }
 
+// by compare and exchange, which is atomic on every OSAL, unlike the plain increment of some
+static void PlatformManagerAtomicAdd(OsalAtomic *counter, int32_t delta)
+{
+    int32_t value = OsalAtomicRead(counter);
+    int32_t seen;
+
+    while ((seen = OsalAtomicCmpXchg(counter, value, value + delta)) != value) {
+        value = seen;
+    }
+}
+
+static void PlatformManagerWaitForZero(OsalAtomic *counter)
+{
+    uint32_t spinCount = 0;
+
+    while (OsalAtomicRead(counter) != 0) {
+        if (++spinCount > PLATFORM_MANAGER_SPIN_COUNT) {
+            OsalMSleep(1);
+            spinCount = 0;
+        }
+    }
+}
+
+static bool PlatformManagerReadTryLock(struct PlatformManager *manager)
+{
+    PlatformManagerAtomicAdd(&manager->readers, 1);
+    if (OsalAtomicRead(&manager->writers) == 0) {
+        return true;
+    }
+    PlatformManagerAtomicAdd(&manager->readers, -1);
+    return false;
+}
+
+static inline void PlatformManagerReadUnlock(struct PlatformManager *manager)
+{
+    PlatformManagerAtomicAdd(&manager->readers, -1);
+}
+
+// may sleep, adds and removes are never called from interrupt context
+static void PlatformManagerWriteLock(struct PlatformManager *manager)
+{
+    PlatformManagerAtomicAdd(&manager->writers, 1);
+    PlatformManagerWaitForZero(&manager->readers);
+    PlatformManagerLock(manager);
+}
+
+static void PlatformManagerWriteUnlock(struct PlatformManager *manager)
+{
+    PlatformManagerUnlock(manager);
+    PlatformManagerAtomicAdd(&manager->writers, -1);
+}
+
+static inline struct DListHead *PlatformManagerNumberBucket(struct DListHead *buckets, uint32_t count,
+    int32_t number)
+{
+    return &buckets[(uint32_t)number & (count - 1)];
+}
+
+static inline struct DListHead *PlatformManagerNameBucket(struct DListHead *buckets, uint32_t count,
+    const char *name)
+{
+    uint32_t key = HdfStringMakeHashKey(name, 0);
+
+    key ^= key >> 16; // 16: fold the high bits into the mask
+    return &buckets[key & (count - 1)];
+}
+
+static struct PlatformDevice *PlatformManagerSearchNumber(const struct PlatformManager *manager, int32_t number)
+{
+    struct PlatformDevice *pos = NULL;
+    struct DListHead *bucket = NULL;
+
+    if (manager->bucketCount == 0) {
+        return NULL;
+    }
+    bucket = PlatformManagerNumberBucket(manager->numberBuckets, manager->bucketCount, number);
+    DLIST_FOR_EACH_ENTRY(pos, bucket, struct PlatformDevice, numberNode) {
+        if (pos->number == number) {
+            return pos;
+        }
+    }
+    return NULL;
+}
+
+static struct PlatformDevice *PlatformManagerSearchName(const struct PlatformManager *manager, const char *name)
+{
+    struct PlatformDevice *pos = NULL;
+    struct DListHead *bucket = NULL;
+
+    if (manager->bucketCount == 0) {
+        return NULL;
+    }
+    bucket = PlatformManagerNameBucket(manager->nameBuckets, manager->bucketCount, name);
+    DLIST_FOR_EACH_ENTRY(pos, bucket, struct PlatformDevice, nameNode) {
+        if (strcmp(pos->name, name) == 0) {
+            return pos;
+        }
+    }
+    return NULL;
+}
+
+static bool PlatformManagerIndexed(const struct PlatformManager *manager, const struct PlatformDevice *device)
+{
+    struct PlatformDevice *pos = NULL;
+    struct DListHead *bucket = NULL;
+
+    if (manager->bucketCount == 0) {
+        return false;
+    }
+    bucket = PlatformManagerNumberBucket(manager->numberBuckets, manager->bucketCount, device->number);
+    DLIST_FOR_EACH_ENTRY(pos, bucket, struct PlatformDevice, numberNode) {
+        if (pos == device) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void PlatformManagerIndexAdd(struct PlatformManager *manager, struct PlatformDevice *device)
+{
+    DListInsertTail(&device->numberNode,
+        PlatformManagerNumberBucket(manager->numberBuckets, manager->bucketCount, device->number));
+    if (device->name != NULL) {
+        DListInsertTail(&device->nameNode,
+            PlatformManagerNameBucket(manager->nameBuckets, manager->bucketCount, device->name));
+    } else {
+        DListHeadInit(&device->nameNode);
+    }
+    manager->deviceCount++;
+}
+
+static void PlatformManagerIndexDel(struct PlatformManager *manager, struct PlatformDevice *device)
+{
+    DListRemove(&device->numberNode);
+    if (!DListIsEmpty(&device->nameNode)) {
+        DListRemove(&device->nameNode);
+    }
+    manager->deviceCount--;
+}
+
+static struct DListHead *PlatformManagerNewBuckets(uint32_t count)
+{
+    uint32_t i;
+    struct DListHead *buckets = NULL;
+
+    buckets = (struct DListHead *)OsalMemCalloc(sizeof(*buckets) * count * 2); // 2: numbers, then names
+    if (buckets == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < count * 2; i++) { // 2: numbers, then names
+        DListHeadInit(&buckets[i]);
+    }
+    return buckets;
+}
+
+// called with the write lock held, returns the buckets to free after unlocking
+static struct DListHead *PlatformManagerRehash(struct PlatformManager *manager, struct DListHead *buckets,
+    uint32_t count)
+{
+    uint32_t i;
+    struct PlatformDevice *pos = NULL;
+    struct PlatformDevice *tmp = NULL;
+    struct DListHead *oldBuckets = manager->numberBuckets;
+
+    if (count <= manager->bucketCount) {
+        return buckets; // grown by another writer meanwhile
+    }
+    for (i = 0; i < manager->bucketCount; i++) {
+        DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->numberBuckets[i], struct PlatformDevice, numberNode) {
+            DListRemove(&pos->numberNode);
+            DListInsertTail(&pos->numberNode, PlatformManagerNumberBucket(buckets, count, pos->number));
+            if (!DListIsEmpty(&pos->nameNode)) {
+                DListRemove(&pos->nameNode);
+                DListInsertTail(&pos->nameNode, PlatformManagerNameBucket(&buckets[count], count, pos->name));
+            }
+        }
+    }
+    manager->numberBuckets = buckets;
+    manager->nameBuckets = &buckets[count];
+    manager->bucketCount = count;
+    return oldBuckets;
+}
+
 static int32_t PlatformManagerInit(struct PlatformManager *manager)
 {
     int32_t ret;
 
     DListHeadInit(&manager->devices);
+    manager->numberBuckets = NULL;
+    manager->nameBuckets = NULL;
+    manager->bucketCount = 0;
+    manager->deviceCount = 0;
+    OsalAtomicSet(&manager->readers, 0);
+    OsalAtomicSet(&manager->writers, 0);
 
     if ((ret = PlatformDeviceInit(&manager->device)) != HDF_SUCCESS) {
         return ret;
@@ -48,12 +242,19 @@ static void PlatformManagerClearDevice(struct PlatformManager *manager)
         return;
     }
 
-    PlatformManagerLock(manager);
+    PlatformManagerWriteLock(manager);
     DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->devices, struct PlatformDevice, node) {
         DListRemove(&pos->node);
+        if (PlatformManagerIndexed(manager, pos)) {
+            PlatformManagerIndexDel(manager, pos);
+        }
         PlatformDevicePut(pos);  // put the reference hold by manager
     }
-    PlatformManagerUnlock(manager);
+    PlatformManagerWriteUnlock(manager);
+    OsalMemFree(manager->numberBuckets);
+    manager->numberBuckets = NULL;
+    manager->nameBuckets = NULL;
+    manager->bucketCount = 0;
 }
 
 static void PlatformManagerUninit(struct PlatformManager *manager)
@@ -123,39 +324,49 @@ struct PlatformManager *PlatformManagerGet(int module)
 static int32_t PlatformManagerAddDeviceDefault(struct PlatformManager *manager, struct PlatformDevice *device)
 {
     struct PlatformDevice *tmp = NULL;
-    bool repeatId = false;
-    bool repeatName = false;
+    struct DListHead *bucket = NULL;
 
-    DLIST_FOR_EACH_ENTRY(tmp, &manager->devices, struct PlatformDevice, node) {
-        if (device->number == tmp->number) {
-            repeatId = true;
-            PLAT_LOGE("%s: device:%s(%d) num repeated in manager:%s", __func__,
-                device->name, device->number, manager->device.name);
-            break;
-        }
-        if (device->name != NULL && device->name == tmp->name) {
-            repeatName = true;
-            PLAT_LOGE("%s: device:%s(%d) name repeated in manager:%s", __func__,
-                device->name, device->number, manager->device.name);
-            break;
-        }
-    }
-
-    if (repeatId) {
+    if (PlatformManagerSearchNumber(manager, device->number) != NULL) {
+        PLAT_LOGE("%s: device:%s(%d) num repeated in manager:%s", __func__,
+            device->name, device->number, manager->device.name);
         return HDF_PLT_ERR_ID_REPEAT;
     }
-    if (repeatName) {
-        return HDF_PLT_ERR_NAME_REPEAT;
+    if (device->name != NULL && manager->bucketCount != 0) {
+        bucket = PlatformManagerNameBucket(manager->nameBuckets, manager->bucketCount, device->name);
+        DLIST_FOR_EACH_ENTRY(tmp, bucket, struct PlatformDevice, nameNode) {
+            if (device->name == tmp->name) {
+                PLAT_LOGE("%s: device:%s(%d) name repeated in manager:%s", __func__,
+                    device->name, device->number, manager->device.name);
+                return HDF_PLT_ERR_NAME_REPEAT;
+            }
+        }
     }
 
     DListInsertTail(&device->node, &manager->devices);
     return HDF_SUCCESS;
 }
 
+static struct DListHead *PlatformManagerPrepareBuckets(struct PlatformManager *manager, uint32_t *count)
+{
+    uint32_t bucketCount;
+    uint32_t deviceCount;
+
+    PlatformManagerLock(manager);
+    bucketCount = manager->bucketCount;
+    deviceCount = manager->deviceCount;
+    PlatformManagerUnlock(manager);
+    if (deviceCount < bucketCount) {
+        return NULL;
+    }
+    *count = (bucketCount == 0) ? PLATFORM_MANAGER_BUCKET_INIT : bucketCount * PLATFORM_MANAGER_BUCKET_GROW;
+    return PlatformManagerNewBuckets(*count);
+}
+
 int32_t PlatformManagerAddDevice(struct PlatformManager *manager, struct PlatformDevice *device)
 {
     int32_t ret;
-    struct PlatformDevice *pos = NULL;
+    uint32_t count = 0;
+    struct DListHead *buckets = NULL;
 
     if (manager == NULL || device == NULL) {
         return HDF_ERR_INVALID_OBJECT;
@@ -165,22 +376,28 @@ int32_t PlatformManagerAddDevice(struct PlatformManager *manager, struct Platfor
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    PlatformManagerLock(manager);
-    DLIST_FOR_EACH_ENTRY(pos, &manager->devices, struct PlatformDevice, node) {
-        if (pos == device) {
-            PlatformManagerUnlock(manager);
-            PLAT_LOGE("%s: device:%s(%d) already in manager:%s", __func__,
-                device->name, device->number, manager->device.name);
-            PlatformDevicePut(device);
-            return HDF_PLT_ERR_OBJ_REPEAT;
-        }
+    // allocated before the lock is taken, longer chains are still correct if it fails with an index
+    buckets = PlatformManagerPrepareBuckets(manager, &count);
+    PlatformManagerWriteLock(manager);
+    if (buckets != NULL) {
+        buckets = PlatformManagerRehash(manager, buckets, count);
     }
-    if (manager->add != NULL) {
+    if (manager->bucketCount == 0) {
+        ret = HDF_ERR_MALLOC_FAIL;
+    } else if (PlatformManagerIndexed(manager, device)) {
+        PLAT_LOGE("%s: device:%s(%d) already in manager:%s", __func__,
+            device->name, device->number, manager->device.name);
+        ret = HDF_PLT_ERR_OBJ_REPEAT;
+    } else if (manager->add != NULL) {
         ret = manager->add(manager, device);
     } else {
         ret = PlatformManagerAddDeviceDefault(manager, device);
     }
-    PlatformManagerUnlock(manager);
+    if (ret == HDF_SUCCESS) {
+        PlatformManagerIndexAdd(manager, device);
+    }
+    PlatformManagerWriteUnlock(manager);
+    OsalMemFree(buckets);
 
     if (ret == HDF_SUCCESS) {
         PLAT_LOGD("%s: add dev:%s(%d) to %s success", __func__,
@@ -212,22 +429,16 @@ static int32_t PlatformManagerDelDeviceDefault(struct PlatformManager *manager,
 int32_t PlatformManagerDelDevice(struct PlatformManager *manager, struct PlatformDevice *device)
 {
     int32_t ret;
-    struct PlatformDevice *pos = NULL;
 
     if (manager == NULL || device == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    PlatformManagerLock(manager);
-    DLIST_FOR_EACH_ENTRY(pos, &manager->devices, struct PlatformDevice, node) {
-        if (pos == device) {
-            break;
-        }
-    }
-    if (pos != device) {
+    PlatformManagerWriteLock(manager);
+    if (!PlatformManagerIndexed(manager, device)) {
         PLAT_LOGE("%s: device:%s(%d) not in manager:%s", __func__,
             device->name, device->number, manager->device.name);
-        PlatformManagerUnlock(manager);
+        PlatformManagerWriteUnlock(manager);
         return HDF_PLT_ERR_NO_DEV;
     }
     if (manager->del != NULL) {
@@ -235,7 +446,11 @@ int32_t PlatformManagerDelDevice(struct PlatformManager *manager, struct Platfor
     } else {
         ret = PlatformManagerDelDeviceDefault(manager, device);
     }
-    PlatformManagerUnlock(manager);
+    if (ret == HDF_SUCCESS) {
+        PlatformManagerIndexDel(manager, device);
+    }
+    // no lookup can still hold the device without a reference from here on
+    PlatformManagerWriteUnlock(manager);
 
     if (ret == HDF_SUCCESS) {
         PlatformDevicePut(device);  // put the reference hold by manager
@@ -277,36 +492,54 @@ struct PlatformDevice *PlatformManagerFindDevice(struct PlatformManager *manager
     return pdevice;
 }
 
-static bool PlatformDeviceMatchByNumber(struct PlatformDevice *device, void *data)
-{
-    uint32_t number = (uint32_t)(uintptr_t)data;
+typedef struct PlatformDevice *(*PlatformManagerSearch)(const struct PlatformManager *manager, const void *key);
 
-    return (device != NULL && (uint32_t)device->number == number);
+static struct PlatformDevice *PlatformManagerSearchByNumber(const struct PlatformManager *manager, const void *key)
+{
+    return PlatformManagerSearchNumber(manager, (int32_t)(uintptr_t)key);
 }
 
-struct PlatformDevice *PlatformManagerGetDeviceByNumber(struct PlatformManager *manager, uint32_t number)
+static struct PlatformDevice *PlatformManagerSearchByName(const struct PlatformManager *manager, const void *key)
 {
-    if (manager == NULL) {
-        return NULL;
-    }
-    return PlatformManagerFindDevice(manager, (void *)(uintptr_t)number, PlatformDeviceMatchByNumber);
+    return PlatformManagerSearchName(manager, (const char *)key);
 }
 
-static bool PlatformDeviceMatchByName(struct PlatformDevice *device, void *data)
+static struct PlatformDevice *PlatformManagerGetIndexed(struct PlatformManager *manager, const void *key,
+    PlatformManagerSearch search)
 {
-    const char *name = (const char *)data;
+    struct PlatformDevice *pdevice = NULL;
 
-    if (name == NULL || device->name == NULL) {
-        return false;
+    if (PlatformManagerReadTryLock(manager)) {
+        pdevice = search(manager, key);
+        if (pdevice != NULL && PlatformDeviceGet(pdevice) != HDF_SUCCESS) {
+            pdevice = NULL;
+        }
+        PlatformManagerReadUnlock(manager);
+        return pdevice;
     }
 
-    return (strcmp(name, device->name) == 0);
+    // a writer is changing the index, wait for it on the lock
+    PlatformManagerLock(manager);
+    pdevice = search(manager, key);
+    if (pdevice != NULL && PlatformDeviceGet(pdevice) != HDF_SUCCESS) {
+        pdevice = NULL;
+    }
+    PlatformManagerUnlock(manager);
+    return pdevice;
 }
 
-struct PlatformDevice *PlatformManagerGetDeviceByName(struct PlatformManager *manager, const char *name)
+struct PlatformDevice *PlatformManagerGetDeviceByNumber(struct PlatformManager *manager, uint32_t number)
 {
     if (manager == NULL) {
         return NULL;
     }
-    return PlatformManagerFindDevice(manager, (void *)name, PlatformDeviceMatchByName);
+    return PlatformManagerGetIndexed(manager, (void *)(uintptr_t)number, PlatformManagerSearchByNumber);
+}
+
+struct PlatformDevice *PlatformManagerGetDeviceByName(struct PlatformManager *manager, const char *name)
+{
+    if (manager == NULL || name == NULL) {
+        return NULL;
+    }
+    return PlatformManagerGetIndexed(manager, name, PlatformManagerSearchByName);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021 Huawei Device Co., Ltd.
+ * Copyright (c) 2020-2022 Huawei Device Co., Ltd.
  *
  * HDF is dual licensed: you can use it either under the terms of
  * the GPL, or the BSD license, at your option.
@@ -17,58 +17,135 @@
 
 #define PLAT_QUEUE_THREAD_STAK 20000
 #define PLAT_QUEUE_DEPTH_MAX   32
+#define PLAT_QUEUE_BATCH_MAX   64
 
 static void PlatformQueueDoDestroy(struct PlatformQueue *queue)
 {
-    (void)OsalThreadDestroy(&queue->thread);
+    if (queue->start) {
+        (void)OsalThreadDestroy(&queue->thread);
+    }
     (void)OsalSemDestroy(&queue->sem);
-    (void)OsalSpinDestroy(&queue->spin);
     OsalMemFree(queue);
 }
 
-static int32_t PlatformQueueNextMsg(struct PlatformQueue *queue, struct PlatformMsg **msg)
+/* OsalAtomicInc and OsalAtomicDec are not atomic on every platform, so counters are changed by compare and exchange */
+static void PlatformQueueAtomicAdd(OsalAtomic *counter, int32_t delta)
 {
-    int32_t ret;
+    int32_t old;
+
+    do {
+        old = OsalAtomicReadAcquire(counter);
+    } while (OsalAtomicCmpXchg(counter, old, old + delta) != old);
+}
+
+static void PlatformQueuePush(struct PlatformQueue *queue, struct PlatformMsg *msg)
+{
+    struct PlatformMsg *prev = NULL;
+
+    OsalAtomicPtrSetRelease(&msg->next, NULL);
+    prev = OsalAtomicPtrXchg(&queue->head, msg);
+    /* until this link the consumer sees the message as not added yet, it is fully ordered before the wake */
+    (void)OsalAtomicPtrXchg(&prev->next, msg);
+}
 
-    (void)OsalSpinLock(&queue->spin);
-    if (DListIsEmpty(&queue->msgs)) {
-        ret = HDF_PLT_ERR_NO_DATA;
-    } else {
-        *msg = DLIST_FIRST_ENTRY(&queue->msgs, struct PlatformMsg, node);
-        DListRemove(&((*msg)->node));
-        queue->depth--;
-        ret = HDF_SUCCESS;
+static bool PlatformQueueHasMsg(struct PlatformQueue *queue)
+{
+    struct PlatformMsg *tail = queue->tail;
+
+    if (OsalAtomicPtrReadAcquire(&tail->next) != NULL) {
+        return true;
     }
-    (void)OsalSpinUnlock(&queue->spin);
+    return tail != &queue->stub && OsalAtomicPtrReadAcquire(&queue->head) == tail;
+}
 
-    return ret;
+static struct PlatformMsg *PlatformQueuePop(struct PlatformQueue *queue)
+{
+    struct PlatformMsg *tail = queue->tail;
+    struct PlatformMsg *next = OsalAtomicPtrReadAcquire(&tail->next);
+
+    if (tail == &queue->stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+        queue->tail = next;
+        tail = next;
+        next = OsalAtomicPtrReadAcquire(&next->next);
+    }
+    if (next == NULL) {
+        if (OsalAtomicPtrReadAcquire(&queue->head) != tail) {
+            return NULL; // a producer is linking its message behind tail
+        }
+        /* tail is the last message, put the stub behind it so that it can be taken */
+        PlatformQueuePush(queue, &queue->stub);
+        next = OsalAtomicPtrReadAcquire(&tail->next);
+        if (next == NULL) {
+            return NULL;
+        }
+    }
+    queue->tail = next;
+    PlatformQueueAtomicAdd(&queue->depth, -1);
+    return tail;
 }
 
-static int32_t PlatformQueueWorker(void *data)
+static void PlatformQueueWake(struct PlatformQueue *queue)
+{
+    if (OsalAtomicReadAcquire(&queue->waiting) != 0 && OsalAtomicCmpXchg(&queue->waiting, 1, 0) != 0) {
+        (void)OsalSemPost(&queue->sem);
+    }
+}
+
+static int32_t PlatformQueueWait(struct PlatformQueue *queue, uint32_t tms)
 {
     int32_t ret;
-    struct PlatformQueue *queue = (struct PlatformQueue *)data;
-    struct PlatformMsg *msg = NULL;
 
-    while (true) {
-        /* wait envent */
-        ret = OsalSemWait(&queue->sem, HDF_WAIT_FOREVER);
-        if (ret != HDF_SUCCESS) {
-            continue;
+    /* fully ordered before the checks below, as the producers link their message before they check the flag */
+    (void)OsalAtomicCmpXchg(&queue->waiting, 0, 1);
+    if (PlatformQueueHasMsg(queue) || OsalAtomicReadAcquire(&queue->stop) != 0) {
+        if (OsalAtomicCmpXchg(&queue->waiting, 1, 0) != 0) {
+            return HDF_SUCCESS;
         }
+        /* a producer took the flag first and posts, consume it */
+        return OsalSemWait(&queue->sem, HDF_WAIT_FOREVER);
+    }
+
+    ret = OsalSemWait(&queue->sem, tms);
+    if (ret != HDF_SUCCESS && OsalAtomicCmpXchg(&queue->waiting, 1, 0) == 0) {
+        (void)OsalSemWait(&queue->sem, HDF_WAIT_FOREVER);
+        return HDF_SUCCESS;
+    }
+    return ret;
+}
 
-        if (!queue->start) {
-            queue->exited = true;
+static uint32_t PlatformQueueDrain(struct PlatformQueue *queue)
+{
+    uint32_t count;
+    struct PlatformMsg *msg = NULL;
+
+    for (count = 0; count < PLAT_QUEUE_BATCH_MAX; count++) {
+        msg = PlatformQueuePop(queue);
+        if (msg == NULL) {
             break;
         }
-
-        (void)PlatformQueueNextMsg(queue, &msg);
         /* message process */
-        if (msg != NULL && queue->handle != NULL) {
+        if (queue->handle != NULL) {
             (void)(queue->handle(queue, msg));
-            msg = NULL;
         }
     }
+    return count;
+}
+
+static int32_t PlatformQueueWorker(void *data)
+{
+    struct PlatformQueue *queue = (struct PlatformQueue *)data;
+
+    while (OsalAtomicReadAcquire(&queue->stop) == 0) {
+        if (PlatformQueueDrain(queue) == PLAT_QUEUE_BATCH_MAX) {
+            continue;
+        }
+        /* wait envent */
+        (void)PlatformQueueWait(queue, HDF_WAIT_FOREVER);
+    }
+    OsalAtomicSetRelease(&queue->exited, 1);
     return HDF_SUCCESS;
 }
 
@@ -82,16 +159,19 @@ struct PlatformQueue *PlatformQueueCreate(PlatformMsgHandle handle, const char *
         return NULL;
     }
 
-    (void)OsalSpinInit(&queue->spin);
     (void)OsalSemInit(&queue->sem, 0);
-    DListHeadInit(&queue->msgs);
+    queue->stub.next = NULL;
+    queue->head = &queue->stub;
+    queue->tail = &queue->stub;
     queue->name = (name == NULL) ? "PlatformQueue" : name;
     queue->handle = handle;
-    queue->depth = 0;
-    queue->depthMax = PLAT_QUEUE_DEPTH_MAX;
+    OsalAtomicSet(&queue->depth, 0);
+    OsalAtomicSet(&queue->depthMax, PLAT_QUEUE_DEPTH_MAX);
     queue->data = data;
     queue->start = false;
-    queue->exited = false;
+    OsalAtomicSet(&queue->stop, 0);
+    OsalAtomicSet(&queue->exited, 0);
+    OsalAtomicSet(&queue->waiting, 0);
     return queue;
 }
 
@@ -105,8 +185,6 @@ int32_t PlatformQueueStart(struct PlatformQueue *queue)
     }
 
     ret = OsalThreadCreate(&queue->thread, (OsalThreadEntry)PlatformQueueWorker, (void *)queue);
-    (void)PlatformQueueWorker;
-    ret = HDF_SUCCESS;
     if (ret != HDF_SUCCESS) {
         PLAT_LOGE("PlatformQueueStart: create thread fail!");
         return ret;
@@ -116,8 +194,6 @@ int32_t PlatformQueueStart(struct PlatformQueue *queue)
     cfg.priority = OSAL_THREAD_PRI_HIGHEST;
     cfg.stackSize = PLAT_QUEUE_THREAD_STAK;
     ret = OsalThreadStart(&queue->thread, &cfg);
-    (void)cfg;
-    ret = HDF_SUCCESS;
     if (ret != HDF_SUCCESS) {
         OsalThreadDestroy(&queue->thread);
         PLAT_LOGE("PlatformQueueStart: start thread fail:%d", ret);
@@ -128,6 +204,15 @@ int32_t PlatformQueueStart(struct PlatformQueue *queue)
     return HDF_SUCCESS;
 }
 
+int32_t PlatformQueueSetDepthMax(struct PlatformQueue *queue, uint32_t depthMax)
+{
+    if (queue == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    OsalAtomicSetRelease(&queue->depthMax, (int32_t)depthMax);
+    return HDF_SUCCESS;
+}
+
 void PlatformQueueDestroy(struct PlatformQueue *queue)
 {
     if (queue == NULL) {
@@ -135,15 +220,32 @@ void PlatformQueueDestroy(struct PlatformQueue *queue)
     }
 
     if (queue->start) {
-        queue->start = false;
-        (void)OsalSemPost(&queue->sem);
-        while (!queue->exited) {
+        /* fully ordered before the wake reads the waiting flag */
+        (void)OsalAtomicCmpXchg(&queue->stop, 0, 1);
+        PlatformQueueWake(queue);
+        while (OsalAtomicReadAcquire(&queue->exited) == 0) {
             OsalMSleep(1);
         }
-        PlatformQueueDoDestroy(queue);
-    } else {
-        PlatformQueueDoDestroy(queue);
     }
+    PlatformQueueDoDestroy(queue);
+}
+
+static bool PlatformQueueReserve(struct PlatformQueue *queue)
+{
+    uint32_t depthMax = (uint32_t)OsalAtomicReadAcquire(&queue->depthMax);
+    int32_t depth;
+
+    if (depthMax == PLAT_QUEUE_DEPTH_UNBOUNDED) {
+        PlatformQueueAtomicAdd(&queue->depth, 1);
+        return true;
+    }
+    do {
+        depth = OsalAtomicReadAcquire(&queue->depth);
+        if ((uint32_t)depth >= depthMax) {
+            return false;
+        }
+    } while (OsalAtomicCmpXchg(&queue->depth, depth, depth + 1) != depth);
+    return true;
 }
 
 int32_t PlatformQueueAddMsg(struct PlatformQueue *queue, struct PlatformMsg *msg)
@@ -154,17 +256,13 @@ int32_t PlatformQueueAddMsg(struct PlatformQueue *queue, struct PlatformMsg *msg
 
     DListHeadInit(&msg->node);
     msg->error = HDF_SUCCESS;
-    (void)OsalSpinLock(&queue->spin);
-    if (queue->depth >= queue->depthMax) {
-        (void)OsalSpinUnlock(&queue->spin);
+    if (!PlatformQueueReserve(queue)) {
         HDF_LOGE("PlatformQueueAddMsg: queue(%s) full!", queue->name);
         return HDF_PLT_OUT_OF_RSC;
     }
-    DListInsertTail(&msg->node, &queue->msgs);
-    queue->depth++;
-    (void)OsalSpinUnlock(&queue->spin);
-    /* notify the worker thread */
-    (void)OsalSemPost(&queue->sem);
+    PlatformQueuePush(queue, msg);
+    /* notify the worker thread if it sleeps */
+    PlatformQueueWake(queue);
     return HDF_SUCCESS;
 }
 
@@ -178,21 +276,23 @@ int32_t PlatformQueueGetMsg(struct PlatformQueue *queue, struct PlatformMsg **ms
     if (msg == NULL) {
         return HDF_ERR_INVALID_PARAM;
     }
-
-    ret = PlatformQueueNextMsg(queue, msg);
-    if (ret == HDF_SUCCESS) {
-        (void)OsalSemWait(&queue->sem, HDF_WAIT_FOREVER); // consume the semaphore after get
-        return ret;
+    if (queue->start) {
+        PLAT_LOGE("PlatformQueueGetMsg: queue(%s) is consumed by its worker!", queue->name);
+        return HDF_ERR_DEVICE_BUSY;
     }
 
+    *msg = PlatformQueuePop(queue);
+    if (*msg != NULL) {
+        return HDF_SUCCESS;
+    }
     if (tms == 0) {
         return HDF_PLT_ERR_NO_DATA;
     }
 
-    ret = OsalSemWait(&queue->sem, tms);
+    ret = PlatformQueueWait(queue, tms);
     if (ret != HDF_SUCCESS) {
         return ret;
     }
-    return PlatformQueueNextMsg(queue, msg);
+    *msg = PlatformQueuePop(queue);
+    return (*msg == NULL) ? HDF_PLT_ERR_NO_DATA : HDF_SUCCESS;
 }
-
@@ -12,7 +12,7 @@
 
 #define HDF_LOG_TAG gpio_core
 
-#define GPIO_IRQ_STACK_SIZE        10000
+#define GPIO_MULTI_BITS 32
 
 static inline void GpioInfoLock(struct GpioInfo *ginfo)
 {
@@ -51,6 +51,88 @@ int32_t GpioCntlrRead(struct GpioCntlr *cntlr, uint16_t local, uint16_t *val)
     return cntlr->ops->read(cntlr, local, val);
 }
 
+// every pin selected by mask must be of the controller
+static bool GpioCntlrMaskValid(struct GpioCntlr *cntlr, uint16_t local, uint32_t mask)
+{
+    uint32_t last = 0;
+
+    if (mask == 0) {
+        return false;
+    }
+    while ((mask >> last) > 1) {
+        last++;
+    }
+    return ((uint32_t)local + last) < cntlr->count;
+}
+
+int32_t GpioCntlrWriteMulti(struct GpioCntlr *cntlr, uint16_t local, uint32_t mask, uint32_t val)
+{
+    int32_t ret;
+    uint16_t i;
+
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (cntlr->ops == NULL || (cntlr->ops->writeMulti == NULL && cntlr->ops->write == NULL)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (!GpioCntlrMaskValid(cntlr, local, mask)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (cntlr->ops->writeMulti != NULL) {
+        return cntlr->ops->writeMulti(cntlr, local, mask, val);
+    }
+    for (i = 0; i < GPIO_MULTI_BITS; i++) {
+        if ((mask & (1U << i)) == 0) {
+            continue;
+        }
+        ret = cntlr->ops->write(cntlr, local + i, ((val & (1U << i)) != 0) ? GPIO_VAL_HIGH : GPIO_VAL_LOW);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t GpioCntlrReadMulti(struct GpioCntlr *cntlr, uint16_t local, uint32_t mask, uint32_t *val)
+{
+    int32_t ret;
+    uint16_t i;
+    uint16_t level;
+    uint32_t bits = 0;
+
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (cntlr->ops == NULL || (cntlr->ops->readMulti == NULL && cntlr->ops->read == NULL)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (val == NULL || !GpioCntlrMaskValid(cntlr, local, mask)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (cntlr->ops->readMulti != NULL) {
+        ret = cntlr->ops->readMulti(cntlr, local, mask, &bits);
+        if (ret == HDF_SUCCESS) {
+            *val = bits & mask;
+        }
+        return ret;
+    }
+    for (i = 0; i < GPIO_MULTI_BITS; i++) {
+        if ((mask & (1U << i)) == 0) {
+            continue;
+        }
+        ret = cntlr->ops->read(cntlr, local + i, &level);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+        bits |= (level == GPIO_VAL_HIGH) ? (1U << i) : 0;
+    }
+    *val = bits;
+    return HDF_SUCCESS;
+}
+
 int32_t GpioCntlrSetDir(struct GpioCntlr *cntlr, uint16_t local, uint16_t dir)
 {
     if (cntlr == NULL) {
@@ -117,32 +199,16 @@ void GpioCntlrIrqCallback(struct GpioCntlr *cntlr, uint16_t local)
     GpioInfoUnlock(ginfo);
 }
 
-static int32_t GpioCntlrIrqThreadHandler(void *data)
+static void GpioIrqRecordBhHandler(struct PlatformBhWork *work)
 {
-    int32_t ret;
-    uint32_t irqSave;
-    struct GpioIrqRecord *irqRecord = (struct GpioIrqRecord *)data;
+    struct GpioIrqRecord *irqRecord = (struct GpioIrqRecord *)work->data;
 
-    while (true) {
-        ret = OsalSemWait(&irqRecord->sem, HDF_WAIT_FOREVER);
-        if (irqRecord->removed) {
-            break;
-        }
-        if (ret != HDF_SUCCESS) {
-            continue;
-        }
-        if (irqRecord->btmFunc != NULL) {
-            (void)irqRecord->btmFunc(irqRecord->global, irqRecord->irqData);
-        }
-    }
-    (void)OsalSpinLockIrqSave(&irqRecord->spin, &irqSave);
-    (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave); // last post done
-    PLAT_LOGI("GpioCntlrIrqThreadHandler: gpio(%hu) thread exit", irqRecord->global);
-    (void)OsalSemDestroy(&irqRecord->sem);
-    (void)OsalSpinDestroy(&irqRecord->spin);
-    (void)OsalThreadDestroy(&irqRecord->thread);
-    OsalMemFree(irqRecord);
-    return HDF_SUCCESS;
+    (void)irqRecord->btmFunc(irqRecord->global, irqRecord->irqData);
+}
+
+static void GpioIrqRecordBhRelease(struct PlatformBhWork *work)
+{
+    OsalMemFree(work->data);
 }
 
 static int32_t GpioCntlrSetIrqInner(struct GpioInfo *ginfo, struct GpioIrqRecord *irqRecord)
@@ -179,42 +245,28 @@ static int32_t GpioIrqRecordCreate(struct GpioInfo *ginfo, uint16_t mode, GpioIr
     struct GpioIrqRecord **new)
 {
     int32_t ret;
+    uint32_t priority;
     struct GpioIrqRecord *irqRecord = NULL;
-    struct OsalThreadParam cfg;
 
     irqRecord = (struct GpioIrqRecord *)OsalMemCalloc(sizeof(*irqRecord));
     if (irqRecord == NULL) {
         PLAT_LOGE("GpioIrqRecordCreate: alloc irq record failed");
         return HDF_ERR_MALLOC_FAIL;
     }
-    irqRecord->removed = false;
     irqRecord->mode = mode;
     irqRecord->irqFunc = ((mode & GPIO_IRQ_USING_THREAD) == 0) ? func : NULL;
     irqRecord->btmFunc = ((mode & GPIO_IRQ_USING_THREAD) != 0) ? func : NULL;
     irqRecord->irqData = arg;
     irqRecord->global = GpioInfoToGlobal(ginfo);
     if (irqRecord->btmFunc != NULL) {
-        ret = OsalThreadCreate(&irqRecord->thread, GpioCntlrIrqThreadHandler, irqRecord);
+        priority = ((mode & GPIO_IRQ_THREAD_NORMAL_PRIORITY) != 0) ? PLATFORM_BH_PRI_NORMAL : PLATFORM_BH_PRI_HIGH;
+        ret = PlatformBhWorkInit(&irqRecord->bh, GpioIrqRecordBhHandler, irqRecord, priority);
         if (ret != HDF_SUCCESS) {
             OsalMemFree(irqRecord);
-            PLAT_LOGE("GpioIrqRecordCreate: create irq thread failed:%d", ret);
+            PLAT_LOGE("GpioIrqRecordCreate: init irq bottom half failed:%d", ret);
             return ret;
         }
-        (void)OsalSpinInit(&irqRecord->spin);
-        (void)OsalSemInit(&irqRecord->sem, 0);
-        cfg.name = (char *)ginfo->name;
-        cfg.priority = OSAL_THREAD_PRI_HIGHEST;
-        cfg.stackSize = GPIO_IRQ_STACK_SIZE;
-        ret = OsalThreadStart(&irqRecord->thread, &cfg);
-        if (ret != HDF_SUCCESS) {
-            (void)OsalSemDestroy(&irqRecord->sem);
-            (void)OsalSpinDestroy(&irqRecord->spin);
-            (void)OsalThreadDestroy(&irqRecord->thread);
-            OsalMemFree(irqRecord);
-            PLAT_LOGE("GpioIrqRecordCreate: start irq thread failed:%d", ret);
-            return ret;
-        }
-        PLAT_LOGI("GpioIrqRecordCreate: gpio(%hu) thread started", GpioInfoToGlobal(ginfo));
+        irqRecord->bh.release = GpioIrqRecordBhRelease;
     }
 
     *new = irqRecord;
@@ -292,6 +344,29 @@ int32_t GpioCntlrUnsetIrq(struct GpioCntlr *cntlr, uint16_t local, void *arg)
     return ret;
 }
 
+int32_t GpioCntlrGetIrqStat(struct GpioCntlr *cntlr, uint16_t local, struct PlatformBhStat *stat)
+{
+    int32_t ret;
+    struct GpioInfo *ginfo = NULL;
+
+    if (cntlr == NULL || cntlr->ginfos == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (local >= cntlr->count || stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ginfo = &cntlr->ginfos[local];
+    GpioInfoLock(ginfo);
+    if (ginfo->irqRecord == NULL || ginfo->irqRecord->btmFunc == NULL) {
+        GpioInfoUnlock(ginfo);
+        return HDF_ERR_NOT_SUPPORT; // counted for thread handlers only
+    }
+    ret = PlatformBhWorkGetStat(&ginfo->irqRecord->bh, stat);
+    GpioInfoUnlock(ginfo);
+    return ret;
+}
+
 int32_t GpioCntlrEnableIrq(struct GpioCntlr *cntlr, uint16_t local)
 {
     if (cntlr == NULL) {
@@ -36,6 +36,28 @@ int32_t GpioWrite(uint16_t gpio, uint16_t val)
     return ret;
 }
 
+int32_t GpioReadMulti(uint16_t gpio, uint32_t mask, uint32_t *val)
+{
+    int32_t ret;
+    struct GpioCntlr *cntlr = GpioCntlrGetByGpio(gpio);
+
+    ret = GpioCntlrReadMulti(cntlr, GpioCntlrGetLocal(cntlr, gpio), mask, val);
+
+    GpioCntlrPut(cntlr);
+    return ret;
+}
+
+int32_t GpioWriteMulti(uint16_t gpio, uint32_t mask, uint32_t val)
+{
+    int32_t ret;
+    struct GpioCntlr *cntlr = GpioCntlrGetByGpio(gpio);
+
+    ret = GpioCntlrWriteMulti(cntlr, GpioCntlrGetLocal(cntlr, gpio), mask, val);
+
+    GpioCntlrPut(cntlr);
+    return ret;
+}
+
 int32_t GpioSetDir(uint16_t gpio, uint16_t dir)
 {
     int32_t ret;
@@ -135,6 +135,100 @@ int32_t GpioWrite(uint16_t gpio, uint16_t val)
     return HDF_SUCCESS;
 }
 
+int32_t GpioReadMulti(uint16_t gpio, uint32_t mask, uint32_t *val)
+{
+    int32_t ret;
+    struct HdfIoService *service = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    if (val == NULL) {
+        HDF_LOGE("%s: val is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    service = GpioManagerServiceGet();
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("%s: get gpio manager service fail!", __func__);
+        return HDF_PLT_ERR_DEV_GET;
+    }
+
+    data = HdfSbufObtainDefaultSize();
+    if (data == NULL) {
+        HDF_LOGE("%s: fail to obtain data", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    reply = HdfSbufObtainDefaultSize();
+    if (reply == NULL) {
+        HDF_LOGE("%s: fail to obtain reply", __func__);
+        HdfSbufRecycle(data);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    if (!HdfSbufWriteUint16(data, (uint16_t)gpio) || !HdfSbufWriteUint32(data, mask)) {
+        HDF_LOGE("%s: write gpio number or mask fail!", __func__);
+        HdfSbufRecycle(data);
+        HdfSbufRecycle(reply);
+        return HDF_ERR_IO;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_READ_MULTI, data, reply);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: service call fail:%d", __func__, ret);
+        HdfSbufRecycle(data);
+        HdfSbufRecycle(reply);
+        return ret;
+    }
+
+    if (!HdfSbufReadUint32(reply, val)) {
+        HDF_LOGE("%s: read sbuf fail", __func__);
+        HdfSbufRecycle(data);
+        HdfSbufRecycle(reply);
+        return HDF_ERR_IO;
+    }
+
+    HdfSbufRecycle(data);
+    HdfSbufRecycle(reply);
+    return HDF_SUCCESS;
+}
+
+int32_t GpioWriteMulti(uint16_t gpio, uint32_t mask, uint32_t val)
+{
+    int32_t ret;
+    struct HdfIoService *service = NULL;
+    struct HdfSBuf *data = NULL;
+
+    service = GpioManagerServiceGet();
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("%s: get gpio manager service fail!", __func__);
+        return HDF_PLT_ERR_DEV_GET;
+    }
+
+    data = HdfSbufObtainDefaultSize();
+    if (data == NULL) {
+        HDF_LOGE("%s: fail to obtain data", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    if (!HdfSbufWriteUint16(data, (uint16_t)gpio) || !HdfSbufWriteUint32(data, mask) ||
+        !HdfSbufWriteUint32(data, val)) {
+        HDF_LOGE("%s: write gpio number, mask or value fail!", __func__);
+        HdfSbufRecycle(data);
+        return HDF_ERR_IO;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_WRITE_MULTI, data, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: service call fail:%d", __func__, ret);
+        HdfSbufRecycle(data);
+        return ret;
+    }
+
+    HdfSbufRecycle(data);
+    return HDF_SUCCESS;
+}
+
 int32_t GpioGetDir(uint16_t gpio, uint16_t *dir)
 {
     int32_t ret;
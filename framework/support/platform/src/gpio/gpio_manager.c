@@ -8,6 +8,7 @@
 
 #include "gpio/gpio_core.h"
 #include "osal_mem.h"
+#include "osal_spinlock.h"
 #include "platform_core.h"
 #include "securec.h"
 
@@ -15,47 +16,166 @@
 
 #define MAX_CNT_PER_CNTLR          1024
 
+#ifndef GPIO_RANGE_MAX
+#define GPIO_RANGE_MAX             64
+#endif
+
+/*
+ * The gpio ranges of all controllers sorted by start, so that a gpio number is mapped to its controller by a
+ * binary search under a lock of its own, instead of a walk of the manager list under the manager lock.
+ * Controllers added while the table is full are only found by the walk, until a removal frees a slot for them.
+ */
+struct GpioRange {
+    uint16_t start;
+    uint16_t count;
+    struct GpioCntlr *cntlr;
+};
+
+struct GpioRangeTable {
+    OsalSpinlock spin;
+    uint16_t cnt;
+    uint16_t missed;    // controllers not in the table
+    struct GpioRange ranges[GPIO_RANGE_MAX];
+};
+
+static struct GpioRangeTable g_gpioRangeTable;
+
+// the manager list is in adding order, so check the new range against every controller
 static int32_t GpioCntlrCheckStart(struct GpioCntlr *cntlr, struct DListHead *list)
 {
-    uint16_t freeStart;
-    uint16_t freeCount;
-    struct PlatformDevice *iterLast = NULL;
     struct PlatformDevice *iterCur = NULL;
-    struct PlatformDevice *tmp = NULL;
     struct GpioCntlr *cntlrCur = NULL;
-    struct GpioCntlr *cntlrLast = NULL;
 
-    DLIST_FOR_EACH_ENTRY_SAFE(iterCur, tmp, list, struct PlatformDevice, node) {
+    if ((uint32_t)cntlr->start + cntlr->count > GPIO_NUM_MAX) {
+        PLAT_LOGE("GpioCntlrCheckStart: start:%hu(%hu) out of range", cntlr->start, cntlr->count);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    DLIST_FOR_EACH_ENTRY(iterCur, list, struct PlatformDevice, node) {
         cntlrCur = CONTAINER_OF(iterCur, struct GpioCntlr, device);
-        cntlrLast = CONTAINER_OF(iterLast, struct GpioCntlr, device);
-        if (cntlrLast == NULL) {
-            freeStart = 0;
-            freeCount = cntlrCur->start;
+        if (cntlr->start < (cntlrCur->start + cntlrCur->count) && cntlrCur->start < (cntlr->start + cntlr->count)) {
+            PLAT_LOGE("GpioCntlrCheckStart: start:%hu(%hu) not available(curStart:%hu, curCount:%hu)",
+                cntlr->start, cntlr->count, cntlrCur->start, cntlrCur->count);
+            return HDF_PLT_RSC_NOT_AVL;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+// returns the index of the range containing gpio, or the index to insert a range starting at gpio, negated
+static int32_t GpioRangeSearch(const struct GpioRangeTable *table, uint16_t gpio)
+{
+    int32_t low = 0;
+    int32_t high = table->cnt;
+    int32_t mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2; // 2: half
+        if (gpio < table->ranges[mid].start) {
+            high = mid;
+        } else if (gpio >= table->ranges[mid].start + table->ranges[mid].count) {
+            low = mid + 1;
         } else {
-            freeStart = cntlrLast->start + cntlrLast->count;
-            freeCount = cntlrCur->start - freeStart;
+            return mid;
         }
+    }
+    return -low - 1;
+}
 
-        if (cntlr->start < freeStart) {
-            PLAT_LOGE("GpioCntlrCheckStart: start:%hu not available(freeStart:%hu, freeCount:%hu)",
-                cntlr->start, freeStart, freeCount);
-            return HDF_PLT_RSC_NOT_AVL;
+// the range must not overlap any in the table, which GpioCntlrCheckStart makes sure of
+static void GpioRangeInsertLocked(struct GpioRangeTable *table, struct GpioCntlr *cntlr)
+{
+    int32_t index = -GpioRangeSearch(table, cntlr->start) - 1;
+
+    if (index < table->cnt) {
+        (void)memmove_s(&table->ranges[index + 1], sizeof(table->ranges[0]) * (GPIO_RANGE_MAX - index - 1),
+            &table->ranges[index], sizeof(table->ranges[0]) * (table->cnt - index));
+    }
+    table->ranges[index].start = cntlr->start;
+    table->ranges[index].count = cntlr->count;
+    table->ranges[index].cntlr = cntlr;
+    table->cnt++;
+}
+
+static void GpioRangeAdd(struct GpioCntlr *cntlr)
+{
+    uint32_t irqSave;
+    struct GpioRangeTable *table = &g_gpioRangeTable;
+
+    (void)OsalSpinLockIrqSave(&table->spin, &irqSave);
+    if (table->cnt >= GPIO_RANGE_MAX) {
+        table->missed++;
+        (void)OsalSpinUnlockIrqRestore(&table->spin, &irqSave);
+        PLAT_LOGW("GpioRangeAdd: table full, start:%hu count:%hu looked up slowly", cntlr->start, cntlr->count);
+        return;
+    }
+    GpioRangeInsertLocked(table, cntlr);
+    (void)OsalSpinUnlockIrqRestore(&table->spin, &irqSave);
+}
+
+// move controllers left out of a full table into the slots freed since, the list is stable under the manager lock
+static void GpioRangeRefill(struct DListHead *list)
+{
+    int32_t index;
+    uint32_t irqSave;
+    struct PlatformDevice *device = NULL;
+    struct GpioCntlr *cntlr = NULL;
+    struct GpioRangeTable *table = &g_gpioRangeTable;
+
+    (void)OsalSpinLockIrqSave(&table->spin, &irqSave);
+    DLIST_FOR_EACH_ENTRY(device, list, struct PlatformDevice, node) {
+        if (table->missed == 0 || table->cnt >= GPIO_RANGE_MAX) {
+            break;
+        }
+        cntlr = CONTAINER_OF(device, struct GpioCntlr, device);
+        index = GpioRangeSearch(table, cntlr->start);
+        if (index >= 0) {
+            continue; // in the table already
         }
+        GpioRangeInsertLocked(table, cntlr);
+        table->missed--;
+    }
+    (void)OsalSpinUnlockIrqRestore(&table->spin, &irqSave);
+}
 
-        if ((cntlr->start + cntlr->count) <= (freeStart + freeCount)) {
-            return HDF_SUCCESS;
+static void GpioRangeDel(struct GpioCntlr *cntlr)
+{
+    int32_t index;
+    uint32_t irqSave;
+    struct GpioRangeTable *table = &g_gpioRangeTable;
+
+    (void)OsalSpinLockIrqSave(&table->spin, &irqSave);
+    index = GpioRangeSearch(table, cntlr->start);
+    if (index < 0 || table->ranges[index].cntlr != cntlr) {
+        if (table->missed > 0) {
+            table->missed--;
         }
-        cntlrLast = cntlrCur;
+        (void)OsalSpinUnlockIrqRestore(&table->spin, &irqSave);
+        return;
     }
-    if (cntlrLast == NULL) { // empty list
-        return HDF_SUCCESS;
+    if (index + 1 < table->cnt) {
+        (void)memmove_s(&table->ranges[index], sizeof(table->ranges[0]) * (GPIO_RANGE_MAX - index),
+            &table->ranges[index + 1], sizeof(table->ranges[0]) * (table->cnt - index - 1));
     }
-    if (cntlr->start >= (cntlrLast->start + cntlrLast->count)) {
-        return HDF_SUCCESS;
+    table->cnt--;
+    (void)OsalSpinUnlockIrqRestore(&table->spin, &irqSave);
+}
+
+// a reference of the controller is taken in the table lock, so that it can not be removed before being got
+static struct GpioCntlr *GpioRangeGetCntlr(uint16_t gpio, bool *missed)
+{
+    int32_t index;
+    uint32_t irqSave;
+    struct GpioCntlr *cntlr = NULL;
+    struct GpioRangeTable *table = &g_gpioRangeTable;
+
+    (void)OsalSpinLockIrqSave(&table->spin, &irqSave);
+    index = GpioRangeSearch(table, gpio);
+    if (index >= 0 && PlatformDeviceGet(&table->ranges[index].cntlr->device) == HDF_SUCCESS) {
+        cntlr = table->ranges[index].cntlr;
     }
-    PLAT_LOGE("GpioCntlrCheckStart: start:%hu(%hu) not available(lastStart:%hu, lastCount:%hu)",
-        cntlr->start, cntlr->count, cntlrLast->start, cntlrLast->count);
-    return GPIO_NUM_MAX;
+    *missed = (table->missed > 0);
+    (void)OsalSpinUnlockIrqRestore(&table->spin, &irqSave);
+    return cntlr;
 }
 
 static int32_t GpioManagerAdd(struct PlatformManager *manager, struct PlatformDevice *device)
@@ -70,6 +190,7 @@ static int32_t GpioManagerAdd(struct PlatformManager *manager, struct PlatformDe
     }
 
     DListInsertTail(&device->node, &manager->devices);
+    GpioRangeAdd(cntlr);
     PLAT_LOGI("GpioManagerAdd: start:%hu count:%hu added success", cntlr->start, cntlr->count);
     return HDF_SUCCESS;
 }
@@ -78,6 +199,8 @@ static int32_t GpioManagerDel(struct PlatformManager *manager, struct PlatformDe
 {
     if (!DListIsEmpty(&device->node)) {
         DListRemove(&device->node);
+        GpioRangeDel(CONTAINER_OF(device, struct GpioCntlr, device));
+        GpioRangeRefill(&manager->devices);
     }
     return HDF_SUCCESS;
 }
@@ -89,6 +212,7 @@ struct PlatformManager *GpioManagerGet(void)
     if (manager == NULL) {
         manager = PlatformManagerGet(PLATFORM_MODULE_GPIO);
         if (manager != NULL) {
+            (void)OsalSpinInit(&g_gpioRangeTable.spin);
             manager->add = GpioManagerAdd;
             manager->del = GpioManagerDel;
         }
@@ -203,6 +327,8 @@ struct GpioCntlr *GpioCntlrGetByGpio(uint16_t gpio)
 {
     struct PlatformManager *gpioMgr = NULL;
     struct PlatformDevice *device = NULL;
+    struct GpioCntlr *cntlr = NULL;
+    bool missed = false;
 
     gpioMgr = GpioManagerGet();
     if (gpioMgr == NULL) {
@@ -210,7 +336,13 @@ struct GpioCntlr *GpioCntlrGetByGpio(uint16_t gpio)
         return NULL;
     }
 
-    device = PlatformManagerFindDevice(gpioMgr, (void *)(uintptr_t)gpio, GpioCntlrFindMatch);
+    cntlr = GpioRangeGetCntlr(gpio, &missed);
+    if (cntlr != NULL) {
+        return cntlr;
+    }
+    if (missed) {
+        device = PlatformManagerFindDevice(gpioMgr, (void *)(uintptr_t)gpio, GpioCntlrFindMatch);
+    }
     if (device == NULL) {
         PLAT_LOGE("GpioCntlrGetByGpio: gpio %hu not in any controllers!", gpio);
         return NULL;
@@ -77,6 +77,64 @@ static int32_t GpioServiceIoWrite(struct HdfSBuf *data, struct HdfSBuf *reply)
     return ret;
 }
 
+static int32_t GpioServiceIoReadMulti(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint16_t gpio;
+    uint32_t mask;
+    uint32_t value;
+
+    if (data == NULL || reply == NULL) {
+        HDF_LOGE("%s: data or reply is NULL", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (!HdfSbufReadUint16(data, &gpio) || !HdfSbufReadUint32(data, &mask)) {
+        HDF_LOGE("%s: read gpio number or mask fail", __func__);
+        return HDF_ERR_IO;
+    }
+
+    ret = GpioReadMulti(gpio, mask, &value);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: read gpios fail:%d", __func__, ret);
+        return ret;
+    }
+
+    if (!HdfSbufWriteUint32(reply, value)) {
+        HDF_LOGE("%s: write sbuf fail", __func__);
+        return HDF_ERR_IO;
+    }
+
+    return ret;
+}
+
+static int32_t GpioServiceIoWriteMulti(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint16_t gpio;
+    uint32_t mask;
+    uint32_t value;
+
+    (void)reply;
+    if (data == NULL) {
+        HDF_LOGE("%s: data is NULL", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (!HdfSbufReadUint16(data, &gpio) || !HdfSbufReadUint32(data, &mask) || !HdfSbufReadUint32(data, &value)) {
+        HDF_LOGE("%s: read gpio number, mask or value fail", __func__);
+        return HDF_ERR_IO;
+    }
+
+    ret = GpioWriteMulti(gpio, mask, value);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: write gpios fail:%d", __func__, ret);
+        return ret;
+    }
+
+    return ret;
+}
+
 static int32_t GpioServiceIoGetDir(struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     int32_t ret;
@@ -299,6 +357,10 @@ static int32_t GpioServiceDispatch(
             return GpioServiceIoEnableIrq(data, reply);
         case GPIO_IO_DISABLEIRQ:
             return GpioServiceIoDisableIrq(data, reply);
+        case GPIO_IO_READ_MULTI:
+            return GpioServiceIoReadMulti(data, reply);
+        case GPIO_IO_WRITE_MULTI:
+            return GpioServiceIoWriteMulti(data, reply);
         default:
             ret = HDF_ERR_NOT_SUPPORT;
             break;
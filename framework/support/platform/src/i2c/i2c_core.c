@@ -10,6 +10,9 @@
 #include "hdf_device_desc.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "osal_thread.h"
 #include "osal_time.h"
 #include "platform_core.h"
 
@@ -17,6 +20,10 @@
 #define LOCK_WAIT_SECONDS_M 1
 #define I2C_HANDLE_SHIFT    ((uintptr_t)(-1) << 16)
 
+#define I2C_ASYNC_DEPTH_MAX    64
+#define I2C_ASYNC_BATCH_MAX    8
+#define I2C_ASYNC_STACK_SIZE   10000
+
 struct I2cManager {
     struct IDeviceIoService service;
     struct HdfDeviceObject *device;
@@ -26,6 +33,28 @@ struct I2cManager {
 
 static struct I2cManager *g_i2cManager = NULL;
 
+struct I2cAsyncReq {
+    struct DListHead node;
+    struct I2cTransferReq *req;
+    int32_t ret;
+};
+
+/*
+ * Asynchronous requests of a controller, a list for each priority. The worker thread drains them in batches,
+ * up to I2C_ASYNC_BATCH_MAX requests run under one hold of the controller, and their callbacks are called out
+ * of it, so a callback may queue the next request and synchronous callers get the bus between batches.
+ */
+struct I2cAsyncQueue {
+    struct I2cCntlr *cntlr;
+    OsalSpinlock spin;
+    struct OsalSem sem;
+    struct OsalThread thread;
+    struct DListHead reqs[I2C_TRANSFER_PRI_MAX];
+    uint32_t depth;
+    bool stop;
+    bool exited;
+};
+
 static int32_t I2cCntlrLockDefault(struct I2cCntlr *cntlr)
 {
     if (cntlr == NULL) {
@@ -170,6 +199,7 @@ int32_t I2cCntlrAdd(struct I2cCntlr *cntlr)
         HDF_LOGE("I2cCntlrAdd: init lock fail!");
         return HDF_FAILURE;
     }
+    cntlr->asyncQueue = NULL;
 
     ret = I2cManagerAddCntlr(cntlr);
     if (ret != HDF_SUCCESS) {
@@ -179,12 +209,18 @@ int32_t I2cCntlrAdd(struct I2cCntlr *cntlr)
     return HDF_SUCCESS;
 }
 
+static void I2cAsyncQueueDestroy(struct I2cAsyncQueue *queue);
+
 void I2cCntlrRemove(struct I2cCntlr *cntlr)
 {
     if (cntlr == NULL) {
         return;
     }
     I2cManagerRemoveCntlr(cntlr);
+    if (cntlr->asyncQueue != NULL) {
+        I2cAsyncQueueDestroy(cntlr->asyncQueue); // queued requests are done before
+        cntlr->asyncQueue = NULL;
+    }
     (void)OsalMutexDestroy(&cntlr->lock);
 }
 
@@ -226,12 +262,253 @@ int32_t I2cCntlrTransfer(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t co
     return ret;
 }
 
-static int32_t I2cTransferRebuildMsgs(struct HdfSBuf *data, struct I2cMsg **ppmsgs, int16_t *pcount, uint8_t **ppbuf)
+static struct I2cAsyncReq *I2cAsyncQueueTake(struct I2cAsyncQueue *queue)
+{
+    uint32_t pri;
+    struct I2cAsyncReq *areq = NULL;
+
+    (void)OsalSpinLock(&queue->spin);
+    for (pri = 0; pri < I2C_TRANSFER_PRI_MAX; pri++) {
+        if (!DListIsEmpty(&queue->reqs[pri])) {
+            areq = DLIST_FIRST_ENTRY(&queue->reqs[pri], struct I2cAsyncReq, node);
+            DListRemove(&areq->node);
+            queue->depth--;
+            break;
+        }
+    }
+    (void)OsalSpinUnlock(&queue->spin);
+    return areq;
+}
+
+static uint32_t I2cAsyncQueueRunBatch(struct I2cAsyncQueue *queue)
+{
+    uint32_t cnt = 0;
+    bool locked;
+    struct DListHead done;
+    struct I2cAsyncReq *areq = NULL;
+    struct I2cAsyncReq *tmp = NULL;
+    struct I2cCntlr *cntlr = queue->cntlr;
+
+    DListHeadInit(&done);
+    locked = (I2cCntlrLock(cntlr) == HDF_SUCCESS);
+    while (cnt < I2C_ASYNC_BATCH_MAX && (areq = I2cAsyncQueueTake(queue)) != NULL) {
+        areq->ret = locked ? cntlr->ops->transfer(cntlr, areq->req->msgs, areq->req->count) : HDF_ERR_DEVICE_BUSY;
+        DListInsertTail(&areq->node, &done);
+        cnt++;
+    }
+    if (locked) {
+        I2cCntlrUnlock(cntlr);
+    }
+
+    DLIST_FOR_EACH_ENTRY_SAFE(areq, tmp, &done, struct I2cAsyncReq, node) {
+        DListRemove(&areq->node);
+        areq->req->callback(areq->req, areq->ret);
+        OsalMemFree(areq);
+    }
+    return cnt;
+}
+
+static int32_t I2cAsyncQueueWorker(void *data)
+{
+    bool stop = false;
+    struct I2cAsyncQueue *queue = (struct I2cAsyncQueue *)data;
+
+    while (!stop) {
+        if (OsalSemWait(&queue->sem, HDF_WAIT_FOREVER) != HDF_SUCCESS) {
+            continue;
+        }
+        (void)OsalSpinLock(&queue->spin);
+        stop = queue->stop;
+        (void)OsalSpinUnlock(&queue->spin);
+        while (I2cAsyncQueueRunBatch(queue) > 0) {
+        }
+    }
+
+    (void)OsalSpinLock(&queue->spin);
+    queue->exited = true;
+    (void)OsalSpinUnlock(&queue->spin);
+    return HDF_SUCCESS;
+}
+
+static struct I2cAsyncQueue *I2cAsyncQueueCreate(struct I2cCntlr *cntlr)
+{
+    int32_t ret;
+    uint32_t pri;
+    struct OsalThreadParam cfg;
+    struct I2cAsyncQueue *queue = NULL;
+
+    queue = (struct I2cAsyncQueue *)OsalMemCalloc(sizeof(*queue));
+    if (queue == NULL) {
+        HDF_LOGE("I2cAsyncQueueCreate: alloc queue fail!");
+        return NULL;
+    }
+    queue->cntlr = cntlr;
+    (void)OsalSpinInit(&queue->spin);
+    (void)OsalSemInit(&queue->sem, 0);
+    for (pri = 0; pri < I2C_TRANSFER_PRI_MAX; pri++) {
+        DListHeadInit(&queue->reqs[pri]);
+    }
+
+    ret = OsalThreadCreate(&queue->thread, I2cAsyncQueueWorker, queue);
+    if (ret == HDF_SUCCESS) {
+        cfg.name = "i2c_async";
+        cfg.priority = OSAL_THREAD_PRI_HIGH;
+        cfg.stackSize = I2C_ASYNC_STACK_SIZE;
+        ret = OsalThreadStart(&queue->thread, &cfg);
+        if (ret != HDF_SUCCESS) {
+            (void)OsalThreadDestroy(&queue->thread);
+        }
+    }
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("I2cAsyncQueueCreate: start worker of bus:%hd fail:%d", cntlr->busId, ret);
+        (void)OsalSemDestroy(&queue->sem);
+        (void)OsalSpinDestroy(&queue->spin);
+        OsalMemFree(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+static void I2cAsyncQueueDestroy(struct I2cAsyncQueue *queue)
+{
+    bool exited = false;
+
+    (void)OsalSpinLock(&queue->spin);
+    queue->stop = true;
+    (void)OsalSpinUnlock(&queue->spin);
+    (void)OsalSemPost(&queue->sem);
+
+    while (!exited) {
+        (void)OsalSpinLock(&queue->spin);
+        exited = queue->exited;
+        (void)OsalSpinUnlock(&queue->spin);
+        if (!exited) {
+            OsalMSleep(1);
+        }
+    }
+    (void)OsalThreadDestroy(&queue->thread);
+    (void)OsalSemDestroy(&queue->sem);
+    (void)OsalSpinDestroy(&queue->spin);
+    OsalMemFree(queue);
+}
+
+// the worker of a controller is started by its first asynchronous transfer
+static struct I2cAsyncQueue *I2cAsyncQueueGet(struct I2cCntlr *cntlr)
+{
+    struct I2cAsyncQueue *queue = NULL;
+    struct I2cManager *manager = g_i2cManager;
+
+    if (manager == NULL) {
+        HDF_LOGE("I2cAsyncQueueGet: get i2c manager fail!");
+        return NULL;
+    }
+    if (OsalMutexLock(&manager->lock) != HDF_SUCCESS) {
+        HDF_LOGE("I2cAsyncQueueGet: lock i2c manager fail!");
+        return NULL;
+    }
+    if (cntlr->asyncQueue == NULL) {
+        cntlr->asyncQueue = I2cAsyncQueueCreate(cntlr);
+    }
+    queue = cntlr->asyncQueue;
+    (void)OsalMutexUnlock(&manager->lock);
+    return queue;
+}
+
+int32_t I2cCntlrTransferAsync(struct I2cCntlr *cntlr, struct I2cTransferReq *req)
+{
+    bool post = false;
+    struct I2cAsyncReq *areq = NULL;
+    struct I2cAsyncQueue *queue = NULL;
+
+    if (cntlr == NULL) {
+        HDF_LOGE("I2cCntlrTransferAsync: cntlr is null");
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (cntlr->ops == NULL || cntlr->ops->transfer == NULL) {
+        HDF_LOGE("I2cCntlrTransferAsync: ops or transfer is null");
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (req == NULL || req->msgs == NULL || req->count <= 0 || req->callback == NULL ||
+        req->priority >= I2C_TRANSFER_PRI_MAX) {
+        HDF_LOGE("I2cCntlrTransferAsync: invalid req");
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    queue = I2cAsyncQueueGet(cntlr);
+    if (queue == NULL) {
+        return HDF_ERR_THREAD_CREATE_FAIL;
+    }
+    areq = (struct I2cAsyncReq *)OsalMemCalloc(sizeof(*areq));
+    if (areq == NULL) {
+        HDF_LOGE("I2cCntlrTransferAsync: alloc req fail!");
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    areq->req = req;
+
+    (void)OsalSpinLock(&queue->spin);
+    if (queue->stop || queue->depth >= I2C_ASYNC_DEPTH_MAX) {
+        (void)OsalSpinUnlock(&queue->spin);
+        OsalMemFree(areq);
+        HDF_LOGE("I2cCntlrTransferAsync: queue of bus:%hd full or stopped!", cntlr->busId);
+        return HDF_PLT_OUT_OF_RSC;
+    }
+    DListInsertTail(&areq->node, &queue->reqs[req->priority]);
+    post = (queue->depth == 0); // the worker drains the queue once woken
+    queue->depth++;
+    (void)OsalSpinUnlock(&queue->spin);
+
+    if (post) {
+        (void)OsalSemPost(&queue->sem);
+    }
+    return HDF_SUCCESS;
+}
+
+/* buffers of a user space client, mapped by it, requests refer to data in them by offset */
+struct I2cIoSharedBuf {
+    uint8_t *buf;
+    uint32_t size;
+};
+
+static bool I2cIoSharedBufHas(const struct I2cIoSharedBuf *shared, const uint8_t *buf)
+{
+    return shared != NULL && buf >= shared->buf && buf < shared->buf + shared->size;
+}
+
+// the offset of a shared message buffer, which takes the place of the copied buffer in the request
+static int32_t I2cTransferRebuildSharedMsg(struct HdfSBuf *data, const struct I2cIoSharedBuf *shared,
+    struct I2cMsg *msg, bool *isShared)
+{
+    uint32_t offset;
+
+    *isShared = false;
+    if (shared == NULL) {
+        return HDF_SUCCESS;
+    }
+    if (!HdfSbufReadUint32(data, &offset)) {
+        HDF_LOGE("I2cTransferRebuildSharedMsg: read offset fail!");
+        return HDF_ERR_IO;
+    }
+    if (offset == I2C_IO_NOT_SHARED) {
+        return HDF_SUCCESS;
+    }
+    if (msg->len == 0 || offset >= shared->size || msg->len > shared->size - offset) {
+        HDF_LOGE("I2cTransferRebuildSharedMsg: invalid offset:%u, len:%u", offset, msg->len);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    msg->buf = shared->buf + offset;
+    *isShared = true;
+    return HDF_SUCCESS;
+}
+
+static int32_t I2cTransferRebuildMsgs(struct HdfSBuf *data, const struct I2cIoSharedBuf *shared,
+    struct I2cMsg **ppmsgs, int16_t *pcount, uint8_t **ppbuf)
 {
     int16_t count;
     int16_t i;
+    int32_t ret;
     uint32_t len;
     uint32_t lenReply = 0;
+    bool isShared = false;
     uint8_t *buf = NULL;
     uint8_t *bufReply = NULL;
     struct I2cMsg *msgs = NULL;
@@ -245,8 +522,16 @@ static int32_t I2cTransferRebuildMsgs(struct HdfSBuf *data, struct I2cMsg **ppms
     PLAT_LOGV("I2cTransferRebuildMsgs: count:%hd, len:%u, sizeof(*msgs):%u",
         count, len, sizeof(*msgs));
     for (i = 0; i < count; i++) {
+        ret = I2cTransferRebuildSharedMsg(data, shared, &msgs[i], &isShared);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+        if (isShared) {
+            continue;
+        }
         if ((msgs[i].flags & I2C_FLAG_READ) != 0) {
             lenReply += msgs[i].len;
+            msgs[i].buf = NULL;
         } else if (!HdfSbufReadBuffer(data, (const void **)&buf, &len)) {
             HDF_LOGE("I2cTransferRebuildMsgs: read msg[%d] buf fail!", i);
         } else {
@@ -261,7 +546,7 @@ static int32_t I2cTransferRebuildMsgs(struct HdfSBuf *data, struct I2cMsg **ppms
             return HDF_ERR_MALLOC_FAIL;
         }
         for (i = 0, buf = bufReply; i < count && buf < (bufReply + lenReply); i++) {
-            if ((msgs[i].flags & I2C_FLAG_READ) != 0) {
+            if ((msgs[i].flags & I2C_FLAG_READ) != 0 && msgs[i].buf == NULL) {
                 msgs[i].buf = buf;
                 buf += msgs[i].len;
             }
@@ -274,13 +559,14 @@ static int32_t I2cTransferRebuildMsgs(struct HdfSBuf *data, struct I2cMsg **ppms
     return HDF_SUCCESS;
 }
 
-static int32_t I2cTransferWriteBackMsgs(struct HdfSBuf *reply, struct I2cMsg *msgs, int16_t count)
+static int32_t I2cTransferWriteBackMsgs(struct HdfSBuf *reply, const struct I2cIoSharedBuf *shared,
+    struct I2cMsg *msgs, int16_t count)
 {
     int16_t i;
 
     for (i = 0; i < count; i++) {
-        if ((msgs[i].flags & I2C_FLAG_READ) == 0) {
-            continue;
+        if ((msgs[i].flags & I2C_FLAG_READ) == 0 || I2cIoSharedBufHas(shared, msgs[i].buf)) {
+            continue; // shared reads are already in place
         }
         if (!HdfSbufWriteBuffer(reply, msgs[i].buf, msgs[i].len)) {
             HDF_LOGE("I2cTransferWriteBackMsgs: write msg[%hd] reply fail!", i);
@@ -291,7 +577,7 @@ static int32_t I2cTransferWriteBackMsgs(struct HdfSBuf *reply, struct I2cMsg *ms
     return HDF_SUCCESS;
 }
 
-static int32_t I2cManagerIoTransfer(struct HdfSBuf *data, struct HdfSBuf *reply)
+static int32_t I2cManagerIoTransfer(struct HdfSBuf *data, struct HdfSBuf *reply, const struct I2cIoSharedBuf *shared)
 {
     int32_t ret;
     int16_t count;
@@ -310,7 +596,7 @@ static int32_t I2cManagerIoTransfer(struct HdfSBuf *data, struct HdfSBuf *reply)
     }
     number = (int16_t)(handle - I2C_HANDLE_SHIFT);
 
-    ret = I2cTransferRebuildMsgs(data, &msgs, &count, &bufReply);
+    ret = I2cTransferRebuildMsgs(data, shared, &msgs, &count, &bufReply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("I2cManagerIoTransfer: rebuild msgs fail:%d", ret);
         return ret;
@@ -324,7 +610,7 @@ static int32_t I2cManagerIoTransfer(struct HdfSBuf *data, struct HdfSBuf *reply)
         return ret;
     }
 
-    ret = I2cTransferWriteBackMsgs(reply, msgs, count);
+    ret = I2cTransferWriteBackMsgs(reply, shared, msgs, count);
 
     if (bufReply != NULL) {
         OsalMemFree(bufReply);
@@ -332,6 +618,19 @@ static int32_t I2cManagerIoTransfer(struct HdfSBuf *data, struct HdfSBuf *reply)
     return ret;
 }
 
+static int32_t I2cManagerIoTransferShared(struct HdfDeviceIoClient *client, struct HdfSBuf *data,
+    struct HdfSBuf *reply)
+{
+    struct I2cIoSharedBuf shared;
+
+    shared.buf = (uint8_t *)HdfDeviceGetClientSharedBuf(client, &shared.size);
+    if (shared.buf == NULL) {
+        HDF_LOGE("I2cManagerIoTransferShared: no shared buffer mapped!");
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    return I2cManagerIoTransfer(data, reply, &shared);
+}
+
 static int32_t I2cManagerIoOpen(struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     int16_t number;
@@ -384,7 +683,9 @@ static int32_t I2cManagerDispatch(struct HdfDeviceIoClient *client, int cmd,
         case I2C_IO_CLOSE:
             return I2cManagerIoClose(data, reply);
         case I2C_IO_TRANSFER:
-            return I2cManagerIoTransfer(data, reply);
+            return I2cManagerIoTransfer(data, reply, NULL);
+        case I2C_IO_TRANSFER_SHARED:
+            return I2cManagerIoTransferShared(client, data, reply);
         default:
             ret = HDF_ERR_NOT_SUPPORT;
             break;
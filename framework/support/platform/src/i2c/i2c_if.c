@@ -44,3 +44,24 @@ int32_t I2cTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t count)
 
     return I2cCntlrTransfer((struct I2cCntlr *)handle, msgs, count);
 }
+
+int32_t I2cTransferAsync(DevHandle handle, struct I2cTransferReq *req)
+{
+    if (handle == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (req == NULL || req->msgs == NULL || req->count <= 0 || req->callback == NULL) {
+        HDF_LOGE("I2cTransferAsync: err params!");
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    return I2cCntlrTransferAsync((struct I2cCntlr *)handle, req);
+}
+
+void *I2cMapSharedBuffer(DevHandle handle, uint32_t size)
+{
+    (void)handle;
+    (void)size;
+    return NULL; // kernel space callers transfer their buffers directly
+}
@@ -17,6 +17,13 @@
 
 #define I2C_SERVICE_NAME "HDF_PLATFORM_I2C_MANAGER"
 
+struct I2cSharedBuf {
+    uint8_t *buf;
+    uint32_t size;
+};
+
+static struct I2cSharedBuf g_i2cSharedBuf;
+
 static struct HdfIoService *I2cManagerGetService(void)
 {
     static struct HdfIoService *service = NULL;
@@ -107,10 +114,36 @@ void I2cClose(DevHandle handle)
     HdfSbufRecycle(data);
 }
 
-static int32_t I2cMsgWriteArray(DevHandle handle, struct HdfSBuf *data, struct I2cMsg *msgs, int16_t count)
+// offset of a message buffer which lies in the shared buffer, the service reads and writes it in place
+static uint32_t I2cMsgSharedOffset(const struct I2cMsg *msg)
+{
+    const uint8_t *base = g_i2cSharedBuf.buf;
+
+    if (base == NULL || msg->buf == NULL || msg->len == 0 || msg->buf < base ||
+        msg->buf >= base + g_i2cSharedBuf.size || msg->len > (uint32_t)(base + g_i2cSharedBuf.size - msg->buf)) {
+        return I2C_IO_NOT_SHARED;
+    }
+    return (uint32_t)(msg->buf - base);
+}
+
+static bool I2cMsgsUseSharedBuf(const struct I2cMsg *msgs, int16_t count)
 {
     int16_t i;
 
+    for (i = 0; i < count; i++) {
+        if (I2cMsgSharedOffset(&msgs[i]) != I2C_IO_NOT_SHARED) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int32_t I2cMsgWriteArray(DevHandle handle, struct HdfSBuf *data, struct I2cMsg *msgs, int16_t count,
+    bool shared)
+{
+    int16_t i;
+    uint32_t offset;
+
     if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
         HDF_LOGE("I2cMsgWriteArray: write handle fail!");
         return HDF_ERR_IO;
@@ -122,7 +155,12 @@ static int32_t I2cMsgWriteArray(DevHandle handle, struct HdfSBuf *data, struct I
     }
 
     for (i = 0; i < count; i++) {
-        if ((msgs[i].flags & I2C_FLAG_READ) != 0) {
+        offset = shared ? I2cMsgSharedOffset(&msgs[i]) : I2C_IO_NOT_SHARED;
+        if (shared && !HdfSbufWriteUint32(data, offset)) {
+            HDF_LOGE("I2cMsgWriteArray: write msg[%hd] offset fail!", i);
+            return HDF_ERR_IO;
+        }
+        if ((msgs[i].flags & I2C_FLAG_READ) != 0 || offset != I2C_IO_NOT_SHARED) {
             continue;
         }
         if (!HdfSbufWriteBuffer(data, (uint8_t *)msgs[i].buf, msgs[i].len)) {
@@ -161,12 +199,15 @@ static int32_t I2cMsgReadBack(struct HdfSBuf *data, struct I2cMsg *msg)
     return HDF_SUCCESS;
 }
 
-static int32_t I2cMsgReadArray(struct HdfSBuf *reply, struct I2cMsg *msgs, int16_t count)
+static int32_t I2cMsgReadArray(struct HdfSBuf *reply, struct I2cMsg *msgs, int16_t count, bool shared)
 {
     int16_t i;
     int32_t ret;
 
     for (i = 0; i < count; i++) {
+        if (shared && I2cMsgSharedOffset(&msgs[i]) != I2C_IO_NOT_SHARED) {
+            continue; /* read in place */
+        }
         ret = I2cMsgReadBack(reply, &msgs[i]);
         if (ret != HDF_SUCCESS) {
             return ret;
@@ -180,6 +221,7 @@ static int32_t I2cServiceTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t
     int16_t i;
     int32_t ret;
     uint32_t recvLen = 0;
+    bool shared = I2cMsgsUseSharedBuf(msgs, count);
     struct HdfSBuf *data = NULL;
     struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
@@ -190,7 +232,7 @@ static int32_t I2cServiceTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t
         return HDF_ERR_MALLOC_FAIL;
     }
 
-    ret = I2cMsgWriteArray(handle, data, msgs, count);
+    ret = I2cMsgWriteArray(handle, data, msgs, count, shared);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("I2cServiceTransfer: failed to write msgs!");
         goto EXIT;
@@ -211,13 +253,14 @@ static int32_t I2cServiceTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t
         ret = HDF_ERR_NOT_SUPPORT;
         goto EXIT;
     }
-    ret = service->dispatcher->Dispatch(&service->object, I2C_IO_TRANSFER, data, reply);
+    ret = service->dispatcher->Dispatch(&service->object, shared ? I2C_IO_TRANSFER_SHARED : I2C_IO_TRANSFER,
+        data, reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("I2cServiceTransfer: failed to send service call:%d", ret);
         goto EXIT;
     }
 
-    ret = I2cMsgReadArray(reply, msgs, count);
+    ret = I2cMsgReadArray(reply, msgs, count, shared);
     if (ret != HDF_SUCCESS) {
         goto EXIT;
     }
@@ -247,3 +290,31 @@ int32_t I2cTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t count)
 
     return I2cServiceTransfer(handle, msgs, count);
 }
+
+int32_t I2cTransferAsync(DevHandle handle, struct I2cTransferReq *req)
+{
+    (void)handle;
+    (void)req;
+    HDF_LOGE("I2cTransferAsync: not support in user space!");
+    return HDF_ERR_NOT_SUPPORT;
+}
+
+void *I2cMapSharedBuffer(DevHandle handle, uint32_t size)
+{
+    void *buf = NULL;
+    struct HdfIoService *service = NULL;
+
+    if (handle == NULL) {
+        return NULL;
+    }
+    service = I2cManagerGetService();
+    if (service == NULL) {
+        return NULL;
+    }
+    buf = HdfIoServiceMapSharedBuffer(service, size);
+    if (buf != NULL && g_i2cSharedBuf.buf == NULL) {
+        g_i2cSharedBuf.size = size; // later calls get the first mapping, which is at least as large
+        g_i2cSharedBuf.buf = (uint8_t *)buf;
+    }
+    return buf;
+}
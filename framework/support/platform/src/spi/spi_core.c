@@ -113,14 +113,83 @@ int32_t SpiCntlrGetCfg(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiCfg *cf
     return ret;
 }
 
-static int32_t SpiTransferRebuildMsgs(struct HdfSBuf *data, struct SpiMsg **ppmsgs, uint32_t *pcount, uint8_t **ppbuf)
+/* buffer of a user space client, mapped by it, requests refer to data in it by offset */
+struct SpiIoSharedBuf {
+    uint8_t *buf;
+    uint32_t size;
+};
+
+/* kernel buffer the reads not in the shared buffer are done into, and copied back to the client from */
+struct SpiIoReplyBuf {
+    uint8_t *buf;
+    uint32_t size;
+};
+
+static bool SpiIoReplyBufHas(const struct SpiIoReplyBuf *reply, const uint8_t *buf)
+{
+    return reply->buf != NULL && buf >= reply->buf && buf < reply->buf + reply->size;
+}
+
+static int32_t SpiIoSharedBufGet(const struct SpiIoSharedBuf *shared, uint32_t offset, uint32_t len, uint8_t **buf)
+{
+    if (len == 0 || offset >= shared->size || len > shared->size - offset) {
+        HDF_LOGE("%s: invalid offset:%u, len:%u", __func__, offset, len);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *buf = shared->buf + offset;
+    return HDF_SUCCESS;
+}
+
+// offsets of shared message buffers, a buffer not shared is copied in the request as usual
+static int32_t SpiTransferRebuildSharedMsg(struct HdfSBuf *data, const struct SpiIoSharedBuf *shared,
+    struct SpiMsg *msg, bool *wShared, bool *rShared)
+{
+    int32_t ret;
+    uint32_t wOffset;
+    uint32_t rOffset;
+
+    *wShared = false;
+    *rShared = false;
+    if (shared == NULL) {
+        return HDF_SUCCESS;
+    }
+    if (!HdfSbufReadUint32(data, &wOffset) || !HdfSbufReadUint32(data, &rOffset)) {
+        HDF_LOGE("%s: read offset fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (msg->wbuf != NULL && wOffset != SPI_IO_NOT_SHARED) {
+        ret = SpiIoSharedBufGet(shared, wOffset, msg->len, &msg->wbuf);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+        *wShared = true;
+    }
+    if (msg->rbuf != NULL && rOffset != SPI_IO_NOT_SHARED) {
+        ret = SpiIoSharedBufGet(shared, rOffset, msg->len, &msg->rbuf);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+        *rShared = true;
+    }
+    return HDF_SUCCESS;
+}
+
+/*
+ * The rbuf of a read not shared comes from user space and means nothing here but that there is a read, so it is
+ * always replaced by a part of the reply buffer. With a shared buffer, which reads are shared is kept till then.
+ */
+static int32_t SpiTransferRebuildMsgs(struct HdfSBuf *data, const struct SpiIoSharedBuf *shared,
+    struct SpiMsg **ppmsgs, uint32_t *pcount, struct SpiIoReplyBuf *reply)
 {
     uint32_t count;
-    int32_t i;
+    uint32_t i;
+    int32_t ret = HDF_SUCCESS;
     uint32_t len;
     uint32_t lenReply = 0;
+    bool wShared = false;
+    bool rShared = false;
+    bool *rSharedMsgs = NULL;
     uint8_t *buf = NULL;
-    uint8_t *bufReply = NULL;
     struct SpiMsg *msgs = NULL;
 
     if (!HdfSbufReadBuffer(data, (const void **)&msgs, &len) || msgs == NULL || len == 0) {
@@ -129,27 +198,47 @@ static int32_t SpiTransferRebuildMsgs(struct HdfSBuf *data, struct SpiMsg **ppms
     }
 
     count = (uint32_t)len / (uint32_t)sizeof(struct SpiMsg);
+    if (shared != NULL) {
+        rSharedMsgs = (bool *)OsalMemCalloc(sizeof(*rSharedMsgs) * count);
+        if (rSharedMsgs == NULL) {
+            return HDF_ERR_MALLOC_FAIL;
+        }
+    }
     for (i = 0; i < count; i++) {
-        if (msgs[i].rbuf != NULL) {
+        ret = SpiTransferRebuildSharedMsg(data, shared, &msgs[i], &wShared, &rShared);
+        if (ret != HDF_SUCCESS) {
+            goto EXIT;
+        }
+        if (rSharedMsgs != NULL) {
+            rSharedMsgs[i] = rShared;
+        }
+        if (msgs[i].rbuf != NULL && !rShared) {
+            if (msgs[i].len > UINT32_MAX - lenReply) {
+                HDF_LOGE("%s: reply of msg[%u] too long!", __func__, i);
+                ret = HDF_ERR_INVALID_PARAM;
+                goto EXIT;
+            }
             lenReply += msgs[i].len;
         }
-        if (msgs[i].wbuf == NULL) {
+        if (msgs[i].wbuf == NULL || wShared) {
             continue;
         }
         if (!HdfSbufReadBuffer(data, (const void **)&buf, &len)) {
-            HDF_LOGE("%s: read msg[%d] buf fail!", __func__, i);
+            HDF_LOGE("%s: read msg[%u] buf fail!", __func__, i);
         } else {
             msgs[i].wbuf = buf;
         }
     }
 
     if (lenReply > 0) {
-        bufReply = OsalMemCalloc(lenReply);
-        if (bufReply == NULL) {
-            return HDF_ERR_MALLOC_FAIL;
+        reply->buf = OsalMemCalloc(lenReply);
+        if (reply->buf == NULL) {
+            ret = HDF_ERR_MALLOC_FAIL;
+            goto EXIT;
         }
-        for (i = 0, buf = bufReply; i < count && buf < (bufReply + lenReply); i++) {
-            if (msgs[i].rbuf != NULL) {
+        reply->size = lenReply;
+        for (i = 0, buf = reply->buf; i < count; i++) {
+            if (msgs[i].rbuf != NULL && (rSharedMsgs == NULL || !rSharedMsgs[i])) {
                 msgs[i].rbuf = buf;
                 buf += msgs[i].len;
             }
@@ -158,18 +247,21 @@ static int32_t SpiTransferRebuildMsgs(struct HdfSBuf *data, struct SpiMsg **ppms
 
     *ppmsgs = msgs;
     *pcount = count;
-    *ppbuf = bufReply;
-
-    return HDF_SUCCESS;
+EXIT:
+    if (rSharedMsgs != NULL) {
+        OsalMemFree(rSharedMsgs);
+    }
+    return ret;
 }
 
-static int32_t SpiTransferWriteBackMsgs(struct HdfSBuf *reply, struct SpiMsg *msgs, uint32_t count)
+static int32_t SpiTransferWriteBackMsgs(struct HdfSBuf *reply, const struct SpiIoReplyBuf *replyBuf,
+    struct SpiMsg *msgs, uint32_t count)
 {
     uint32_t i;
 
     for (i = 0; i < count; i++) {
-        if (msgs[i].rbuf == NULL) {
-            continue;
+        if (msgs[i].rbuf == NULL || !SpiIoReplyBufHas(replyBuf, msgs[i].rbuf)) {
+            continue; // shared reads are already in place
         }
 
         if (!HdfSbufWriteBuffer(reply, msgs[i].rbuf, msgs[i].len)) {
@@ -181,18 +273,19 @@ static int32_t SpiTransferWriteBackMsgs(struct HdfSBuf *reply, struct SpiMsg *ms
     return HDF_SUCCESS;
 }
 
-static int32_t SpiIoTransfer(struct SpiCntlr *cntlr, uint32_t csNum, struct HdfSBuf *data, struct HdfSBuf *reply)
+static int32_t SpiIoTransfer(struct SpiCntlr *cntlr, uint32_t csNum, struct HdfSBuf *data, struct HdfSBuf *reply,
+    const struct SpiIoSharedBuf *shared)
 {
     int32_t ret;
     uint32_t count;
     struct SpiMsg *msgs = NULL;
-    uint8_t *bufReply = NULL;
+    struct SpiIoReplyBuf replyBuf = { NULL, 0 };
 
     if (data == NULL || reply == NULL) {
         return HDF_ERR_INVALID_PARAM;
     }
 
-    ret = SpiTransferRebuildMsgs(data, &msgs, &count, &bufReply);
+    ret = SpiTransferRebuildMsgs(data, shared, &msgs, &count, &replyBuf);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: rebuild msgs fail:%d", __func__, ret);
         goto EXIT;
@@ -204,15 +297,28 @@ static int32_t SpiIoTransfer(struct SpiCntlr *cntlr, uint32_t csNum, struct HdfS
         goto EXIT;
     }
 
-    ret =  SpiTransferWriteBackMsgs(reply, msgs, count);
+    ret =  SpiTransferWriteBackMsgs(reply, &replyBuf, msgs, count);
 
 EXIT:
-    if (bufReply != NULL) {
-        OsalMemFree(bufReply);
+    if (replyBuf.buf != NULL) {
+        OsalMemFree(replyBuf.buf);
     }
     return ret;
 }
 
+static int32_t SpiIoTransferShared(struct HdfDeviceIoClient *client, struct SpiCntlr *cntlr, uint32_t csNum,
+    struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    struct SpiIoSharedBuf shared;
+
+    shared.buf = (uint8_t *)HdfDeviceGetClientSharedBuf(client, &shared.size);
+    if (shared.buf == NULL) {
+        HDF_LOGE("%s: no shared buffer mapped!", __func__);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    return SpiIoTransfer(cntlr, csNum, data, reply, &shared);
+}
+
 static inline int32_t SpiIoOpen(struct SpiCntlr *cntlr, uint32_t csNum)
 {
     return SpiCntlrOpen(cntlr, csNum);
@@ -286,7 +392,9 @@ static int32_t SpiIoDispatch(struct HdfDeviceIoClient *client, int cmd,
         case SPI_IO_GET_CONFIG:
             return SpiIoGetConfig(cntlr, csNum, reply);
         case SPI_IO_TRANSFER:
-            return SpiIoTransfer(cntlr, csNum, data, reply);
+            return SpiIoTransfer(cntlr, csNum, data, reply, NULL);
+        case SPI_IO_TRANSFER_SHARED:
+            return SpiIoTransferShared(client, cntlr, csNum, data, reply);
         default:
             ret = HDF_ERR_NOT_SUPPORT;
             break;
@@ -47,6 +47,13 @@ int32_t SpiTransfer(DevHandle handle, struct SpiMsg *msgs, uint32_t count)
     return SpiCntlrTransfer(client->cntlr, client->csNum, msgs, count);
 }
 
+void *SpiMapSharedBuffer(DevHandle handle, uint32_t size)
+{
+    (void)handle;
+    (void)size;
+    return NULL; // kernel space callers transfer their buffers directly
+}
+
 int32_t SpiRead(DevHandle handle, uint8_t *buf, uint32_t len)
 {
     struct SpiMsg msg = {0};
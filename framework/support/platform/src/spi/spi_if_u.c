@@ -18,6 +18,8 @@
 struct SpiClient {
     struct SpiCntlr *cntlr;
     uint32_t csNum;
+    uint8_t *sharedBuf;
+    uint32_t sharedBufSize;
 };
 
 static struct HdfIoService *SpiGetCntlrByBusNum(uint32_t num)
@@ -36,9 +38,36 @@ static struct HdfIoService *SpiGetCntlrByBusNum(uint32_t num)
     return service;
 }
 
-static int32_t SpiMsgWriteArray(struct SpiClient *client, struct HdfSBuf *data, struct SpiMsg *msgs, uint32_t count)
+// offset of a message buffer which lies in the shared buffer, the service reads and writes it in place
+static uint32_t SpiSharedOffset(const struct SpiClient *client, const uint8_t *buf, uint32_t len)
+{
+    const uint8_t *base = client->sharedBuf;
+
+    if (base == NULL || buf == NULL || len == 0 || buf < base || buf >= base + client->sharedBufSize ||
+        len > (uint32_t)(base + client->sharedBufSize - buf)) {
+        return SPI_IO_NOT_SHARED;
+    }
+    return (uint32_t)(buf - base);
+}
+
+static bool SpiMsgsUseSharedBuf(const struct SpiClient *client, const struct SpiMsg *msgs, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (SpiSharedOffset(client, msgs[i].wbuf, msgs[i].len) != SPI_IO_NOT_SHARED ||
+            SpiSharedOffset(client, msgs[i].rbuf, msgs[i].len) != SPI_IO_NOT_SHARED) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int32_t SpiMsgWriteArray(struct SpiClient *client, struct HdfSBuf *data, struct SpiMsg *msgs, uint32_t count,
+    bool shared)
 {
     uint32_t i;
+    uint32_t wOffset;
 
     if (!HdfSbufWriteUint32(data, client->csNum)) {
         HDF_LOGE("%s: write csNum failed!", __func__);
@@ -51,7 +80,13 @@ static int32_t SpiMsgWriteArray(struct SpiClient *client, struct HdfSBuf *data,
     }
 
     for (i = 0; i < count; i++) {
-        if (msgs[i].wbuf == NULL) {
+        wOffset = shared ? SpiSharedOffset(client, msgs[i].wbuf, msgs[i].len) : SPI_IO_NOT_SHARED;
+        if (shared && (!HdfSbufWriteUint32(data, wOffset) ||
+            !HdfSbufWriteUint32(data, SpiSharedOffset(client, msgs[i].rbuf, msgs[i].len)))) {
+            HDF_LOGE("%s: write msg[%u] offset failed!", __func__, i);
+            return HDF_ERR_IO;
+        }
+        if (msgs[i].wbuf == NULL || wOffset != SPI_IO_NOT_SHARED) {
             continue;
         }
 
@@ -87,7 +122,8 @@ static int32_t SpiMsgReadBack(struct HdfSBuf *data, struct SpiMsg *msg)
     return HDF_SUCCESS;
 }
 
-static int32_t SpiMsgReadArray(struct HdfSBuf *reply, struct SpiMsg *msgs, uint32_t count)
+static int32_t SpiMsgReadArray(const struct SpiClient *client, struct HdfSBuf *reply, struct SpiMsg *msgs,
+    uint32_t count, bool shared)
 {
     uint32_t i;
     int32_t ret;
@@ -96,6 +132,9 @@ static int32_t SpiMsgReadArray(struct HdfSBuf *reply, struct SpiMsg *msgs, uint3
         if (msgs[i].rbuf == NULL) {
             continue;
         }
+        if (shared && SpiSharedOffset(client, msgs[i].rbuf, msgs[i].len) != SPI_IO_NOT_SHARED) {
+            continue; /* read in place */
+        }
         ret = SpiMsgReadBack(reply, &msgs[i]);
         if (ret != HDF_SUCCESS) {
             return ret;
@@ -109,6 +148,7 @@ int32_t SpiTransfer(DevHandle handle, struct SpiMsg *msgs, uint32_t count)
     int32_t ret;
     uint32_t i;
     uint32_t len = 0;
+    bool shared = false;
     struct HdfSBuf *data = NULL;
     struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
@@ -119,9 +159,11 @@ int32_t SpiTransfer(DevHandle handle, struct SpiMsg *msgs, uint32_t count)
         return HDF_ERR_INVALID_OBJECT;
     }
     client = (struct SpiClient *)handle;
+    shared = SpiMsgsUseSharedBuf(client, msgs, count);
 
     for (i = 0; i < count; i++) {
         len += ((msgs[i].wbuf == NULL) ? 0 : msgs[i].len) + sizeof(uint64_t) + sizeof(*msgs) + sizeof(uint32_t);
+        len += shared ? (sizeof(uint32_t) + sizeof(uint32_t)) : 0; // the offsets of wbuf and rbuf
     }
     data = HdfSbufObtain(len);
     if (data == NULL) {
@@ -139,7 +181,7 @@ int32_t SpiTransfer(DevHandle handle, struct SpiMsg *msgs, uint32_t count)
         goto EXIT;
     }
 
-    ret = SpiMsgWriteArray(client, data, msgs, count);
+    ret = SpiMsgWriteArray(client, data, msgs, count, shared);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: failed to write msgs!", __func__);
         goto EXIT;
@@ -151,13 +193,14 @@ int32_t SpiTransfer(DevHandle handle, struct SpiMsg *msgs, uint32_t count)
         ret =  HDF_FAILURE;
         goto EXIT;
     }
-    ret = service->dispatcher->Dispatch(&service->object, SPI_IO_TRANSFER, data, reply);
+    ret = service->dispatcher->Dispatch(&service->object, shared ? SPI_IO_TRANSFER_SHARED : SPI_IO_TRANSFER,
+        data, reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: failed to send service call:%d", __func__, ret);
         goto EXIT;
     }
 
-    ret = SpiMsgReadArray(reply, msgs, count);
+    ret = SpiMsgReadArray(client, reply, msgs, count, shared);
     if (ret != HDF_SUCCESS) {
         goto EXIT;
     }
@@ -169,6 +212,24 @@ EXIT:
     return ret;
 }
 
+void *SpiMapSharedBuffer(DevHandle handle, uint32_t size)
+{
+    void *buf = NULL;
+    struct SpiClient *client = NULL;
+
+    if (handle == NULL) {
+        HDF_LOGE("%s: handle is invalid", __func__);
+        return NULL;
+    }
+    client = (struct SpiClient *)handle;
+    buf = HdfIoServiceMapSharedBuffer((struct HdfIoService *)client->cntlr, size);
+    if (buf != NULL && client->sharedBuf == NULL) {
+        client->sharedBufSize = size; // later calls get the first mapping, which is at least as large
+        client->sharedBuf = (uint8_t *)buf;
+    }
+    return buf;
+}
+
 int32_t SpiRead(DevHandle handle, uint8_t *buf, uint32_t len)
 {
     struct SpiMsg msg = {0};
@@ -9,10 +9,39 @@
 #include "uart_core.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "platform_bh.h"
+#include "platform_listener_common.h"
+#include "securec.h"
 #include "uart_if.h"
 
 #define HDF_LOG_TAG uart_core_c
 
+#define UART_RX_RING_SIZE_MIN 64
+#define UART_RX_RING_SIZE_MAX (64 * 1024)
+
+/*
+ * Bytes received by the controller, pushed with interrupts off and taken by one reader at a time. The reader
+ * copies out of the ring without the spinlock, since the producer only writes to the free part of it. The ring
+ * is freed only after the notify work is released, which waits for a running notify to return.
+ */
+struct UartRxRing {
+    struct UartHost *host;
+    OsalSpinlock spin;
+    struct OsalMutex readLock;
+    uint8_t *buf;
+    uint32_t size;     // power of two
+    uint32_t head;     // taken position, free running
+    uint32_t tail;     // pushed position, free running
+    uint32_t overruns; // bytes dropped since the last notify
+    struct PlatformBhWork notify;
+    struct OsalSem released;
+};
+
+typedef int32_t (*UartRxRingCopy)(void *ctx, const uint8_t *data, uint32_t len);
+
 int32_t UartHostRequest(struct UartHost *host)
 {
     int32_t ret;
@@ -67,11 +96,256 @@ int32_t UartHostRelease(struct UartHost *host)
     return HDF_SUCCESS;
 }
 
+static void UartRxRingNotify(struct PlatformBhWork *work)
+{
+    uint32_t irqSave;
+    uint32_t avail;
+    uint32_t overruns;
+    struct HdfSBuf *data = NULL;
+    struct UartRxRing *ring = (struct UartRxRing *)work->data;
+
+    (void)OsalSpinLockIrqSave(&ring->spin, &irqSave);
+    avail = ring->tail - ring->head;
+    overruns = ring->overruns;
+    ring->overruns = 0;
+    (void)OsalSpinUnlockIrqRestore(&ring->spin, &irqSave);
+
+    if (overruns > 0) {
+        HDF_LOGW("%s: uart %u rx ring full, %u bytes dropped", __func__, ring->host->num, overruns);
+    }
+    if (avail == 0) {
+        return; // taken before the notify ran
+    }
+
+    data = HdfSbufObtainDefaultSize();
+    if (data == NULL) {
+        HDF_LOGE("%s: obtain sbuf fail", __func__);
+        return;
+    }
+    if (HdfSbufWriteUint32(data, ring->host->num) && HdfSbufWriteUint32(data, avail)) {
+        (void)HdfDeviceSendEvent(ring->host->device, PLATFORM_LISTENER_EVENT_UART_RX_NOTIFY, data);
+    }
+    HdfSbufRecycle(data);
+}
+
+static void UartRxRingReleased(struct PlatformBhWork *work)
+{
+    struct UartRxRing *ring = (struct UartRxRing *)work->data;
+
+    (void)OsalSemPost(&ring->released);
+}
+
+static void UartRxRingFree(struct UartRxRing *ring)
+{
+    (void)OsalSemDestroy(&ring->released);
+    (void)OsalMutexDestroy(&ring->readLock);
+    (void)OsalSpinDestroy(&ring->spin);
+    OsalMemFree(ring->buf);
+    OsalMemFree(ring);
+}
+
+int32_t UartHostRxRingInit(struct UartHost *host, uint32_t size)
+{
+    int32_t ret;
+    uint32_t ringSize = UART_RX_RING_SIZE_MIN;
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (host->rxRing != NULL) {
+        return HDF_SUCCESS;
+    }
+    if (size == 0 || size > UART_RX_RING_SIZE_MAX) {
+        HDF_LOGE("%s: invalid ring size:%u", __func__, size);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    while (ringSize < size) {
+        ringSize <<= 1;
+    }
+
+    ring = (struct UartRxRing *)OsalMemCalloc(sizeof(*ring));
+    if (ring == NULL) {
+        HDF_LOGE("%s: malloc ring fail", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    ring->buf = (uint8_t *)OsalMemCalloc(ringSize);
+    if (ring->buf == NULL) {
+        HDF_LOGE("%s: malloc ring buf fail", __func__);
+        OsalMemFree(ring);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    ring->host = host;
+    ring->size = ringSize;
+    (void)OsalSpinInit(&ring->spin);
+    (void)OsalMutexInit(&ring->readLock);
+    (void)OsalSemInit(&ring->released, 0);
+
+    ret = PlatformBhWorkInit(&ring->notify, UartRxRingNotify, ring, PLATFORM_BH_PRI_HIGH);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: init notify work fail:%d", __func__, ret);
+        UartRxRingFree(ring);
+        return ret;
+    }
+    ring->notify.release = UartRxRingReleased;
+    host->rxRing = ring;
+    return HDF_SUCCESS;
+}
+
+void UartHostRxRingDeinit(struct UartHost *host)
+{
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || host->rxRing == NULL) {
+        return;
+    }
+    ring = host->rxRing;
+    host->rxRing = NULL;
+    // released at once, or by the bottom half worker once a running notify returns, which still uses the host
+    PlatformBhWorkRelease(&ring->notify);
+    while (OsalSemWait(&ring->released, HDF_WAIT_FOREVER) != HDF_SUCCESS) {
+        continue;
+    }
+    UartRxRingFree(ring);
+}
+
+uint32_t UartHostRecv(struct UartHost *host, const uint8_t *data, uint32_t size)
+{
+    uint32_t irqSave;
+    uint32_t len;
+    uint32_t first;
+    uint32_t offset;
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || host->rxRing == NULL || data == NULL || size == 0) {
+        return 0;
+    }
+    ring = host->rxRing;
+
+    (void)OsalSpinLockIrqSave(&ring->spin, &irqSave);
+    len = ring->size - (ring->tail - ring->head);
+    len = (size < len) ? size : len;
+    offset = ring->tail & (ring->size - 1);
+    first = (len < ring->size - offset) ? len : (ring->size - offset);
+    if (first > 0) {
+        (void)memcpy_s(ring->buf + offset, ring->size - offset, data, first);
+    }
+    if (len > first) {
+        (void)memcpy_s(ring->buf, ring->size, data + first, len - first);
+    }
+    ring->tail += len;
+    ring->overruns += size - len;
+    (void)OsalSpinUnlockIrqRestore(&ring->spin, &irqSave);
+
+    (void)PlatformBhSchedule(&ring->notify);
+    return len;
+}
+
+/*
+ * Take up to size bytes, handing them to copy in at most two pieces, the part up to the end of the ring and
+ * the part wrapped to its start. Returns the number of bytes taken.
+ */
+static int32_t UartRxRingTake(struct UartRxRing *ring, uint32_t size, UartRxRingCopy copy, void *ctx)
+{
+    int32_t ret;
+    uint32_t irqSave;
+    uint32_t head;
+    uint32_t len;
+    uint32_t first;
+    uint32_t offset;
+
+    if (OsalMutexLock(&ring->readLock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: lock read fail", __func__);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    (void)OsalSpinLockIrqSave(&ring->spin, &irqSave);
+    head = ring->head;
+    len = ring->tail - head;
+    (void)OsalSpinUnlockIrqRestore(&ring->spin, &irqSave);
+
+    len = (size < len) ? size : len;
+    offset = head & (ring->size - 1);
+    first = (len < ring->size - offset) ? len : (ring->size - offset);
+    ret = copy(ctx, ring->buf + offset, first);
+    if (ret == HDF_SUCCESS) {
+        ret = copy(ctx, ring->buf, len - first);
+    }
+    if (ret != HDF_SUCCESS) {
+        (void)OsalMutexUnlock(&ring->readLock);
+        return ret;
+    }
+
+    (void)OsalSpinLockIrqSave(&ring->spin, &irqSave);
+    ring->head = head + len;
+    (void)OsalSpinUnlockIrqRestore(&ring->spin, &irqSave);
+    (void)OsalMutexUnlock(&ring->readLock);
+    return (int32_t)len;
+}
+
+struct UartRxRingBuf {
+    uint8_t *data;
+    uint32_t size;
+};
+
+static int32_t UartRxRingCopyToBuf(void *ctx, const uint8_t *data, uint32_t len)
+{
+    struct UartRxRingBuf *buf = (struct UartRxRingBuf *)ctx;
+
+    if (len == 0) {
+        return HDF_SUCCESS;
+    }
+    if (memcpy_s(buf->data, buf->size, data, len) != EOK) {
+        return HDF_ERR_IO;
+    }
+    buf->data += len;
+    buf->size -= len;
+    return HDF_SUCCESS;
+}
+
+int32_t UartHostReadStream(struct UartHost *host, uint8_t *data, uint32_t size)
+{
+    struct UartRxRingBuf buf = { data, size };
+
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (data == NULL || size == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (host->rxRing == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    return UartRxRingTake(host->rxRing, size, UartRxRingCopyToBuf, &buf);
+}
+
+static int32_t UartRxRingCopyToSbuf(void *ctx, const uint8_t *data, uint32_t len)
+{
+    return HdfSbufWriteBuffer((struct HdfSBuf *)ctx, (len == 0) ? NULL : data, len) ? HDF_SUCCESS : HDF_ERR_IO;
+}
+
+int32_t UartHostReadStreamToSbuf(struct UartHost *host, struct HdfSBuf *reply, uint32_t size)
+{
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (reply == NULL || size == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (host->rxRing == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    return UartRxRingTake(host->rxRing, size, UartRxRingCopyToSbuf, reply);
+}
+
 void UartHostDestroy(struct UartHost *host)
 {
     if (host == NULL) {
         return;
     }
+    UartHostRxRingDeinit(host);
     OsalMemFree(host);
 }
 
@@ -96,5 +370,6 @@ struct UartHost *UartHostCreate(struct HdfDeviceObject *device)
     OsalAtomicSet(&host->atom, 0);
     host->priv = NULL;
     host->method = NULL;
+    host->rxRing = NULL;
     return host;
 }
@@ -75,6 +75,11 @@ int32_t UartRead(DevHandle handle, uint8_t *data, uint32_t size)
     return UartHostRead((struct UartHost *)handle, data, size);
 }
 
+int32_t UartReadStream(DevHandle handle, uint8_t *data, uint32_t size)
+{
+    return UartHostReadStream((struct UartHost *)handle, data, size);
+}
+
 int32_t UartWrite(DevHandle handle, uint8_t *data, uint32_t size)
 {
     return UartHostWrite((struct UartHost *)handle, data, size);
@@ -9,11 +9,26 @@
 #include "hdf_io_service_if.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_mutex.h"
 #include "securec.h"
 #include "uart_if.h"
 
 #define HDF_LOG_TAG uart_if_u_c
 #define UART_HOST_NAME_LEN 32
+#define UART_STREAM_READ_MAX 65535
+#define UART_STREAM_REPLY_EXTRA (sizeof(uint32_t) * 4) // lengths and padding of the two pieces
+
+/*
+ * Stream reads are small and frequent, so the sbufs of them are kept with the handle and reused, the reply
+ * one growing to the largest read asked for.
+ */
+struct UartClient {
+    struct HdfIoService *service;
+    struct OsalMutex lock;
+    struct HdfSBuf *streamData;
+    struct HdfSBuf *streamReply;
+    uint32_t streamReplySize;
+};
 
 static void *UartGetObjGetByBusNum(uint32_t num)
 {
@@ -37,10 +52,24 @@ static void UartPutObjByPointer(const void *obj)
     HdfIoServiceRecycle((struct HdfIoService *)obj);
 };
 
+static void UartClientFree(struct UartClient *client)
+{
+    if (client->streamData != NULL) {
+        HdfSbufRecycle(client->streamData);
+    }
+    if (client->streamReply != NULL) {
+        HdfSbufRecycle(client->streamReply);
+    }
+    (void)OsalMutexDestroy(&client->lock);
+    UartPutObjByPointer(client->service);
+    OsalMemFree(client);
+}
+
 DevHandle UartOpen(uint32_t port)
 {
     int32_t ret;
     void *handle = NULL;
+    struct UartClient *client = NULL;
 
     handle = UartGetObjGetByBusNum(port);
     if (handle == NULL) {
@@ -54,29 +83,45 @@ DevHandle UartOpen(uint32_t port)
         UartPutObjByPointer(handle);
         return NULL;
     }
+
+    client = (struct UartClient *)OsalMemCalloc(sizeof(*client));
+    if (client == NULL) {
+        HDF_LOGE("%s: client malloc failed", __func__);
+        UartPutObjByPointer(handle);
+        return NULL;
+    }
+    if (OsalMutexInit(&client->lock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init lock failed", __func__);
+        OsalMemFree(client);
+        UartPutObjByPointer(handle);
+        return NULL;
+    }
+    client->service = service;
+
     ret = service->dispatcher->Dispatch(&service->object, UART_IO_REQUEST, NULL, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: UartHostRequest error, ret %d", __func__, ret);
-        UartPutObjByPointer(handle);
+        UartClientFree(client);
         return NULL;
     }
 
-    return (DevHandle)handle;
+    return (DevHandle)client;
 }
 
 void UartClose(DevHandle handle)
 {
     int32_t ret;
+    struct UartClient *client = (struct UartClient *)handle;
 
-    if (handle == NULL) {
+    if (client == NULL) {
         HDF_LOGE("%s: handle is NULL", __func__);
         return;
     }
 
-    struct HdfIoService *service = (struct HdfIoService *)handle;
+    struct HdfIoService *service = client->service;
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: service is invalid", __func__);
-        UartPutObjByPointer(handle);
+        UartClientFree(client);
         return;
     }
 
@@ -84,18 +129,20 @@ void UartClose(DevHandle handle)
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: UartHostRelease error, ret %d", __func__, ret);
     }
-    UartPutObjByPointer(handle);
+    UartClientFree(client);
 }
 
 static int32_t UartDispatch(DevHandle handle, int cmd, struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     int32_t ret;
-    struct HdfIoService *service = (struct HdfIoService *)handle;
+    struct UartClient *client = (struct UartClient *)handle;
+    struct HdfIoService *service = NULL;
 
-    if (service == NULL) {
+    if (client == NULL || client->service == NULL) {
         HDF_LOGE("%s: service is null", __func__);
         return HDF_ERR_INVALID_OBJECT;
     }
+    service = client->service;
 
     if (service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: dispatcher is null", __func__);
@@ -165,6 +212,94 @@ EXIT:
     return ret;
 }
 
+static int32_t UartStreamSbufPrepare(struct UartClient *client, uint32_t size)
+{
+    uint32_t replySize = size + UART_STREAM_REPLY_EXTRA;
+
+    if (client->streamData == NULL) {
+        client->streamData = HdfSbufObtainDefaultSize();
+        if (client->streamData == NULL) {
+            HDF_LOGE("%s: failed to obtain data buf", __func__);
+            return HDF_ERR_MALLOC_FAIL;
+        }
+    }
+    if (client->streamReply == NULL || client->streamReplySize < replySize) {
+        if (client->streamReply != NULL) {
+            HdfSbufRecycle(client->streamReply);
+        }
+        client->streamReplySize = 0;
+        client->streamReply = HdfSbufObtain(replySize);
+        if (client->streamReply == NULL) {
+            HDF_LOGE("%s: failed to obtain reply buf", __func__);
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        client->streamReplySize = replySize;
+    }
+    HdfSbufFlush(client->streamData);
+    HdfSbufFlush(client->streamReply);
+    return HDF_SUCCESS;
+}
+
+static int32_t UartStreamReadPieces(struct HdfSBuf *reply, uint8_t *buf, uint32_t len)
+{
+    int32_t i;
+    uint32_t got = 0;
+    uint32_t pieceLen;
+    const void *piece = NULL;
+
+    for (i = 0; i < 2; i++) { // the part up to the end of the ring and the part wrapped to its start
+        if (!HdfSbufReadBuffer(reply, &piece, &pieceLen)) {
+            HDF_LOGE("%s: sbuf read buffer failed", __func__);
+            return HDF_ERR_IO;
+        }
+        if (pieceLen == 0) {
+            continue;
+        }
+        if (pieceLen > len - got || memcpy_s(buf + got, len - got, piece, pieceLen) != EOK) {
+            HDF_LOGE("%s: copy %u bytes failed", __func__, pieceLen);
+            return HDF_ERR_IO;
+        }
+        got += pieceLen;
+    }
+    return (int32_t)got;
+}
+
+int32_t UartReadStream(DevHandle handle, uint8_t *buf, uint32_t len)
+{
+    int32_t ret;
+    struct UartClient *client = (struct UartClient *)handle;
+
+    if (client == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (buf == NULL || len == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    len = (len > UART_STREAM_READ_MAX) ? UART_STREAM_READ_MAX : len;
+
+    if (OsalMutexLock(&client->lock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: lock client failed", __func__);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    ret = UartStreamSbufPrepare(client, len);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalMutexUnlock(&client->lock);
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(client->streamData, len)) {
+        HDF_LOGE("%s: write read size failed!", __func__);
+        (void)OsalMutexUnlock(&client->lock);
+        return HDF_ERR_IO;
+    }
+
+    ret = UartDispatch(handle, UART_IO_READ_STREAM, client->streamData, client->streamReply);
+    if (ret == HDF_SUCCESS) {
+        ret = UartStreamReadPieces(client->streamReply, buf, len);
+    }
+    (void)OsalMutexUnlock(&client->lock);
+    return ret;
+}
+
 int32_t UartWrite(DevHandle handle, uint8_t *buf, uint32_t len)
 {
     int32_t ret;
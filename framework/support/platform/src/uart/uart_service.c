@@ -53,6 +53,25 @@ static int32_t UartIoRead(struct UartHost *host, struct HdfSBuf *data, struct Hd
     return HDF_SUCCESS;
 }
 
+static int32_t UartIoReadStream(struct UartHost *host, struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint32_t len;
+
+    if (!HdfSbufReadUint32(data, &len)) {
+        HDF_LOGE("%s: sbuf read data len failed", __func__);
+        return HDF_ERR_IO;
+    }
+
+    if (len == 0 || len > UART_RBUF_MALLOC_SIZE_MAX) {
+        HDF_LOGE("%s: invalid buf len:%u", __func__, len);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ret = UartHostReadStreamToSbuf(host, reply, len);
+    return (ret < 0) ? ret : HDF_SUCCESS;
+}
+
 static int32_t UartIoWrite(struct UartHost *host, struct HdfSBuf *data)
 {
     size_t size;
@@ -164,6 +183,8 @@ int32_t UartIoDispatch(struct HdfDeviceIoClient *client, int cmd, struct HdfSBuf
             return UartHostRelease(host);
         case UART_IO_READ:
             return UartIoRead(host, data, reply);
+        case UART_IO_READ_STREAM:
+            return UartIoReadStream(host, data, reply);
         case UART_IO_WRITE:
             return UartIoWrite(host, data);
         case UART_IO_GET_BAUD:
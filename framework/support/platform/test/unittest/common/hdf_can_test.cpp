@@ -160,3 +160,63 @@ HWTEST_F(HdfCanTest, HdfCanTest010_WriteMultiHandleInMultiThread, TestSize.Level
     struct HdfTestMsg msg = {TEST_PAL_CAN_TYPE, CAN_TEST_MULTI_THREAD_SEND_MULTI_HANDLE, -1};
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
+
+/**
+ * @tc.name: HdfCanTest011
+ * @tc.desc: can bus rx box overflow test
+ * @tc.type: FUNC
+ * @tc.require: NA
+ */
+HWTEST_F(HdfCanTest, HdfCanTest011_RxBoxOverflow, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_CAN_TYPE, CAN_TEST_RX_OVERFLOW, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+ * @tc.name: HdfCanTest012
+ * @tc.desc: can bus loopback throughput test
+ * @tc.type: PERF
+ * @tc.require: NA
+ */
+HWTEST_F(HdfCanTest, HdfCanTest012_LoopbackThroughput, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_CAN_TYPE, CAN_TEST_LOOPBACK_THROUGHPUT, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+ * @tc.name: HdfCanTest013
+ * @tc.desc: can bus filters of multi handles test
+ * @tc.type: FUNC
+ * @tc.require: NA
+ */
+HWTEST_F(HdfCanTest, HdfCanTest013_FilterTable, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_CAN_TYPE, CAN_TEST_FILTER_TABLE, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+ * @tc.name: HdfCanTest014
+ * @tc.desc: can bus batch send and read test
+ * @tc.type: FUNC
+ * @tc.require: NA
+ */
+HWTEST_F(HdfCanTest, HdfCanTest014_BatchSendRead, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_CAN_TYPE, CAN_TEST_BATCH_SEND_READ, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+ * @tc.name: HdfCanTest015
+ * @tc.desc: can bus batch throughput test
+ * @tc.type: PERF
+ * @tc.require: NA
+ */
+HWTEST_F(HdfCanTest, HdfCanTest015_BatchThroughput, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_CAN_TYPE, CAN_TEST_BATCH_THROUGHPUT, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "dma_test.h"
+#include "hdf_uhdf_test.h"
+
+using namespace testing::ext;
+
+class HdfDmaTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void HdfDmaTest::SetUpTestCase()
+{
+    HdfTestOpenService();
+}
+
+void HdfDmaTest::TearDownTestCase()
+{
+    HdfTestCloseService();
+}
+
+void HdfDmaTest::SetUp()
+{
+}
+
+void HdfDmaTest::TearDown()
+{
+}
+
+/**
+  * @tc.name: HdfDmaTestM2m001
+  * @tc.desc: dma memory to memory transfer test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfDmaTest, HdfDmaTestM2m001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DMA_TYPE, DMA_TEST_M2M, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfDmaTestPeriph001
+  * @tc.desc: dma peripheral transfer test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfDmaTest, HdfDmaTestPeriph001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DMA_TYPE, DMA_TEST_PERIPH, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfDmaTestSg001
+  * @tc.desc: dma scatter-gather transfer test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfDmaTest, HdfDmaTestSg001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DMA_TYPE, DMA_TEST_SG, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfDmaTestReliability001
+  * @tc.desc: dma reliability test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfDmaTest, HdfDmaTestReliability001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DMA_TYPE, DMA_TEST_RELIABILITY, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfDmaTestPerformance001
+  * @tc.desc: dma lli pool performance test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfDmaTest, HdfDmaTestPerformance001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DMA_TYPE, DMA_TEST_PERFORMANCE, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
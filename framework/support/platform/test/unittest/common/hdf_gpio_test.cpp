@@ -77,6 +77,22 @@ HWTEST_F(HdfLiteGpioTest, GpioTestWriteRead001, TestSize.Level1)
     printf("%s: exit!\n", __func__);
 }
 
+/**
+  * @tc.name: GpioTestWriteReadMulti001
+  * @tc.desc: gpio multi write and read test
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfLiteGpioTest, GpioTestWriteReadMulti001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_GPIO_TYPE, GPIO_TEST_WRITE_READ_MULTI, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    printf("%s: kernel test done, then for user...\n", __func__);
+
+    EXPECT_EQ(0, GpioTestExecute(GPIO_TEST_WRITE_READ_MULTI));
+    printf("%s: exit!\n", __func__);
+}
+
 /**
   * @tc.name: GpioTestIrqLevel001
   * @tc.desc: gpio level irq trigger test
@@ -133,3 +133,41 @@ HWTEST_F(HdfLiteI2cTest, HdfLiteI2cTestPeformance001, TestSize.Level1)
 {
     EXPECT_EQ(0, I2cTestExecute(I2C_TEST_CMD_PERFORMANCE));
 }
+
+/**
+  * @tc.name: HdfLiteI2cTestAsync001
+  * @tc.desc: i2c async transfer test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteI2cTest, HdfLiteI2cTestAsync001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_I2C_TYPE, I2C_TEST_CMD_ASYNC, -1};
+
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    EXPECT_EQ(0, I2cTestExecute(I2C_TEST_CMD_ASYNC));
+}
+
+/**
+  * @tc.name: HdfLiteI2cTestAsyncPeformance001
+  * @tc.desc: i2c async transfer performance test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteI2cTest, HdfLiteI2cTestAsyncPeformance001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_I2C_TYPE, I2C_TEST_CMD_ASYNC_PERFORMANCE, -1};
+
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfLiteI2cTestShared001
+  * @tc.desc: i2c transfer test with buffers in the shared buffer
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteI2cTest, HdfLiteI2cTestShared001, TestSize.Level1)
+{
+    EXPECT_EQ(0, I2cTestExecute(I2C_TEST_CMD_SHARED));
+}
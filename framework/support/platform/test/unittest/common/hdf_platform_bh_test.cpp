@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "hdf_uhdf_test.h"
+#include "platform_bh_test.h"
+
+using namespace testing::ext;
+
+class HdfPlatformBhTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void HdfPlatformBhTest::SetUpTestCase()
+{
+    HdfTestOpenService();
+}
+
+void HdfPlatformBhTest::TearDownTestCase()
+{
+    HdfTestCloseService();
+}
+
+void HdfPlatformBhTest::SetUp()
+{
+}
+
+void HdfPlatformBhTest::TearDown()
+{
+}
+
+/**
+  * @tc.name: HdfPlatformBhTestScheduleAndRun001
+  * @tc.desc: platform bottom half function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformBhTest, HdfPlatformBhTestScheduleAndRun001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_BH_TYPE, PLAT_BH_TEST_SCHEDULE_AND_RUN, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfPlatformBhTestCoalesce001
+  * @tc.desc: platform bottom half function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformBhTest, HdfPlatformBhTestCoalesce001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_BH_TYPE, PLAT_BH_TEST_COALESCE, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfPlatformBhTestReleaseWhileRunning001
+  * @tc.desc: platform bottom half function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformBhTest, HdfPlatformBhTestReleaseWhileRunning001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_BH_TYPE, PLAT_BH_TEST_RELEASE_WHILE_RUNNING, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfPlatformBhTestReliability001
+  * @tc.desc: platform bottom half function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformBhTest, HdfPlatformBhTestReliability001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_BH_TYPE, PLAT_BH_TEST_RELIABILITY, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
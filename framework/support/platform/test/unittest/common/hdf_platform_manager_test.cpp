@@ -80,3 +80,26 @@ HWTEST_F(HdfPlatformManagerTest, HdfPlatformManagerTestReliability001, TestSize.
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
 
+/**
+  * @tc.name: HdfPlatformManagerTestManyDevices001
+  * @tc.desc: platform manager indexed lookup test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformManagerTest, HdfPlatformManagerTestManyDevices001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_MANAGER_TYPE, PLAT_MANAGER_TEST_MANY_DEVICES, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfPlatformManagerTestConcurrentGet001
+  * @tc.desc: platform manager concurrent lookup test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformManagerTest, HdfPlatformManagerTestConcurrentGet001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_MANAGER_TYPE, PLAT_MANAGER_TEST_CONCURRENT_GET, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
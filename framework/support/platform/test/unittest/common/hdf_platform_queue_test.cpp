@@ -67,3 +67,27 @@ HWTEST_F(HdfPlatformQueueTest, HdfPlatformQueueTestReliability001, TestSize.Leve
     struct HdfTestMsg msg = {TEST_PAL_QUEUE_TYPE, PLAT_QUEUE_TEST_RELIABILITY, -1};
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
+
+/**
+  * @tc.name: HdfPlatformQueueTestBounded001
+  * @tc.desc: platform queue depth limit and get msg test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformQueueTest, HdfPlatformQueueTestBounded001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_QUEUE_TYPE, PLAT_QUEUE_TEST_BOUNDED, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfPlatformQueueTestMultiProducer001
+  * @tc.desc: platform queue multi producer stress test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformQueueTest, HdfPlatformQueueTestMultiProducer001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_QUEUE_TYPE, PLAT_QUEUE_TEST_MULTI_PRODUCER, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
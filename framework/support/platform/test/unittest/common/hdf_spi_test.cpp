@@ -127,3 +127,25 @@ HWTEST_F(HdfLiteSpiTest, SpiIfPerformanceTest001, TestSize.Level1)
 {
     EXPECT_EQ(0, SpiTestExecute(SPI_PERFORMANCE_TEST));
 }
+
+/**
+  * @tc.name: SpiSharedTransferTest001
+  * @tc.desc: Spi shared buffer transfer test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteSpiTest, SpiSharedTransferTest001, TestSize.Level1)
+{
+    EXPECT_EQ(0, SpiTestExecute(SPI_SHARED_TRANSFER_TEST));
+}
+
+/**
+  * @tc.name: SpiSharedPerformanceTest001
+  * @tc.desc: Spi transfer of 4 KB to 1 MB, with copied and shared buffers
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteSpiTest, SpiSharedPerformanceTest001, TestSize.Level1)
+{
+    EXPECT_EQ(0, SpiTestExecute(SPI_SHARED_PERFORMANCE_TEST));
+}
@@ -183,3 +183,30 @@ HWTEST_F(HdfLiteUartTest, UartIfPerformanceTest001, TestSize.Level1)
 {
     EXPECT_EQ(0, UartTestExecute(UART_TEST_CMD_PERFORMANCE));
 }
+
+/**
+  * @tc.name: UartReadStreamTest001
+  * @tc.desc: uart stream read loopback test
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfLiteUartTest, UartReadStreamTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_UART_TYPE, UART_TEST_CMD_READ_STREAM, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    printf("%s: kernel test done, then for user...\n", __func__);
+
+    EXPECT_EQ(0, UartTestExecute(UART_TEST_CMD_READ_STREAM));
+    printf("%s: exit!\n", __func__);
+}
+
+/**
+  * @tc.name: UartStreamPerformanceTest001
+  * @tc.desc: uart stream read throughput and latency test
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfLiteUartTest, UartStreamPerformanceTest001, TestSize.Level1)
+{
+    EXPECT_EQ(0, UartTestExecute(UART_TEST_CMD_STREAM_PERFORMANCE));
+}
@@ -74,6 +74,9 @@
 #if defined(LOSCFG_DRIVERS_HDF_PLATFORM_TIMER) || defined(CONFIG_DRIVERS_HDF_PLATFORM_TIMER)
 #include "hdf_timer_entry_test.h"
 #endif
+#if defined(LOSCFG_DRIVERS_HDF_PLATFORM_DMAC) || defined(CONFIG_DRIVERS_HDF_PLATFORM_DMAC)
+#include "hdf_dma_entry_test.h"
+#endif
 #endif
 #if defined(LOSCFG_DRIVERS_HDF_WIFI) || defined(CONFIG_DRIVERS_HDF_WIFI)
 #include "hdf_wifi_test.h"
@@ -96,6 +99,7 @@ HdfTestFuncList g_hdfTestFuncList[] = {
 #if defined(LOSCFG_DRIVERS_HDF_PLATFORM) || defined(CONFIG_DRIVERS_HDF_PLATFORM)
     { TEST_PAL_EVENT_TYPE, HdfPlatformEventTestEntry },
     { TEST_PAL_QUEUE_TYPE, HdfPlatformQueueTestEntry },
+    { TEST_PAL_BH_TYPE, HdfPlatformBhTestEntry },
     { TEST_PAL_DEVICE_TYPE, HdfPlatformDeviceTestEntry },
     { TEST_PAL_MANAGER_TYPE, HdfPlatformManagerTestEntry },
     { TEST_PAL_DUMPER_TYPE, HdfPlatformDumperTestEntry },
@@ -161,6 +165,9 @@ HdfTestFuncList g_hdfTestFuncList[] = {
 #if defined(LOSCFG_DRIVERS_HDF_PLATFORM_TIMER) || defined(CONFIG_DRIVERS_HDF_PLATFORM_TIMER)
         { TEST_PAL_TIMER_TYPE, HdfTimerUnitTestEntry },
 #endif
+#if defined(LOSCFG_DRIVERS_HDF_PLATFORM_DMAC) || defined(CONFIG_DRIVERS_HDF_PLATFORM_DMAC)
+    { TEST_PAL_DMA_TYPE, HdfDmaTestEntry },
+#endif
 #endif
     { TEST_CONFIG_TYPE, HdfConfigEntry },
     { TEST_OSAL_ITEM, HdfOsalEntry },
@@ -62,6 +62,7 @@ typedef enum {
     TEST_PAL_DAC_TYPE       = 24,
     TEST_PAL_TIMER_TYPE     = 25,
     TEST_PAL_CAN_TYPE       = 26,
+    TEST_PAL_BH_TYPE        = 193,
     TEST_PAL_MANAGER_TYPE   = 194,
     TEST_PAL_DEVICE_TYPE    = 195,
     TEST_PAL_QUEUE_TYPE     = 196,
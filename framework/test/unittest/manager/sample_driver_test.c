@@ -13,6 +13,7 @@
 #include "hdf_pm.h"
 #include "osal_file.h"
 #include "osal_mem.h"
+#include "osal_time.h"
 
 #define HDF_LOG_TAG sample_driver_test
 
@@ -151,6 +152,33 @@ int32_t SampleDriverSendEvent(struct HdfDeviceIoClient *client, int id, struct H
     return broadcast ? HdfDeviceSendEvent(client->device, id, data) : HdfDeviceSendEventToClient(client, id, data);
 }
 
+int32_t SampleDriverSendEventBurst(struct HdfDeviceIoClient *client, struct HdfSBuf *data)
+{
+    uint32_t count = 0;
+    OsalTimespec time;
+    struct HdfSBuf *event = NULL;
+
+    if (!HdfSbufReadUint32(data, &count) || count > SAMPLE_DRIVER_BURST_MAX) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    event = HdfSbufObtainDefaultSize();
+    if (event == NULL) {
+        return HDF_DEV_ERR_NO_MEMORY;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        HdfSbufFlush(event);
+        OsalGetTime(&time);
+        if (!HdfSbufWriteUint32(event, i) ||
+            !HdfSbufWriteUint64(event, time.sec * HDF_KILO_UNIT * HDF_KILO_UNIT + time.usec)) {
+            HdfSbufRecycle(event);
+            return HDF_FAILURE;
+        }
+        (void)HdfDeviceSendEventToClient(client, SAMPLE_DRIVER_SENDEVENT_BURST, event);
+    }
+    HdfSbufRecycle(event);
+    return HDF_SUCCESS;
+}
+
 int32_t SampleDriverPowerStateInject(uint32_t powerState)
 {
     int ret;
@@ -210,6 +238,9 @@ int32_t SampleDriverDispatch(struct HdfDeviceIoClient *client, int cmdId, struct
             ret = SampleDriverSendEvent(client, cmdId, data, true);
             HdfSbufWriteInt32(reply, INT32_MAX);
             break;
+        case SAMPLE_DRIVER_SENDEVENT_BURST:
+            ret = SampleDriverSendEventBurst(client, data);
+            break;
         case SAMPLE_DRIVER_PM_STATE_INJECT:
             HdfSbufReadUint32(data, &powerState);
             return SampleDriverPowerStateInject(powerState);
@@ -20,8 +20,12 @@ typedef enum {
     SAMPLE_DRIVER_SENDEVENT_SINGLE_DEVICE,
     SAMPLE_DRIVER_SENDEVENT_BROADCAST_DEVICE,
     SAMPLE_DRIVER_PM_STATE_INJECT,
+    SAMPLE_DRIVER_SENDEVENT_BURST,
 } SAMPLE_DRIVER_CMDID;
 
+/* payload of each SAMPLE_DRIVER_SENDEVENT_BURST event: uint32 sequence number, uint64 send time in microseconds */
+#define SAMPLE_DRIVER_BURST_MAX 4096
+
 struct HdfDeviceObject *GetDeviceObject(void);
 
 #endif // HDF_MAIN_TEST_H
@@ -30,6 +30,19 @@
 #define CAN_TEST_TIMEOUT_20 20
 #define CAN_TEST_TIMEOUT_10 10
 
+#define CAN_TEST_OVERFLOW_FRAMES 1024
+#define CAN_TEST_BENCH_FRAMES    8000
+#define CAN_TEST_BENCH_READERS   3
+#define CAN_TEST_BENCH_TIMEOUT   100
+#define CAN_TEST_BENCH_WAIT_MAX  100
+#define CAN_TEST_BITS_PER_BYTE   8
+#define CAN_TEST_BATCH_SIZE      64 // half of a receive box
+#define CAN_TEST_BATCH_ROUNDS    200
+
+#define CAN_TEST_GROUP_MASK       0x700
+#define CAN_TEST_MANY_FILTER_BASE 0x100
+#define CAN_TEST_MANY_FILTER_CNT  12 // more than the virtual controller keeps in hardware
+
 static struct HdfDeviceObject hdfDev = {
     .service = NULL,
     .property = NULL,
@@ -62,6 +75,17 @@ static struct CanFilter g_filterB = {
     .idMask = CAN_MASK_FULL,
 };
 
+static struct CanFilter g_filterGroupB = {
+    .rtr = 0,
+    .ide = 0,
+    .id = CAN_TEST_ID_B,
+    .rtrMask = 0,
+    .ideMask = 0,
+    .idMask = CAN_TEST_GROUP_MASK,
+};
+
+static struct CanFilter g_manyFilters[CAN_TEST_MANY_FILTER_CNT];
+
 static void CanMsgInitByParms(struct CanMsg *msg, uint32_t id, uint32_t ide, uint32_t rtr, uint8_t data)
 {
     msg->ide = ide;
@@ -234,7 +258,10 @@ static int32_t CanTestBlockRead(void)
 
 static int32_t CanTestAddAndDelFilter(void)
 {
-    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusAddFilter(g_handle, &g_filterA));
+    struct CanFilter filter = g_filterA;
+
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusAddFilter(g_handle, &filter));
+    filter.id = g_filterB.id; // the filter is copied in, changing it afterwards has no effect
     LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusSendMsg(g_handle, &g_msgA));
     LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusSendMsg(g_handle, &g_msgB));
     CHECK_TRUE_RETURN(CanBusCanReadMsg(g_handle, &g_msgA));
@@ -432,6 +459,277 @@ static int32_t CanTestReliability(void)
     return HDF_SUCCESS;
 }
 
+static void CanMsgSetSeq(struct CanMsg *msg, uint32_t seq)
+{
+    msg->data[0] = (uint8_t)seq;
+    msg->data[1] = (uint8_t)(seq >> CAN_TEST_BITS_PER_BYTE);
+}
+
+static uint32_t CanMsgGetSeq(const struct CanMsg *msg)
+{
+    return (uint32_t)msg->data[0] | ((uint32_t)msg->data[1] << CAN_TEST_BITS_PER_BYTE);
+}
+
+static int32_t CanTestRxOverflow(void)
+{
+    uint32_t seq;
+    uint32_t count = 0;
+    struct CanMsg msg = g_msgA;
+    struct CanMsg msgGot;
+
+    // nobody reads while sending, the receive box keeps the first frames and drops the rest
+    for (seq = 0; seq < CAN_TEST_OVERFLOW_FRAMES; seq++) {
+        CanMsgSetSeq(&msg, seq);
+        LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusSendMsg(g_handle, &msg));
+    }
+    while (CanBusReadMsg(g_handle, &msgGot, 0) == HDF_SUCCESS) {
+        LONGS_EQUAL_RETURN(count, CanMsgGetSeq(&msgGot));
+        count++;
+    }
+    HDF_LOGI("CanTestRxOverflow: sent %u, kept %u", CAN_TEST_OVERFLOW_FRAMES, count);
+    CHECK_TRUE_RETURN(count > 0 && count < CAN_TEST_OVERFLOW_FRAMES);
+
+    // space is back once the box was drained
+    CHECK_TRUE_RETURN(CanBusCanSendAndReadMsg(g_handle, &g_msgB));
+    return HDF_SUCCESS;
+}
+
+struct CanTestBenchReader {
+    DevHandle handle;
+    struct OsalThread *thread;
+    uint32_t received;
+    bool done;
+};
+
+static int CanTestBenchReaderFunc(void *param)
+{
+    struct CanMsg msg;
+    struct CanTestBenchReader *reader = (struct CanTestBenchReader *)param;
+
+    while (CanBusReadMsg(reader->handle, &msg, CAN_TEST_BENCH_TIMEOUT) == HDF_SUCCESS) {
+        reader->received++;
+    }
+    __atomic_store_n(&reader->done, true, __ATOMIC_RELEASE);
+    return HDF_SUCCESS;
+}
+
+static bool CanTestBenchWaitReaders(struct CanTestBenchReader *readers, uint32_t count)
+{
+    uint32_t i;
+    uint32_t wait;
+
+    for (wait = 0; wait < CAN_TEST_BENCH_WAIT_MAX; wait++) {
+        for (i = 0; i < count; i++) {
+            if (!__atomic_load_n(&readers[i].done, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+        }
+        if (i == count) {
+            return true;
+        }
+        OsalMSleep(CAN_TEST_TIMEOUT_20);
+    }
+    return false;
+}
+
+static void CanTestBenchStopReaders(struct CanTestBenchReader *readers, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        CanTestStopTestThread(readers[i].thread);
+        if (readers[i].handle != NULL) {
+            CanBusClose(readers[i].handle);
+        }
+    }
+}
+
+static int32_t CanTestLoopbackThroughput(void)
+{
+    uint32_t i;
+    uint32_t seq;
+    uint32_t received = 0;
+    uint64_t begin;
+    uint64_t cost;
+    bool done = false;
+    int32_t ret = HDF_SUCCESS;
+    struct CanMsg msg = g_msgA;
+    struct CanTestBenchReader readers[CAN_TEST_BENCH_READERS];
+
+    (void)memset_s(readers, sizeof(readers), 0, sizeof(readers));
+    for (i = 0; i < CAN_TEST_BENCH_READERS; i++) {
+        if (CanBusOpen(g_busNum, &readers[i].handle) != HDF_SUCCESS ||
+            (readers[i].thread = CanTestStartTestThread(CanTestBenchReaderFunc, &readers[i])) == NULL) {
+            CanTestBenchStopReaders(readers, i + 1);
+            return HDF_FAILURE;
+        }
+    }
+
+    // every frame is looped back and fanned out to each reader's receive box
+    begin = OsalGetSysTimeMs();
+    for (seq = 0; seq < CAN_TEST_BENCH_FRAMES && ret == HDF_SUCCESS; seq++) {
+        CanMsgSetSeq(&msg, seq);
+        ret = CanBusSendMsg(g_handle, &msg);
+    }
+    cost = OsalGetSysTimeMs() - begin;
+    done = CanTestBenchWaitReaders(readers, CAN_TEST_BENCH_READERS);
+    for (i = 0; i < CAN_TEST_BENCH_READERS; i++) {
+        received += readers[i].received;
+    }
+    CanTestBenchStopReaders(readers, CAN_TEST_BENCH_READERS);
+
+    HDF_LOGI("CanTestLoopbackThroughput: %u frames to %u readers in %llu ms, %llu frames/s, delivered %u of %u",
+        CAN_TEST_BENCH_FRAMES, CAN_TEST_BENCH_READERS, (unsigned long long)cost,
+        (unsigned long long)CAN_TEST_BENCH_FRAMES * 1000 / ((cost == 0) ? 1 : cost), received,
+        CAN_TEST_BENCH_FRAMES * CAN_TEST_BENCH_READERS);
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, ret);
+    CHECK_TRUE_RETURN(done);
+    CHECK_TRUE_RETURN(received > 0 && received <= CAN_TEST_BENCH_FRAMES * CAN_TEST_BENCH_READERS);
+    return HDF_SUCCESS;
+}
+
+// kept off the stack, it is small in kernel threads
+static struct CanMsg g_batchMsgs[CAN_TEST_BATCH_SIZE];
+static struct CanMsg g_batchMsgsGot[CAN_TEST_BATCH_SIZE * 2];
+
+static int32_t CanTestBatchSendRead(void)
+{
+    uint32_t i;
+    struct CanMsg *msgs = g_batchMsgs;
+    struct CanMsg *msgsGot = g_batchMsgsGot;
+
+    for (i = 0; i < CAN_TEST_BATCH_SIZE; i++) {
+        msgs[i] = g_msgA;
+        CanMsgSetSeq(&msgs[i], i);
+    }
+    LONGS_EQUAL_RETURN(CAN_TEST_BATCH_SIZE, CanBusSendMsgs(g_handle, msgs, CAN_TEST_BATCH_SIZE));
+
+    // asks for more than was sent, gets what arrived once the timeout expires
+    LONGS_EQUAL_RETURN(CAN_TEST_BATCH_SIZE,
+        CanBusReadMsgs(g_handle, msgsGot, CAN_TEST_BATCH_SIZE * 2, CAN_TEST_TIMEOUT_20));
+    for (i = 0; i < CAN_TEST_BATCH_SIZE; i++) {
+        LONGS_EQUAL_RETURN(i, CanMsgGetSeq(&msgsGot[i]));
+    }
+    CHECK_FALSE_RETURN(CanBusReadMsgs(g_handle, msgsGot, CAN_TEST_BATCH_SIZE, 0) >= 0);
+    LONGS_EQUAL_RETURN(HDF_ERR_TIMEOUT, CanBusReadMsgs(g_handle, msgsGot, CAN_TEST_BATCH_SIZE, CAN_TEST_TIMEOUT_10));
+
+    // no block read drains what is queued
+    LONGS_EQUAL_RETURN(CAN_TEST_BATCH_SIZE, CanBusSendMsgs(g_handle, msgs, CAN_TEST_BATCH_SIZE));
+    LONGS_EQUAL_RETURN(CAN_TEST_BATCH_SIZE / 2, CanBusReadMsgs(g_handle, msgsGot, CAN_TEST_BATCH_SIZE / 2, 0));
+    LONGS_EQUAL_RETURN(CAN_TEST_BATCH_SIZE / 2, CanBusReadMsgs(g_handle, msgsGot, CAN_TEST_BATCH_SIZE, 0));
+    LONGS_EQUAL_RETURN(CAN_TEST_BATCH_SIZE - 1, CanMsgGetSeq(&msgsGot[CAN_TEST_BATCH_SIZE / 2 - 1]));
+
+    LONGS_EQUAL_RETURN(HDF_ERR_INVALID_PARAM, CanBusSendMsgs(g_handle, msgs, 0));
+    LONGS_EQUAL_RETURN(HDF_ERR_INVALID_PARAM, CanBusReadMsgs(g_handle, NULL, CAN_TEST_BATCH_SIZE, 0));
+    return HDF_SUCCESS;
+}
+
+static uint32_t CanTestBatchRound(struct CanMsg *msgs, struct CanMsg *msgsGot, bool batch)
+{
+    uint32_t i;
+    int32_t ret;
+
+    if (batch) {
+        ret = CanBusSendMsgs(g_handle, msgs, CAN_TEST_BATCH_SIZE);
+        if (ret != CAN_TEST_BATCH_SIZE) {
+            return 0;
+        }
+        ret = CanBusReadMsgs(g_handle, msgsGot, CAN_TEST_BATCH_SIZE, 0);
+        return (ret > 0) ? (uint32_t)ret : 0;
+    }
+    for (i = 0; i < CAN_TEST_BATCH_SIZE; i++) {
+        if (CanBusSendMsg(g_handle, &msgs[i]) != HDF_SUCCESS) {
+            return 0;
+        }
+    }
+    for (i = 0; i < CAN_TEST_BATCH_SIZE; i++) {
+        if (CanBusReadMsg(g_handle, &msgsGot[i], 0) != HDF_SUCCESS) {
+            break;
+        }
+    }
+    return i;
+}
+
+static int32_t CanTestBatchThroughput(void)
+{
+    uint32_t i;
+    uint32_t mode;
+    uint32_t received[2] = {0}; // single frame calls, batch calls
+    uint64_t cost[2] = {0};
+    uint64_t begin;
+    struct CanMsg *msgs = g_batchMsgs;
+    struct CanMsg *msgsGot = g_batchMsgsGot;
+
+    for (i = 0; i < CAN_TEST_BATCH_SIZE; i++) {
+        msgs[i] = g_msgA;
+        CanMsgSetSeq(&msgs[i], i);
+    }
+    for (mode = 0; mode < 2; mode++) {
+        begin = OsalGetSysTimeMs();
+        for (i = 0; i < CAN_TEST_BATCH_ROUNDS; i++) {
+            received[mode] += CanTestBatchRound(msgs, msgsGot, mode == 1);
+        }
+        cost[mode] = OsalGetSysTimeMs() - begin;
+    }
+
+    HDF_LOGI("CanTestBatchThroughput: %u frames, single calls %llu ms, batches of %u %llu ms",
+        CAN_TEST_BATCH_SIZE * CAN_TEST_BATCH_ROUNDS, (unsigned long long)cost[0], CAN_TEST_BATCH_SIZE,
+        (unsigned long long)cost[1]);
+    LONGS_EQUAL_RETURN(CAN_TEST_BATCH_SIZE * CAN_TEST_BATCH_ROUNDS, received[0]);
+    LONGS_EQUAL_RETURN(CAN_TEST_BATCH_SIZE * CAN_TEST_BATCH_ROUNDS, received[1]);
+    return HDF_SUCCESS;
+}
+
+static int32_t CanTestFilterTableMultiHandle(DevHandle handle)
+{
+    uint32_t i;
+    struct CanMsg msg = g_msgA;
+
+    // exact id filter on one handle, mask filter on another
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusAddFilter(g_handle, &g_filterA));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusAddFilter(handle, &g_filterGroupB));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusSendMsg(g_handle, &g_msgA));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusSendMsg(g_handle, &g_msgB));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusSendMsg(g_handle, &g_msgC));
+    CHECK_TRUE_RETURN(CanBusCanReadMsg(g_handle, &g_msgA));
+    CHECK_TRUE_RETURN(CanBusCanNotReadMsg(g_handle, &g_msgB));
+    CHECK_TRUE_RETURN(CanBusCanReadMsg(handle, &g_msgB));
+    CHECK_TRUE_RETURN(CanBusCanNotReadMsg(handle, &g_msgC));
+
+    // too many filters for the hardware, software matching still applies them
+    for (i = 0; i < CAN_TEST_MANY_FILTER_CNT; i++) {
+        g_manyFilters[i] = g_filterA;
+        g_manyFilters[i].id = CAN_TEST_MANY_FILTER_BASE + i;
+        LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusAddFilter(g_handle, &g_manyFilters[i]));
+    }
+    msg.id = CAN_TEST_MANY_FILTER_BASE + CAN_TEST_MANY_FILTER_CNT - 1;
+    CHECK_TRUE_RETURN(CanBusCanSendAndReadMsg(g_handle, &msg));
+    CHECK_TRUE_RETURN(CanBusCanNotReadMsg(handle, &msg));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusSendMsg(g_handle, &g_msgC));
+    CHECK_TRUE_RETURN(CanBusCanNotReadMsg(g_handle, &g_msgC));
+    CHECK_TRUE_RETURN(CanBusCanNotReadMsg(handle, &g_msgC));
+
+    for (i = 0; i < CAN_TEST_MANY_FILTER_CNT; i++) {
+        LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusDelFilter(g_handle, &g_manyFilters[i]));
+    }
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusDelFilter(g_handle, &g_filterA));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusDelFilter(handle, &g_filterGroupB));
+    CHECK_TRUE_RETURN(CanBusCanSendAndReadMsg(g_handle, &g_msgC));
+    CHECK_TRUE_RETURN(CanBusCanReadMsg(handle, &g_msgC));
+    return HDF_SUCCESS;
+}
+
+static int32_t CanTestFilterTable(void)
+{
+    int32_t ret;
+    DevHandle handle = NULL;
+
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, CanBusOpen(g_busNum, &handle));
+    ret = CanTestFilterTableMultiHandle(handle);
+    CanBusClose(handle);
+    return ret;
+}
+
 struct CanTestEntry {
     int cmd;
     int32_t (*func)(void);
@@ -454,6 +752,11 @@ static struct CanTestEntry g_testEntry[] = {
     { CAN_TEST_MULTI_THREAD_SEND_MULTI_HANDLE, CanTestMultiThreadSendMultiHandle,
         "should_send_success_in_another_thread_by_another_handle" },
     { CAN_TEST_RELIABILITY, CanTestReliability, "CanTestReliability" },
+    { CAN_TEST_RX_OVERFLOW, CanTestRxOverflow, "should_keep_oldest_msgs_when_rx_box_overflows" },
+    { CAN_TEST_LOOPBACK_THROUGHPUT, CanTestLoopbackThroughput, "should_deliver_loopback_msgs_to_multi_readers" },
+    { CAN_TEST_FILTER_TABLE, CanTestFilterTable, "should_match_filters_of_multi_handles" },
+    { CAN_TEST_BATCH_SEND_READ, CanTestBatchSendRead, "should_send_and_read_msgs_in_batch" },
+    { CAN_TEST_BATCH_THROUGHPUT, CanTestBatchThroughput, "should_move_batches_faster_than_single_msgs" },
 };
 
 int32_t CanTestExecute(int cmd)
@@ -33,6 +33,11 @@ enum CanTestCmd {
     CAN_TEST_MULTI_THREAD_SEND_SAME_HANDLE,
     CAN_TEST_MULTI_THREAD_SEND_MULTI_HANDLE,
     CAN_TEST_RELIABILITY,
+    CAN_TEST_RX_OVERFLOW,
+    CAN_TEST_LOOPBACK_THROUGHPUT,
+    CAN_TEST_FILTER_TABLE,
+    CAN_TEST_BATCH_SEND_READ,
+    CAN_TEST_BATCH_THROUGHPUT,
     CAN_TEST_CMD_MAX,
 };
 
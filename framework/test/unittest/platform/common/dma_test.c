@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "dma_test.h"
+#include "dma/dmac_core.h"
+#include "osal_mem.h"
+#include "osal_sem.h"
+#include "osal_time.h"
+#include "platform_assert.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG dma_test
+
+#define DMA_TEST_BUF_SIZE    4096
+#define DMA_TEST_WAIT_MS     1000
+#define DMA_TEST_M2M_LEN     3996
+#define DMA_TEST_PERIPH_LEN  1000
+#define DMA_TEST_SG_PIECES   20      // more llis than a channel keeps in the pool
+#define DMA_TEST_SG_PIECE    200
+#define DMA_TEST_BAD_ROUNDS  8
+#define DMA_TEST_PERF_LEN    2048
+#define DMA_TEST_PERF_ROUNDS 64
+#define DMA_TEST_US_PER_SEC  1000000
+
+struct DmaTester {
+    struct DmaCntlr *cntlr;
+    struct OsalSem done;
+    int status;
+    uint8_t *src;
+    uint8_t *dest;
+    uint8_t *periph;
+};
+
+static void DmaTestCallback(void *callbackData, int status)
+{
+    struct DmaTester *tester = (struct DmaTester *)callbackData;
+
+    tester->status = status;
+    (void)OsalSemPost(&tester->done);
+}
+
+static void DmaTestMsgInit(struct DmaTester *tester, struct DmacMsg *msg, uint8_t transType)
+{
+    (void)memset_s(msg, sizeof(*msg), 0, sizeof(*msg));
+    msg->transType = transType;
+    msg->srcWidth = 1;
+    msg->destWidth = 1;
+    msg->cb = DmaTestCallback;
+    msg->para = tester;
+    if (transType == TRASFER_TYPE_M2P) {
+        msg->destAddr = (uintptr_t)tester->periph;
+    } else if (transType == TRASFER_TYPE_P2M) {
+        msg->srcAddr = (uintptr_t)tester->periph;
+    }
+}
+
+static int32_t DmaTestWaitDone(struct DmaTester *tester)
+{
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, OsalSemWait(&tester->done, DMA_TEST_WAIT_MS));
+    LONGS_EQUAL_RETURN(DMAC_CHN_SUCCESS, tester->status);
+    return HDF_SUCCESS;
+}
+
+static void DmaTestFill(uint8_t *buf, uint32_t len, uint8_t seed)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(i * 7 + seed);
+    }
+}
+
+static int32_t DmaTestM2m(struct DmaTester *tester)
+{
+    struct DmacMsg msg;
+
+    PLAT_LOGD("%s: enter", __func__);
+    DmaTestFill(tester->src, DMA_TEST_BUF_SIZE, 1);
+    DmaTestMsgInit(tester, &msg, TRASFER_TYPE_M2M);
+    msg.srcAddr = (uintptr_t)tester->src;
+    msg.destAddr = (uintptr_t)tester->dest;
+    msg.transLen = DMA_TEST_M2M_LEN;
+    // m2m transfers return when done, in blocks of maxTransSize
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, DmaCntlrTransfer(tester->cntlr, &msg));
+    CHECK_EQ_RETURN(DmaTestWaitDone(tester), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_EQ_RETURN(memcmp(tester->dest, tester->src, DMA_TEST_M2M_LEN), 0, HDF_FAILURE);
+    CHECK_EQ_RETURN(tester->dest[DMA_TEST_M2M_LEN], 0, HDF_FAILURE);
+    return HDF_SUCCESS;
+}
+
+static int32_t DmaTestPeriph(struct DmaTester *tester)
+{
+    struct DmacMsg msg;
+
+    PLAT_LOGD("%s: enter", __func__);
+    DmaTestFill(tester->src, DMA_TEST_BUF_SIZE, 2);
+    DmaTestMsgInit(tester, &msg, TRASFER_TYPE_M2P);
+    msg.srcAddr = (uintptr_t)tester->src;
+    msg.transLen = DMA_TEST_PERIPH_LEN;
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, DmaCntlrTransfer(tester->cntlr, &msg));
+    CHECK_EQ_RETURN(DmaTestWaitDone(tester), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_EQ_RETURN(memcmp(tester->periph, tester->src, DMA_TEST_PERIPH_LEN), 0, HDF_FAILURE);
+
+    DmaTestMsgInit(tester, &msg, TRASFER_TYPE_P2M);
+    msg.destAddr = (uintptr_t)tester->dest;
+    msg.transLen = DMA_TEST_PERIPH_LEN;
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, DmaCntlrTransfer(tester->cntlr, &msg));
+    CHECK_EQ_RETURN(DmaTestWaitDone(tester), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_EQ_RETURN(memcmp(tester->dest, tester->src, DMA_TEST_PERIPH_LEN), 0, HDF_FAILURE);
+    return HDF_SUCCESS;
+}
+
+static int32_t DmaTestSgGather(struct DmaTester *tester)
+{
+    uint16_t i;
+    struct DmacMsg msg;
+    struct DmacSgEntry sgl[DMA_TEST_SG_PIECES];
+
+    // every other piece of src, one after another on the peripheral, in more llis than the pool keeps
+    DmaTestFill(tester->src, DMA_TEST_BUF_SIZE, 3);
+    for (i = 0; i < DMA_TEST_SG_PIECES / 2; i++) {
+        sgl[i].addr = (uintptr_t)tester->src + (size_t)i * 2 * DMA_TEST_SG_PIECE;
+        sgl[i].len = DMA_TEST_SG_PIECE;
+    }
+    DmaTestMsgInit(tester, &msg, TRASFER_TYPE_M2P);
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, DmaCntlrTransferSg(tester->cntlr, &msg, sgl, DMA_TEST_SG_PIECES / 2));
+    CHECK_EQ_RETURN(DmaTestWaitDone(tester), HDF_SUCCESS, HDF_FAILURE);
+    for (i = 0; i < DMA_TEST_SG_PIECES / 2; i++) {
+        CHECK_EQ_RETURN(memcmp(tester->periph + (size_t)i * DMA_TEST_SG_PIECE, (void *)sgl[i].addr,
+            DMA_TEST_SG_PIECE), 0, HDF_FAILURE);
+    }
+
+    for (i = 0; i < DMA_TEST_SG_PIECES; i++) {
+        sgl[i].addr = (uintptr_t)tester->src + (size_t)i * DMA_TEST_SG_PIECE;
+        sgl[i].len = DMA_TEST_SG_PIECE;
+    }
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, DmaCntlrTransferSg(tester->cntlr, &msg, sgl, DMA_TEST_SG_PIECES));
+    CHECK_EQ_RETURN(DmaTestWaitDone(tester), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_EQ_RETURN(memcmp(tester->periph, tester->src, DMA_TEST_SG_PIECES * DMA_TEST_SG_PIECE), 0, HDF_FAILURE);
+    return HDF_SUCCESS;
+}
+
+static int32_t DmaTestSgScatter(struct DmaTester *tester)
+{
+    struct DmacMsg msg;
+    struct DmacSgEntry sgl[] = {
+        { (uintptr_t)tester->dest, DMA_TEST_SG_PIECE },
+        { 0, DMA_TEST_SG_PIECE },                                   // dropped
+        { (uintptr_t)tester->dest + DMA_TEST_PERIPH_LEN, DMA_TEST_PERIPH_LEN },
+    };
+
+    DmaTestFill(tester->periph, DMA_TEST_BUF_SIZE, 4);
+    (void)memset_s(tester->dest, DMA_TEST_BUF_SIZE, 0, DMA_TEST_BUF_SIZE);
+    DmaTestMsgInit(tester, &msg, TRASFER_TYPE_P2M);
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, DmaCntlrTransferSg(tester->cntlr, &msg, sgl, sizeof(sgl) / sizeof(sgl[0])));
+    CHECK_EQ_RETURN(DmaTestWaitDone(tester), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_EQ_RETURN(memcmp(tester->dest, tester->periph, DMA_TEST_SG_PIECE), 0, HDF_FAILURE);
+    CHECK_EQ_RETURN(tester->dest[DMA_TEST_SG_PIECE], 0, HDF_FAILURE);
+    CHECK_EQ_RETURN(memcmp(tester->dest + DMA_TEST_PERIPH_LEN, tester->periph + 2 * DMA_TEST_SG_PIECE,
+        DMA_TEST_PERIPH_LEN), 0, HDF_FAILURE);
+    return HDF_SUCCESS;
+}
+
+static int32_t DmaTestSg(struct DmaTester *tester)
+{
+    PLAT_LOGD("%s: enter", __func__);
+    CHECK_EQ_RETURN(DmaTestSgGather(tester), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_EQ_RETURN(DmaTestSgScatter(tester), HDF_SUCCESS, HDF_FAILURE);
+    return HDF_SUCCESS;
+}
+
+static int32_t DmaTestReliability(struct DmaTester *tester)
+{
+    uint32_t i;
+    struct DmacMsg msg;
+    struct DmacSgEntry sg = { (uintptr_t)tester->src, 0 };
+
+    PLAT_LOGD("%s: enter", __func__);
+    DmaTestMsgInit(tester, &msg, TRASFER_TYPE_M2P);
+    CHECK_NE_RETURN(DmaCntlrTransfer(NULL, &msg), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_NE_RETURN(DmaCntlrTransfer(tester->cntlr, NULL), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_NE_RETURN(DmaCntlrTransferSg(tester->cntlr, &msg, NULL, 1), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_NE_RETURN(DmaCntlrTransferSg(tester->cntlr, &msg, &sg, 0), HDF_SUCCESS, HDF_FAILURE);
+
+    // failed transfers give their channel back
+    for (i = 0; i < DMA_TEST_BAD_ROUNDS; i++) {
+        CHECK_NE_RETURN(DmaCntlrTransferSg(tester->cntlr, &msg, &sg, 1), HDF_SUCCESS, HDF_FAILURE);
+    }
+    sg.len = DMA_TEST_SG_PIECE;
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, DmaCntlrTransferSg(tester->cntlr, &msg, &sg, 1));
+    CHECK_EQ_RETURN(DmaTestWaitDone(tester), HDF_SUCCESS, HDF_FAILURE);
+
+    DmaTestMsgInit(tester, &msg, TRASFER_TYPE_M2M);
+    LONGS_EQUAL_RETURN(HDF_ERR_NOT_SUPPORT, DmaCntlrTransferSg(tester->cntlr, &msg, &sg, 1));
+    return HDF_SUCCESS;
+}
+
+static uint64_t DmaTestNowUs(void)
+{
+    OsalTimespec time = {0};
+
+    (void)OsalGetTime(&time);
+    return time.sec * DMA_TEST_US_PER_SEC + time.usec;
+}
+
+static int32_t DmaTestRounds(struct DmaTester *tester, struct DmaCntlr *cntlr, uint64_t *us)
+{
+    uint32_t i;
+    uint64_t start;
+    struct DmacMsg msg;
+
+    DmaTestMsgInit(tester, &msg, TRASFER_TYPE_M2P);
+    msg.srcAddr = (uintptr_t)tester->src;
+    msg.transLen = DMA_TEST_PERF_LEN;
+    start = DmaTestNowUs();
+    for (i = 0; i < DMA_TEST_PERF_ROUNDS; i++) {
+        LONGS_EQUAL_RETURN(HDF_SUCCESS, DmaCntlrTransfer(cntlr, &msg));
+        CHECK_EQ_RETURN(DmaTestWaitDone(tester), HDF_SUCCESS, HDF_FAILURE);
+    }
+    *us = DmaTestNowUs() - start;
+    return HDF_SUCCESS;
+}
+
+static int32_t DmaTestPerformance(struct DmaTester *tester)
+{
+    int32_t ret;
+    uint64_t pooledUs;
+    uint64_t allocUs;
+    struct DmaCntlr *cntlr = NULL;
+
+    PLAT_LOGD("%s: enter", __func__);
+    CHECK_EQ_RETURN(DmaTestRounds(tester, tester->cntlr, &pooledUs), HDF_SUCCESS, HDF_FAILURE);
+
+    // one lli kept for each channel, so every transfer allocates its list as before the pool
+    cntlr = VirtualDmacCreate(1);
+    CHECK_NOT_NULL_RETURN(cntlr, HDF_FAILURE);
+    ret = DmaTestRounds(tester, cntlr, &allocUs);
+    VirtualDmacDestroy(cntlr);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+
+    PLAT_LOGI("%s: %d transfers of %d bytes, pooled llis %llu us, allocated llis %llu us", __func__,
+        DMA_TEST_PERF_ROUNDS, DMA_TEST_PERF_LEN, pooledUs, allocUs);
+    return HDF_SUCCESS;
+}
+
+struct DmaTestEntry {
+    int cmd;
+    int32_t (*func)(struct DmaTester *tester);
+    const char *name;
+};
+
+static struct DmaTestEntry g_entry[] = {
+    { DMA_TEST_M2M, DmaTestM2m, "DmaTestM2m" },
+    { DMA_TEST_PERIPH, DmaTestPeriph, "DmaTestPeriph" },
+    { DMA_TEST_SG, DmaTestSg, "DmaTestSg" },
+    { DMA_TEST_RELIABILITY, DmaTestReliability, "DmaTestReliability" },
+    { DMA_TEST_PERFORMANCE, DmaTestPerformance, "DmaTestPerformance" },
+};
+
+static void DmaTesterDeinit(struct DmaTester *tester)
+{
+    VirtualDmacDestroy(tester->cntlr);
+    OsalMemFree(tester->periph);
+    OsalMemFree(tester->dest);
+    OsalMemFree(tester->src);
+    (void)OsalSemDestroy(&tester->done);
+}
+
+static int32_t DmaTesterInit(struct DmaTester *tester)
+{
+    (void)OsalSemInit(&tester->done, 0);
+    tester->src = (uint8_t *)OsalMemCalloc(DMA_TEST_BUF_SIZE);
+    tester->dest = (uint8_t *)OsalMemCalloc(DMA_TEST_BUF_SIZE);
+    tester->periph = (uint8_t *)OsalMemCalloc(DMA_TEST_BUF_SIZE);
+    tester->cntlr = VirtualDmacCreate(0);
+    if (tester->src == NULL || tester->dest == NULL || tester->periph == NULL || tester->cntlr == NULL) {
+        PLAT_LOGE("%s: init tester failed", __func__);
+        DmaTesterDeinit(tester);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t DmaTestExecute(int cmd)
+{
+    uint32_t i;
+    int32_t ret;
+    struct DmaTester tester = {0};
+    struct DmaTestEntry *entry = NULL;
+
+    for (i = 0; i < sizeof(g_entry) / sizeof(g_entry[0]); i++) {
+        if (g_entry[i].cmd != cmd || g_entry[i].func == NULL) {
+            continue;
+        }
+        entry = &g_entry[i];
+        break;
+    }
+
+    if (entry == NULL) {
+        PLAT_LOGE("%s: no entry matched, cmd = %d", __func__, cmd);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    ret = DmaTesterInit(&tester);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    ret = entry->func(&tester);
+    DmaTesterDeinit(&tester);
+
+    PLAT_LOGE("[DmaTestExecute][======cmd:%d====ret:%d======]", cmd, ret);
+    return ret;
+}
+
+void DmaTestExecuteAll(void)
+{
+    int32_t i;
+    int32_t ret;
+    int32_t fails = 0;
+
+    for (i = 0; i < DMA_TEST_CMD_MAX; i++) {
+        ret = DmaTestExecute(i);
+        fails += (ret != HDF_SUCCESS) ? 1 : 0;
+    }
+
+    PLAT_LOGE("DmaTestExecuteAll: **********PASS:%d  FAIL:%d************\n\n",
+        DMA_TEST_CMD_MAX - fails, fails);
+}
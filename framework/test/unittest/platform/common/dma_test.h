@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef DMA_TEST_H
+#define DMA_TEST_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum DmaTestCmd {
+    DMA_TEST_M2M = 0,
+    DMA_TEST_PERIPH = 1,
+    DMA_TEST_SG = 2,
+    DMA_TEST_RELIABILITY = 3,
+    DMA_TEST_PERFORMANCE = 4,
+    DMA_TEST_CMD_MAX,
+};
+
+int32_t DmaTestExecute(int cmd);
+void DmaTestExecuteAll(void);
+
+struct DmaCntlr;
+
+/* software controller of dmac_virtual.c, keeping lliPoolPerChan llis for each channel */
+struct DmaCntlr *VirtualDmacCreate(uint16_t lliPoolPerChan);
+void VirtualDmacDestroy(struct DmaCntlr *cntlr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DMA_TEST_H */
@@ -253,6 +253,62 @@ static int32_t GpioTestWriteRead(void)
     return HDF_SUCCESS;
 }
 
+static int32_t GpioTestWriteReadMultiOnce(struct GpioTester *tester, uint32_t valWrite)
+{
+    int32_t ret;
+    uint16_t valRead = GPIO_VAL_LOW;
+    uint32_t valMulti = ~valWrite;
+
+    ret = GpioWriteMulti(tester->cfg.gpio, 0x1, valWrite);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: write multi val:%u fail! ret:%d", __func__, valWrite, ret);
+        return ret;
+    }
+    ret = GpioReadMulti(tester->cfg.gpio, 0x1, &valMulti);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: read multi fail! ret:%d", __func__, ret);
+        return ret;
+    }
+    if (valMulti != valWrite) {
+        HDF_LOGE("%s: write multi:%u, but read multi:%u", __func__, valWrite, valMulti);
+        return HDF_FAILURE;
+    }
+    ret = GpioRead(tester->cfg.gpio, &valRead);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: read fail! ret:%d", __func__, ret);
+        return ret;
+    }
+    if (valRead != ((valWrite != 0) ? GPIO_VAL_HIGH : GPIO_VAL_LOW)) {
+        HDF_LOGE("%s: write multi:%u, but get:%u", __func__, valWrite, valRead);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t GpioTestWriteReadMulti(void)
+{
+    int32_t ret;
+    struct GpioTester *tester = NULL;
+
+    tester = GpioTesterGet();
+    if (tester == NULL) {
+        HDF_LOGE("%s: get tester failed", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    ret = GpioSetDir(tester->cfg.gpio, GPIO_DIR_OUT);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: set dir fail! ret:%d", __func__, ret);
+        return ret;
+    }
+    ret = GpioTestWriteReadMultiOnce(tester, 0x0);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    /* change the value and test one more time */
+    return GpioTestWriteReadMultiOnce(tester, 0x1);
+}
+
 static int32_t GpioTestIrqHandler(uint16_t gpio, void *data)
 {
     struct GpioTester *tester = (struct GpioTester *)data;
@@ -390,6 +446,10 @@ static int32_t GpioTestReliability(void)
     (void)GpioGetDir(-1, &val);            /* invalid gpio number */
     (void)GpioGetDir(tester->cfg.gpio, NULL);  /* invalid pointer */
 
+    (void)GpioWriteMulti(-1, 0x1, 0);              /* invalid gpio number */
+    (void)GpioWriteMulti(tester->cfg.gpio, 0, 0);  /* invalid mask */
+    (void)GpioReadMulti(tester->cfg.gpio, 0x1, NULL);  /* invalid pointer */
+
     /* invalid gpio number */
     (void)GpioSetIrq(-1, OSAL_IRQF_TRIGGER_RISING, GpioTestIrqHandler, (void *)tester);
     /* invalid irq handler */
@@ -445,6 +505,7 @@ static struct GpioTestEntry g_entry[] = {
     { GPIO_TEST_IRQ_THREAD, GpioTestIrqThread, "GpioTestIrqThread" },
     { GPIO_TEST_RELIABILITY, GpioTestReliability, "GpioTestReliability" },
     { GPIO_TEST_PERFORMANCE, GpioIfPerformanceTest, "GpioIfPerformanceTest" },
+    { GPIO_TEST_WRITE_READ_MULTI, GpioTestWriteReadMulti, "GpioTestWriteReadMulti" },
 };
 
 int32_t GpioTestExecute(int cmd)
@@ -25,7 +25,8 @@ enum GpioTestCmd {
     GPIO_TEST_IRQ_THREAD = 4,
     GPIO_TEST_RELIABILITY = 5,
     GPIO_TEST_PERFORMANCE = 6,
-    GPIO_TEST_MAX = 7,
+    GPIO_TEST_WRITE_READ_MULTI = 7,
+    GPIO_TEST_MAX = 8,
 };
 
 struct GpioTestConfig {
@@ -28,7 +28,10 @@ enum I2cTestCmd {
     I2C_TEST_CMD_TEARDOWN_ALL = 6,
     I2C_TEST_CMD_SETUP_SINGLE = 7,
     I2C_TEST_CMD_TEARDOWN_SINGLE = 8,
-    I2C_TEST_CMD_MAX = 9,
+    I2C_TEST_CMD_ASYNC = 9,
+    I2C_TEST_CMD_ASYNC_PERFORMANCE = 10,
+    I2C_TEST_CMD_SHARED = 11,
+    I2C_TEST_CMD_MAX = 12,
 };
 
 struct I2cTestConfig {
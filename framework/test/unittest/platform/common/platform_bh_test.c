@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "platform_bh_test.h"
+#include "osal_sem.h"
+#include "platform_assert.h"
+#include "platform_bh.h"
+
+#define HDF_LOG_TAG platform_bh_test
+
+#define PLAT_BH_TEST_TIMEOUT    1000
+#define PLAT_BH_TEST_NO_RUN     20
+#define PLAT_BH_TEST_TRIGGERS   5
+
+struct PlatformBhTester {
+    struct PlatformBhWork work;
+    struct OsalSem ran;      // posted by every run
+    struct OsalSem gate;     // a blocking run waits here
+    struct OsalSem released;
+    bool block;
+    uint32_t runs;
+    uint32_t releases;
+};
+
+static void PlatformBhTestFunc(struct PlatformBhWork *work)
+{
+    struct PlatformBhTester *tester = (struct PlatformBhTester *)work->data;
+    bool block = tester->block;
+
+    tester->runs++;
+    (void)OsalSemPost(&tester->ran);
+    if (block) {
+        (void)OsalSemWait(&tester->gate, PLAT_BH_TEST_TIMEOUT);
+    }
+}
+
+static void PlatformBhTestRelease(struct PlatformBhWork *work)
+{
+    struct PlatformBhTester *tester = (struct PlatformBhTester *)work->data;
+
+    tester->releases++;
+    (void)OsalSemPost(&tester->released);
+}
+
+static int32_t PlatformBhTestScheduleAndRun(struct PlatformBhTester *tester)
+{
+    struct PlatformBhStat stat;
+
+    PLAT_LOGD("%s: enter", __func__);
+    // should run once scheduled
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformBhSchedule(&tester->work));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, OsalSemWait(&tester->ran, PLAT_BH_TEST_TIMEOUT));
+
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformBhWorkGetStat(&tester->work, &stat));
+    LONGS_EQUAL_RETURN(1, stat.runs);
+    LONGS_EQUAL_RETURN(0, stat.coalesced);
+    PLAT_LOGD("%s: latency %u us", __func__, stat.latencyMaxUs);
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformBhTestCoalesce(struct PlatformBhTester *tester)
+{
+    uint32_t i;
+    struct PlatformBhStat stat;
+
+    PLAT_LOGD("%s: enter", __func__);
+    tester->block = true;
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformBhSchedule(&tester->work));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, OsalSemWait(&tester->ran, PLAT_BH_TEST_TIMEOUT));
+
+    // triggers while running make one more run, not one each
+    for (i = 0; i < PLAT_BH_TEST_TRIGGERS; i++) {
+        LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformBhSchedule(&tester->work));
+    }
+    tester->block = false;
+    (void)OsalSemPost(&tester->gate);
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, OsalSemWait(&tester->ran, PLAT_BH_TEST_TIMEOUT));
+    CHECK_NE_RETURN(OsalSemWait(&tester->ran, PLAT_BH_TEST_NO_RUN), HDF_SUCCESS, HDF_FAILURE);
+
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformBhWorkGetStat(&tester->work, &stat));
+    LONGS_EQUAL_RETURN(2, stat.runs);
+    LONGS_EQUAL_RETURN(PLAT_BH_TEST_TRIGGERS - 1, stat.coalesced);
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformBhTestReleaseWhileRunning(struct PlatformBhTester *tester)
+{
+    PLAT_LOGD("%s: enter", __func__);
+    tester->block = true;
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformBhSchedule(&tester->work));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, OsalSemWait(&tester->ran, PLAT_BH_TEST_TIMEOUT));
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformBhSchedule(&tester->work));
+
+    // the pending run is dropped, and the work is given back when the current run returns
+    PlatformBhWorkRelease(&tester->work);
+    LONGS_EQUAL_RETURN(0, tester->releases);
+    CHECK_NE_RETURN(PlatformBhSchedule(&tester->work), HDF_SUCCESS, HDF_FAILURE);
+    tester->block = false;
+    (void)OsalSemPost(&tester->gate);
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, OsalSemWait(&tester->released, PLAT_BH_TEST_TIMEOUT));
+    CHECK_NE_RETURN(OsalSemWait(&tester->ran, PLAT_BH_TEST_NO_RUN), HDF_SUCCESS, HDF_FAILURE);
+    LONGS_EQUAL_RETURN(1, tester->runs);
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformBhTestReliability(struct PlatformBhTester *tester)
+{
+    struct PlatformBhWork work;
+    struct PlatformBhStat stat;
+
+    PLAT_LOGD("%s: enter", __func__);
+    CHECK_NE_RETURN(PlatformBhWorkInit(NULL, PlatformBhTestFunc, tester, PLATFORM_BH_PRI_NORMAL), HDF_SUCCESS,
+        HDF_FAILURE);
+    CHECK_NE_RETURN(PlatformBhWorkInit(&work, NULL, tester, PLATFORM_BH_PRI_NORMAL), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_NE_RETURN(PlatformBhWorkInit(&work, PlatformBhTestFunc, tester, PLATFORM_BH_PRI_MAX), HDF_SUCCESS,
+        HDF_FAILURE);
+    CHECK_NE_RETURN(PlatformBhSchedule(NULL), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_NE_RETURN(PlatformBhWorkGetStat(NULL, &stat), HDF_SUCCESS, HDF_FAILURE);
+    CHECK_NE_RETURN(PlatformBhWorkGetStat(&tester->work, NULL), HDF_SUCCESS, HDF_FAILURE);
+    PlatformBhWorkRelease(NULL);
+    return HDF_SUCCESS;
+}
+
+struct PlatformBhTestEntry {
+    int cmd;
+    int32_t (*func)(struct PlatformBhTester *tester);
+    const char *name;
+};
+
+static struct PlatformBhTestEntry g_entry[] = {
+    { PLAT_BH_TEST_SCHEDULE_AND_RUN, PlatformBhTestScheduleAndRun, "PlatformBhTestScheduleAndRun" },
+    { PLAT_BH_TEST_COALESCE, PlatformBhTestCoalesce, "PlatformBhTestCoalesce" },
+    { PLAT_BH_TEST_RELEASE_WHILE_RUNNING, PlatformBhTestReleaseWhileRunning, "PlatformBhTestReleaseWhileRunning" },
+    { PLAT_BH_TEST_RELIABILITY, PlatformBhTestReliability, "PlatformBhTestReliability" },
+};
+
+static void PlatformBhTesterDeinit(struct PlatformBhTester *tester)
+{
+    if (tester->releases == 0) {
+        tester->block = false;
+        (void)OsalSemPost(&tester->gate);
+        PlatformBhWorkRelease(&tester->work);
+        (void)OsalSemWait(&tester->released, PLAT_BH_TEST_TIMEOUT);
+    }
+    (void)OsalSemDestroy(&tester->released);
+    (void)OsalSemDestroy(&tester->gate);
+    (void)OsalSemDestroy(&tester->ran);
+}
+
+int PlatformBhTestExecute(int cmd)
+{
+    uint32_t i;
+    int32_t ret;
+    struct PlatformBhTester tester = {0};
+    struct PlatformBhTestEntry *entry = NULL;
+
+    for (i = 0; i < sizeof(g_entry) / sizeof(g_entry[0]); i++) {
+        if (g_entry[i].cmd != cmd || g_entry[i].func == NULL) {
+            continue;
+        }
+        entry = &g_entry[i];
+        break;
+    }
+
+    if (entry == NULL) {
+        PLAT_LOGE("%s: no entry matched, cmd = %d", __func__, cmd);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    (void)OsalSemInit(&tester.ran, 0);
+    (void)OsalSemInit(&tester.gate, 0);
+    (void)OsalSemInit(&tester.released, 0);
+    ret = PlatformBhWorkInit(&tester.work, PlatformBhTestFunc, &tester, PLATFORM_BH_PRI_NORMAL);
+    if (ret != HDF_SUCCESS) {
+        PLAT_LOGE("%s: init work failed, ret = %d", __func__, ret);
+        (void)OsalSemDestroy(&tester.released);
+        (void)OsalSemDestroy(&tester.gate);
+        (void)OsalSemDestroy(&tester.ran);
+        return ret;
+    }
+    tester.work.release = PlatformBhTestRelease;
+
+    ret = entry->func(&tester);
+    PlatformBhTesterDeinit(&tester);
+
+    PLAT_LOGE("[PlatformBhTestExecute][======cmd:%d====ret:%d======]", cmd, ret);
+    return ret;
+}
+
+void PlatformBhTestExecuteAll(void)
+{
+    int32_t i;
+    int32_t ret;
+    int32_t fails = 0;
+
+    for (i = 0; i < PLAT_BH_TEST_CMD_MAX; i++) {
+        ret = PlatformBhTestExecute(i);
+        fails += (ret != HDF_SUCCESS) ? 1 : 0;
+    }
+
+    PLAT_LOGE("PlatformBhTestExecuteAll: **********PASS:%d  FAIL:%d************\n\n",
+        PLAT_BH_TEST_CMD_MAX - fails, fails);
+}
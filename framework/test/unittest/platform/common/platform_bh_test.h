@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef PLATFORM_BH_TEST_H
+#define PLATFORM_BH_TEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum PlatformBhTestCmd {
+    PLAT_BH_TEST_SCHEDULE_AND_RUN = 0,
+    PLAT_BH_TEST_COALESCE = 1,
+    PLAT_BH_TEST_RELEASE_WHILE_RUNNING = 2,
+    PLAT_BH_TEST_RELIABILITY = 3,
+    PLAT_BH_TEST_CMD_MAX,
+};
+
+int PlatformBhTestExecute(int cmd);
+void PlatformBhTestExecuteAll(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PLATFORM_BH_TEST_H */
@@ -10,6 +10,7 @@
 #include "device_resource_if.h"
 #include "hdf_base.h"
 #include "hdf_device_desc.h"
+#include "platform_bh_test.h"
 #include "platform_device_test.h"
 #include "platform_event_test.h"
 #include "platform_log.h"
@@ -21,6 +22,7 @@ static void DoAllPlatformTest(void)
 #ifdef PLATFORM_TEST_ON_INIT
     PlatformEventTestExecuteAll();
     PlatformQueueTestExecuteAll();
+    PlatformBhTestExecuteAll();
     PlatformManagerTestExecuteAll();
     PlatformDeviceTestExecuteAll();
 #ifdef LOSCFG_DRIVERS_HDF_PLATFORM_I2C
@@ -8,7 +8,10 @@
 
 #include "platform_manager_test.h"
 #include "osal_mem.h"
+#include "osal_thread.h"
+#include "osal_time.h"
 #include "platform_assert.h"
+#include "platform_errno.h"
 #include "platform_manager.h"
 
 #define HDF_LOG_TAG platform_manager_test
@@ -18,6 +21,13 @@
 #define PLAT_DEV_NUMBER_0               0
 #define PLAT_DEV_NUMBER_1               1
 #define PLAT_DEV_NUMBER_2               2
+#define PLAT_MGR_TEST_MANY_NUM          256
+#define PLAT_MGR_TEST_MANY_NUM_START    0x100
+#define PLAT_MGR_TEST_READERS           2
+#define PLAT_MGR_TEST_ROUNDS            4
+#define PLAT_MGR_TEST_STACK_SIZE        (1024 * 16)
+#define PLAT_MGR_TEST_WAIT_MS           10000
+#define PLAT_MGR_TEST_US_PER_SEC        1000000
 
 static struct PlatformDevice *g_platDevices[PLAT_MGR_TEST_DEV_NUM];
 
@@ -219,6 +229,211 @@ static int32_t PlatformManagerTestReliability(struct PlatformManager *manager)
     return HDF_SUCCESS;
 }
 
+static struct PlatformDevice *PlatformManagerTestCreateMany(void)
+{
+    int32_t i;
+    struct PlatformDevice *devices = NULL;
+
+    devices = (struct PlatformDevice *)OsalMemCalloc(sizeof(*devices) * PLAT_MGR_TEST_MANY_NUM);
+    if (devices == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < PLAT_MGR_TEST_MANY_NUM; i++) {
+        devices[i].number = PLAT_MGR_TEST_MANY_NUM_START + i;
+        if (PlatformDeviceInit(&devices[i]) != HDF_SUCCESS) {
+            break;
+        }
+        if (PlatformDeviceSetName(&devices[i], "platform_many_device%d", i) != HDF_SUCCESS) {
+            PlatformDeviceUninit(&devices[i]);
+            break;
+        }
+    }
+    if (i == PLAT_MGR_TEST_MANY_NUM) {
+        return devices;
+    }
+    while (i-- > 0) {
+        PlatformDeviceClearName(&devices[i]);
+        PlatformDeviceUninit(&devices[i]);
+    }
+    OsalMemFree(devices);
+    return NULL;
+}
+
+static void PlatformManagerTestDestroyMany(struct PlatformManager *manager, struct PlatformDevice *devices,
+    int32_t ret)
+{
+    int32_t i;
+
+    for (i = 0; i < PLAT_MGR_TEST_MANY_NUM; i++) {
+        if (ret != HDF_SUCCESS) {
+            (void)PlatformManagerDelDevice(manager, &devices[i]); // what a failed run left behind
+        }
+        PlatformDeviceClearName(&devices[i]);
+        PlatformDeviceUninit(&devices[i]);
+    }
+    OsalMemFree(devices);
+}
+
+static uint64_t PlatformManagerTestNowUs(void)
+{
+    OsalTimespec time = {0};
+
+    (void)OsalGetTime(&time);
+    return time.sec * PLAT_MGR_TEST_US_PER_SEC + time.usec;
+}
+
+static int32_t PlatformManagerTestCheckMany(struct PlatformManager *manager, struct PlatformDevice *devices,
+    int32_t step)
+{
+    int32_t i;
+    struct PlatformDevice *device = NULL;
+
+    for (i = 0; i < PLAT_MGR_TEST_MANY_NUM; i++) {
+        device = PlatformManagerGetDeviceByNumber(manager, devices[i].number);
+        // only every step-th device is expected in the manager
+        CHECK_EQ_RETURN(device, ((i % step) == 0) ? &devices[i] : NULL, HDF_FAILURE);
+        PlatformDevicePut(device);
+        device = PlatformManagerGetDeviceByName(manager, devices[i].name);
+        CHECK_EQ_RETURN(device, ((i % step) == 0) ? &devices[i] : NULL, HDF_FAILURE);
+        PlatformDevicePut(device);
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformManagerTestManyRun(struct PlatformManager *manager, struct PlatformDevice *devices)
+{
+    int32_t i;
+    uint64_t us;
+
+    for (i = 0; i < PLAT_MGR_TEST_MANY_NUM; i++) {
+        LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformManagerAddDevice(manager, &devices[i]));
+    }
+    // repeated numbers and the same device are still refused with the index
+    LONGS_EQUAL_RETURN(HDF_PLT_ERR_OBJ_REPEAT, PlatformManagerAddDevice(manager, &devices[0]));
+
+    us = PlatformManagerTestNowUs();
+    CHECK_EQ_RETURN(PlatformManagerTestCheckMany(manager, devices, 1), HDF_SUCCESS, HDF_FAILURE);
+    us = PlatformManagerTestNowUs() - us;
+    PLAT_LOGI("%s: %d lookups by number and by name among %d devices in %llu us", __func__,
+        PLAT_MGR_TEST_MANY_NUM, PLAT_MGR_TEST_MANY_NUM, us);
+
+    for (i = 1; i < PLAT_MGR_TEST_MANY_NUM; i += 2) { // 2: remove the odd ones
+        LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformManagerDelDevice(manager, &devices[i]));
+    }
+    LONGS_EQUAL_RETURN(HDF_PLT_ERR_NO_DEV, PlatformManagerDelDevice(manager, &devices[1]));
+    CHECK_EQ_RETURN(PlatformManagerTestCheckMany(manager, devices, 2), HDF_SUCCESS, HDF_FAILURE); // 2: evens left
+
+    for (i = 0; i < PLAT_MGR_TEST_MANY_NUM; i += 2) { // 2: remove the even ones
+        LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformManagerDelDevice(manager, &devices[i]));
+    }
+    CHECK_EQ_RETURN(PlatformManagerGetDeviceByNumber(manager, devices[0].number), NULL, HDF_FAILURE);
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformManagerTestManyDevices(struct PlatformManager *manager)
+{
+    int32_t ret;
+    struct PlatformDevice *devices = NULL;
+
+    PLAT_LOGD("%s: enter", __func__);
+    devices = PlatformManagerTestCreateMany();
+    CHECK_NOT_NULL_RETURN(devices, HDF_ERR_MALLOC_FAIL);
+    ret = PlatformManagerTestManyRun(manager, devices);
+    PlatformManagerTestDestroyMany(manager, devices, ret);
+    PLAT_LOGD("%s: exit", __func__);
+    return ret;
+}
+
+struct PlatformManagerTestReader {
+    struct PlatformManager *manager;
+    struct PlatformDevice *device;
+    struct OsalThread thread;
+    struct OsalSem done;
+    bool stop;
+    uint32_t lookups;
+    uint32_t errors;
+};
+
+static int PlatformManagerTestReaderFunc(void *data)
+{
+    struct PlatformManagerTestReader *reader = (struct PlatformManagerTestReader *)data;
+    struct PlatformDevice *device = NULL;
+
+    while (!__atomic_load_n(&reader->stop, __ATOMIC_ACQUIRE)) {
+        device = PlatformManagerGetDeviceByNumber(reader->manager, reader->device->number);
+        reader->errors += (device == reader->device) ? 0 : 1;
+        PlatformDevicePut(device);
+        device = PlatformManagerGetDeviceByName(reader->manager, reader->device->name);
+        reader->errors += (device == reader->device) ? 0 : 1;
+        PlatformDevicePut(device);
+        reader->lookups++;
+    }
+    (void)OsalSemPost(&reader->done);
+    return HDF_SUCCESS;
+}
+
+static void PlatformManagerTestStartReaders(struct PlatformManagerTestReader *readers, int32_t count)
+{
+    int32_t i;
+    struct OsalThreadParam cfg;
+
+    cfg.name = (char *)"platform_manager_test_reader";
+    cfg.priority = OSAL_THREAD_PRI_DEFAULT;
+    cfg.stackSize = PLAT_MGR_TEST_STACK_SIZE;
+    for (i = 0; i < count; i++) {
+        (void)OsalSemInit(&readers[i].done, 0);
+        if (OsalThreadCreate(&readers[i].thread, (OsalThreadEntry)PlatformManagerTestReaderFunc,
+            &readers[i]) != HDF_SUCCESS || OsalThreadStart(&readers[i].thread, &cfg) != HDF_SUCCESS) {
+            readers[i].errors++;
+            (void)OsalSemPost(&readers[i].done); // nothing to wait for
+        }
+    }
+}
+
+static int32_t PlatformManagerTestConcurrentGet(struct PlatformManager *manager)
+{
+    int32_t i;
+    int32_t round;
+    int32_t ret = HDF_SUCCESS;
+    uint32_t lookups = 0;
+    struct PlatformDevice *devices = NULL;
+    struct PlatformManagerTestReader readers[PLAT_MGR_TEST_READERS] = {0};
+
+    PLAT_LOGD("%s: enter", __func__);
+    g_platDevices[0]->name = "platform_device0";
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformManagerAddDevice(manager, g_platDevices[0]));
+    devices = PlatformManagerTestCreateMany();
+    CHECK_NOT_NULL_RETURN(devices, HDF_ERR_MALLOC_FAIL);
+
+    // the device looked up must be found all along while others come and go and the index grows
+    for (i = 0; i < PLAT_MGR_TEST_READERS; i++) {
+        readers[i].manager = manager;
+        readers[i].device = g_platDevices[0];
+    }
+    PlatformManagerTestStartReaders(readers, PLAT_MGR_TEST_READERS);
+    for (round = 0; round < PLAT_MGR_TEST_ROUNDS && ret == HDF_SUCCESS; round++) {
+        for (i = 0; i < PLAT_MGR_TEST_MANY_NUM && ret == HDF_SUCCESS; i++) {
+            ret = PlatformManagerAddDevice(manager, &devices[i]);
+        }
+        for (i = 0; i < PLAT_MGR_TEST_MANY_NUM && ret == HDF_SUCCESS; i++) {
+            ret = PlatformManagerDelDevice(manager, &devices[i]);
+        }
+    }
+    for (i = 0; i < PLAT_MGR_TEST_READERS; i++) {
+        __atomic_store_n(&readers[i].stop, true, __ATOMIC_RELEASE);
+        (void)OsalSemWait(&readers[i].done, PLAT_MGR_TEST_WAIT_MS);
+        (void)OsalThreadDestroy(&readers[i].thread);
+        (void)OsalSemDestroy(&readers[i].done);
+        ret = (readers[i].errors != 0) ? HDF_FAILURE : ret;
+        lookups += readers[i].lookups;
+    }
+    PlatformManagerTestDestroyMany(manager, devices, ret);
+
+    PLAT_LOGI("%s: %u lookups by %d readers, ret:%d", __func__, lookups, PLAT_MGR_TEST_READERS, ret);
+    PLAT_LOGD("%s: exit", __func__);
+    return ret;
+}
+
 struct PlatformManagerTestEntry {
     int cmd;
     int32_t (*func)(struct PlatformManager *manager);
@@ -229,6 +444,8 @@ static struct PlatformManagerTestEntry g_entry[] = {
     { PLAT_MANAGER_TEST_ADD_DEVICE, PlatformManagerTestAddAndDel, "PlatformManagerTestAddAndDel" },
     { PLAT_MANAGER_TEST_GET_DEVICE, PlatformManagerTestGetDevice, "PlatformManagerTestGetDevice" },
     { PLAT_MANAGER_TEST_RELIABILITY, PlatformManagerTestReliability, "PlatformManagerTestReliability" },
+    { PLAT_MANAGER_TEST_MANY_DEVICES, PlatformManagerTestManyDevices, "PlatformManagerTestManyDevices" },
+    { PLAT_MANAGER_TEST_CONCURRENT_GET, PlatformManagerTestConcurrentGet, "PlatformManagerTestConcurrentGet" },
 };
 
 int PlatformManagerTestExecute(int cmd)
@@ -17,6 +17,8 @@ enum PlatformManagerTestCmd {
     PLAT_MANAGER_TEST_ADD_DEVICE = 0,
     PLAT_MANAGER_TEST_GET_DEVICE  = 1,
     PLAT_MANAGER_TEST_RELIABILITY = 2,
+    PLAT_MANAGER_TEST_MANY_DEVICES = 3,
+    PLAT_MANAGER_TEST_CONCURRENT_GET = 4,
     PLAT_MANAGER_TEST_CMD_MAX,
 };
 
@@ -7,7 +7,11 @@
  */
 
 #include "platform_queue_test.h"
+#include "osal_mem.h"
+#include "osal_thread.h"
+#include "osal_time.h"
 #include "platform_assert.h"
+#include "platform_errno.h"
 #include "platform_queue.h"
 
 #define HDF_LOG_TAG platform_queue_test
@@ -16,6 +20,14 @@
 
 #define TEST_CODE_A 0x5A
 
+#define PLAT_QUEUE_TEST_DEPTH          4
+#define PLAT_QUEUE_TEST_PRODUCERS      4
+#define PLAT_QUEUE_TEST_MSGS_PER_PROD  2000
+#define PLAT_QUEUE_TEST_STRESS_DEPTH   16
+#define PLAT_QUEUE_TEST_STACK_SIZE     (1024 * 16)
+#define PLAT_QUEUE_TEST_WAIT_MS        10000
+#define PLAT_QUEUE_TEST_US_PER_SEC     1000000
+
 struct PlatformQueueTestMsg {
     struct PlatformMsg msg;
     struct OsalSem sem;
@@ -47,8 +59,9 @@ static int32_t PlatformQueueTestHandle(struct PlatformQueue *queue, struct Platf
         return HDF_ERR_INVALID_PARAM;
     }
 
-    (void)OsalSemPost(&tmsg->sem);
+    // the waiter may return as soon as the sem is posted
     tmsg->status = HDF_SUCCESS;
+    (void)OsalSemPost(&tmsg->sem);
     return HDF_SUCCESS;
 }
 
@@ -102,6 +115,196 @@ static int32_t PlatformQueueTestReliability(struct PlatformQueue *pq)
     return HDF_SUCCESS;
 }
 
+static int32_t PlatformQueueTestBounded(struct PlatformQueue *pq)
+{
+    int32_t i;
+    int32_t ret;
+    struct PlatformMsg msgs[PLAT_QUEUE_TEST_DEPTH + 1];
+    struct PlatformMsg *msg = NULL;
+    struct PlatformQueue *queue = NULL;
+
+    PLAT_LOGD("%s: enter", __func__);
+    // the started queue belongs to its worker
+    LONGS_EQUAL_RETURN(HDF_ERR_DEVICE_BUSY, PlatformQueueGetMsg(pq, &msg, 0));
+
+    queue = PlatformQueueCreate(NULL, "platform_queue_test_bounded", NULL);
+    CHECK_NOT_NULL_RETURN(queue, HDF_FAILURE);
+    ret = PlatformQueueSetDepthMax(queue, PLAT_QUEUE_TEST_DEPTH);
+    for (i = 0; ret == HDF_SUCCESS && i < PLAT_QUEUE_TEST_DEPTH; i++) {
+        msgs[i].code = i;
+        ret = PlatformQueueAddMsg(queue, &msgs[i]);
+    }
+    if (!CHECK_EQ(ret, HDF_SUCCESS) ||
+        !CHECK_EQ(PlatformQueueAddMsg(queue, &msgs[PLAT_QUEUE_TEST_DEPTH]), HDF_PLT_OUT_OF_RSC)) {
+        PlatformQueueDestroy(queue);
+        return HDF_FAILURE;
+    }
+
+    // messages come out in the order they were added, and free their room on the way
+    for (i = 0; i < PLAT_QUEUE_TEST_DEPTH; i++) {
+        ret = PlatformQueueGetMsg(queue, &msg, 0);
+        if (!CHECK_EQ(ret, HDF_SUCCESS) || !CHECK_EQ(msg, &msgs[i])) {
+            PlatformQueueDestroy(queue);
+            return HDF_FAILURE;
+        }
+    }
+    ret = PlatformQueueGetMsg(queue, &msg, 1);
+    if (!CHECK_NE(ret, HDF_SUCCESS) || !CHECK_EQ(PlatformQueueAddMsg(queue, &msgs[0]), HDF_SUCCESS)) {
+        PlatformQueueDestroy(queue);
+        return HDF_FAILURE;
+    }
+    ret = PlatformQueueGetMsg(queue, &msg, PLAT_QUEUE_TEST_TIMEOUT);
+    PlatformQueueDestroy(queue);
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, ret);
+    CHECK_EQ_RETURN(msg, &msgs[0], HDF_FAILURE);
+
+    PLAT_LOGD("%s: exit", __func__);
+    return HDF_SUCCESS;
+}
+
+struct PlatformQueueTestProducer {
+    struct PlatformQueueStress *stress;
+    struct OsalThread thread;
+    struct OsalSem done;
+    uint32_t id;
+    uint32_t retries;
+    struct PlatformMsg msgs[PLAT_QUEUE_TEST_MSGS_PER_PROD];
+};
+
+struct PlatformQueueStress {
+    struct PlatformQueue *queue;
+    struct OsalSem handled;
+    uint32_t count;
+    uint32_t errors;
+    int32_t next[PLAT_QUEUE_TEST_PRODUCERS];
+    struct PlatformQueueTestProducer producers[PLAT_QUEUE_TEST_PRODUCERS];
+};
+
+static int32_t PlatformQueueStressHandle(struct PlatformQueue *queue, struct PlatformMsg *msg)
+{
+    struct PlatformQueueStress *stress = (struct PlatformQueueStress *)queue->data;
+    uint32_t id = (uint32_t)(uintptr_t)msg->data;
+
+    // the messages of one producer must keep their order
+    if (id >= PLAT_QUEUE_TEST_PRODUCERS || msg->code != stress->next[id]) {
+        stress->errors++;
+    } else {
+        stress->next[id]++;
+    }
+    if (++stress->count == PLAT_QUEUE_TEST_PRODUCERS * PLAT_QUEUE_TEST_MSGS_PER_PROD) {
+        (void)OsalSemPost(&stress->handled);
+    }
+    return HDF_SUCCESS;
+}
+
+static int PlatformQueueTestProduce(void *data)
+{
+    int32_t i;
+    struct PlatformQueueTestProducer *producer = (struct PlatformQueueTestProducer *)data;
+
+    for (i = 0; i < PLAT_QUEUE_TEST_MSGS_PER_PROD; i++) {
+        producer->msgs[i].code = i;
+        producer->msgs[i].data = (void *)(uintptr_t)producer->id;
+        while (PlatformQueueAddMsg(producer->stress->queue, &producer->msgs[i]) == HDF_PLT_OUT_OF_RSC) {
+            producer->retries++;
+            OsalMSleep(1);
+        }
+    }
+    (void)OsalSemPost(&producer->done);
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformQueueStressStart(struct PlatformQueueStress *stress)
+{
+    uint32_t i;
+    int32_t ret = HDF_SUCCESS;
+    struct OsalThreadParam cfg;
+    struct PlatformQueueTestProducer *producer = NULL;
+
+    cfg.name = (char *)"platform_queue_test_producer";
+    cfg.priority = OSAL_THREAD_PRI_DEFAULT;
+    cfg.stackSize = PLAT_QUEUE_TEST_STACK_SIZE;
+    for (i = 0; i < PLAT_QUEUE_TEST_PRODUCERS; i++) {
+        producer = &stress->producers[i];
+        producer->stress = stress;
+        producer->id = i;
+        (void)OsalSemInit(&producer->done, 0);
+        ret = OsalThreadCreate(&producer->thread, (OsalThreadEntry)PlatformQueueTestProduce, producer);
+        if (ret == HDF_SUCCESS) {
+            ret = OsalThreadStart(&producer->thread, &cfg);
+        }
+        if (ret != HDF_SUCCESS) {
+            PLAT_LOGE("%s: start producer %u failed, ret = %d", __func__, i, ret);
+            (void)OsalSemPost(&producer->done); // nothing to wait for
+        }
+    }
+    return ret;
+}
+
+static int32_t PlatformQueueStressRun(uint32_t depthMax, uint64_t *us, uint32_t *retries)
+{
+    uint32_t i;
+    int32_t ret;
+    OsalTimespec start = {0};
+    OsalTimespec end = {0};
+    struct PlatformQueueStress *stress = NULL;
+
+    stress = (struct PlatformQueueStress *)OsalMemCalloc(sizeof(*stress));
+    CHECK_NOT_NULL_RETURN(stress, HDF_ERR_MALLOC_FAIL);
+    (void)OsalSemInit(&stress->handled, 0);
+    stress->queue = PlatformQueueCreate(PlatformQueueStressHandle, "platform_queue_test_stress", stress);
+    if (stress->queue == NULL || PlatformQueueSetDepthMax(stress->queue, depthMax) != HDF_SUCCESS ||
+        PlatformQueueStart(stress->queue) != HDF_SUCCESS) {
+        PlatformQueueDestroy(stress->queue);
+        (void)OsalSemDestroy(&stress->handled);
+        OsalMemFree(stress);
+        return HDF_FAILURE;
+    }
+
+    (void)OsalGetTime(&start);
+    ret = PlatformQueueStressStart(stress);
+    if (ret == HDF_SUCCESS) {
+        ret = OsalSemWait(&stress->handled, PLAT_QUEUE_TEST_WAIT_MS);
+    }
+    (void)OsalGetTime(&end);
+    *retries = 0;
+    for (i = 0; i < PLAT_QUEUE_TEST_PRODUCERS; i++) {
+        (void)OsalSemWait(&stress->producers[i].done, PLAT_QUEUE_TEST_WAIT_MS);
+        (void)OsalThreadDestroy(&stress->producers[i].thread);
+        (void)OsalSemDestroy(&stress->producers[i].done);
+        *retries += stress->producers[i].retries;
+    }
+    PlatformQueueDestroy(stress->queue);
+    if (ret == HDF_SUCCESS && stress->errors != 0) {
+        PLAT_LOGE("%s: %u messages out of order", __func__, stress->errors);
+        ret = HDF_FAILURE;
+    }
+    (void)OsalSemDestroy(&stress->handled);
+    OsalMemFree(stress);
+
+    *us = (end.sec - start.sec) * PLAT_QUEUE_TEST_US_PER_SEC + end.usec - start.usec;
+    return ret;
+}
+
+static int32_t PlatformQueueTestMultiProducer(struct PlatformQueue *pq)
+{
+    uint64_t unboundedUs;
+    uint64_t boundedUs;
+    uint32_t retries;
+    (void)pq;
+
+    PLAT_LOGD("%s: enter", __func__);
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformQueueStressRun(PLAT_QUEUE_DEPTH_UNBOUNDED, &unboundedUs, &retries));
+    LONGS_EQUAL_RETURN(0, retries);
+    LONGS_EQUAL_RETURN(HDF_SUCCESS, PlatformQueueStressRun(PLAT_QUEUE_TEST_STRESS_DEPTH, &boundedUs, &retries));
+
+    PLAT_LOGI("%s: %d producers x %d msgs, unbounded %llu us, depth %d %llu us with %u full retries", __func__,
+        PLAT_QUEUE_TEST_PRODUCERS, PLAT_QUEUE_TEST_MSGS_PER_PROD, unboundedUs, PLAT_QUEUE_TEST_STRESS_DEPTH,
+        boundedUs, retries);
+    PLAT_LOGD("%s: exit", __func__);
+    return HDF_SUCCESS;
+}
+
 struct PlatformQueueTestEntry {
     int cmd;
     int32_t (*func)(struct PlatformQueue *pq);
@@ -111,6 +314,8 @@ struct PlatformQueueTestEntry {
 static struct PlatformQueueTestEntry g_entry[] = {
     { PLAT_QUEUE_TEST_ADD_AND_WAIT, PlatformQueueTestAddAndWait, "PlatformQueueTestAddAndWait" },
     { PLAT_QUEUE_TEST_RELIABILITY, PlatformQueueTestReliability, "PlatformQueueTestReliability" },
+    { PLAT_QUEUE_TEST_BOUNDED, PlatformQueueTestBounded, "PlatformQueueTestBounded" },
+    { PLAT_QUEUE_TEST_MULTI_PRODUCER, PlatformQueueTestMultiProducer, "PlatformQueueTestMultiProducer" },
 };
 
 int PlatformQueueTestExecute(int cmd)
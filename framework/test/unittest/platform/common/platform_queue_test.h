@@ -17,6 +17,8 @@ enum PlatformQueueTestCmd {
     PLAT_QUEUE_TEST_ADD_AND_WAIT = 0,
     PLAT_QUEUE_TEST_SUSPEND_AND_RESUME = 1,
     PLAT_QUEUE_TEST_RELIABILITY = 2,
+    PLAT_QUEUE_TEST_BOUNDED = 3,
+    PLAT_QUEUE_TEST_MULTI_PRODUCER = 4,
     PLAT_QUEUE_TEST_CMD_MAX,
 };
 
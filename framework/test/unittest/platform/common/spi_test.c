@@ -500,6 +500,129 @@ static int32_t SpiIfPerformanceTest(struct SpiTester *tester)
     return HDF_FAILURE;
 }
 
+#define SPI_SHARED_LEN_MIN       (4 * 1024)
+#define SPI_SHARED_LEN_MAX       (1024 * 1024)
+#define SPI_SHARED_LEN_STEP      4
+#define SPI_SHARED_ROUNDS        4
+#define SPI_SHARED_US_PER_SEC    1000000
+
+static void SpiSharedFillMsg(struct SpiMsg *msg, uint8_t *wbuf, uint8_t *rbuf, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        wbuf[i] = (uint8_t)(DMA_TRANSFER_BUF_SEED + i);
+    }
+    (void)memset_s(rbuf, len, 0, len);
+    msg->wbuf = wbuf;
+    msg->rbuf = rbuf;
+    msg->len = len;
+    msg->keepCs = 0; // switch off the CS after transfer
+    msg->delayUs = 0;
+    msg->speed = 0;  // use default speed
+}
+
+static int32_t SpiSharedTransferTest(struct SpiTester *tester)
+{
+    int32_t ret;
+    uint8_t *shared = NULL;
+    uint32_t len = tester->config.len;
+    struct SpiMsg msg;
+
+    shared = (uint8_t *)SpiMapSharedBuffer(tester->handle, len * 2); // 2: the write and the read half
+    if (shared == NULL) {
+        HDF_LOGI("%s: shared buffer not supported, skip", __func__);
+        return HDF_SUCCESS;
+    }
+    g_spiCfg.bitsPerWord = BITS_PER_WORD_8BITS;
+    g_spiCfg.transferMode = SPI_POLLING_TRANSFER;
+
+    // both buffers shared
+    SpiSharedFillMsg(&msg, shared, shared + len, len);
+    ret = SpiDoTransferTest(tester, &g_spiCfg, &msg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: shared transfer fail, ret = %d", __func__, ret);
+        return ret;
+    }
+
+    // a buffer out of the shared one is copied as before
+    SpiSharedFillMsg(&msg, shared, tester->config.rbuf, len);
+    ret = SpiDoTransferTest(tester, &g_spiCfg, &msg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: mixed transfer fail, ret = %d", __func__, ret);
+        return ret;
+    }
+
+    // the same mapping is returned while it is large enough
+    if (SpiMapSharedBuffer(tester->handle, len) != shared) {
+        HDF_LOGE("%s: map again fail", __func__);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+static uint64_t SpiSharedTransferUs(struct SpiTester *tester, struct SpiMsg *msg)
+{
+    uint32_t i;
+    OsalTimespec start = {0};
+    OsalTimespec end = {0};
+    OsalTimespec diff = {0};
+
+    (void)OsalGetTime(&start);
+    for (i = 0; i < SPI_SHARED_ROUNDS; i++) {
+        if (SpiTransfer(tester->handle, msg, 1) != HDF_SUCCESS) {
+            return 0;
+        }
+    }
+    (void)OsalGetTime(&end);
+    (void)OsalDiffTime(&start, &end, &diff);
+    return (diff.sec * SPI_SHARED_US_PER_SEC + diff.usec) / SPI_SHARED_ROUNDS;
+}
+
+static int32_t SpiSharedPerformanceTest(struct SpiTester *tester)
+{
+    uint32_t len;
+    uint64_t copyUs;
+    uint64_t sharedUs;
+    uint8_t *shared = NULL;
+    uint8_t *wbuf = NULL;
+    uint8_t *rbuf = NULL;
+    struct SpiMsg msg;
+
+    shared = (uint8_t *)SpiMapSharedBuffer(tester->handle, SPI_SHARED_LEN_MAX * 2); // 2: write and read half
+    if (shared == NULL) {
+        HDF_LOGI("%s: shared buffer not supported, skip", __func__);
+        return HDF_SUCCESS;
+    }
+    wbuf = (uint8_t *)OsalMemCalloc(SPI_SHARED_LEN_MAX);
+    rbuf = (uint8_t *)OsalMemCalloc(SPI_SHARED_LEN_MAX);
+    if (wbuf == NULL || rbuf == NULL) {
+        OsalMemFree(wbuf);
+        OsalMemFree(rbuf);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    g_spiCfg.bitsPerWord = BITS_PER_WORD_8BITS;
+    g_spiCfg.transferMode = SPI_POLLING_TRANSFER;
+    (void)SpiSetCfg(tester->handle, &g_spiCfg);
+
+    for (len = SPI_SHARED_LEN_MIN; len <= SPI_SHARED_LEN_MAX; len *= SPI_SHARED_LEN_STEP) {
+        SpiSharedFillMsg(&msg, wbuf, rbuf, len);
+        copyUs = SpiSharedTransferUs(tester, &msg);
+        SpiSharedFillMsg(&msg, shared, shared + SPI_SHARED_LEN_MAX, len);
+        sharedUs = SpiSharedTransferUs(tester, &msg);
+        if (copyUs == 0 || sharedUs == 0) {
+            HDF_LOGE("%s: transfer %u bytes fail", __func__, len);
+            break;
+        }
+        HDF_LOGI("----->shared buffer performance test: %u bytes, copy:%llu(us), shared:%llu(us)\r\n",
+            len, copyUs, sharedUs);
+    }
+
+    OsalMemFree(wbuf);
+    OsalMemFree(rbuf);
+    return (len > SPI_SHARED_LEN_MAX) ? HDF_SUCCESS : HDF_FAILURE;
+}
+
 struct SpiTestFunc {
     int cmd;
     int32_t (*func)(struct SpiTester *tester);
@@ -514,6 +637,8 @@ static struct SpiTestFunc g_spiTestEntry[] = {
     {SPI_RELIABILITY_TEST, SpiReliabilityTest, "SpiReliabilityTest"},
     {SPI_PERFORMANCE_TEST, SpiIfPerformanceTest, "SpiIfPerformanceTest"},
     {SPI_TEST_ALL, SpiTestAll, "SpiTestAll"},
+    {SPI_SHARED_TRANSFER_TEST, SpiSharedTransferTest, "SpiSharedTransferTest"},
+    {SPI_SHARED_PERFORMANCE_TEST, SpiSharedPerformanceTest, "SpiSharedPerformanceTest"},
 };
 
 int32_t SpiTestExecute(int cmd)
@@ -25,6 +25,8 @@ enum SpiTestCmd {
     SPI_RELIABILITY_TEST,
     SPI_PERFORMANCE_TEST,
     SPI_TEST_ALL,
+    SPI_SHARED_TRANSFER_TEST,
+    SPI_SHARED_PERFORMANCE_TEST,
     SPI_TEST_CMD_MAX,
 };
 
@@ -281,6 +281,133 @@ static int32_t UartIfPerformanceTest(struct UartTester *tester)
     return HDF_SUCCESS;
 }
 
+#define UART_STREAM_WAIT_MS    1000
+#define UART_STREAM_CHUNK      16
+#define UART_STREAM_ROUNDS     64
+#define UART_STREAM_US_PER_SEC 1000000
+
+static uint64_t UartStreamNowUs(void)
+{
+    OsalTimespec time = {0};
+
+    (void)OsalGetTime(&time);
+    return time.sec * UART_STREAM_US_PER_SEC + time.usec;
+}
+
+static void UartStreamDrain(struct UartTester *tester)
+{
+    while (UartReadStream(tester->handle, tester->config.rbuf, tester->config.len) > 0) {
+    }
+}
+
+/*
+ * Collect len bytes written to a looped back port, reading whatever has arrived until all of it is there.
+ * Returns the number of bytes got, and counts the reads and the time spent in them.
+ */
+static uint32_t UartStreamCollect(struct UartTester *tester, uint8_t *buf, uint32_t len, uint32_t *reads,
+    uint64_t *readUs)
+{
+    int32_t ret;
+    uint32_t got = 0;
+    uint32_t waitMs = 0;
+    uint64_t start;
+
+    while (got < len && waitMs < UART_STREAM_WAIT_MS) {
+        start = UartStreamNowUs();
+        ret = UartReadStream(tester->handle, buf + got, len - got);
+        *readUs += UartStreamNowUs() - start;
+        (*reads)++;
+        if (ret < 0) {
+            HDF_LOGE("%s: read stream failed:%d", __func__, ret);
+            break;
+        }
+        if (ret == 0) {
+            OsalMSleep(1);
+            waitMs++;
+            continue;
+        }
+        got += (uint32_t)ret;
+    }
+    return got;
+}
+
+static int32_t UartReadStreamTest(struct UartTester *tester)
+{
+    int32_t ret;
+    uint32_t got;
+    uint32_t reads = 0;
+    uint64_t readUs = 0;
+
+    ret = UartReadStream(tester->handle, tester->config.rbuf, tester->config.len);
+    if (ret == HDF_ERR_NOT_SUPPORT) {
+        HDF_LOGI("%s: port %u has no receive ring, skip", __func__, tester->config.port);
+        return HDF_SUCCESS;
+    }
+    if (UartReadStream(tester->handle, NULL, tester->config.len) == HDF_SUCCESS ||
+        UartReadStream(NULL, tester->config.rbuf, tester->config.len) == HDF_SUCCESS) {
+        HDF_LOGE("%s: invalid params accepted", __func__);
+        return HDF_FAILURE;
+    }
+    UartStreamDrain(tester);
+
+    // the port loops back, as the virtual one does
+    if (UartWrite(tester->handle, tester->config.wbuf, tester->config.len) != HDF_SUCCESS) {
+        HDF_LOGE("%s: write failed", __func__);
+        return HDF_FAILURE;
+    }
+    (void)memset_s(tester->config.rbuf, tester->config.len, 0, tester->config.len);
+    got = UartStreamCollect(tester, tester->config.rbuf, tester->config.len, &reads, &readUs);
+    if (got != tester->config.len) {
+        HDF_LOGE("%s: got %u of %u bytes", __func__, got, tester->config.len);
+        return HDF_FAILURE;
+    }
+    if (memcmp(tester->config.wbuf, tester->config.rbuf, tester->config.len) != 0) {
+        HDF_LOGE("%s: data mismatch", __func__);
+        return HDF_FAILURE;
+    }
+    HDF_LOGD("%s: success, %u bytes in %u reads", __func__, got, reads);
+    return HDF_SUCCESS;
+}
+
+static int32_t UartStreamPerformanceTest(struct UartTester *tester)
+{
+    uint32_t i;
+    uint32_t got = 0;
+    uint32_t reads = 0;
+    uint32_t chunk;
+    uint64_t readUs = 0;
+    uint64_t start;
+    uint64_t totalUs;
+
+    if (UartReadStream(tester->handle, tester->config.rbuf, tester->config.len) == HDF_ERR_NOT_SUPPORT) {
+        HDF_LOGI("%s: port %u has no receive ring, skip", __func__, tester->config.port);
+        return HDF_SUCCESS;
+    }
+    UartStreamDrain(tester);
+
+    chunk = (tester->config.len < UART_STREAM_CHUNK) ? tester->config.len : UART_STREAM_CHUNK;
+    start = UartStreamNowUs();
+    for (i = 0; i < UART_STREAM_ROUNDS; i++) {
+        if (UartWrite(tester->handle, tester->config.wbuf, chunk) != HDF_SUCCESS) {
+            HDF_LOGE("%s: write failed", __func__);
+            return HDF_FAILURE;
+        }
+        if (UartStreamCollect(tester, tester->config.rbuf, chunk, &reads, &readUs) != chunk) {
+            HDF_LOGE("%s: round %u lost data", __func__, i);
+            return HDF_FAILURE;
+        }
+        got += chunk;
+    }
+    totalUs = UartStreamNowUs() - start;
+    if (totalUs == 0 || reads == 0) {
+        return HDF_SUCCESS;
+    }
+
+    HDF_LOGI("----->stream read performance test: %u bytes, %llu bytes/s, %u reads, %llu us per read\r\n",
+        got, (uint64_t)got * UART_STREAM_US_PER_SEC / totalUs, reads, readUs / reads);
+    return HDF_SUCCESS;
+}
+
 struct UartTestEntry {
     int cmd;
     int32_t (*func)(struct UartTester *tester);
@@ -297,6 +424,8 @@ static struct UartTestEntry g_entry[] = {
     { UART_TEST_CMD_SET_TRANSMODE, UartSetTransModeTest, "UartSetTransModeTest" },
     { UART_TEST_CMD_RELIABILITY, UartReliabilityTest, "UartReliabilityTest" },
     { UART_TEST_CMD_PERFORMANCE, UartIfPerformanceTest, "UartIfPerformanceTest" },
+    { UART_TEST_CMD_READ_STREAM, UartReadStreamTest, "UartReadStreamTest" },
+    { UART_TEST_CMD_STREAM_PERFORMANCE, UartStreamPerformanceTest, "UartStreamPerformanceTest" },
 };
 
 int32_t UartTestExecute(int cmd)
@@ -27,7 +27,9 @@ enum UartTestCmd {
     UART_TEST_CMD_SET_TRANSMODE = 6,
     UART_TEST_CMD_RELIABILITY = 7,
     UART_TEST_CMD_PERFORMANCE = 8,
-    UART_TEST_CMD_MAX = 9,
+    UART_TEST_CMD_READ_STREAM = 9,
+    UART_TEST_CMD_STREAM_PERFORMANCE = 10,
+    UART_TEST_CMD_MAX = 11,
 };
 
 struct UartTestConfig {
@@ -10,6 +10,7 @@
 
 #include "can_test.h"
 #include "hdf_log.h"
+#include "platform_bh_test.h"
 #include "platform_device_test.h"
 #include "platform_dumper_test.h"
 #include "platform_event_test.h"
@@ -37,6 +38,14 @@ int32_t HdfPlatformQueueTestEntry(HdfTestMsg *msg)
     return HDF_SUCCESS;
 }
 
+int32_t HdfPlatformBhTestEntry(HdfTestMsg *msg)
+{
+    if (msg != NULL) {
+        msg->result = PlatformBhTestExecute(msg->subCmd);
+    }
+    return HDF_SUCCESS;
+}
+
 int32_t HdfPlatformDeviceTestEntry(HdfTestMsg *msg)
 {
     if (msg != NULL) {
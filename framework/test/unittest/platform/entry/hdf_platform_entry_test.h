@@ -16,6 +16,8 @@ int32_t HdfPlatformEventTestEntry(HdfTestMsg *msg);
 
 int32_t HdfPlatformQueueTestEntry(HdfTestMsg *msg);
 
+int32_t HdfPlatformBhTestEntry(HdfTestMsg *msg);
+
 int32_t HdfPlatformDeviceTestEntry(HdfTestMsg *msg);
 
 int32_t HdfPlatformManagerTestEntry(HdfTestMsg *msg);
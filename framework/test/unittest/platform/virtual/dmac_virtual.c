@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "dma/dmac_core.h"
+#include "dma_test.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "osal_sem.h"
+#include "platform_bh.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG dmac_virtual
+
+#define VIRTUAL_DMAC_CHAN_NUM       4
+#define VIRTUAL_DMAC_MAX_TRANS_SIZE 256
+#define VIRTUAL_DMAC_LLI_EN         0x2
+#define VIRTUAL_DMAC_WAIT_MS        1000
+
+/*
+ * A controller moving data with the cpu. Every channel runs its transfer in a bottom half, walking the lli
+ * list by the physical addresses the core filled in, and reports the end through DmacCntlrIrqCallback as an
+ * interrupt would. Addresses are virtual ones, and the peripheral of a channel is a buffer it streams
+ * through from the start, the way a fifo would deliver or take bytes.
+ */
+struct VirtualDmacChan {
+    struct PlatformBhWork work;
+    struct VirtualDmac *virtual;
+    struct DmacChanInfo *chanInfo;
+    uint16_t channel;
+    bool m2m;
+    uintptr_t src;            // m2m block
+    uintptr_t dest;
+    size_t len;
+    uintptr_t currDest;
+    int status;               // cleared on read, like an interrupt status register
+    struct OsalSem released;
+};
+
+struct VirtualDmac {
+    struct HdfDeviceObject device;
+    struct DmaCntlr *cntlr;
+    OsalSpinlock lock;
+    struct VirtualDmacChan chans[VIRTUAL_DMAC_CHAN_NUM];
+};
+
+static void *VirtualDmacPaddrToVaddr(uintptr_t paddr)
+{
+    return (void *)paddr;
+}
+
+static uintptr_t VirtualDmacVaddrToPaddr(void *vaddr)
+{
+    return (uintptr_t)vaddr;
+}
+
+static void VirtualDmacCacheNop(uintptr_t vaddr, uintptr_t vend)
+{
+    (void)vaddr;
+    (void)vend;
+}
+
+static int VirtualDmacRunLli(struct VirtualDmacChan *chan)
+{
+    uint16_t n;
+    size_t periphOff = 0;
+    uintptr_t src;
+    uintptr_t dest;
+    struct DmacChanInfo *chanInfo = chan->chanInfo;
+    struct DmacLli *plli = chanInfo->lli;
+
+    for (n = 0; plli != NULL && n < chanInfo->lliCnt; n++) {
+        if (plli->count == 0 || plli->count > chan->virtual->cntlr->maxTransSize ||
+            plli->srcAddr == 0 || plli->destAddr == 0) {
+            HDF_LOGE("%s: chan %u bad lli %u", __func__, chan->channel, n);
+            return DMAC_CHN_ERROR;
+        }
+        src = plli->srcAddr + ((chanInfo->transType == TRASFER_TYPE_P2M) ? periphOff : 0);
+        dest = plli->destAddr + ((chanInfo->transType == TRASFER_TYPE_M2P) ? periphOff : 0);
+        if (memcpy_s(VirtualDmacPaddrToVaddr(dest), plli->count, VirtualDmacPaddrToVaddr(src),
+            plli->count) != EOK) {
+            return DMAC_CHN_ERROR;
+        }
+        periphOff += plli->count;
+        chan->currDest = dest + plli->count;
+        plli = (plli->nextLli == 0) ? NULL :
+            (struct DmacLli *)VirtualDmacPaddrToVaddr(plli->nextLli & ~(uintptr_t)(DMAC_LLI_SIZE - 1));
+    }
+    return DMAC_CHN_SUCCESS;
+}
+
+static void VirtualDmacChanRun(struct PlatformBhWork *work)
+{
+    int status;
+    uint32_t flags;
+    struct VirtualDmacChan *chan = (struct VirtualDmacChan *)work->data;
+    struct VirtualDmac *virtual = chan->virtual;
+
+    if (chan->m2m) {
+        status = (memcpy_s(VirtualDmacPaddrToVaddr(chan->dest), chan->len, VirtualDmacPaddrToVaddr(chan->src),
+            chan->len) == EOK) ? DMAC_CHN_SUCCESS : DMAC_CHN_ERROR;
+        chan->currDest = chan->dest + chan->len;
+    } else {
+        status = VirtualDmacRunLli(chan);
+    }
+
+    (void)OsalSpinLockIrqSave(&virtual->lock, &flags);
+    chan->status = status;
+    (void)OsalSpinUnlockIrqRestore(&virtual->lock, &flags);
+    DmacCntlrIrqCallback(virtual->cntlr);
+}
+
+static void VirtualDmacChanRelease(struct PlatformBhWork *work)
+{
+    struct VirtualDmacChan *chan = (struct VirtualDmacChan *)work->data;
+
+    (void)OsalSemPost(&chan->released);
+}
+
+static int32_t VirtualDmacGetChanInfo(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo, struct DmacMsg *msg)
+{
+    (void)cntlr;
+    chanInfo->srcWidth = (msg->srcWidth == 0) ? 1 : msg->srcWidth;
+    chanInfo->destWidth = (msg->destWidth == 0) ? 1 : msg->destWidth;
+    chanInfo->config = msg->transType;
+    chanInfo->lliEnFlag = VIRTUAL_DMAC_LLI_EN;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualDmacChanEnable(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo)
+{
+    struct VirtualDmac *virtual = (struct VirtualDmac *)cntlr->private;
+    struct VirtualDmacChan *chan = &virtual->chans[chanInfo->channel];
+
+    chan->chanInfo = chanInfo;
+    chan->m2m = false;
+    return PlatformBhSchedule(&chan->work);
+}
+
+static int32_t VirtualDmacM2mChanEnable(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo,
+    uintptr_t src, uintptr_t dest, size_t length)
+{
+    struct VirtualDmac *virtual = (struct VirtualDmac *)cntlr->private;
+    struct VirtualDmacChan *chan = &virtual->chans[chanInfo->channel];
+
+    chan->chanInfo = chanInfo;
+    chan->m2m = true;
+    chan->src = src;
+    chan->dest = dest;
+    chan->len = length;
+    return PlatformBhSchedule(&chan->work);
+}
+
+static void VirtualDmacChanDisable(struct DmaCntlr *cntlr, uint16_t channel)
+{
+    (void)cntlr;
+    (void)channel;
+}
+
+static int VirtualDmacGetChanStatus(struct DmaCntlr *cntlr, uint16_t chan)
+{
+    int status;
+    uint32_t flags;
+    struct VirtualDmac *virtual = (struct VirtualDmac *)cntlr->private;
+
+    (void)OsalSpinLockIrqSave(&virtual->lock, &flags);
+    status = virtual->chans[chan].status;
+    virtual->chans[chan].status = 0;
+    (void)OsalSpinUnlockIrqRestore(&virtual->lock, &flags);
+    return status;
+}
+
+static uintptr_t VirtualDmacGetCurrDestAddr(struct DmaCntlr *cntlr, uint16_t chan)
+{
+    struct VirtualDmac *virtual = (struct VirtualDmac *)cntlr->private;
+
+    return virtual->chans[chan].currDest;
+}
+
+static void VirtualDmacSetOps(struct DmaCntlr *cntlr)
+{
+    cntlr->getChanInfo = VirtualDmacGetChanInfo;
+    cntlr->dmaChanEnable = VirtualDmacChanEnable;
+    cntlr->dmaM2mChanEnable = VirtualDmacM2mChanEnable;
+    cntlr->dmacChanDisable = VirtualDmacChanDisable;
+    cntlr->dmacCacheInv = VirtualDmacCacheNop;
+    cntlr->dmacCacheFlush = VirtualDmacCacheNop;
+    cntlr->dmacPaddrToVaddr = VirtualDmacPaddrToVaddr;
+    cntlr->dmacVaddrToPaddr = VirtualDmacVaddrToPaddr;
+    cntlr->dmacGetChanStatus = VirtualDmacGetChanStatus;
+    cntlr->dmacGetCurrDestAddr = VirtualDmacGetCurrDestAddr;
+}
+
+static void VirtualDmacReleaseChans(struct VirtualDmac *virtual, uint16_t count)
+{
+    uint16_t i;
+
+    for (i = 0; i < count; i++) {
+        PlatformBhWorkRelease(&virtual->chans[i].work);
+        (void)OsalSemWait(&virtual->chans[i].released, VIRTUAL_DMAC_WAIT_MS);
+        (void)OsalSemDestroy(&virtual->chans[i].released);
+    }
+}
+
+static int32_t VirtualDmacInitChans(struct VirtualDmac *virtual)
+{
+    int32_t ret;
+    uint16_t i;
+    struct VirtualDmacChan *chan = NULL;
+
+    for (i = 0; i < VIRTUAL_DMAC_CHAN_NUM; i++) {
+        chan = &virtual->chans[i];
+        chan->virtual = virtual;
+        chan->channel = i;
+        (void)OsalSemInit(&chan->released, 0);
+        ret = PlatformBhWorkInit(&chan->work, VirtualDmacChanRun, chan, PLATFORM_BH_PRI_HIGH);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: init work of chan %u failed, ret = %d", __func__, i, ret);
+            (void)OsalSemDestroy(&chan->released);
+            VirtualDmacReleaseChans(virtual, i);
+            return ret;
+        }
+        chan->work.release = VirtualDmacChanRelease;
+    }
+    return HDF_SUCCESS;
+}
+
+struct DmaCntlr *VirtualDmacCreate(uint16_t lliPoolPerChan)
+{
+    int32_t ret;
+    struct VirtualDmac *virtual = NULL;
+    struct DmaCntlr *cntlr = NULL;
+
+    virtual = (struct VirtualDmac *)OsalMemCalloc(sizeof(*virtual));
+    if (virtual == NULL) {
+        HDF_LOGE("%s: malloc virtual fail!", __func__);
+        return NULL;
+    }
+    cntlr = DmaCntlrCreate(&virtual->device);
+    if (cntlr == NULL) {
+        OsalMemFree(virtual);
+        return NULL;
+    }
+    virtual->cntlr = cntlr;
+    (void)OsalSpinInit(&virtual->lock);
+    if (VirtualDmacInitChans(virtual) != HDF_SUCCESS) {
+        goto ERR;
+    }
+
+    cntlr->irq = DMAC_IRQ_NONE;
+    cntlr->maxTransSize = VIRTUAL_DMAC_MAX_TRANS_SIZE;
+    cntlr->channelNum = VIRTUAL_DMAC_CHAN_NUM;
+    cntlr->lliPoolPerChan = lliPoolPerChan;
+    cntlr->private = virtual;
+    VirtualDmacSetOps(cntlr);
+    ret = DmacCntlrAdd(cntlr);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: add cntlr failed, ret = %d", __func__, ret);
+        VirtualDmacReleaseChans(virtual, VIRTUAL_DMAC_CHAN_NUM);
+        goto ERR;
+    }
+    return cntlr;
+ERR:
+    (void)OsalSpinDestroy(&virtual->lock);
+    DmaCntlrDestroy(cntlr);
+    OsalMemFree(virtual);
+    return NULL;
+}
+
+void VirtualDmacDestroy(struct DmaCntlr *cntlr)
+{
+    struct VirtualDmac *virtual = NULL;
+
+    if (cntlr == NULL || cntlr->private == NULL) {
+        return;
+    }
+    virtual = (struct VirtualDmac *)cntlr->private;
+    // a channel may still be finishing in its bottom half after the callback of its transfer
+    VirtualDmacReleaseChans(virtual, VIRTUAL_DMAC_CHAN_NUM);
+    DmacCntlrRemove(cntlr);
+    (void)OsalSpinDestroy(&virtual->lock);
+    DmaCntlrDestroy(cntlr);
+    OsalMemFree(virtual);
+}
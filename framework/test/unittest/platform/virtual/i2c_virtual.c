@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "i2c/i2c_core.h"
+#include "device_resource_if.h"
+#include "hdf_device_desc.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "osal_time.h"
+
+#define HDF_LOG_TAG i2c_virtual
+
+#define VIRTUAL_I2C_REG_SIZE        256
+#define VIRTUAL_I2C_SPEED_DEFAULT   400000
+#define VIRTUAL_I2C_BITS_PER_BYTE   9       // 8 data bits and the ack
+#define VIRTUAL_I2C_BITS_START_STOP 2
+#define VIRTUAL_I2C_NS_PER_SEC      1000000000
+#define VIRTUAL_I2C_NS_PER_US       1000
+#define VIRTUAL_I2C_US_PER_MS       1000
+#define VIRTUAL_I2C_8BIT            8
+
+/*
+ * A controller with one register based device on its bus. The first regLen bytes written to the device set
+ * the register address, following bytes are written from it on, and reads go on from the current address.
+ * Every transfer takes the time the bytes would take on the bus at the configured speed.
+ */
+struct VirtualI2cCntlr {
+    struct I2cCntlr cntlr;
+    uint16_t busId;
+    uint16_t devAddr;
+    uint16_t regLen;
+    uint16_t regAddr;
+    uint32_t speed;
+    uint32_t bitNs;
+    uint8_t regs[VIRTUAL_I2C_REG_SIZE];
+};
+
+static void VirtualI2cDevWrite(struct VirtualI2cCntlr *virtual, const struct I2cMsg *msg)
+{
+    uint16_t i;
+
+    for (i = 0; i < msg->len; i++) {
+        if (i < virtual->regLen) {
+            virtual->regAddr = (i == 0) ? msg->buf[i] : ((virtual->regAddr << VIRTUAL_I2C_8BIT) | msg->buf[i]);
+            continue;
+        }
+        virtual->regs[virtual->regAddr % VIRTUAL_I2C_REG_SIZE] = msg->buf[i];
+        virtual->regAddr++;
+    }
+}
+
+static void VirtualI2cDevRead(struct VirtualI2cCntlr *virtual, const struct I2cMsg *msg)
+{
+    uint16_t i;
+
+    for (i = 0; i < msg->len; i++) {
+        msg->buf[i] = virtual->regs[virtual->regAddr % VIRTUAL_I2C_REG_SIZE];
+        virtual->regAddr++;
+    }
+}
+
+static void VirtualI2cBusDelay(const struct VirtualI2cCntlr *virtual, uint32_t bytes)
+{
+    uint32_t us;
+
+    us = (bytes * VIRTUAL_I2C_BITS_PER_BYTE + VIRTUAL_I2C_BITS_START_STOP) * virtual->bitNs / VIRTUAL_I2C_NS_PER_US;
+    if (us >= VIRTUAL_I2C_US_PER_MS) {
+        OsalMSleep(us / VIRTUAL_I2C_US_PER_MS);
+    }
+    OsalUDelay(us % VIRTUAL_I2C_US_PER_MS);
+}
+
+static int32_t VirtualI2cTransfer(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count)
+{
+    int16_t i;
+    uint32_t bytes = 0;
+    struct VirtualI2cCntlr *virtual = NULL;
+
+    if (cntlr == NULL || msgs == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    virtual = CONTAINER_OF(cntlr, struct VirtualI2cCntlr, cntlr);
+
+    for (i = 0; i < count; i++) {
+        bytes++; // the address byte
+        if (msgs[i].addr != virtual->devAddr || (msgs[i].buf == NULL && msgs[i].len > 0)) {
+            break; // no ack
+        }
+        if ((msgs[i].flags & I2C_FLAG_READ) != 0) {
+            VirtualI2cDevRead(virtual, &msgs[i]);
+        } else {
+            VirtualI2cDevWrite(virtual, &msgs[i]);
+        }
+        bytes += msgs[i].len;
+    }
+    VirtualI2cBusDelay(virtual, bytes);
+
+    return (i > 0) ? i : HDF_ERR_IO;
+}
+
+static const struct I2cMethod g_method = {
+    .transfer = VirtualI2cTransfer,
+};
+
+static int32_t VirtualI2cReadDrs(struct VirtualI2cCntlr *virtual, const struct DeviceResourceNode *node)
+{
+    struct DeviceResourceIface *drsOps = NULL;
+
+    drsOps = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (drsOps == NULL || drsOps->GetUint32 == NULL || drsOps->GetUint16 == NULL) {
+        HDF_LOGE("%s: Invalid drs ops fail!", __func__);
+        return HDF_FAILURE;
+    }
+    if (drsOps->GetUint16(node, "busId", &virtual->busId, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read busId fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (drsOps->GetUint16(node, "devAddr", &virtual->devAddr, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read devAddr fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (drsOps->GetUint16(node, "regLen", &virtual->regLen, 1) != HDF_SUCCESS) {
+        HDF_LOGW("%s: Read regLen fail, use 1", __func__);
+    }
+    if (drsOps->GetUint32(node, "speed", &virtual->speed, VIRTUAL_I2C_SPEED_DEFAULT) != HDF_SUCCESS) {
+        HDF_LOGW("%s: Read speed fail, use default", __func__);
+    }
+
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualI2cParseAndInit(struct HdfDeviceObject *device, const struct DeviceResourceNode *node)
+{
+    int32_t ret;
+    struct VirtualI2cCntlr *virtual = NULL;
+    (void)device;
+
+    virtual = (struct VirtualI2cCntlr *)OsalMemCalloc(sizeof(*virtual));
+    if (virtual == NULL) {
+        HDF_LOGE("%s: Malloc virtual fail!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    ret = VirtualI2cReadDrs(virtual, node);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read drs fail! ret:%d", __func__, ret);
+        OsalMemFree(virtual);
+        return ret;
+    }
+    if (virtual->speed == 0) {
+        virtual->speed = VIRTUAL_I2C_SPEED_DEFAULT;
+    }
+    virtual->bitNs = VIRTUAL_I2C_NS_PER_SEC / virtual->speed;
+
+    virtual->cntlr.priv = (void *)node;
+    virtual->cntlr.busId = (int16_t)virtual->busId;
+    virtual->cntlr.ops = &g_method;
+    ret = I2cCntlrAdd(&virtual->cntlr);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: add i2c controller failed! ret = %d", __func__, ret);
+        OsalMemFree(virtual);
+        return ret;
+    }
+
+    HDF_LOGI("%s: bus:%hu dev:0x%x speed:%u init done!", __func__, virtual->busId, virtual->devAddr, virtual->speed);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualI2cInit(struct HdfDeviceObject *device)
+{
+    int32_t ret;
+    const struct DeviceResourceNode *childNode = NULL;
+
+    if (device == NULL || device->property == NULL) {
+        HDF_LOGE("%s: device or property is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    ret = HDF_SUCCESS;
+    DEV_RES_NODE_FOR_EACH_CHILD_NODE(device->property, childNode) {
+        ret = VirtualI2cParseAndInit(device, childNode);
+        if (ret != HDF_SUCCESS) {
+            break;
+        }
+    }
+    return ret;
+}
+
+static void VirtualI2cRemoveByNode(const struct DeviceResourceNode *node)
+{
+    int32_t ret;
+    int16_t busId;
+    struct I2cCntlr *cntlr = NULL;
+    struct DeviceResourceIface *drsOps = NULL;
+
+    drsOps = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (drsOps == NULL || drsOps->GetUint16 == NULL) {
+        HDF_LOGE("%s: invalid drs ops fail!", __func__);
+        return;
+    }
+
+    ret = drsOps->GetUint16(node, "busId", (uint16_t *)&busId, 0);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: read busId fail!", __func__);
+        return;
+    }
+
+    cntlr = I2cCntlrGet(busId);
+    if (cntlr != NULL && cntlr->priv == node) {
+        I2cCntlrPut(cntlr);
+        I2cCntlrRemove(cntlr);
+        OsalMemFree(CONTAINER_OF(cntlr, struct VirtualI2cCntlr, cntlr));
+    }
+}
+
+static void VirtualI2cRelease(struct HdfDeviceObject *device)
+{
+    const struct DeviceResourceNode *childNode = NULL;
+
+    if (device == NULL || device->property == NULL) {
+        HDF_LOGE("%s: device or property is NULL", __func__);
+        return;
+    }
+
+    DEV_RES_NODE_FOR_EACH_CHILD_NODE(device->property, childNode) {
+        VirtualI2cRemoveByNode(childNode);
+    }
+}
+
+struct HdfDriverEntry g_i2cVirtualDriverEntry = {
+    .moduleVersion = 1,
+    .Init = VirtualI2cInit,
+    .Release = VirtualI2cRelease,
+    .moduleName = "virtual_i2c_driver",
+};
+HDF_INIT(g_i2cVirtualDriverEntry);
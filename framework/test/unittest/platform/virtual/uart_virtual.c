@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "uart/uart_core.h"
+#include "device_resource_if.h"
+#include "hdf_device_desc.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "osal_time.h"
+
+#define HDF_LOG_TAG uart_virtual
+
+#define VIRTUAL_UART_BAUD_DEFAULT    115200
+#define VIRTUAL_UART_RX_RING_DEFAULT 4096
+#define VIRTUAL_UART_BITS_PER_BYTE   10      // start, 8 data bits and stop
+#define VIRTUAL_UART_US_PER_SEC      1000000
+#define VIRTUAL_UART_US_PER_MS       1000
+
+/*
+ * A port with its TX wired to its RX. Written bytes take the time they would take on the line at the
+ * configured baud rate, and then arrive in the receive ring of the host.
+ */
+struct VirtualUartDev {
+    uint32_t baudRate;
+    uint32_t rxRingSize;
+    struct UartAttribute attribute;
+    enum UartTransMode mode;
+};
+
+static void VirtualUartLineDelay(const struct VirtualUartDev *dev, uint32_t bytes)
+{
+    uint64_t us;
+
+    us = (uint64_t)bytes * VIRTUAL_UART_BITS_PER_BYTE * VIRTUAL_UART_US_PER_SEC / dev->baudRate;
+    if (us >= VIRTUAL_UART_US_PER_MS) {
+        OsalMSleep((uint32_t)(us / VIRTUAL_UART_US_PER_MS));
+    }
+    OsalUDelay((uint32_t)(us % VIRTUAL_UART_US_PER_MS));
+}
+
+static int32_t VirtualUartInit(struct UartHost *host)
+{
+    (void)host;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualUartDeinit(struct UartHost *host)
+{
+    (void)host;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualUartRead(struct UartHost *host, uint8_t *data, uint32_t size)
+{
+    return UartHostReadStream(host, data, size);
+}
+
+static int32_t VirtualUartWrite(struct UartHost *host, uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+    struct VirtualUartDev *dev = (struct VirtualUartDev *)host->priv;
+
+    if (data == NULL || size == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    VirtualUartLineDelay(dev, size);
+    len = UartHostRecv(host, data, size);
+    if (len < size) {
+        HDF_LOGW("%s: rx ring full, %u of %u bytes looped back", __func__, len, size);
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualUartGetBaud(struct UartHost *host, uint32_t *baudRate)
+{
+    struct VirtualUartDev *dev = (struct VirtualUartDev *)host->priv;
+
+    if (baudRate == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *baudRate = dev->baudRate;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualUartSetBaud(struct UartHost *host, uint32_t baudRate)
+{
+    struct VirtualUartDev *dev = (struct VirtualUartDev *)host->priv;
+
+    if (baudRate == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    dev->baudRate = baudRate;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualUartGetAttribute(struct UartHost *host, struct UartAttribute *attribute)
+{
+    struct VirtualUartDev *dev = (struct VirtualUartDev *)host->priv;
+
+    if (attribute == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *attribute = dev->attribute;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualUartSetAttribute(struct UartHost *host, struct UartAttribute *attribute)
+{
+    struct VirtualUartDev *dev = (struct VirtualUartDev *)host->priv;
+
+    if (attribute == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    dev->attribute = *attribute;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualUartSetTransMode(struct UartHost *host, enum UartTransMode mode)
+{
+    struct VirtualUartDev *dev = (struct VirtualUartDev *)host->priv;
+
+    dev->mode = mode;
+    return HDF_SUCCESS;
+}
+
+static struct UartHostMethod g_method = {
+    .Init = VirtualUartInit,
+    .Deinit = VirtualUartDeinit,
+    .Read = VirtualUartRead,
+    .Write = VirtualUartWrite,
+    .GetBaud = VirtualUartGetBaud,
+    .SetBaud = VirtualUartSetBaud,
+    .GetAttribute = VirtualUartGetAttribute,
+    .SetAttribute = VirtualUartSetAttribute,
+    .SetTransMode = VirtualUartSetTransMode,
+};
+
+static int32_t VirtualUartReadDrs(struct UartHost *host, struct VirtualUartDev *dev,
+    const struct DeviceResourceNode *node)
+{
+    struct DeviceResourceIface *drsOps = NULL;
+
+    drsOps = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (drsOps == NULL || drsOps->GetUint32 == NULL) {
+        HDF_LOGE("%s: Invalid drs ops fail!", __func__);
+        return HDF_FAILURE;
+    }
+    if (drsOps->GetUint32(node, "num", &host->num, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read num fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (drsOps->GetUint32(node, "baudRate", &dev->baudRate, VIRTUAL_UART_BAUD_DEFAULT) != HDF_SUCCESS) {
+        HDF_LOGW("%s: Read baudRate fail, use default", __func__);
+    }
+    if (drsOps->GetUint32(node, "rxRingSize", &dev->rxRingSize, VIRTUAL_UART_RX_RING_DEFAULT) != HDF_SUCCESS) {
+        HDF_LOGW("%s: Read rxRingSize fail, use default", __func__);
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualUartBind(struct HdfDeviceObject *device)
+{
+    if (device == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return (UartHostCreate(device) == NULL) ? HDF_FAILURE : HDF_SUCCESS;
+}
+
+static int32_t VirtualUartDriverInit(struct HdfDeviceObject *device)
+{
+    int32_t ret;
+    struct UartHost *host = NULL;
+    struct VirtualUartDev *dev = NULL;
+
+    if (device == NULL || device->property == NULL) {
+        HDF_LOGE("%s: device or property is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    host = UartHostFromDevice(device);
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return HDF_FAILURE;
+    }
+
+    dev = (struct VirtualUartDev *)OsalMemCalloc(sizeof(*dev));
+    if (dev == NULL) {
+        HDF_LOGE("%s: Malloc dev fail!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    ret = VirtualUartReadDrs(host, dev, device->property);
+    if (ret != HDF_SUCCESS) {
+        OsalMemFree(dev);
+        return ret;
+    }
+    if (dev->baudRate == 0) {
+        dev->baudRate = VIRTUAL_UART_BAUD_DEFAULT;
+    }
+
+    ret = UartHostRxRingInit(host, dev->rxRingSize);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: init rx ring fail! ret:%d", __func__, ret);
+        OsalMemFree(dev);
+        return ret;
+    }
+    host->priv = dev;
+    host->method = &g_method;
+
+    HDF_LOGI("%s: port:%u baud:%u ring:%u init done!", __func__, host->num, dev->baudRate, dev->rxRingSize);
+    return HDF_SUCCESS;
+}
+
+static void VirtualUartRelease(struct HdfDeviceObject *device)
+{
+    struct UartHost *host = NULL;
+
+    if (device == NULL) {
+        HDF_LOGE("%s: device is NULL", __func__);
+        return;
+    }
+    host = UartHostFromDevice(device);
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return;
+    }
+    host->method = NULL;
+    OsalMemFree(host->priv);
+    host->priv = NULL;
+    UartHostDestroy(host);
+}
+
+struct HdfDriverEntry g_uartVirtualDriverEntry = {
+    .moduleVersion = 1,
+    .Bind = VirtualUartBind,
+    .Init = VirtualUartDriverInit,
+    .Release = VirtualUartRelease,
+    .moduleName = "virtual_uart_driver",
+};
+HDF_INIT(g_uartVirtualDriverEntry);
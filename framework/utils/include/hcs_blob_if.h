@@ -11,6 +11,12 @@
 
 #include "hdf_base.h"
 
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
 #define CONFIG_NODE 0x1
 #define CONFIG_ATTR 0x2
 #define CONFIG_REFERENCE 0x3
@@ -82,4 +88,10 @@ bool HcsSwapToUint16(uint16_t *value, const char *realValue, uint32_t type);
 bool HcsSwapToUint32(uint32_t *value, const char *realValue, uint32_t type);
 bool HcsSwapToUint64(uint64_t *value, const char *realValue, uint32_t type);
 
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
 #endif /* HCS_BLOB_IF_H */
\ No newline at end of file
@@ -11,6 +11,20 @@
 
 #include "device_resource_if.h"
 
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
 bool HcsDecompile(const char *hcsBlob, uint32_t offset, struct DeviceResourceNode **root);
+// Frees a tree returned by HcsDecompile together with its lookup index.
+void HcsTreeRelease(struct DeviceResourceNode *root);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
 
 #endif /* HCS_PARSER_H */
\ No newline at end of file
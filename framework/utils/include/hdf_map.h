@@ -15,12 +15,24 @@
 extern "C" {
 #endif /* __cplusplus */
 
+struct MapSlot;
 struct MapNode;
+struct MapArenaChunk;
 
+#define HDF_MAP_SIZE_CLASS_NUM 13
+
+/*
+ * Open-addressed (Robin Hood, linear probing) hash map. The slot array keeps the hash next to
+ * the node pointer so probing stays within a few cache lines, and nodes are carved from
+ * map-owned arena chunks instead of one heap allocation per key. Node sizes are rounded up to
+ * size classes, so that an erased node is reused by any later node of its class.
+ */
 typedef struct {
-    struct MapNode **nodes; /**< Map node bucket */
+    struct MapSlot *slots; /**< Map slot array */
     uint32_t nodeSize; /**< Map node count */
-    uint32_t bucketSize; /**< Map node bucket size */
+    uint32_t bucketSize; /**< Map slot count, power of two */
+    struct MapArenaChunk *chunks; /**< Arena chunks backing the nodes */
+    struct MapNode *freeNodes[HDF_MAP_SIZE_CLASS_NUM]; /**< Erased nodes available for reuse, by size class */
 } Map;
 
 void MapInit(Map *map);
@@ -33,6 +45,22 @@ void *MapGet(const Map *map, const char *key);
 
 int32_t MapErase(Map *map, const char *key);
 
+/*
+ * Hash of a key as used by the map. Callers on hot paths may compute it once and pass it to
+ * the *WithHash variants, which skip rehashing the key. Passing a hash that was not produced
+ * by MapHash for the same key makes the lookup miss.
+ */
+uint32_t MapHash(const char *key);
+
+int32_t MapSetWithHash(Map *map, const char *key, uint32_t hash, const void *value, uint32_t valueSize);
+
+void *MapGetWithHash(const Map *map, const char *key, uint32_t hash);
+
+int32_t MapEraseWithHash(Map *map, const char *key, uint32_t hash);
+
+/* Bytes held by the arena chunks of the map, live and erased nodes included. */
+uint32_t MapArenaSize(const Map *map);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -31,6 +31,8 @@ struct HdfMessageTask {
     struct IHdfMessageHandler *messageHandler;
 };
 
+int32_t HdfMessageTaskSendMessageLater(
+    struct HdfMessageTask *task, struct HdfMessage *msg, bool sync, long delay);
 void HdfMessageTaskConstruct(struct HdfMessageTask *inst,
     struct HdfMessageLooper *looper, struct IHdfMessageHandler *handler);
 
@@ -55,7 +55,7 @@ struct HdfSBufImpl {
     const char16_t *(*readString16)(struct HdfSBufImpl *sbuf);
     int32_t (*writeRemoteService)(struct HdfSBufImpl *sbuf, const struct HdfRemoteService *service);
     struct HdfRemoteService *(*readRemoteService)(struct HdfSBufImpl *sbuf);
-    const uint8_t *(*getData)(const struct HdfSBufImpl *sbuf);
+    const uint8_t *(*getData)(struct HdfSBufImpl *sbuf);
     void (*flush)(struct HdfSBufImpl *sbuf);
     size_t (*getCapacity)(const struct HdfSBufImpl *sbuf);
     size_t (*getDataSize)(const struct HdfSBufImpl *sbuf);
@@ -64,6 +64,10 @@ struct HdfSBufImpl {
     struct HdfSBufImpl *(*move)(struct HdfSBufImpl *sbuf);
     struct HdfSBufImpl *(*copy)(const struct HdfSBufImpl *sbuf);
     void (*transDataOwnership)(struct HdfSBufImpl *sbuf);
+    bool (*writeBufferRef)(struct HdfSBufImpl *sbuf, const uint8_t *data, uint32_t writeSize);
+    bool (*readBufferRef)(struct HdfSBufImpl *sbuf, const uint8_t **data, uint32_t *readSize);
+    int32_t (*forEachSegment)(struct HdfSBufImpl *sbuf,
+        int32_t (*func)(void *priv, const uint8_t *data, size_t size), void *priv);
 };
 
 #ifdef __cplusplus
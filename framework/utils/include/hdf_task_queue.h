@@ -14,6 +14,10 @@
 #include "osal_mutex.h"
 #include "osal_thread.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
 struct HdfTaskType;
 typedef int32_t (*HdfTaskFunc)(struct HdfTaskType *para);
 
@@ -26,14 +30,29 @@ struct HdfTaskQueue {
     struct OsalSem sem;
     struct OsalMutex mutex;
     struct DListHead head;
-    struct OsalThread thread;
+    struct OsalThread *threads;
+    uint32_t threadCount;
+    uint32_t aliveThreads;
     bool threadRunFlag;
     HdfTaskFunc queueFunc;
     const char *queueName;
 };
 
 void HdfTaskEnqueue(struct HdfTaskQueue *queue, struct HdfTaskType *task);
+/*
+ * Tasks run without holding the queue mutex, so producers never wait for a running task.
+ * A single-worker queue drains all pending tasks as one batch and keeps FIFO order.
+ */
 struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc queueFunc, const char *name);
+/*
+ * Creates a queue served by workerCount threads. Each worker takes one task at a time,
+ * so tasks may run concurrently and complete out of order.
+ */
+struct HdfTaskQueue *HdfTaskQueueCreatePool(HdfTaskFunc queueFunc, const char *name, uint32_t workerCount);
 void HdfTaskQueueDestroy(struct HdfTaskQueue *queue);
 
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
 #endif /* HDF_TASK_QUEUE_H */
\ No newline at end of file
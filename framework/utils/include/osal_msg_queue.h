@@ -9,7 +9,6 @@
 #ifndef OSAL_MSG_QUEUE_H
 #define OSAL_MSG_QUEUE_H
 
-#include "hdf_slist.h"
 #include "osal_message.h"
 #include "osal_mutex.h"
 #include "osal_sem.h"
@@ -18,10 +17,23 @@
 extern "C" {
 #endif /* __cplusplus */
 
+struct HdfMessageQueueNode {
+    uint64_t timeStamp;
+    uint64_t sequence;
+    struct HdfMessage *message;
+};
+
+/*
+ * Pending messages are kept in a binary min-heap ordered by (timeStamp, sequence),
+ * so enqueue and dequeue are O(log n) and messages with the same deadline keep FIFO order.
+ */
 struct HdfMessageQueue {
     struct OsalMutex mutex;
     struct OsalSem   semaphore;
-    struct HdfSList  list;
+    struct HdfMessageQueueNode *heap;
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t sequence;
 };
 
 void OsalMessageQueueInit(struct HdfMessageQueue *queue);
@@ -29,7 +41,12 @@ void OsalMessageQueueDestroy(struct HdfMessageQueue *queue);
 void HdfMessageQueueEnqueue(
     struct HdfMessageQueue *queue, struct HdfMessage *message, long delayed);
 
+/*
+ * Returns the earliest message whose deadline has passed. If none is due yet, waits until the
+ * earliest deadline or until an earlier message is enqueued, and returns NULL.
+ */
 struct HdfMessage *HdfMessageQueueNext(struct HdfMessageQueue *queue);
+void HdfMessageQueueFlush(struct HdfMessageQueue *queue);
 
 #ifdef __cplusplus
 }
@@ -9,6 +9,7 @@
 #include "hcs_parser.h"
 #include "hcs_blob_if.h"
 #include "hcs_generate_tree.h"
+#include "hcs_tree_index.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
 
@@ -48,5 +49,17 @@ bool HcsDecompile(const char *hcsBlob, uint32_t offset, struct DeviceResourceNod
         *root = NULL;
         return false;
     }
+    if (HcsTreeIndexBuild(*root, treeMem, (uint32_t)treeMemLength) != HDF_SUCCESS) {
+        HDF_LOGW("%s: config tree index not built, config queries walk the tree", __func__);
+    }
     return true;
+}
+
+void HcsTreeRelease(struct DeviceResourceNode *root)
+{
+    if (root == NULL) {
+        return;
+    }
+    HcsTreeIndexRelease(root);
+    OsalMemFree(root);
 }
\ No newline at end of file
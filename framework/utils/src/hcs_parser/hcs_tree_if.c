@@ -8,16 +8,28 @@
 
 #include "hcs_tree_if.h"
 #include "hcs_blob_if.h"
+#include "hcs_tree_index.h"
 #include "hdf_log.h"
 
 #define HDF_LOG_TAG hcs_tree_if
 
-static struct DeviceResourceAttr *GetAttrInNode(const struct DeviceResourceNode *node, const char *attrName)
+static struct DeviceResourceAttr *GetAttrInNodeEx(const struct DeviceResourceNode *node, const char *attrName,
+    const uint32_t **elemOffsets)
 {
     struct DeviceResourceAttr *attr = NULL;
+    const struct HcsAttrIndex *attrIndex = NULL;
     if ((node == NULL) || (attrName == NULL)) {
         return NULL;
     }
+    if (HcsTreeIndexFindAttr(node, attrName, &attrIndex)) {
+        if (attrIndex == NULL) {
+            return NULL;
+        }
+        if (elemOffsets != NULL) {
+            *elemOffsets = attrIndex->elemOffsets;
+        }
+        return (struct DeviceResourceAttr *)attrIndex->attr;
+    }
     for (attr = node->attrData; attr != NULL; attr = attr->next) {
         if ((attr->name != NULL) && (strcmp(attr->name, attrName) == 0)) {
             break;
@@ -26,6 +38,11 @@ static struct DeviceResourceAttr *GetAttrInNode(const struct DeviceResourceNode
     return attr;
 }
 
+static inline struct DeviceResourceAttr *GetAttrInNode(const struct DeviceResourceNode *node, const char *attrName)
+{
+    return GetAttrInNodeEx(node, attrName, NULL);
+}
+
 bool HcsGetBool(const struct DeviceResourceNode *node, const char *attrName)
 {
     uint8_t value;
@@ -105,7 +122,7 @@ int32_t HcsGetUint64(const struct DeviceResourceNode *node, const char *attrName
     return HDF_SUCCESS;
 }
 
-static const char *GetArrayElem(const struct DeviceResourceAttr *attr, uint32_t index)
+static const char *GetArrayElem(const struct DeviceResourceAttr *attr, const uint32_t *elemOffsets, uint32_t index)
 {
     int32_t offset = HCS_WORD_LENGTH + HCS_PREFIX_LENGTH;
     uint16_t count;
@@ -119,6 +136,9 @@ static const char *GetArrayElem(const struct DeviceResourceAttr *attr, uint32_t
         HDF_LOGE("%s failed, index: %u >= count: %u", __func__, index, count);
         return NULL;
     }
+    if (elemOffsets != NULL) {
+        return attr->value + elemOffsets[index];
+    }
     for (i = 0; i < index; i++) {
         int32_t result = HcsGetDataTypeOffset(attr->value + offset);
         if (result < 0) {
@@ -133,10 +153,11 @@ int32_t HcsGetUint8ArrayElem(const struct DeviceResourceNode *node, const char *
     uint8_t *value, uint8_t def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    const uint32_t *elemOffsets = NULL;
+    struct DeviceResourceAttr *attr = GetAttrInNodeEx(node, attrName, &elemOffsets);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
-    realValue = GetArrayElem(attr, index);
+    realValue = GetArrayElem(attr, elemOffsets, index);
     if (realValue == NULL) {
         *value = def;
         HDF_LOGE("%s failed, the realValue is NULL", __func__);
@@ -154,10 +175,11 @@ int32_t HcsGetUint16ArrayElem(const struct DeviceResourceNode *node, const char
     uint16_t *value, uint16_t def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    const uint32_t *elemOffsets = NULL;
+    struct DeviceResourceAttr *attr = GetAttrInNodeEx(node, attrName, &elemOffsets);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
-    realValue = GetArrayElem(attr, index);
+    realValue = GetArrayElem(attr, elemOffsets, index);
     if (realValue == NULL) {
         *value = def;
         HDF_LOGE("%s failed, the realValue is NULL", __func__);
@@ -175,10 +197,11 @@ int32_t HcsGetUint32ArrayElem(const struct DeviceResourceNode *node, const char
     uint32_t *value, uint32_t def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    const uint32_t *elemOffsets = NULL;
+    struct DeviceResourceAttr *attr = GetAttrInNodeEx(node, attrName, &elemOffsets);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
-    realValue = GetArrayElem(attr, index);
+    realValue = GetArrayElem(attr, elemOffsets, index);
     if (realValue == NULL) {
         *value = def;
         HDF_LOGE("%s failed, the realValue is NULL", __func__);
@@ -196,10 +219,11 @@ int32_t HcsGetUint64ArrayElem(const struct DeviceResourceNode *node, const char
     uint64_t *value, uint64_t def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    const uint32_t *elemOffsets = NULL;
+    struct DeviceResourceAttr *attr = GetAttrInNodeEx(node, attrName, &elemOffsets);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
-    realValue = GetArrayElem(attr, index);
+    realValue = GetArrayElem(attr, elemOffsets, index);
     if ((realValue == NULL) || !HcsSwapToUint64(value, realValue + HCS_PREFIX_LENGTH, HcsGetPrefix(realValue))) {
         *value = def;
         HDF_LOGE("%s failed, invalid realValue (NULL) or incorrect prefix", __func__);
@@ -208,99 +232,240 @@ int32_t HcsGetUint64ArrayElem(const struct DeviceResourceNode *node, const char
     return HDF_SUCCESS;
 }
 
-#define CONTINUE_RETURN_DIFFERENT_ERRNO(ret, result) do {              \
-    if ((result) == HDF_ERR_INVALID_OBJECT) {                          \
-        (ret) = HDF_ERR_INVALID_OBJECT;                                \
-        HDF_LOGE("%s failed, the result is %d", __func__, (result));   \
-        continue;                                                      \
-    }                                                                  \
-    if ((result) != HDF_SUCCESS) {                                     \
-        HDF_LOGE("%s failed, the result is %d", __func__, (result));   \
-        return result;                                                 \
-    }                                                                  \
-} while (0)
+#define HCS_BITS_PER_BYTE 8
 
-int32_t HcsGetUint8Array(const struct DeviceResourceNode *node, const char *attrName, uint8_t *value, uint32_t len,
-    uint8_t def)
+static uint32_t GetDataTypeWidth(uint32_t type)
 {
-    int32_t ret = HDF_SUCCESS;
-    uint32_t i;
-    if ((value == NULL) || (len == 0)) {
-        HDF_LOGE("%s failed, parameter error, len: %u", __func__, len);
-        return HDF_FAILURE;
+    switch (type) {
+        case CONFIG_BYTE:
+            return sizeof(uint8_t);
+        case CONFIG_WORD:
+            return sizeof(uint16_t);
+        case CONFIG_DWORD:
+            return sizeof(uint32_t);
+        case CONFIG_QWORD:
+            return sizeof(uint64_t);
+        default:
+            return 0;
     }
+}
+
+/*
+ * Decodes count elements of the same type laid out every stride bytes. The loops have a fixed load width and stride,
+ * so the compiler can unroll and vectorize them; byte aligned blobs keep byte and word values in 32-bit slots.
+ */
+#define DEFINE_DECODE_ARRAY_RUN(name, dstType)                                                      \
+static void name(dstType *dst, const char *data, uint32_t stride, uint32_t count, uint32_t type)    \
+{                                                                                                   \
+    uint32_t i;                                                                                     \
+    if (type == CONFIG_QWORD) {                                                                     \
+        for (i = 0; i < count; i++) {                                                               \
+            dst[i] = (dstType)HcsByteCodeToUint64(data + i * stride);                               \
+        }                                                                                           \
+    } else if ((type == CONFIG_DWORD) || HcsIsByteAlign()) {                                        \
+        uint32_t mask = (uint32_t)((1ULL << (GetDataTypeWidth(type) * HCS_BITS_PER_BYTE)) - 1);     \
+        for (i = 0; i < count; i++) {                                                               \
+            dst[i] = (dstType)(HcsByteCodeToUint32(data + i * stride) & mask);                      \
+        }                                                                                           \
+    } else if (type == CONFIG_WORD) {                                                               \
+        for (i = 0; i < count; i++) {                                                               \
+            dst[i] = (dstType)HcsByteCodeToUint16(data + i * stride);                               \
+        }                                                                                           \
+    } else {                                                                                        \
+        for (i = 0; i < count; i++) {                                                               \
+            dst[i] = (dstType)HcsByteCodeToUint8(data + i * stride);                                \
+        }                                                                                           \
+    }                                                                                               \
+}
+
+DEFINE_DECODE_ARRAY_RUN(DecodeUint8ArrayRun, uint8_t)
+DEFINE_DECODE_ARRAY_RUN(DecodeUint16ArrayRun, uint16_t)
+DEFINE_DECODE_ARRAY_RUN(DecodeUint32ArrayRun, uint32_t)
+DEFINE_DECODE_ARRAY_RUN(DecodeUint64ArrayRun, uint64_t)
 
-    for (i = 0; i < len; i++) {
-        int32_t result = HcsGetUint8ArrayElem(node, attrName, i, value + i, def);
-        // If the error type is HDF_ERR_INVALID_OBJECT, the error is recorded and returned after the loop exits.
-        CONTINUE_RETURN_DIFFERENT_ERRNO(ret, result);
+static void StoreArrayValue(void *value, uint32_t width, uint32_t index, uint64_t data)
+{
+    switch (width) {
+        case sizeof(uint8_t):
+            ((uint8_t *)value)[index] = (uint8_t)data;
+            break;
+        case sizeof(uint16_t):
+            ((uint16_t *)value)[index] = (uint16_t)data;
+            break;
+        case sizeof(uint32_t):
+            ((uint32_t *)value)[index] = (uint32_t)data;
+            break;
+        default:
+            ((uint64_t *)value)[index] = data;
+            break;
     }
-    return ret;
 }
 
-int32_t HcsGetUint16Array(const struct DeviceResourceNode *node, const char *attrName, uint16_t *value, uint32_t len,
-    uint16_t def)
+/*
+ * Decodes the run of elements sharing the type of the element at start, up to maxCount of them, into value from
+ * index on. Returns the number of decoded elements, 0 if the element does not fit in width bytes.
+ */
+static uint32_t DecodeArrayRun(const char *start, uint32_t maxCount, void *value, uint32_t width, uint32_t index,
+    uint32_t *runLength)
 {
-    int32_t ret = HDF_SUCCESS;
-    uint32_t i;
-    if ((value == NULL) || (len == 0)) {
-        HDF_LOGE("%s failed, parameter error, len: %u", __func__, len);
-        return HDF_FAILURE;
+    uint32_t type = HcsGetPrefix(start);
+    uint32_t typeWidth = GetDataTypeWidth(type);
+    uint32_t stride;
+    uint32_t count = 1;
+    if ((typeWidth == 0) || (typeWidth > width)) {
+        return 0;
+    }
+    stride = (uint32_t)HcsGetDataTypeOffset(start);
+    while ((count < maxCount) && (HcsGetPrefix(start + count * stride) == type)) {
+        count++;
+    }
+
+    start += HCS_PREFIX_LENGTH;
+    switch (width) {
+        case sizeof(uint8_t):
+            DecodeUint8ArrayRun((uint8_t *)value + index, start, stride, count, type);
+            break;
+        case sizeof(uint16_t):
+            DecodeUint16ArrayRun((uint16_t *)value + index, start, stride, count, type);
+            break;
+        case sizeof(uint32_t):
+            DecodeUint32ArrayRun((uint32_t *)value + index, start, stride, count, type);
+            break;
+        default:
+            DecodeUint64ArrayRun((uint64_t *)value + index, start, stride, count, type);
+            break;
     }
+    *runLength = count * stride;
+    return count;
+}
 
-    for (i = 0; i < len; i++) {
-        int32_t result = HcsGetUint16ArrayElem(node, attrName, i, value + i, def);
-        // If the error type is HDF_ERR_INVALID_OBJECT, the error is recorded and returned after the loop exits.
-        CONTINUE_RETURN_DIFFERENT_ERRNO(ret, result);
+static bool DecodeArrayElem(const char *elem, uint32_t width, uint64_t *data)
+{
+    uint8_t value8;
+    uint16_t value16;
+    uint32_t value32;
+    bool ret;
+    switch (width) {
+        case sizeof(uint8_t):
+            ret = HcsSwapToUint8(&value8, elem + HCS_PREFIX_LENGTH, HcsGetPrefix(elem));
+            *data = value8;
+            break;
+        case sizeof(uint16_t):
+            ret = HcsSwapToUint16(&value16, elem + HCS_PREFIX_LENGTH, HcsGetPrefix(elem));
+            *data = value16;
+            break;
+        case sizeof(uint32_t):
+            ret = HcsSwapToUint32(&value32, elem + HCS_PREFIX_LENGTH, HcsGetPrefix(elem));
+            *data = value32;
+            break;
+        default:
+            ret = HcsSwapToUint64(data, elem + HCS_PREFIX_LENGTH, HcsGetPrefix(elem));
+            break;
     }
     return ret;
 }
 
-int32_t HcsGetUint32Array(const struct DeviceResourceNode *node, const char *attrName, uint32_t *value, uint32_t len,
-    uint32_t def)
+/*
+ * Decodes the first len elements of an array attribute in a single pass, with the results of calling the element
+ * getter for each index: an element wider than width gets def and HDF_ERR_INVALID_OBJECT is returned at the end
+ * (HDF_FAILURE right away for 64-bit values), running out of elements stores def and fails right away.
+ */
+static int32_t GetArrayValues(const struct DeviceResourceNode *node, const char *attrName, void *value, uint32_t len,
+    uint32_t width, uint64_t def)
 {
     int32_t ret = HDF_SUCCESS;
-    uint32_t i;
+    struct DeviceResourceAttr *attr = NULL;
+    uint32_t offset = HCS_PREFIX_LENGTH + HCS_WORD_LENGTH;
+    uint16_t count;
+    uint32_t i = 0;
     if ((value == NULL) || (len == 0)) {
         HDF_LOGE("%s failed, parameter error, len: %u", __func__, len);
         return HDF_FAILURE;
     }
 
-    for (i = 0; i < len; i++) {
-        int32_t result = HcsGetUint32ArrayElem(node, attrName, i, value + i, def);
-        // If the error type is HDF_ERR_INVALID_OBJECT, the error is recorded and returned after the loop exits.
-        CONTINUE_RETURN_DIFFERENT_ERRNO(ret, result);
+    attr = GetAttrInNode(node, attrName);
+    if ((attr == NULL) || (attr->value == NULL) || (HcsGetPrefix(attr->value) != CONFIG_ARRAY) ||
+        !HcsSwapToUint16(&count, attr->value + HCS_PREFIX_LENGTH, CONFIG_WORD)) {
+        HDF_LOGE("%s failed, the attr of %s is not array", __func__, (attrName == NULL) ? "error attrName" : attrName);
+        StoreArrayValue(value, width, 0, def);
+        return HDF_FAILURE;
+    }
+
+    while (i < len) {
+        const char *elem = attr->value + offset;
+        uint64_t data;
+        uint32_t runLength;
+        uint32_t decoded;
+        int32_t elemLength;
+        if (i >= count) {
+            HDF_LOGE("%s failed, index: %u >= count: %u", __func__, i, count);
+            StoreArrayValue(value, width, i, def);
+            return HDF_FAILURE;
+        }
+        decoded = DecodeArrayRun(elem, ((len < count) ? len : count) - i, value, width, i, &runLength);
+        if (decoded > 0) {
+            i += decoded;
+            offset += runLength;
+            continue;
+        }
+
+        if (DecodeArrayElem(elem, width, &data)) {
+            StoreArrayValue(value, width, i, data);
+        } else {
+            StoreArrayValue(value, width, i, def);
+            if (width == sizeof(uint64_t)) {
+                return HDF_FAILURE;
+            }
+            ret = HDF_ERR_INVALID_OBJECT;
+        }
+        elemLength = HcsGetDataTypeOffset(elem);
+        i++;
+        if (elemLength < 0) {
+            if (i < len) {
+                HDF_LOGE("%s failed, the element %u of %s is broken", __func__, i - 1, attrName);
+                StoreArrayValue(value, width, i, def);
+                return HDF_FAILURE;
+            }
+            break;
+        }
+        offset += (uint32_t)elemLength;
     }
     return ret;
 }
 
+int32_t HcsGetUint8Array(const struct DeviceResourceNode *node, const char *attrName, uint8_t *value, uint32_t len,
+    uint8_t def)
+{
+    return GetArrayValues(node, attrName, value, len, sizeof(*value), def);
+}
+
+int32_t HcsGetUint16Array(const struct DeviceResourceNode *node, const char *attrName, uint16_t *value, uint32_t len,
+    uint16_t def)
+{
+    return GetArrayValues(node, attrName, value, len, sizeof(*value), def);
+}
+
+int32_t HcsGetUint32Array(const struct DeviceResourceNode *node, const char *attrName, uint32_t *value, uint32_t len,
+    uint32_t def)
+{
+    return GetArrayValues(node, attrName, value, len, sizeof(*value), def);
+}
+
 int32_t HcsGetUint64Array(const struct DeviceResourceNode *node, const char *attrName, uint64_t *value, uint32_t len,
     uint64_t def)
 {
-    uint32_t i;
-    if ((value == NULL) || (len == 0)) {
-        HDF_LOGE("%s failed, parameter error, len: %u", __func__, len);
-        return HDF_FAILURE;
-    }
-
-    for (i = 0; i < len; i++) {
-        int32_t result = HcsGetUint64ArrayElem(node, attrName, i, value + i, def);
-        if (result != HDF_SUCCESS) {
-            HDF_LOGE("%s failed, the ret is %d", __func__, result);
-            return result;
-        }
-    }
-    return HDF_SUCCESS;
+    return GetArrayValues(node, attrName, value, len, sizeof(*value), def);
 }
 
 int32_t HcsGetStringArrayElem(const struct DeviceResourceNode *node, const char *attrName, uint32_t index,
     const char **value, const char *def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    const uint32_t *elemOffsets = NULL;
+    struct DeviceResourceAttr *attr = GetAttrInNodeEx(node, attrName, &elemOffsets);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
-    realValue = GetArrayElem(attr, index);
+    realValue = GetArrayElem(attr, elemOffsets, index);
     if ((realValue == NULL) || (HcsGetPrefix(realValue) != CONFIG_STRING)) {
         *value = def;
         HDF_LOGE("%s failed, %s attr is default value", __func__, attrName);
@@ -370,6 +535,9 @@ const struct DeviceResourceNode *HcsGetNodeByMatchAttr(const struct DeviceResour
         return NULL;
     }
     curNode = (node != NULL) ? node : instance->GetRootNode();
+    if ((curNode != NULL) && HcsTreeIndexFindMatchAttr(curNode, attrValue, &curNode)) {
+        return curNode;
+    }
     while (curNode != NULL) {
         if (GetAttrValueInNode(curNode, attrValue) != NULL) {
             break;
@@ -413,6 +581,9 @@ const struct DeviceResourceNode *HcsGetNodeByRefAttr(const struct DeviceResource
         return NULL;
     }
     curNode = instance->GetRootNode();
+    if ((curNode != NULL) && HcsTreeIndexFindNode(curNode, attrValue, &curNode)) {
+        return curNode;
+    }
     while (curNode != NULL) {
         if (curNode->hashValue == attrValue) {
             break;
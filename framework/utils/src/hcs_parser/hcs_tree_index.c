@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hcs_tree_index.h"
+#include "hcs_blob_if.h"
+#include "hcs_tree_if.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "osal_spinlock.h"
+
+#define HDF_LOG_TAG hcs_tree_index
+
+#define HCS_FNV_OFFSET_BASIS 2166136261U
+#define HCS_FNV_PRIME 16777619U
+#define HCS_HASH_GOLDEN 2654435761U
+#define HCS_HASH_SHIFT 16
+
+struct HcsNodeIndex {
+    const struct DeviceResourceNode *node; // NULL for a free slot
+    struct HcsAttrIndex *attrs;            // per-node attribute table, NULL if the node has no attribute
+    uint32_t attrMask;
+};
+
+struct HcsMatchIndex {
+    uint32_t valueHash;
+    const char *value;
+    const struct DeviceResourceNode *node; // NULL for a free slot
+};
+
+struct HcsTreeIndex {
+    struct HcsTreeIndex *next;
+    const struct DeviceResourceNode *root;
+    uintptr_t memStart; // the tree memory, a node belongs to this index if its address is in [memStart, memEnd)
+    uintptr_t memEnd;
+    struct HcsNodeIndex *nodes;
+    uint32_t nodeMask;
+    struct HcsMatchIndex *matches;
+    uint32_t matchMask;
+};
+
+struct HcsTreeIndexStat {
+    uint32_t nodeSlots;
+    uint32_t attrSlots;
+    uint32_t matchSlots;
+    uint32_t elemCount;
+};
+
+/*
+ * Indexes are added once their tree is fully built and removed right before the tree is freed. A tree
+ * may be built or released while queries run on another one, so the list is guarded by a lock, which is
+ * set up by the first build, as the first configuration is loaded before anything queries it.
+ */
+static struct HcsTreeIndex *g_hcsTreeIndexList = NULL;
+static OsalSpinlock g_hcsTreeIndexLock;
+static bool g_hcsTreeIndexLockReady = false;
+
+static uint32_t HcsStringHash(const char *str)
+{
+    uint32_t hash = HCS_FNV_OFFSET_BASIS;
+    while (*str != '\0') {
+        hash ^= (uint8_t)*str++;
+        hash *= HCS_FNV_PRIME;
+    }
+    return hash;
+}
+
+static inline uint32_t HcsMixHash(uint32_t value)
+{
+    value *= HCS_HASH_GOLDEN;
+    return value ^ (value >> HCS_HASH_SHIFT);
+}
+
+// The slot count keeps the load factor at most 3/4, so every probe sequence ends on a free slot.
+static uint32_t HcsTableSize(uint32_t count)
+{
+    uint32_t size = 1;
+    uint32_t need;
+    if (count == 0) {
+        return 0;
+    }
+    need = count + count / 3 + 1;
+    while (size < need) {
+        size <<= 1;
+    }
+    return size;
+}
+
+static const struct DeviceResourceNode *HcsTreeIndexNextNode(const struct DeviceResourceNode *node)
+{
+    if (node->child != NULL) {
+        return node->child;
+    }
+    while ((node->parent != NULL) && (node->sibling == NULL)) {
+        node = node->parent;
+    }
+    return node->sibling;
+}
+
+static inline bool HcsIsMatchAttr(const struct DeviceResourceAttr *attr)
+{
+    return (attr->name != NULL) && (attr->value != NULL) && (strcmp(attr->name, HCS_MATCH_ATTR) == 0);
+}
+
+static uint16_t HcsArrayElemCount(const struct DeviceResourceAttr *attr)
+{
+    uint16_t count;
+    if ((attr->value == NULL) || (HcsGetPrefix(attr->value) != CONFIG_ARRAY) ||
+        !HcsSwapToUint16(&count, attr->value + HCS_PREFIX_LENGTH, CONFIG_WORD)) {
+        return 0;
+    }
+    return count;
+}
+
+static void HcsTreeIndexCount(const struct DeviceResourceNode *root, struct HcsTreeIndexStat *stat)
+{
+    const struct DeviceResourceNode *node = NULL;
+    const struct DeviceResourceAttr *attr = NULL;
+    uint32_t nodeCount = 0;
+    uint32_t matchCount = 0;
+
+    for (node = root; node != NULL; node = HcsTreeIndexNextNode(node)) {
+        uint32_t attrCount = 0;
+        for (attr = node->attrData; attr != NULL; attr = attr->next) {
+            if (attr->name == NULL) {
+                continue;
+            }
+            attrCount++;
+            matchCount += HcsIsMatchAttr(attr) ? 1 : 0;
+            stat->elemCount += HcsArrayElemCount(attr);
+        }
+        stat->attrSlots += HcsTableSize(attrCount);
+        nodeCount++;
+    }
+    stat->nodeSlots = HcsTableSize(nodeCount);
+    stat->matchSlots = HcsTableSize(matchCount);
+}
+
+static struct HcsNodeIndex *HcsTreeIndexFindNodeEntry(const struct HcsTreeIndex *index, uint32_t hashValue)
+{
+    uint32_t slot;
+    if (index->nodes == NULL) {
+        return NULL;
+    }
+    for (slot = HcsMixHash(hashValue) & index->nodeMask; index->nodes[slot].node != NULL;
+        slot = (slot + 1) & index->nodeMask) {
+        if (index->nodes[slot].node->hashValue == hashValue) {
+            return &index->nodes[slot];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t *HcsTreeIndexFillElemOffsets(const struct DeviceResourceAttr *attr, uint32_t **elemPool)
+{
+    uint16_t count = HcsArrayElemCount(attr);
+    uint32_t *offsets = *elemPool;
+    uint32_t offset = HCS_PREFIX_LENGTH + HCS_WORD_LENGTH;
+    uint16_t i;
+    if (count == 0) {
+        return NULL;
+    }
+    *elemPool += count;
+    for (i = 0; i < count; i++) {
+        int32_t result = HcsGetDataTypeOffset(attr->value + offset);
+        if (result < 0) {
+            HDF_LOGE("%s failed, the element %u of %s is broken", __func__, i, attr->name);
+            return NULL;
+        }
+        offsets[i] = offset;
+        offset += (uint32_t)result;
+    }
+    return offsets;
+}
+
+static void HcsTreeIndexAddAttr(struct HcsNodeIndex *entry, const struct DeviceResourceAttr *attr,
+    uint32_t **elemPool)
+{
+    uint32_t nameHash = HcsStringHash(attr->name);
+    uint32_t slot;
+    for (slot = nameHash & entry->attrMask; entry->attrs[slot].attr != NULL; slot = (slot + 1) & entry->attrMask) {
+        // The attribute list is searched from its head, keep the first one of a duplicated name.
+        if ((entry->attrs[slot].nameHash == nameHash) && (strcmp(entry->attrs[slot].attr->name, attr->name) == 0)) {
+            return;
+        }
+    }
+    entry->attrs[slot].nameHash = nameHash;
+    entry->attrs[slot].attr = attr;
+    entry->attrs[slot].elemOffsets = HcsTreeIndexFillElemOffsets(attr, elemPool);
+}
+
+static void HcsTreeIndexAddMatch(struct HcsTreeIndex *index, const struct DeviceResourceNode *node,
+    const struct DeviceResourceAttr *attr)
+{
+    const char *value = attr->value + HCS_PREFIX_LENGTH;
+    uint32_t valueHash = HcsStringHash(value);
+    uint32_t slot = valueHash & index->matchMask;
+    while (index->matches[slot].node != NULL) {
+        slot = (slot + 1) & index->matchMask;
+    }
+    index->matches[slot].valueHash = valueHash;
+    index->matches[slot].value = value;
+    index->matches[slot].node = node;
+}
+
+static void HcsTreeIndexAddNode(struct HcsTreeIndex *index, const struct DeviceResourceNode *node,
+    struct HcsAttrIndex **attrPool, uint32_t **elemPool)
+{
+    const struct DeviceResourceAttr *attr = NULL;
+    uint32_t attrCount = 0;
+    uint32_t slot = HcsMixHash(node->hashValue) & index->nodeMask;
+    struct HcsNodeIndex *entry = NULL;
+
+    while (index->nodes[slot].node != NULL) {
+        slot = (slot + 1) & index->nodeMask;
+    }
+    entry = &index->nodes[slot];
+    entry->node = node;
+
+    for (attr = node->attrData; attr != NULL; attr = attr->next) {
+        attrCount += (attr->name != NULL) ? 1 : 0;
+    }
+    if (attrCount == 0) {
+        return;
+    }
+    entry->attrMask = HcsTableSize(attrCount) - 1;
+    entry->attrs = *attrPool;
+    *attrPool += entry->attrMask + 1;
+
+    for (attr = node->attrData; attr != NULL; attr = attr->next) {
+        if (attr->name == NULL) {
+            continue;
+        }
+        HcsTreeIndexAddAttr(entry, attr, elemPool);
+        if (HcsIsMatchAttr(attr)) {
+            HcsTreeIndexAddMatch(index, node, attr);
+        }
+    }
+}
+
+int32_t HcsTreeIndexBuild(const struct DeviceResourceNode *root, const char *treeMem, uint32_t treeMemLength)
+{
+    struct HcsTreeIndexStat stat = {0};
+    struct HcsTreeIndex *index = NULL;
+    struct HcsAttrIndex *attrPool = NULL;
+    uint32_t *elemPool = NULL;
+    const struct DeviceResourceNode *node = NULL;
+    size_t size;
+    char *mem = NULL;
+
+    if ((root == NULL) || (treeMem == NULL) || (treeMemLength == 0)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (!g_hcsTreeIndexLockReady) {
+        if (OsalSpinInit(&g_hcsTreeIndexLock) != HDF_SUCCESS) {
+            HDF_LOGE("%s failed, OsalSpinInit error", __func__);
+            return HDF_FAILURE;
+        }
+        g_hcsTreeIndexLockReady = true;
+    }
+    HcsTreeIndexCount(root, &stat);
+    size = sizeof(struct HcsTreeIndex) + stat.nodeSlots * sizeof(struct HcsNodeIndex) +
+        stat.attrSlots * sizeof(struct HcsAttrIndex) + stat.matchSlots * sizeof(struct HcsMatchIndex) +
+        stat.elemCount * sizeof(uint32_t);
+    mem = (char *)OsalMemCalloc(size);
+    if (mem == NULL) {
+        HDF_LOGE("%s failed, OsalMemCalloc %u bytes error", __func__, (uint32_t)size);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    index = (struct HcsTreeIndex *)mem;
+    mem += sizeof(struct HcsTreeIndex);
+    index->root = root;
+    index->memStart = (uintptr_t)treeMem;
+    index->memEnd = (uintptr_t)treeMem + treeMemLength;
+    index->nodes = (struct HcsNodeIndex *)mem;
+    index->nodeMask = stat.nodeSlots - 1;
+    mem += stat.nodeSlots * sizeof(struct HcsNodeIndex);
+    attrPool = (struct HcsAttrIndex *)mem;
+    mem += stat.attrSlots * sizeof(struct HcsAttrIndex);
+    index->matches = (stat.matchSlots > 0) ? (struct HcsMatchIndex *)mem : NULL;
+    index->matchMask = (stat.matchSlots > 0) ? (stat.matchSlots - 1) : 0;
+    mem += stat.matchSlots * sizeof(struct HcsMatchIndex);
+    elemPool = (uint32_t *)mem;
+
+    for (node = root; node != NULL; node = HcsTreeIndexNextNode(node)) {
+        HcsTreeIndexAddNode(index, node, &attrPool, &elemPool);
+    }
+
+    (void)OsalSpinLock(&g_hcsTreeIndexLock);
+    index->next = g_hcsTreeIndexList;
+    g_hcsTreeIndexList = index;
+    (void)OsalSpinUnlock(&g_hcsTreeIndexLock);
+    return HDF_SUCCESS;
+}
+
+void HcsTreeIndexRelease(const struct DeviceResourceNode *root)
+{
+    struct HcsTreeIndex **pos = &g_hcsTreeIndexList;
+    struct HcsTreeIndex *index = NULL;
+
+    if (!g_hcsTreeIndexLockReady) {
+        return;
+    }
+    (void)OsalSpinLock(&g_hcsTreeIndexLock);
+    while (*pos != NULL) {
+        if ((*pos)->root == root) {
+            index = *pos;
+            *pos = index->next;
+            break;
+        }
+        pos = &(*pos)->next;
+    }
+    (void)OsalSpinUnlock(&g_hcsTreeIndexLock);
+    OsalMemFree(index);
+}
+
+static const struct HcsTreeIndex *HcsTreeIndexOf(const struct DeviceResourceNode *node)
+{
+    const struct HcsTreeIndex *index = NULL;
+
+    if (!g_hcsTreeIndexLockReady) {
+        return NULL;
+    }
+    (void)OsalSpinLock(&g_hcsTreeIndexLock);
+    for (index = g_hcsTreeIndexList; index != NULL; index = index->next) {
+        if (((uintptr_t)node >= index->memStart) && ((uintptr_t)node < index->memEnd)) {
+            break;
+        }
+    }
+    (void)OsalSpinUnlock(&g_hcsTreeIndexLock);
+    // the index lives as long as the tree node passed in, it is only released together with the tree
+    return index;
+}
+
+bool HcsTreeIndexFindAttr(const struct DeviceResourceNode *node, const char *attrName,
+    const struct HcsAttrIndex **result)
+{
+    const struct HcsTreeIndex *index = HcsTreeIndexOf(node);
+    const struct HcsNodeIndex *entry = NULL;
+    uint32_t nameHash;
+    uint32_t slot;
+
+    if (index == NULL) {
+        return false;
+    }
+    entry = HcsTreeIndexFindNodeEntry(index, node->hashValue);
+    if ((entry == NULL) || (entry->node != node)) {
+        return false;
+    }
+    *result = NULL;
+    if (entry->attrs == NULL) {
+        return true;
+    }
+    nameHash = HcsStringHash(attrName);
+    for (slot = nameHash & entry->attrMask; entry->attrs[slot].attr != NULL; slot = (slot + 1) & entry->attrMask) {
+        if ((entry->attrs[slot].nameHash == nameHash) && (strcmp(entry->attrs[slot].attr->name, attrName) == 0)) {
+            *result = &entry->attrs[slot];
+            break;
+        }
+    }
+    return true;
+}
+
+bool HcsTreeIndexFindMatchAttr(const struct DeviceResourceNode *start, const char *attrValue,
+    const struct DeviceResourceNode **result)
+{
+    const struct HcsTreeIndex *index = HcsTreeIndexOf(start);
+    const struct DeviceResourceNode *found = NULL;
+    uint32_t valueHash;
+    uint32_t slot;
+
+    if (index == NULL) {
+        return false;
+    }
+    *result = NULL;
+    if (index->matches == NULL) {
+        return true;
+    }
+    /*
+     * Nodes are laid out in the tree memory in pre-order, so the node a walk from start would reach
+     * first is the matching node with the lowest address not below start.
+     */
+    valueHash = HcsStringHash(attrValue);
+    for (slot = valueHash & index->matchMask; index->matches[slot].node != NULL;
+        slot = (slot + 1) & index->matchMask) {
+        const struct HcsMatchIndex *match = &index->matches[slot];
+        if ((match->valueHash != valueHash) || ((uintptr_t)match->node < (uintptr_t)start) ||
+            ((found != NULL) && ((uintptr_t)match->node >= (uintptr_t)found))) {
+            continue;
+        }
+        if (strcmp(match->value, attrValue) == 0) {
+            found = match->node;
+        }
+    }
+    *result = found;
+    return true;
+}
+
+bool HcsTreeIndexFindNode(const struct DeviceResourceNode *node, uint32_t hashValue,
+    const struct DeviceResourceNode **result)
+{
+    const struct HcsTreeIndex *index = HcsTreeIndexOf(node);
+    const struct HcsNodeIndex *entry = NULL;
+    if (index == NULL) {
+        return false;
+    }
+    entry = HcsTreeIndexFindNodeEntry(index, hashValue);
+    *result = (entry != NULL) ? entry->node : NULL;
+    return true;
+}
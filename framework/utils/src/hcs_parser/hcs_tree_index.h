@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HCS_TREE_INDEX_H
+#define HCS_TREE_INDEX_H
+
+#include "device_resource_if.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
+/*
+ * Lookup tables built next to a config tree by HcsDecompile(). Every query has a fallback walking the tree,
+ * so a tree without index (out of memory, or not built by HcsDecompile) still works, only slower.
+ */
+struct HcsAttrIndex {
+    uint32_t nameHash;
+    const struct DeviceResourceAttr *attr; // NULL for a free slot
+    const uint32_t *elemOffsets;           // offset of each array element from attr->value, NULL if not an array
+};
+
+int32_t HcsTreeIndexBuild(const struct DeviceResourceNode *root, const char *treeMem, uint32_t treeMemLength);
+void HcsTreeIndexRelease(const struct DeviceResourceNode *root);
+
+/* The lookups return false if the node is not indexed, the result is only valid when they return true. */
+bool HcsTreeIndexFindAttr(const struct DeviceResourceNode *node, const char *attrName,
+    const struct HcsAttrIndex **result);
+bool HcsTreeIndexFindMatchAttr(const struct DeviceResourceNode *start, const char *attrValue,
+    const struct DeviceResourceNode **result);
+bool HcsTreeIndexFindNode(const struct DeviceResourceNode *node, uint32_t hashValue,
+    const struct DeviceResourceNode **result);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+#endif /* HCS_TREE_INDEX_H */
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "hcs_blob_if.h"
+#include "hcs_blob_writer.h"
+#include "hcs_parser.h"
+#include "hcs_tree_if.h"
+
+using namespace testing::ext;
+
+namespace HcsArrayTest {
+// byte aligned builds of the hc-gen test corpus, generated by hc_gen_hex() in the test BUILD.gn
+namespace NumberArrayAligned {
+#include "hcs_corpus_06_number_array_hex.c"
+}
+namespace LargeHslAligned {
+#include "hcs_corpus_32_large_hsl_hex.c"
+}
+
+// framework/tools/hc-gen/test/06_number_array/golden.hcb: root { module = "test"; term1 = [0x1,0x2,0xffffffffff]; }
+const unsigned char NUMBER_ARRAY_GOLDEN[] = {
+    0x0a, 0xa0, 0x0a, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x2f, 0x00, 0x00, 0x00, 0x01, 0x72, 0x6f, 0x6f, 0x74, 0x00, 0x25, 0x00, 0x00, 0x00, 0x02, 0x6d,
+    0x6f, 0x64, 0x75, 0x6c, 0x65, 0x00, 0x14, 0x74, 0x65, 0x73, 0x74, 0x00, 0x02, 0x74, 0x65, 0x72,
+    0x6d, 0x31, 0x00, 0x04, 0x03, 0x00, 0x10, 0x01, 0x10, 0x02, 0x13, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00
+};
+constexpr uint32_t LARGE_HSL_TERM_COUNT = 1000; // term0 to term996 in foo, the rest in bar
+constexpr uint32_t LARGE_HSL_FOO_TERM_COUNT = 997;
+constexpr uint32_t LARGE_ARRAY_SIZE = 4096;
+constexpr uint32_t QUERY_ROUNDS = 10;
+
+class HcsArrayTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() {}
+    void TearDown() {}
+};
+
+static struct DeviceResourceNode *LoadTree(const unsigned char *blob, uint32_t length)
+{
+    struct DeviceResourceNode *root = nullptr;
+    const char *data = reinterpret_cast<const char *>(blob);
+    // HcsCheckBlobFormat also selects the aligned or non-aligned layout for the blob
+    if (!HcsCheckBlobFormat(data, length) || !HcsDecompile(data, HBC_HEADER_LENGTH, &root)) {
+        return nullptr;
+    }
+    return root;
+}
+
+template <typename T>
+using ElemGetter = int32_t (*)(const struct DeviceResourceNode *, const char *, uint32_t, T *, T);
+template <typename T>
+using ArrayGetter = int32_t (*)(const struct DeviceResourceNode *, const char *, T *, uint32_t, T);
+
+// What the array getters returned when they called the element getter for each index.
+template <typename T>
+static int32_t GetArrayByElem(ElemGetter<T> getter, const struct DeviceResourceNode *node, const char *attrName,
+    std::vector<T> &value, T def)
+{
+    int32_t ret = HDF_SUCCESS;
+    for (uint32_t i = 0; i < value.size(); i++) {
+        int32_t result = getter(node, attrName, i, &value[i], def);
+        if ((result == HDF_ERR_INVALID_OBJECT) && (sizeof(T) != sizeof(uint64_t))) {
+            ret = result;
+            continue;
+        }
+        if (result != HDF_SUCCESS) {
+            return result;
+        }
+    }
+    return ret;
+}
+
+template <typename T>
+static void CheckArray(ArrayGetter<T> arrayGetter, ElemGetter<T> elemGetter, const struct DeviceResourceNode *node,
+    const char *attrName, uint32_t len)
+{
+    const T def = static_cast<T>(0x5a5a5a5a5a5a5a5aULL);
+    std::vector<T> bulk(len, 0);
+    std::vector<T> byElem(len, 0);
+    int32_t ret = arrayGetter(node, attrName, bulk.data(), len, def);
+    EXPECT_EQ(GetArrayByElem(elemGetter, node, attrName, byElem, def), ret) << attrName << " len " << len;
+    EXPECT_EQ(byElem, bulk) << attrName << " len " << len;
+}
+
+static void CheckAllWidths(const struct DeviceResourceNode *node, const char *attrName, uint32_t len)
+{
+    CheckArray<uint8_t>(HcsGetUint8Array, HcsGetUint8ArrayElem, node, attrName, len);
+    CheckArray<uint16_t>(HcsGetUint16Array, HcsGetUint16ArrayElem, node, attrName, len);
+    CheckArray<uint32_t>(HcsGetUint32Array, HcsGetUint32ArrayElem, node, attrName, len);
+    CheckArray<uint64_t>(HcsGetUint64Array, HcsGetUint64ArrayElem, node, attrName, len);
+}
+
+static void CheckNumberArray(const struct DeviceResourceNode *root)
+{
+    const uint64_t term1[] = {0x1, 0x2, 0xffffffffff};
+    uint64_t value64[3] = {0};
+    uint32_t value32[3] = {0};
+    uint8_t value8[3] = {0};
+
+    ASSERT_NE(root, nullptr);
+    EXPECT_EQ(HDF_SUCCESS, HcsGetUint64Array(root, "term1", value64, 3, 0));
+    for (uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(term1[i], value64[i]);
+    }
+    // the last element does not fit in 32 bits
+    EXPECT_EQ(HDF_ERR_INVALID_OBJECT, HcsGetUint32Array(root, "term1", value32, 3, 0xdead));
+    EXPECT_EQ(1u, value32[0]);
+    EXPECT_EQ(2u, value32[1]);
+    EXPECT_EQ(0xdeadu, value32[2]);
+    EXPECT_EQ(HDF_ERR_INVALID_OBJECT, HcsGetUint8Array(root, "term1", value8, 3, 0xee));
+    EXPECT_EQ(0xee, value8[2]);
+
+    for (uint32_t len = 1; len <= 4; len++) {
+        CheckAllWidths(root, "term1", len);
+        CheckAllWidths(root, "module", len);
+        CheckAllWidths(root, "not_exist", len);
+    }
+    EXPECT_EQ(HDF_FAILURE, HcsGetUint32Array(root, "term1", nullptr, 3, 0));
+    EXPECT_EQ(HDF_FAILURE, HcsGetUint32Array(root, "term1", value32, 0, 0));
+}
+
+/**
+ * @tc.name: HcsArrayCorpusTest001
+ * @tc.desc: bulk array getters on the non-aligned 06_number_array golden blob
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsArrayTest, HcsArrayCorpusTest001, TestSize.Level1)
+{
+    struct DeviceResourceNode *root = LoadTree(NUMBER_ARRAY_GOLDEN, sizeof(NUMBER_ARRAY_GOLDEN));
+    CheckNumberArray(root);
+    HcsTreeRelease(root);
+}
+
+/**
+ * @tc.name: HcsArrayCorpusTest002
+ * @tc.desc: bulk array getters on the byte aligned build of 06_number_array
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsArrayTest, HcsArrayCorpusTest002, TestSize.Level1)
+{
+    const unsigned char *blob = nullptr;
+    unsigned int length = 0;
+    NumberArrayAligned::HdfGetBuildInConfigData(&blob, &length);
+    struct DeviceResourceNode *root = LoadTree(blob, length);
+    CheckNumberArray(root);
+    HcsTreeRelease(root);
+}
+
+/**
+ * @tc.name: HcsArrayCorpusTest003
+ * @tc.desc: the terms of 32_large_hsl are scalars, array getters reject them like the element getters
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsArrayTest, HcsArrayCorpusTest003, TestSize.Level1)
+{
+    const unsigned char *blob = nullptr;
+    unsigned int length = 0;
+    LargeHslAligned::HdfGetBuildInConfigData(&blob, &length);
+    struct DeviceResourceNode *root = LoadTree(blob, length);
+    ASSERT_NE(root, nullptr);
+    const struct DeviceResourceNode *foo = HcsGetChildNode(root, "foo");
+    const struct DeviceResourceNode *bar = HcsGetChildNode(root, "bar");
+    ASSERT_NE(foo, nullptr);
+    ASSERT_NE(bar, nullptr);
+    for (uint32_t i = 0; i < LARGE_HSL_TERM_COUNT; i++) {
+        const struct DeviceResourceNode *node = (i < LARGE_HSL_FOO_TERM_COUNT) ? foo : bar;
+        std::string term = "term" + std::to_string(i);
+        uint32_t value = 0;
+        EXPECT_EQ(HDF_SUCCESS, HcsGetUint32(node, term.c_str(), &value, 0)) << term;
+        CheckAllWidths(node, term.c_str(), 1);
+    }
+    HcsTreeRelease(root);
+}
+
+/**
+ * @tc.name: HcsArrayBulkTest001
+ * @tc.desc: large uniform and mixed width arrays decode like element by element reads, and faster
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsArrayTest, HcsArrayBulkTest001, TestSize.Level1)
+{
+    std::vector<uint32_t> regs(LARGE_ARRAY_SIZE);
+    for (uint32_t i = 0; i < LARGE_ARRAY_SIZE; i++) {
+        regs[i] = i * 0x01010101U;
+    }
+    HcsTest::HcbWriter writer;
+    writer.BeginNode(HBC_ROOT_NAME);
+    writer.AttrDwordArray("regs", regs);
+    writer.AttrMixedArray("mixed", LARGE_ARRAY_SIZE, 1);
+    writer.AttrStringArray("strings", 4, 0);
+    writer.EndNode();
+    std::vector<char> &blob = writer.Finish();
+    struct DeviceResourceNode *root = LoadTree(reinterpret_cast<const unsigned char *>(blob.data()), blob.size());
+    ASSERT_NE(root, nullptr);
+
+    for (uint32_t len : {1u, 3u, LARGE_ARRAY_SIZE - 1, LARGE_ARRAY_SIZE, LARGE_ARRAY_SIZE + 1}) {
+        CheckAllWidths(root, "regs", len);
+        CheckAllWidths(root, "mixed", len);
+    }
+    CheckAllWidths(root, "strings", 4);
+
+    std::vector<uint32_t> value(LARGE_ARRAY_SIZE);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < QUERY_ROUNDS; round++) {
+        EXPECT_EQ(HDF_SUCCESS, HcsGetUint32Array(root, "regs", value.data(), LARGE_ARRAY_SIZE, 0));
+    }
+    auto bulkCost = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(regs, value);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < QUERY_ROUNDS; round++) {
+        EXPECT_EQ(HDF_SUCCESS, GetArrayByElem<uint32_t>(HcsGetUint32ArrayElem, root, "regs", value, 0));
+    }
+    auto elemCost = std::chrono::steady_clock::now() - start;
+    printf("HcsArrayTest: %u x %u dwords, bulk %lld us, by element %lld us\n", QUERY_ROUNDS, LARGE_ARRAY_SIZE,
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(bulkCost).count()),
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(elemCost).count()));
+    HcsTreeRelease(root);
+}
+} // namespace HcsArrayTest
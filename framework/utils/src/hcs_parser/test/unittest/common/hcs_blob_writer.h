@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HCS_BLOB_WRITER_H
+#define HCS_BLOB_WRITER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "hcs_blob_if.h"
+
+namespace HcsTest {
+/*
+ * Builds a non-aligned .hcb in memory, laid out the way hc-gen writes it.
+ * AttrRef() refers to nodes by the order their BeginNode() was called in, the root being node 0.
+ */
+class HcbWriter {
+public:
+    HcbWriter()
+    {
+        blob_.resize(HBC_HEADER_LENGTH);
+    }
+
+    void BeginNode(const std::string &name)
+    {
+        nodeOffsets_.push_back(Offset());
+        PutByte(CONFIG_NODE);
+        PutString(name);
+        openNodes_.push_back(blob_.size());
+        PutDword(0);
+    }
+
+    void EndNode()
+    {
+        size_t lengthPos = openNodes_.back();
+        openNodes_.pop_back();
+        uint32_t contentLength = static_cast<uint32_t>(blob_.size() - (lengthPos + sizeof(uint32_t)));
+        (void)memcpy(&blob_[lengthPos], &contentLength, sizeof(contentLength));
+    }
+
+    void AttrDword(const std::string &name, uint32_t value)
+    {
+        AttrName(name);
+        PutByte(CONFIG_DWORD);
+        PutDword(value);
+    }
+
+    void AttrString(const std::string &name, const std::string &value)
+    {
+        AttrName(name);
+        PutByte(CONFIG_STRING);
+        PutString(value);
+    }
+
+    void AttrRef(const std::string &name, uint32_t targetNode)
+    {
+        AttrName(name);
+        PutByte(CONFIG_REFERENCE);
+        refs_.emplace_back(blob_.size(), targetNode);
+        PutDword(0);
+    }
+
+    void AttrDwordArray(const std::string &name, const std::vector<uint32_t> &values)
+    {
+        AttrName(name);
+        PutByte(CONFIG_ARRAY);
+        PutWord(static_cast<uint16_t>(values.size()));
+        for (uint32_t value : values) {
+            PutByte(CONFIG_DWORD);
+            PutDword(value);
+        }
+    }
+
+    void AttrMixedArray(const std::string &name, uint32_t count, uint32_t seed)
+    {
+        AttrName(name);
+        PutByte(CONFIG_ARRAY);
+        PutWord(static_cast<uint16_t>(count));
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t value = seed + i;
+            switch (i % 4) { // cycle through the element widths so every offset differs
+                case 0:
+                    PutByte(CONFIG_BYTE);
+                    PutByte(static_cast<uint8_t>(value));
+                    break;
+                case 1:
+                    PutByte(CONFIG_WORD);
+                    PutWord(static_cast<uint16_t>(value));
+                    break;
+                case 2:
+                    PutByte(CONFIG_DWORD);
+                    PutDword(value);
+                    break;
+                default:
+                    PutByte(CONFIG_QWORD);
+                    PutDword(value);
+                    PutDword(0);
+                    break;
+            }
+        }
+    }
+
+    void AttrStringArray(const std::string &name, uint32_t count, uint32_t seed)
+    {
+        AttrName(name);
+        PutByte(CONFIG_ARRAY);
+        PutWord(static_cast<uint16_t>(count));
+        for (uint32_t i = 0; i < count; i++) {
+            PutByte(CONFIG_STRING);
+            PutString("str_" + std::to_string(seed) + "_" + std::to_string(i));
+        }
+    }
+
+    std::vector<char> &Finish()
+    {
+        for (auto &ref : refs_) {
+            uint32_t hashValue = nodeOffsets_[ref.second] + HBC_HEADER_LENGTH;
+            (void)memcpy(&blob_[ref.first], &hashValue, sizeof(hashValue));
+        }
+        struct HbcHeader header = {HBC_MAGIC_NUMBER, 1, 0, 0, static_cast<int32_t>(blob_.size() - HBC_HEADER_LENGTH)};
+        (void)memcpy(blob_.data(), &header, sizeof(header));
+        return blob_;
+    }
+
+private:
+    uint32_t Offset() const
+    {
+        return static_cast<uint32_t>(blob_.size() - HBC_HEADER_LENGTH);
+    }
+
+    void AttrName(const std::string &name)
+    {
+        PutByte(CONFIG_ATTR);
+        PutString(name);
+    }
+
+    void PutByte(uint8_t value)
+    {
+        blob_.push_back(static_cast<char>(value));
+    }
+
+    void PutWord(uint16_t value)
+    {
+        blob_.insert(blob_.end(), reinterpret_cast<char *>(&value), reinterpret_cast<char *>(&value) + sizeof(value));
+    }
+
+    void PutDword(uint32_t value)
+    {
+        blob_.insert(blob_.end(), reinterpret_cast<char *>(&value), reinterpret_cast<char *>(&value) + sizeof(value));
+    }
+
+    void PutString(const std::string &str)
+    {
+        blob_.insert(blob_.end(), str.c_str(), str.c_str() + str.size() + 1);
+    }
+
+    std::vector<char> blob_;
+    std::vector<size_t> openNodes_;     // positions of the length field of unfinished nodes
+    std::vector<uint32_t> nodeOffsets_; // node offsets in creation order, used to resolve references
+    std::vector<std::pair<size_t, uint32_t>> refs_;
+};
+} // namespace HcsTest
+
+#endif // HCS_BLOB_WRITER_H
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "hcs_blob_if.h"
+#include "hcs_blob_writer.h"
+#include "hcs_parser.h"
+#include "hcs_tree_if.h"
+#include "hcs_tree_index.h"
+
+using namespace testing::ext;
+using HcsTest::HcbWriter;
+
+namespace HcsTreeIndexTest {
+constexpr uint32_t DEVICE_COUNT = 2000;
+constexpr uint32_t ARRAY_ELEM_COUNT = 64;
+constexpr uint32_t STRING_ELEM_COUNT = 8;
+constexpr uint32_t REF_STEP = 7;
+constexpr uint32_t QUERY_ROUNDS = 3;
+
+class HcsTreeIndexTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp() {}
+    void TearDown() {}
+
+    static std::vector<char> blob_;
+    static struct DeviceResourceNode *indexedRoot_;
+    static struct DeviceResourceNode *walkRoot_;
+};
+
+std::vector<char> HcsTreeIndexTest::blob_;
+struct DeviceResourceNode *HcsTreeIndexTest::indexedRoot_ = nullptr;
+struct DeviceResourceNode *HcsTreeIndexTest::walkRoot_ = nullptr;
+
+static std::string DeviceName(uint32_t i)
+{
+    return "device_" + std::to_string(i);
+}
+
+static std::string MatchName(uint32_t i)
+{
+    return "test_hcs_index_" + std::to_string(i);
+}
+
+static int64_t NowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void HcsTreeIndexTest::SetUpTestCase()
+{
+    // root { device_N { match_attr, reg, name, mixed array, string array, ref, sub { id } } ... }
+    HcbWriter writer;
+    writer.BeginNode(HBC_ROOT_NAME);
+    for (uint32_t i = 0; i < DEVICE_COUNT; i++) {
+        writer.BeginNode(DeviceName(i));
+        writer.AttrString(HCS_MATCH_ATTR, MatchName(i));
+        writer.AttrDword("reg", i);
+        writer.AttrString("name", DeviceName(i));
+        writer.AttrMixedArray("mixed", ARRAY_ELEM_COUNT, i);
+        writer.AttrStringArray("strings", STRING_ELEM_COUNT, i);
+        // node 0 is root, device i is node 2 * i + 1 and its sub node is 2 * i + 2
+        writer.AttrRef("ref", 2 * ((i * REF_STEP) % DEVICE_COUNT) + 1);
+        writer.BeginNode("sub");
+        writer.AttrDword("id", i);
+        writer.EndNode();
+        writer.EndNode();
+    }
+    writer.EndNode();
+    blob_ = writer.Finish();
+    printf("HcsTreeIndexTest: blob %zu bytes, %u devices\n", blob_.size(), DEVICE_COUNT);
+
+    ASSERT_TRUE(HcsCheckBlobFormat(blob_.data(), blob_.size()));
+    int64_t start = NowUs();
+    ASSERT_TRUE(HcsDecompile(blob_.data(), HBC_HEADER_LENGTH, &indexedRoot_));
+    int64_t indexedCost = NowUs() - start;
+    ASSERT_TRUE(HcsDecompile(blob_.data(), HBC_HEADER_LENGTH, &walkRoot_));
+    // drop the index of the second tree so every query on it takes the walking path
+    HcsTreeIndexRelease(walkRoot_);
+    printf("HcsTreeIndexTest: decompile with index %lld us\n", static_cast<long long>(indexedCost));
+}
+
+void HcsTreeIndexTest::TearDownTestCase()
+{
+    HcsTreeRelease(indexedRoot_);
+    indexedRoot_ = nullptr;
+    HcsTreeRelease(walkRoot_);
+    walkRoot_ = nullptr;
+}
+
+static void CompareNode(const struct DeviceResourceNode *indexed, const struct DeviceResourceNode *walk)
+{
+    const struct DeviceResourceAttr *attr = nullptr;
+    for (attr = walk->attrData; attr != nullptr; attr = attr->next) {
+        uint32_t walkValue = 0;
+        uint32_t indexedValue = 0;
+        int32_t walkRet = HcsGetUint32(walk, attr->name, &walkValue, 0);
+        EXPECT_EQ(walkRet, HcsGetUint32(indexed, attr->name, &indexedValue, 0));
+        EXPECT_EQ(walkValue, indexedValue);
+
+        const char *walkStr = nullptr;
+        const char *indexedStr = nullptr;
+        walkRet = HcsGetString(walk, attr->name, &walkStr, nullptr);
+        EXPECT_EQ(walkRet, HcsGetString(indexed, attr->name, &indexedStr, nullptr));
+        if (walkRet == HDF_SUCCESS) {
+            EXPECT_STREQ(walkStr, indexedStr);
+        }
+
+        int32_t num = HcsGetElemNum(walk, attr->name);
+        ASSERT_EQ(num, HcsGetElemNum(indexed, attr->name));
+        for (int32_t i = 0; i <= num; i++) { // one past the end checks the bound on both paths
+            uint64_t walkElem = 0;
+            uint64_t indexedElem = 0;
+            walkRet = HcsGetUint64ArrayElem(walk, attr->name, i, &walkElem, 0);
+            EXPECT_EQ(walkRet, HcsGetUint64ArrayElem(indexed, attr->name, i, &indexedElem, 0));
+            EXPECT_EQ(walkElem, indexedElem);
+            walkRet = HcsGetStringArrayElem(walk, attr->name, i, &walkStr, nullptr);
+            EXPECT_EQ(walkRet, HcsGetStringArrayElem(indexed, attr->name, i, &indexedStr, nullptr));
+            if (walkRet == HDF_SUCCESS) {
+                EXPECT_STREQ(walkStr, indexedStr);
+            }
+        }
+    }
+    uint32_t value = 0;
+    EXPECT_NE(HDF_SUCCESS, HcsGetUint32(indexed, "not_exist", &value, 0));
+}
+
+/**
+ * @tc.name: HcsTreeIndexAttrTest001
+ * @tc.desc: attribute and array element queries return the same result with and without index
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsTreeIndexTest, HcsTreeIndexAttrTest001, TestSize.Level1)
+{
+    const struct DeviceResourceNode *indexed = indexedRoot_;
+    const struct DeviceResourceNode *walk = walkRoot_;
+    ASSERT_NE(indexed, nullptr);
+    ASSERT_NE(walk, nullptr);
+    for (walk = walk->child, indexed = indexed->child; walk != nullptr;
+        walk = walk->sibling, indexed = indexed->sibling) {
+        ASSERT_NE(indexed, nullptr);
+        ASSERT_EQ(walk->hashValue, indexed->hashValue);
+        CompareNode(indexed, walk);
+        CompareNode(indexed->child, walk->child);
+    }
+}
+
+/**
+ * @tc.name: HcsTreeIndexMatchAttrTest001
+ * @tc.desc: match_attr queries find the node a pre-order walk from the start node finds
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsTreeIndexTest, HcsTreeIndexMatchAttrTest001, TestSize.Level1)
+{
+    const struct DeviceResourceNode *middle = HcsGetChildNode(indexedRoot_, DeviceName(DEVICE_COUNT / 2).c_str());
+    ASSERT_NE(middle, nullptr);
+    for (uint32_t i = 0; i < DEVICE_COUNT; i++) {
+        std::string match = MatchName(i);
+        const struct DeviceResourceNode *walk = HcsGetNodeByMatchAttr(walkRoot_, match.c_str());
+        const struct DeviceResourceNode *indexed = HcsGetNodeByMatchAttr(indexedRoot_, match.c_str());
+        ASSERT_NE(walk, nullptr);
+        ASSERT_NE(indexed, nullptr);
+        EXPECT_EQ(walk->hashValue, indexed->hashValue);
+        EXPECT_STREQ(indexed->name, DeviceName(i).c_str());
+        // only nodes from the start node on are searched
+        indexed = HcsGetNodeByMatchAttr(middle, match.c_str());
+        EXPECT_EQ(indexed != nullptr, i >= DEVICE_COUNT / 2);
+    }
+    EXPECT_EQ(HcsGetNodeByMatchAttr(indexedRoot_, "not_exist"), nullptr);
+}
+
+/**
+ * @tc.name: HcsTreeIndexRefTest001
+ * @tc.desc: references resolve to the node with the referenced hash value
+ * @tc.type: FUNC
+ */
+HWTEST_F(HcsTreeIndexTest, HcsTreeIndexRefTest001, TestSize.Level1)
+{
+    const struct DeviceResourceNode *device = nullptr;
+    const struct DeviceResourceNode *result = nullptr;
+    EXPECT_FALSE(HcsTreeIndexFindNode(walkRoot_, indexedRoot_->hashValue, &result));
+    for (device = indexedRoot_->child; device != nullptr; device = device->sibling) {
+        uint32_t reg = 0;
+        uint32_t hashValue = 0;
+        const struct DeviceResourceAttr *attr = device->attrData;
+        while ((attr != nullptr) && (strcmp(attr->name, "ref") != 0)) {
+            attr = attr->next;
+        }
+        ASSERT_NE(attr, nullptr);
+        ASSERT_TRUE(HcsSwapToUint32(&hashValue, attr->value + HCS_PREFIX_LENGTH, CONFIG_DWORD));
+        ASSERT_TRUE(HcsTreeIndexFindNode(indexedRoot_, hashValue, &result));
+        ASSERT_NE(result, nullptr);
+        EXPECT_EQ(result->hashValue, hashValue);
+        ASSERT_EQ(HDF_SUCCESS, HcsGetUint32(device, "reg", &reg, 0));
+        EXPECT_STREQ(result->name, DeviceName((reg * REF_STEP) % DEVICE_COUNT).c_str());
+    }
+    EXPECT_TRUE(HcsTreeIndexFindNode(indexedRoot_, 0, &result));
+    EXPECT_EQ(result, nullptr);
+}
+
+static int64_t RunQueries(const struct DeviceResourceNode *root)
+{
+    int64_t start = NowUs();
+    for (uint32_t round = 0; round < QUERY_ROUNDS; round++) {
+        for (uint32_t i = 0; i < DEVICE_COUNT; i++) {
+            uint32_t value = 0;
+            const struct DeviceResourceNode *node = HcsGetNodeByMatchAttr(root, MatchName(i).c_str());
+            EXPECT_NE(node, nullptr);
+            EXPECT_EQ(HDF_SUCCESS, HcsGetUint32(node, "reg", &value, 0));
+            EXPECT_EQ(HDF_SUCCESS, HcsGetUint32ArrayElem(node, "mixed", ARRAY_ELEM_COUNT - 2, &value, 0));
+        }
+    }
+    return NowUs() - start;
+}
+
+/**
+ * @tc.name: HcsTreeIndexPerfTest001
+ * @tc.desc: config query cost on a large tree, with and without index
+ * @tc.type: PERF
+ */
+HWTEST_F(HcsTreeIndexTest, HcsTreeIndexPerfTest001, TestSize.Level1)
+{
+    int64_t walkCost = RunQueries(walkRoot_);
+    int64_t indexedCost = RunQueries(indexedRoot_);
+    uint32_t queries = QUERY_ROUNDS * DEVICE_COUNT;
+    printf("HcsTreeIndexTest: %u match_attr + attr + array element queries, walk %lld us, index %lld us\n",
+        queries, static_cast<long long>(walkCost), static_cast<long long>(indexedCost));
+    EXPECT_LT(indexedCost, walkCost);
+}
+} // namespace HcsTreeIndexTest
@@ -15,26 +15,52 @@
 #include "osal_mem.h"
 #include "securec.h"
 
-struct MapNode {
+struct MapSlot {
     uint32_t hash;
+    uint32_t distance; /**< probe distance from the home slot */
+    struct MapNode *node; /**< NULL for an empty slot */
+};
+
+/* value and the NUL terminated key follow the node header in the same allocation */
+struct MapNode {
     uint32_t valueSize;
-    void *key;
-    void *value;
-    struct MapNode *next;
+    uint32_t allocSize;
+    struct MapNode *next; /**< link in the free node list */
+};
+
+struct MapArenaChunk {
+    struct MapArenaChunk *next;
+    uint32_t size;
+    uint32_t used;
 };
 
 #define HDF_MIN_MAP_SIZE 8
-#define HDF_ENLARGE_FACTOR 2
+#define HDF_ENLARGE_FACTOR 1
+#define HDF_MAP_LOAD_NUM 3
+#define HDF_MAP_LOAD_DEN 4
 #define HDF_MAP_KEY_MAX_SIZE 1000
 #define HDF_MAP_VALUE_MAX_SIZE 1000
+#define HDF_MAP_NODE_ALIGN 8
+#define HDF_MAP_ARENA_CHUNK_SIZE 4096
+#define HDF_MAP_CLASS_MIN_SHIFT 5
+#define HDF_MAP_HASH_MIX 0x9E3779B1U
+#define HDF_MAP_HASH_MIX_SHIFT 15
+
+#define HDF_MAP_ALIGN(size) (((size) + HDF_MAP_NODE_ALIGN - 1) & ~(HDF_MAP_NODE_ALIGN - 1))
+#define HDF_MAP_CHUNK_HEAD_SIZE HDF_MAP_ALIGN(sizeof(struct MapArenaChunk))
+#define HDF_MAP_NODE_HEAD_SIZE HDF_MAP_ALIGN(sizeof(struct MapNode))
 
 const uint32_t HASH_SEED = 131;
 
 /* BKDR Hash */
-static uint32_t MapHash(const char *hashKey)
+uint32_t MapHash(const char *hashKey)
 {
     uint32_t hashValue = 0;
 
+    if (hashKey == NULL) {
+        return 0;
+    }
+
     while (*hashKey) {
         hashValue = hashValue * HASH_SEED + (*hashKey++);
     }
@@ -44,44 +70,166 @@ static uint32_t MapHash(const char *hashKey)
 
 static uint32_t MapHashIdx(const Map *map, uint32_t hash)
 {
-    return (hash & (map->bucketSize - 1));
+    // BKDR hashes of similar keys are close together, spread them before linear probing
+    uint32_t mixed = hash * HDF_MAP_HASH_MIX;
+    mixed ^= mixed >> HDF_MAP_HASH_MIX_SHIFT;
+    return (mixed & (map->bucketSize - 1));
+}
+
+static inline uint32_t MapNextIdx(const Map *map, uint32_t idx)
+{
+    return ((idx + 1) & (map->bucketSize - 1));
+}
+
+static inline void *MapNodeValue(const struct MapNode *node)
+{
+    return (uint8_t *)node + HDF_MAP_NODE_HEAD_SIZE;
+}
+
+static inline char *MapNodeKey(const struct MapNode *node)
+{
+    return (char *)node + HDF_MAP_NODE_HEAD_SIZE + HDF_MAP_ALIGN(node->valueSize);
+}
+
+/* classes are 32, 48, 64, 96, 128 ... 2048 bytes, two per power of two */
+static inline uint32_t MapClassSize(uint32_t sizeClass)
+{
+    uint32_t base = 1U << (HDF_MAP_CLASS_MIN_SHIFT + sizeClass / 2);
+    return (sizeClass % 2 == 0) ? base : (base + base / 2);
 }
 
-static void MapAddNode(Map *map, struct MapNode *node)
+static uint32_t MapSizeClass(uint32_t size)
 {
-    uint32_t idx = MapHashIdx(map, node->hash);
-    node->next = map->nodes[idx];
-    map->nodes[idx] = node;
+    uint32_t sizeClass = 0;
+
+    while (sizeClass < HDF_MAP_SIZE_CLASS_NUM - 1 && MapClassSize(sizeClass) < size) {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+static struct MapNode *MapArenaAlloc(Map *map, uint32_t size)
+{
+    struct MapArenaChunk *chunk = NULL;
+    uint32_t sizeClass = MapSizeClass(size);
+    uint32_t chunkSize;
+    struct MapNode *node = NULL;
+
+    // every erased node of the class fits, so the arena only grows with the live nodes
+    node = map->freeNodes[sizeClass];
+    if (node != NULL && node->allocSize >= size) {
+        map->freeNodes[sizeClass] = node->next;
+        return node;
+    }
+    size = (MapClassSize(sizeClass) < size) ? HDF_MAP_ALIGN(size) : MapClassSize(sizeClass);
+
+    chunk = map->chunks;
+    if (chunk != NULL && chunk->size - chunk->used >= size) {
+        node = (struct MapNode *)((uint8_t *)chunk + chunk->used);
+        chunk->used += size;
+        node->allocSize = size;
+        return node;
+    }
+
+    chunkSize = HDF_MAP_CHUNK_HEAD_SIZE + size;
+    chunkSize = (chunkSize < HDF_MAP_ARENA_CHUNK_SIZE) ? HDF_MAP_ARENA_CHUNK_SIZE : chunkSize;
+    chunk = (struct MapArenaChunk *)OsalMemAlloc(chunkSize);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->size = chunkSize;
+    chunk->used = HDF_MAP_CHUNK_HEAD_SIZE + size;
+    // keep bump allocating from the chunk with more room left
+    if (map->chunks != NULL && chunk->size - chunk->used < map->chunks->size - map->chunks->used) {
+        chunk->next = map->chunks->next;
+        map->chunks->next = chunk;
+    } else {
+        chunk->next = map->chunks;
+        map->chunks = chunk;
+    }
+
+    node = (struct MapNode *)((uint8_t *)chunk + HDF_MAP_CHUNK_HEAD_SIZE);
+    node->allocSize = size;
+    return node;
+}
+
+static void MapArenaFree(Map *map, struct MapNode *node)
+{
+    uint32_t sizeClass = MapSizeClass(node->allocSize);
+
+    node->next = map->freeNodes[sizeClass];
+    map->freeNodes[sizeClass] = node;
+}
+
+static void MapArenaRelease(Map *map)
+{
+    struct MapArenaChunk *chunk = map->chunks;
+    struct MapArenaChunk *next = NULL;
+
+    while (chunk != NULL) {
+        next = chunk->next;
+        OsalMemFree(chunk);
+        chunk = next;
+    }
+    map->chunks = NULL;
+    (void)memset_s(map->freeNodes, sizeof(map->freeNodes), 0, sizeof(map->freeNodes));
+}
+
+uint32_t MapArenaSize(const Map *map)
+{
+    uint32_t size = 0;
+    const struct MapArenaChunk *chunk = NULL;
+
+    if (map == NULL) {
+        return 0;
+    }
+    for (chunk = map->chunks; chunk != NULL; chunk = chunk->next) {
+        size += chunk->size;
+    }
+    return size;
+}
+
+static void MapSlotInsert(Map *map, struct MapSlot entry)
+{
+    struct MapSlot tmp;
+    uint32_t idx = MapHashIdx(map, entry.hash);
+
+    entry.distance = 0;
+    while (map->slots[idx].node != NULL) {
+        // Robin Hood: the entry further from its home slot takes the place
+        if (map->slots[idx].distance < entry.distance) {
+            tmp = map->slots[idx];
+            map->slots[idx] = entry;
+            entry = tmp;
+        }
+        idx = MapNextIdx(map, idx);
+        entry.distance++;
+    }
+    map->slots[idx] = entry;
 }
 
 static int32_t MapResize(Map *map, uint32_t size)
 {
     uint32_t bucketSize;
-    struct MapNode **nodes = NULL;
-    struct MapNode **tmp = NULL;
+    struct MapSlot *slots = NULL;
+    struct MapSlot *tmp = NULL;
     uint32_t i;
 
-    nodes = (struct MapNode **)OsalMemCalloc(size * sizeof(*nodes));
-    if (nodes == NULL) {
+    slots = (struct MapSlot *)OsalMemCalloc(size * sizeof(*slots));
+    if (slots == NULL) {
         return HDF_ERR_MALLOC_FAIL;
     }
 
-    tmp = map->nodes;
+    tmp = map->slots;
     bucketSize = map->bucketSize;
-    map->nodes = nodes;
+    map->slots = slots;
     map->bucketSize = size;
 
     if (tmp != NULL) {
-        struct MapNode *node = NULL;
-        struct MapNode *next = NULL;
-
         /* remap node with new map size */
         for (i = 0; i < bucketSize; i++) {
-            node = tmp[i];
-            while (node != NULL) {
-                next = node->next;
-                MapAddNode(map, node);
-                node = next;
+            if (tmp[i].node != NULL) {
+                MapSlotInsert(map, tmp[i]);
             }
         }
 
@@ -91,140 +239,177 @@ static int32_t MapResize(Map *map, uint32_t size)
     return HDF_SUCCESS;
 }
 
-static struct MapNode *MapCreateNode(const char *key, uint32_t hash,
-    const void *value, uint32_t valueSize)
+static struct MapSlot *MapFindSlot(const Map *map, const char *key, uint32_t hash)
+{
+    uint32_t idx;
+    uint32_t distance = 0;
+    struct MapSlot *slot = NULL;
+
+    if (map->nodeSize == 0 || map->slots == NULL) {
+        return NULL;
+    }
+
+    idx = MapHashIdx(map, hash);
+    while (true) {
+        slot = &map->slots[idx];
+        // an entry closer to home than we are means the key is absent
+        if (slot->node == NULL || slot->distance < distance) {
+            return NULL;
+        }
+        if (slot->hash == hash) {
+            const char *nodeKey = MapNodeKey(slot->node);
+            if (nodeKey == key || strcmp(nodeKey, key) == 0) {
+                return slot;
+            }
+        }
+        idx = MapNextIdx(map, idx);
+        distance++;
+    }
+}
+
+static struct MapNode *MapCreateNode(Map *map, const char *key, const void *value, uint32_t valueSize)
 {
     uint32_t keySize = strlen(key) + 1;
-    struct MapNode *node = (struct MapNode *)OsalMemCalloc(sizeof(*node) + keySize + valueSize);
+    uint32_t valueAllocSize = HDF_MAP_ALIGN(valueSize);
+    struct MapNode *node = MapArenaAlloc(map, HDF_MAP_NODE_HEAD_SIZE + valueAllocSize + keySize);
     if (node == NULL) {
         return NULL;
     }
 
-    node->hash = hash;
-    node->key = (uint8_t *)node + sizeof(*node);
-    node->value = (uint8_t *)node + sizeof(*node) + keySize;
     node->valueSize = valueSize;
-    if (memcpy_s(node->key, keySize, key, keySize) != EOK) {
-        OsalMemFree(node);
+    node->next = NULL;
+    if (memcpy_s(MapNodeKey(node), keySize, key, keySize) != EOK) {
+        MapArenaFree(map, node);
         return NULL;
     }
-    if (memcpy_s(node->value, node->valueSize, value, valueSize) != EOK) {
-        OsalMemFree(node);
+    if (memcpy_s(MapNodeValue(node), valueAllocSize, value, valueSize) != EOK) {
+        MapArenaFree(map, node);
         return NULL;
     }
 
     return node;
 }
 
-int32_t MapSet(Map *map, const char *key, const void *value, uint32_t valueSize)
+int32_t MapSetWithHash(Map *map, const char *key, uint32_t hash, const void *value, uint32_t valueSize)
 {
     struct MapNode *node = NULL;
-    uint32_t hash;
+    struct MapSlot *slot = NULL;
+    struct MapSlot entry;
+    int32_t ret;
+
     if (map == NULL || key == NULL || value == NULL || valueSize == 0) {
         return HDF_ERR_INVALID_PARAM;
     }
     if (valueSize > HDF_MAP_KEY_MAX_SIZE || strlen(key) > HDF_MAP_VALUE_MAX_SIZE) {
         return HDF_ERR_INVALID_PARAM;
     }
-    hash = MapHash(key);
-    if (map->nodeSize > 0 && map->nodes != NULL) {
-        uint32_t idx = MapHashIdx(map, hash);
-        node = map->nodes[idx];
-        while (node != NULL) {
-            if (node->hash != hash || node->key == NULL || strcmp(node->key, key) != 0) {
-                node = node->next;
-                continue;
-            }
-
-            // size mismatch
-            if (node->value == NULL || node->valueSize != valueSize) {
-                return HDF_ERR_INVALID_OBJECT;
-            }
-            // update k-v node
-            if (memcpy_s(node->value, node->valueSize, value, valueSize) != EOK) {
-                return HDF_FAILURE;
-            }
-
-            return HDF_SUCCESS;
+    slot = MapFindSlot(map, key, hash);
+    if (slot != NULL) {
+        node = slot->node;
+        // size mismatch
+        if (node->valueSize != valueSize) {
+            return HDF_ERR_INVALID_OBJECT;
         }
+        // update k-v node
+        if (memcpy_s(MapNodeValue(node), node->valueSize, value, valueSize) != EOK) {
+            return HDF_FAILURE;
+        }
+
+        return HDF_SUCCESS;
     }
-    // Increase the bucket size when nodes is nullptr
-    if (map->nodes == NULL) {
-        MapInit(map);
-        MapResize(map, HDF_MIN_MAP_SIZE);
-    }
-    // Increase the bucket size to decrease the possibility of map search conflict.
-    if (map->nodeSize >= map->bucketSize) {
+    // Increase the bucket size to keep probe sequences short.
+    if (map->slots == NULL || (map->nodeSize + 1) * HDF_MAP_LOAD_DEN > map->bucketSize * HDF_MAP_LOAD_NUM) {
         uint32_t size = (map->bucketSize < HDF_MIN_MAP_SIZE) ? HDF_MIN_MAP_SIZE : \
             (map->bucketSize << HDF_ENLARGE_FACTOR);
-        MapResize(map, size);
+        ret = MapResize(map, size);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
     }
-    node = MapCreateNode(key, hash, value, valueSize);
+    node = MapCreateNode(map, key, value, valueSize);
     if (node == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
-    MapAddNode(map, node);
+    entry.hash = hash;
+    entry.distance = 0;
+    entry.node = node;
+    MapSlotInsert(map, entry);
     map->nodeSize++;
     return HDF_SUCCESS;
 }
 
-void* MapGet(const Map *map, const char *key)
+int32_t MapSet(Map *map, const char *key, const void *value, uint32_t valueSize)
 {
-    uint32_t hash;
-    uint32_t idx;
-    struct MapNode *node = NULL;
+    if (key == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return MapSetWithHash(map, key, MapHash(key), value, valueSize);
+}
 
-    if (map == NULL || key == NULL || map->nodeSize == 0 || map->nodes == NULL) {
+void *MapGetWithHash(const Map *map, const char *key, uint32_t hash)
+{
+    struct MapSlot *slot = NULL;
+
+    if (map == NULL || key == NULL) {
         return NULL;
     }
 
-    hash = MapHash(key);
-    idx = MapHashIdx(map, hash);
-    node = map->nodes[idx];
-
-    while (node != NULL) {
-        if (node->hash == hash && node->key != NULL && !strcmp(node->key, key)) {
-            return node->value;
-        }
+    slot = MapFindSlot(map, key, hash);
+    return (slot != NULL) ? MapNodeValue(slot->node) : NULL;
+}
 
-        node = node->next;
+void* MapGet(const Map *map, const char *key)
+{
+    if (map == NULL || key == NULL || map->nodeSize == 0) {
+        return NULL;
     }
 
-    return NULL;
+    return MapGetWithHash(map, key, MapHash(key));
 }
 
-int32_t MapErase(Map *map, const char *key)
+int32_t MapEraseWithHash(Map *map, const char *key, uint32_t hash)
 {
-    uint32_t hash;
     uint32_t idx;
-    struct MapNode *node = NULL;
-    struct MapNode *prev = NULL;
+    uint32_t next;
+    struct MapSlot *slot = NULL;
 
-    if (map == NULL || key == NULL || map->nodeSize == 0 || map->nodes == NULL) {
+    if (map == NULL || key == NULL || map->nodeSize == 0 || map->slots == NULL) {
         return HDF_ERR_INVALID_PARAM;
     }
 
-    hash = MapHash(key);
-    idx = MapHashIdx(map, hash);
-    node = map->nodes[idx];
-    prev = node;
-
-    while (node != NULL) {
-        if (node->hash == hash && node->key != NULL && !strcmp(node->key, key)) {
-            if (map->nodes[idx] == node) {
-                map->nodes[idx] = node->next;
-            } else {
-                prev->next = node->next;
-            }
-            OsalMemFree(node);
-            map->nodeSize--;
-            return HDF_SUCCESS;
-        }
-        prev = node;
-        node = node->next;
+    slot = MapFindSlot(map, key, hash);
+    if (slot == NULL) {
+        return HDF_FAILURE;
     }
+    MapArenaFree(map, slot->node);
+
+    // backward shift deletion keeps the probe sequences free of tombstones
+    idx = (uint32_t)(slot - map->slots);
+    next = MapNextIdx(map, idx);
+    while (map->slots[next].node != NULL && map->slots[next].distance > 0) {
+        map->slots[idx] = map->slots[next];
+        map->slots[idx].distance--;
+        idx = next;
+        next = MapNextIdx(map, next);
+    }
+    map->slots[idx].node = NULL;
+    map->slots[idx].hash = 0;
+    map->slots[idx].distance = 0;
+    map->nodeSize--;
+    if (map->nodeSize == 0) {
+        // nothing refers to the arena any more, give it back instead of keeping erased nodes around
+        MapArenaRelease(map);
+    }
+    return HDF_SUCCESS;
+}
 
-    return HDF_FAILURE;
+int32_t MapErase(Map *map, const char *key)
+{
+    if (map == NULL || key == NULL || map->nodeSize == 0 || map->slots == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    return MapEraseWithHash(map, key, MapHash(key));
 }
 
 void MapInit(Map *map)
@@ -233,34 +418,21 @@ void MapInit(Map *map)
         return;
     }
 
-    map->nodes = NULL;
+    map->slots = NULL;
     map->nodeSize = 0;
     map->bucketSize = 0;
+    map->chunks = NULL;
+    (void)memset_s(map->freeNodes, sizeof(map->freeNodes), 0, sizeof(map->freeNodes));
 }
 
 void MapDelete(Map *map)
 {
-    uint32_t i;
-    struct MapNode *node = NULL;
-    struct MapNode *next = NULL;
-
-    if (map == NULL || map->nodes == NULL) {
+    if (map == NULL) {
         return;
     }
 
-    for (i = 0; i < map->bucketSize; i++) {
-        node = map->nodes[i];
-        while (node != NULL) {
-            next = node->next;
-            OsalMemFree(node);
-            node = next;
-        }
-    }
-
-    OsalMemFree(map->nodes);
+    MapArenaRelease(map);
+    OsalMemFree(map->slots);
 
-    map->nodes = NULL;
-    map->nodeSize = 0;
-    map->bucketSize = 0;
+    MapInit(map);
 }
-
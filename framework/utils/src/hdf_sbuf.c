@@ -10,6 +10,9 @@
 #include "hdf_log.h"
 #include "hdf_sbuf_impl.h"
 #include "osal_mem.h"
+#ifdef HDF_SBUF_POOL_ENABLE
+#include <pthread.h>
+#endif
 
 #define HDF_SBUF_DEFAULT_SIZE 256
 #define HDF_SBUF_IMPL_CHECK_RETURN(sbuf, api, retCode)               \
@@ -39,6 +42,7 @@
 struct HdfSBuf {
     struct HdfSBufImpl *impl;
     uint32_t type;
+    bool isPooled;
 };
 
 struct HdfSBufImpl *SbufObtainRaw(size_t capacity);
@@ -130,6 +134,45 @@ bool HdfSbufReadBuffer(struct HdfSBuf *sbuf, const void **data, uint32_t *readSi
     return sbuf->impl->readBuffer(sbuf->impl, (const uint8_t **)data, readSize);
 }
 
+bool HdfSbufWriteBufferRef(struct HdfSBuf *sbuf, const void *data, uint32_t writeSize)
+{
+    HDF_SBUF_IMPL_CHECK_RETURN(sbuf, writeBuffer, false);
+    if (sbuf->impl->writeBufferRef == NULL) {
+        return sbuf->impl->writeBuffer(sbuf->impl, (const uint8_t *)data, writeSize);
+    }
+    return sbuf->impl->writeBufferRef(sbuf->impl, (const uint8_t *)data, writeSize);
+}
+
+bool HdfSbufReadBufferRef(struct HdfSBuf *sbuf, const void **data, uint32_t *readSize)
+{
+    HDF_SBUF_IMPL_CHECK_RETURN(sbuf, readBuffer, false);
+    if (sbuf->impl->readBufferRef == NULL) {
+        return sbuf->impl->readBuffer(sbuf->impl, (const uint8_t **)data, readSize);
+    }
+    return sbuf->impl->readBufferRef(sbuf->impl, (const uint8_t **)data, readSize);
+}
+
+int32_t HdfSbufForEachSegment(struct HdfSBuf *sbuf, HdfSbufSegmentFunc func, void *priv)
+{
+    const uint8_t *data = NULL;
+    size_t size;
+
+    HDF_SBUF_IMPL_CHECK_RETURN(sbuf, getData, HDF_ERR_INVALID_OBJECT);
+    if (func == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (sbuf->impl->forEachSegment != NULL) {
+        return sbuf->impl->forEachSegment(sbuf->impl, func, priv);
+    }
+
+    size = HdfSbufGetDataSize(sbuf);
+    data = sbuf->impl->getData(sbuf->impl);
+    if (size == 0) {
+        return HDF_SUCCESS;
+    }
+    return (data != NULL) ? func(priv, data, size) : HDF_FAILURE;
+}
+
 bool HdfSbufWriteUint64(struct HdfSBuf *sbuf, uint64_t value)
 {
     HDF_SBUF_IMPL_CHECK_RETURN(sbuf, writeUint64, false);
@@ -330,6 +373,7 @@ struct HdfSBuf *HdfSbufTypedObtainCapacity(uint32_t type, size_t capacity)
         return NULL;
     }
     sbuf->type = type;
+    sbuf->isPooled = false;
     return sbuf;
 }
 
@@ -348,6 +392,7 @@ struct HdfSBuf *HdfSbufTypedObtainInplace(uint32_t type, struct HdfSBufImpl *imp
 
     sbuf->impl = impl;
     sbuf->type = type;
+    sbuf->isPooled = false;
     return sbuf;
 }
 
@@ -383,6 +428,7 @@ struct HdfSBuf *HdfSbufTypedBind(uint32_t type, uintptr_t base, size_t size)
         return NULL;
     }
     sbuf->type = type;
+    sbuf->isPooled = false;
     return sbuf;
 }
 
@@ -420,6 +466,7 @@ struct HdfSBuf *HdfSbufCopy(const struct HdfSBuf *sbuf)
         return NULL;
     }
     newBuf->type = sbuf->type;
+    newBuf->isPooled = false;
     return newBuf;
 }
 
@@ -436,6 +483,8 @@ struct HdfSBuf *HdfSbufMove(struct HdfSBuf *sbuf)
         OsalMemFree(newBuf);
         return NULL;
     }
+    newBuf->type = sbuf->type;
+    newBuf->isPooled = false;
     return newBuf;
 }
 
@@ -445,20 +494,170 @@ void HdfSbufTransDataOwnership(struct HdfSBuf *sbuf)
     sbuf->impl->transDataOwnership(sbuf->impl);
 }
 
-void HdfSbufRecycle(struct HdfSBuf *sbuf)
+#ifdef HDF_SBUF_POOL_ENABLE
+#define HDF_SBUF_POOL_CLASS_NUM 5
+#define HDF_SBUF_POOL_CLASS_DEPTH 4
+
+static const size_t g_sbufPoolClassSize[HDF_SBUF_POOL_CLASS_NUM] = { 256, 1024, 4096, 16384, 65536 };
+
+struct HdfSbufPoolCache {
+    struct HdfSBuf *bufs[HDF_SBUF_POOL_CLASS_NUM][HDF_SBUF_POOL_CLASS_DEPTH];
+    uint32_t count[HDF_SBUF_POOL_CLASS_NUM];
+    struct HdfSbufPoolStat stat;
+    bool registered;
+    bool released;  // the thread is exiting, later recycles free their buffers directly
+};
+
+static __thread struct HdfSbufPoolCache g_sbufPoolCache;
+static pthread_key_t g_sbufPoolKey;
+static pthread_once_t g_sbufPoolOnce = PTHREAD_ONCE_INIT;
+static bool g_sbufPoolKeyValid = false;
+
+static void HdfSbufFree(struct HdfSBuf *sbuf)
+{
+    if (sbuf->impl != NULL && sbuf->impl->recycle != NULL) {
+        sbuf->impl->recycle(sbuf->impl);
+        sbuf->impl = NULL;
+    }
+    OsalMemFree(sbuf);
+}
+
+static void HdfSbufPoolCacheRelease(void *data)
+{
+    struct HdfSbufPoolCache *cache = (struct HdfSbufPoolCache *)data;
+    uint32_t i;
+
+    cache->released = true;
+    for (i = 0; i < HDF_SBUF_POOL_CLASS_NUM; i++) {
+        while (cache->count[i] > 0) {
+            HdfSbufFree(cache->bufs[i][--cache->count[i]]);
+        }
+    }
+}
+
+static void HdfSbufPoolKeyCreate(void)
+{
+    g_sbufPoolKeyValid = (pthread_key_create(&g_sbufPoolKey, HdfSbufPoolCacheRelease) == 0);
+}
+
+/*
+ * The thread cache is only filled once its release on thread exit has been registered, and no more once
+ * it has been released, as destructors of other keys may still recycle buffers after it.
+ */
+static struct HdfSbufPoolCache *HdfSbufPoolGetCache(void)
+{
+    struct HdfSbufPoolCache *cache = &g_sbufPoolCache;
+    if (cache->released) {
+        return NULL;
+    }
+    if (!cache->registered) {
+        (void)pthread_once(&g_sbufPoolOnce, HdfSbufPoolKeyCreate);
+        if (!g_sbufPoolKeyValid || pthread_setspecific(g_sbufPoolKey, cache) != 0) {
+            return NULL;
+        }
+        cache->registered = true;
+    }
+    return cache;
+}
+
+static int32_t HdfSbufPoolClassIndex(size_t capacity)
+{
+    int32_t i;
+    for (i = 0; i < HDF_SBUF_POOL_CLASS_NUM; i++) {
+        if (capacity <= g_sbufPoolClassSize[i]) {
+            return i;
+        }
+    }
+    return HDF_FAILURE;
+}
+
+struct HdfSBuf *HdfSbufObtainPooled(size_t capacity)
 {
+    struct HdfSBuf *sbuf = NULL;
+    struct HdfSbufPoolCache *cache = HdfSbufPoolGetCache();
+    int32_t index = HdfSbufPoolClassIndex(capacity);
+
+    if (cache == NULL || index < 0) {
+        return HdfSbufObtain(capacity);
+    }
+
+    if (cache->count[index] > 0) {
+        cache->stat.hits++;
+        return cache->bufs[index][--cache->count[index]];
+    }
+
+    cache->stat.misses++;
+    sbuf = HdfSbufTypedObtainCapacity(SBUF_RAW, g_sbufPoolClassSize[index]);
     if (sbuf != NULL) {
-        if (sbuf->impl != NULL && sbuf->impl->recycle != NULL) {
-            sbuf->impl->recycle(sbuf->impl);
-            sbuf->impl = NULL;
+        sbuf->isPooled = true;
+    }
+    return sbuf;
+}
+
+static bool HdfSbufPoolPut(struct HdfSBuf *sbuf)
+{
+    struct HdfSbufPoolCache *cache = NULL;
+    size_t capacity;
+    int32_t index;
+
+    if (!sbuf->isPooled || sbuf->impl == NULL || sbuf->impl->getCapacity == NULL || sbuf->impl->flush == NULL) {
+        return false;
+    }
+    cache = HdfSbufPoolGetCache();
+    if (cache == NULL) {
+        return false;
+    }
+
+    // a grown buffer is filed under the largest class it still satisfies
+    capacity = sbuf->impl->getCapacity(sbuf->impl);
+    for (index = HDF_SBUF_POOL_CLASS_NUM - 1; index >= 0; index--) {
+        if (capacity >= g_sbufPoolClassSize[index]) {
+            break;
         }
-        OsalMemFree(sbuf);
     }
+    if (index < 0 || capacity > g_sbufPoolClassSize[HDF_SBUF_POOL_CLASS_NUM - 1] ||
+        cache->count[index] >= HDF_SBUF_POOL_CLASS_DEPTH) {
+        return false;
+    }
+
+    sbuf->impl->flush(sbuf->impl);
+    cache->bufs[index][cache->count[index]++] = sbuf;
+    return true;
 }
 
-void HdfSBufRecycle(struct HdfSBuf *sbuf)
+void HdfSbufGetPoolStat(struct HdfSbufPoolStat *stat)
+{
+    if (stat != NULL) {
+        *stat = g_sbufPoolCache.stat;
+    }
+}
+#else
+struct HdfSBuf *HdfSbufObtainPooled(size_t capacity)
+{
+    return HdfSbufObtain(capacity);
+}
+
+static bool HdfSbufPoolPut(struct HdfSBuf *sbuf)
+{
+    (void)sbuf;
+    return false;
+}
+
+void HdfSbufGetPoolStat(struct HdfSbufPoolStat *stat)
+{
+    if (stat != NULL) {
+        stat->hits = 0;
+        stat->misses = 0;
+    }
+}
+#endif /* HDF_SBUF_POOL_ENABLE */
+
+void HdfSbufRecycle(struct HdfSBuf *sbuf)
 {
     if (sbuf != NULL) {
+        if (HdfSbufPoolPut(sbuf)) {
+            return;
+        }
         if (sbuf->impl != NULL && sbuf->impl->recycle != NULL) {
             sbuf->impl->recycle(sbuf->impl);
             sbuf->impl = NULL;
@@ -467,6 +666,11 @@ void HdfSBufRecycle(struct HdfSBuf *sbuf)
     }
 }
 
+void HdfSBufRecycle(struct HdfSBuf *sbuf)
+{
+    HdfSbufRecycle(sbuf);
+}
+
 struct HdfSBufImpl *HdfSbufGetImpl(struct HdfSBuf *sbuf)
 {
     if (sbuf != NULL) {
@@ -15,6 +15,7 @@
 #define HDF_SBUF_GROW_SIZE_DEFAULT 256
 #define HDF_SBUF_MAX_SIZE (512 * 1024) // 512KB
 #define HDF_SBUF_ALIGN 4
+#define HDF_SBUF_REF_NUM_DEFAULT 4
 
 #ifndef INT16_MAX
 #ifdef S16_MAX
@@ -24,6 +25,12 @@
 #endif // !S16_MAX
 #endif // INT16_MAX
 
+struct HdfSBufRawRef {
+    size_t offset;       /**< Position in data storage where the referenced payload belongs */
+    const uint8_t *data; /**< Caller-owned payload */
+    uint32_t size;       /**< Payload size */
+};
+
 struct HdfSBufRaw {
     struct HdfSBufImpl infImpl;
     size_t writePos; /**< Current write position */
@@ -31,12 +38,20 @@ struct HdfSBufRaw {
     size_t capacity; /**< Storage capacity, 512 KB at most. */
     uint8_t *data;   /**< Pointer to data storage */
     bool isBind;     /**< Whether to bind the externally transferred pointer to data storage */
+    bool isInline;   /**< Whether data storage is allocated together with this object */
+    struct HdfSBufRawRef *refs; /**< Payloads written by reference, ordered by offset */
+    uint32_t refCount;          /**< Number of payloads not yet flattened into data storage */
+    uint32_t refCapacity;       /**< Number of entries allocated for refs */
+    uint32_t readRef;           /**< Index of the next reference to read */
+    size_t refSize;             /**< Aligned size of all referenced payloads */
 };
 
 #define SBUF_RAW_CAST(impl) (struct HdfSBufRaw *)(impl)
+#define SBUF_RAW_CONST_CAST(impl) (const struct HdfSBufRaw *)(impl)
 
 static struct HdfSBufRaw *SbufRawImplNewInstance(size_t capacity);
 static void SbufInterfaceAssign(struct HdfSBufImpl *inf);
+static bool SbufRawImplFlatten(struct HdfSBufRaw *sbuf);
 
 static size_t SbufRawImplGetAlignSize(size_t size)
 {
@@ -47,9 +62,12 @@ static void SbufRawImplRecycle(struct HdfSBufImpl *impl)
 {
     struct HdfSBufRaw *sbuf = SBUF_RAW_CAST(impl);
     if (sbuf != NULL) {
-        if (sbuf->data != NULL && !sbuf->isBind) {
+        if (sbuf->data != NULL && !sbuf->isBind && !sbuf->isInline) {
             OsalMemFree(sbuf->data);
         }
+        if (sbuf->refs != NULL) {
+            OsalMemFree(sbuf->refs);
+        }
         OsalMemFree(sbuf);
     }
 }
@@ -98,13 +116,16 @@ static bool SbufRawImplReadRollback(struct HdfSBufImpl *impl, uint32_t size)
     return true;
 }
 
-static const uint8_t *SbufRawImplGetData(const struct HdfSBufImpl *impl)
+static const uint8_t *SbufRawImplGetData(struct HdfSBufImpl *impl)
 {
     struct HdfSBufRaw *sbuf = SBUF_RAW_CAST(impl);
     if (sbuf == NULL) {
         HDF_LOGE("The obtained data is null, and the input Sbuf is null.");
         return NULL;
     }
+    if (sbuf->refCount > 0 && !SbufRawImplFlatten(sbuf)) {
+        return NULL;
+    }
     return (uint8_t *)sbuf->data;
 }
 
@@ -114,6 +135,9 @@ static void SbufRawImplSetDataSize(struct HdfSBufImpl *impl, size_t size)
     if (sbuf == NULL) {
         return;
     }
+    if (sbuf->refCount > 0 && !SbufRawImplFlatten(sbuf)) {
+        return;
+    }
     if (size <= sbuf->capacity) {
         sbuf->readPos = 0;
         sbuf->writePos = size;
@@ -126,6 +150,9 @@ static void SbufRawImplFlush(struct HdfSBufImpl *impl)
     if (sbuf != NULL) {
         sbuf->readPos = 0;
         sbuf->writePos = 0;
+        sbuf->refCount = 0;
+        sbuf->readRef = 0;
+        sbuf->refSize = 0;
     }
 }
 
@@ -138,20 +165,24 @@ static size_t SbufRawImplGetCapacity(const struct HdfSBufImpl *impl)
 static size_t SbufRawImplGetDataSize(const struct HdfSBufImpl *impl)
 {
     struct HdfSBufRaw *sbuf = SBUF_RAW_CAST(impl);
-    return (sbuf != NULL) ? sbuf->writePos : 0;
+    return (sbuf != NULL) ? sbuf->writePos + sbuf->refSize : 0;
 }
 
-static bool SbufRawImplGrow(struct HdfSBufRaw *sbuf, uint32_t growSize)
+static bool SbufRawImplGrow(struct HdfSBufRaw *sbuf, size_t minCapacity)
 {
-    uint32_t newSize;
+    size_t newSize;
     uint8_t *newData = NULL;
     if (sbuf->isBind) {
         HDF_LOGE("%s: binded sbuf oom", __func__);
         return false;
     }
 
-    newSize = SbufRawImplGetAlignSize(sbuf->capacity + growSize);
-    if (newSize < sbuf->capacity) {
+    // double the capacity so that a stream of small writes costs amortized O(1) copies
+    newSize = (sbuf->capacity < HDF_SBUF_GROW_SIZE_DEFAULT) ? HDF_SBUF_GROW_SIZE_DEFAULT : sbuf->capacity * 2;
+    newSize = (newSize < minCapacity) ? minCapacity : newSize;
+    newSize = (newSize > HDF_SBUF_MAX_SIZE && minCapacity <= HDF_SBUF_MAX_SIZE) ? HDF_SBUF_MAX_SIZE : newSize;
+    newSize = SbufRawImplGetAlignSize(newSize);
+    if (newSize < minCapacity) {
         HDF_LOGE("%s: grow size overflow", __func__);
         return false;
     }
@@ -160,23 +191,88 @@ static bool SbufRawImplGrow(struct HdfSBufRaw *sbuf, uint32_t growSize)
         return false;
     }
 
-    newData = OsalMemCalloc(newSize);
+    // only [0, writePos) is ever read back, so the new tail does not need zeroing
+    newData = OsalMemAlloc(newSize);
     if (newData == NULL) {
         HDF_LOGE("%s: oom", __func__);
         return false;
     }
 
     if (sbuf->data != NULL) {
-        if (memcpy_s(newData, newSize, sbuf->data, sbuf->writePos) != EOK) {
+        if (sbuf->writePos > 0 && memcpy_s(newData, newSize, sbuf->data, sbuf->writePos) != EOK) {
             OsalMemFree(newData);
             return false;
         }
-        OsalMemFree(sbuf->data);
+        if (!sbuf->isInline) {
+            OsalMemFree(sbuf->data);
+        }
     }
 
     sbuf->data = newData;
     sbuf->capacity = newSize;
+    sbuf->isInline = false;
+
+    return true;
+}
+
+/*
+ * Copy every payload written by reference into its place in data storage, walking from the tail so that
+ * each stretch of inline data is moved at most once.
+ */
+static bool SbufRawImplFlatten(struct HdfSBufRaw *sbuf)
+{
+    size_t total = sbuf->writePos + sbuf->refSize;
+    size_t srcEnd = sbuf->writePos;
+    size_t dstEnd = total;
+    size_t readShift = 0;
+    uint32_t i;
+
+    if (sbuf->refCount == 0) {
+        return true;
+    }
+    if (total < sbuf->writePos || total > HDF_SBUF_MAX_SIZE) {
+        HDF_LOGE("%s: flattened size over limit", __func__);
+        return false;
+    }
+    if (total > sbuf->capacity && !SbufRawImplGrow(sbuf, total)) {
+        return false;
+    }
+
+    for (i = sbuf->refCount; i > 0; i--) {
+        const struct HdfSBufRawRef *ref = &sbuf->refs[i - 1];
+        size_t tailSize = srcEnd - ref->offset;
+        size_t alignSize = SbufRawImplGetAlignSize(ref->size);
+        if (tailSize > 0 && memmove_s(sbuf->data + dstEnd - tailSize, tailSize, sbuf->data + ref->offset,
+            tailSize) != EOK) {
+            return false;
+        }
+        dstEnd -= tailSize + alignSize;
+        if (memcpy_s(sbuf->data + dstEnd, alignSize, ref->data, ref->size) != EOK) {
+            return false;
+        }
+        if (alignSize > ref->size) {
+            (void)memset_s(sbuf->data + dstEnd + ref->size, alignSize - ref->size, 0, alignSize - ref->size);
+        }
+        if (i <= sbuf->readRef) {
+            readShift += alignSize;
+        }
+        srcEnd = ref->offset;
+    }
+
+    sbuf->writePos = total;
+    sbuf->readPos += readShift;
+    sbuf->refCount = 0;
+    sbuf->readRef = 0;
+    sbuf->refSize = 0;
+    return true;
+}
 
+// a read of size bytes that would run into a referenced payload sees the flattened stream instead
+static bool SbufRawImplPrepareRead(struct HdfSBufRaw *sbuf, size_t size)
+{
+    if (sbuf->readRef < sbuf->refCount && sbuf->refs[sbuf->readRef].offset < sbuf->readPos + size) {
+        return SbufRawImplFlatten(sbuf);
+    }
     return true;
 }
 
@@ -203,9 +299,7 @@ static bool SbufRawImplWrite(struct HdfSBufImpl *impl, const uint8_t *data, uint
     }
     writeableSize = SbufRawImplGetLeftWriteSize(sbuf);
     if (alignSize > writeableSize) {
-        size_t growSize = (alignSize > HDF_SBUF_GROW_SIZE_DEFAULT) ? (alignSize + HDF_SBUF_GROW_SIZE_DEFAULT)
-                                                                   : HDF_SBUF_GROW_SIZE_DEFAULT;
-        if (!SbufRawImplGrow(sbuf, growSize)) {
+        if (sbuf->writePos + alignSize < alignSize || !SbufRawImplGrow(sbuf, sbuf->writePos + alignSize)) {
             return false;
         }
         writeableSize = SbufRawImplGetLeftWriteSize(sbuf);
@@ -215,6 +309,10 @@ static bool SbufRawImplWrite(struct HdfSBufImpl *impl, const uint8_t *data, uint
     if (memcpy_s(dest, writeableSize, data, size) != EOK) {
         return false; /* never hits */
     }
+    // storage is not zeroed, clear the alignment padding so no stale bytes are transferred
+    if (alignSize > size) {
+        (void)memset_s(dest + size, writeableSize - size, 0, alignSize - size);
+    }
 
     sbuf->writePos += alignSize;
     return true;
@@ -233,6 +331,9 @@ static bool SbufRawImplRead(struct HdfSBufImpl *impl, uint8_t *data, uint32_t re
     }
 
     alignSize = SbufRawImplGetAlignSize(readSize);
+    if (!SbufRawImplPrepareRead(sbuf, alignSize)) {
+        return false;
+    }
     if (alignSize > SbufRawImplGetLeftReadSize(sbuf)) {
         HDF_LOGE("Read out of buffer range");
         return false;
@@ -316,6 +417,65 @@ static bool SbufRawImplWriteString(struct HdfSBufImpl *impl, const char *value)
     return SbufRawImplWriteBuffer(impl, (const uint8_t *)value, value ? (strlen(value) + 1) : 0);
 }
 
+static bool SbufRawImplAddRef(struct HdfSBufRaw *sbuf, const uint8_t *data, uint32_t size)
+{
+    struct HdfSBufRawRef *ref = NULL;
+    if (sbuf->refCount == sbuf->refCapacity) {
+        uint32_t newCapacity = (sbuf->refCapacity == 0) ? HDF_SBUF_REF_NUM_DEFAULT : sbuf->refCapacity * 2;
+        struct HdfSBufRawRef *newRefs = OsalMemAlloc(sizeof(struct HdfSBufRawRef) * newCapacity);
+        if (newRefs == NULL) {
+            HDF_LOGE("%s: oom", __func__);
+            return false;
+        }
+        if (sbuf->refs != NULL) {
+            if (sbuf->refCount > 0 && memcpy_s(newRefs, sizeof(struct HdfSBufRawRef) * newCapacity, sbuf->refs,
+                sizeof(struct HdfSBufRawRef) * sbuf->refCount) != EOK) {
+                OsalMemFree(newRefs);
+                return false;
+            }
+            OsalMemFree(sbuf->refs);
+        }
+        sbuf->refs = newRefs;
+        sbuf->refCapacity = newCapacity;
+    }
+
+    ref = &sbuf->refs[sbuf->refCount++];
+    ref->offset = sbuf->writePos;
+    ref->data = data;
+    ref->size = size;
+    sbuf->refSize += SbufRawImplGetAlignSize(size);
+    return true;
+}
+
+static bool SbufRawImplWriteBufferRef(struct HdfSBufImpl *impl, const uint8_t *data, uint32_t writeSize)
+{
+    struct HdfSBufRaw *sbuf = SBUF_RAW_CAST(impl);
+    size_t alignSize = SbufRawImplGetAlignSize(writeSize);
+    if (sbuf == NULL) {
+        HDF_LOGE("Failed to write the Sbuf, invalid input params");
+        return false;
+    }
+    // bound storage can not grow when flattened, and small payloads are cheaper to copy than to track
+    if (sbuf->isBind || data == NULL || writeSize < HDF_SBUF_GROW_SIZE_DEFAULT) {
+        return SbufRawImplWriteBuffer(impl, data, writeSize);
+    }
+    // the payload is flattened or gathered into one stream later, which has the same limit as copied data
+    if (alignSize < writeSize || alignSize > HDF_SBUF_MAX_SIZE ||
+        sbuf->writePos + sbuf->refSize + sizeof(int32_t) + alignSize > HDF_SBUF_MAX_SIZE) {
+        HDF_LOGE("%s: buf size over limit", __func__);
+        return false;
+    }
+
+    if (!SbufRawImplWriteInt32(impl, writeSize)) {
+        return false;
+    }
+    if (!SbufRawImplAddRef(sbuf, data, writeSize)) {
+        (void)SbufRawImplWriteRollback(impl, sizeof(int32_t));
+        return false;
+    }
+    return true;
+}
+
 static bool SbufRawImplReadUint64(struct HdfSBufImpl *impl, uint64_t *value)
 {
     return SbufRawImplRead(impl, (uint8_t *)(value), sizeof(*value));
@@ -376,6 +536,10 @@ static bool SbufRawImplReadBuffer(struct HdfSBufImpl *impl, const uint8_t **data
         return true;
     }
     alignSize = SbufRawImplGetAlignSize(buffSize);
+    if (!SbufRawImplPrepareRead(sbuf, alignSize)) {
+        (void)SbufRawImplReadRollback(impl, sizeof(int32_t));
+        return false;
+    }
     if (alignSize > SbufRawImplGetLeftReadSize(sbuf)) {
         HDF_LOGE("%s:readBuff out of range", __func__);
         (void)SbufRawImplReadRollback(impl, sizeof(int32_t));
@@ -388,6 +552,89 @@ static bool SbufRawImplReadBuffer(struct HdfSBufImpl *impl, const uint8_t **data
     return true;
 }
 
+static bool SbufRawImplReadBufferRef(struct HdfSBufImpl *impl, const uint8_t **data, uint32_t *readSize)
+{
+    struct HdfSBufRaw *sbuf = SBUF_RAW_CAST(impl);
+    const struct HdfSBufRawRef *ref = NULL;
+    int32_t buffSize = 0;
+    if (sbuf == NULL || sbuf->data == NULL || data == NULL || readSize == NULL) {
+        HDF_LOGE("%s: input invalid", __func__);
+        return false;
+    }
+    if (sbuf->readRef >= sbuf->refCount) {
+        return SbufRawImplReadBuffer(impl, data, readSize);
+    }
+
+    ref = &sbuf->refs[sbuf->readRef];
+    if (!SbufRawImplReadInt32(impl, &buffSize)) {
+        return false;
+    }
+    if (ref->offset != sbuf->readPos || (uint32_t)buffSize != ref->size) {
+        // the payload was copied into storage, read it from there
+        (void)SbufRawImplReadRollback(impl, sizeof(int32_t));
+        return SbufRawImplReadBuffer(impl, data, readSize);
+    }
+
+    *data = ref->data;
+    *readSize = ref->size;
+    sbuf->readRef++;
+    return true;
+}
+
+static int32_t SbufRawImplWalkSegments(const struct HdfSBufRaw *sbuf,
+    int32_t (*func)(void *priv, const uint8_t *data, size_t size), void *priv)
+{
+    static const uint8_t padding[HDF_SBUF_ALIGN] = {0};
+    size_t pos = 0;
+    uint32_t i;
+    int32_t ret;
+
+    for (i = 0; i < sbuf->refCount; i++) {
+        const struct HdfSBufRawRef *ref = &sbuf->refs[i];
+        size_t alignSize = SbufRawImplGetAlignSize(ref->size);
+        if (ref->offset > pos && (ret = func(priv, sbuf->data + pos, ref->offset - pos)) != HDF_SUCCESS) {
+            return ret;
+        }
+        if ((ret = func(priv, ref->data, ref->size)) != HDF_SUCCESS) {
+            return ret;
+        }
+        if (alignSize > ref->size && (ret = func(priv, padding, alignSize - ref->size)) != HDF_SUCCESS) {
+            return ret;
+        }
+        pos = ref->offset;
+    }
+    if (sbuf->writePos > pos) {
+        return func(priv, sbuf->data + pos, sbuf->writePos - pos);
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t SbufRawImplForEachSegment(struct HdfSBufImpl *impl,
+    int32_t (*func)(void *priv, const uint8_t *data, size_t size), void *priv)
+{
+    const struct HdfSBufRaw *sbuf = SBUF_RAW_CONST_CAST(impl);
+    if (sbuf == NULL || func == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return SbufRawImplWalkSegments(sbuf, func, priv);
+}
+
+struct HdfSBufRawGather {
+    uint8_t *dst;
+    size_t left;
+};
+
+static int32_t SbufRawImplGatherSegment(void *priv, const uint8_t *data, size_t size)
+{
+    struct HdfSBufRawGather *gather = (struct HdfSBufRawGather *)priv;
+    if (memcpy_s(gather->dst, gather->left, data, size) != EOK) {
+        return HDF_FAILURE;
+    }
+    gather->dst += size;
+    gather->left -= size;
+    return HDF_SUCCESS;
+}
+
 static const char *SbufRawImplReadString(struct HdfSBufImpl *impl)
 {
     struct HdfSBufRaw *sbuf = SBUF_RAW_CAST(impl);
@@ -403,7 +650,8 @@ static const char *SbufRawImplReadString(struct HdfSBufImpl *impl)
         return NULL;
     }
     alignSize = SbufRawImplGetAlignSize(strLen);
-    if (strLen > INT16_MAX || alignSize > SbufRawImplGetLeftReadSize(sbuf)) {
+    if (strLen > INT16_MAX || !SbufRawImplPrepareRead(sbuf, alignSize) ||
+        alignSize > SbufRawImplGetLeftReadSize(sbuf)) {
         (void)SbufRawImplReadRollback(impl, sizeof(int32_t));
         return NULL;
     }
@@ -417,20 +665,25 @@ static const char *SbufRawImplReadString(struct HdfSBufImpl *impl)
 
 static struct HdfSBufImpl *SbufRawImplCopy(const struct HdfSBufImpl *impl)
 {
-    struct HdfSBufRaw *sbuf = SBUF_RAW_CAST(impl);
+    const struct HdfSBufRaw *sbuf = SBUF_RAW_CONST_CAST(impl);
     struct HdfSBufRaw *new = NULL;
+    struct HdfSBufRawGather gather;
+    size_t dataSize;
     if (sbuf == NULL || sbuf->data == NULL) {
         return NULL;
     }
 
-    new = SbufRawImplNewInstance(sbuf->capacity);
+    // the copy gathers referenced payloads, so it does not depend on the lifetime of the memory they are in
+    dataSize = sbuf->writePos + sbuf->refSize;
+    new = SbufRawImplNewInstance((dataSize > sbuf->capacity) ? dataSize : sbuf->capacity);
     if (new == NULL) {
         return NULL;
     }
-    new->capacity = sbuf->capacity;
     new->readPos = 0;
-    new->writePos = sbuf->writePos;
-    if (memcpy_s(new->data, new->capacity, sbuf->data, sbuf->capacity) != EOK) {
+    new->writePos = dataSize;
+    gather.dst = new->data;
+    gather.left = new->capacity;
+    if (dataSize > 0 && SbufRawImplWalkSegments(sbuf, SbufRawImplGatherSegment, &gather) != HDF_SUCCESS) {
         SbufRawImplRecycle(&new->infImpl);
         return NULL;
     }
@@ -445,6 +698,18 @@ static struct HdfSBufImpl *SbufRawImplMove(struct HdfSBufImpl *impl)
     if (sbuf == NULL || sbuf->isBind) {
         return NULL;
     }
+    if (sbuf->refCount > 0 && !SbufRawImplFlatten(sbuf)) {
+        return NULL;
+    }
+
+    if (sbuf->isInline) {
+        // storage shares the allocation of the source object, hand over a copy instead
+        struct HdfSBufImpl *copied = SbufRawImplCopy(impl);
+        if (copied != NULL) {
+            SbufRawImplFlush(impl);
+        }
+        return copied;
+    }
 
     new = OsalMemCalloc(sizeof(struct HdfSBufRaw));
     if (new == NULL) {
@@ -504,31 +769,33 @@ static void SbufInterfaceAssign(struct HdfSBufImpl *inf)
     inf->move = SbufRawImplMove;
     inf->copy = SbufRawImplCopy;
     inf->transDataOwnership = SbufRawImplTransDataOwnership;
+    inf->writeBufferRef = SbufRawImplWriteBufferRef;
+    inf->readBufferRef = SbufRawImplReadBufferRef;
+    inf->forEachSegment = SbufRawImplForEachSegment;
 }
 
 static struct HdfSBufRaw *SbufRawImplNewInstance(size_t capacity)
 {
     struct HdfSBufRaw *sbuf = NULL;
+    size_t headSize = SbufRawImplGetAlignSize(sizeof(struct HdfSBufRaw));
     if (capacity > HDF_SBUF_MAX_SIZE) {
         HDF_LOGE("%s: Sbuf size exceeding max limit", __func__);
         return NULL;
     }
-    sbuf = (struct HdfSBufRaw *)OsalMemCalloc(sizeof(struct HdfSBufRaw));
+    // one allocation for the object and its initial storage, left unzeroed like grown storage
+    sbuf = (struct HdfSBufRaw *)OsalMemAlloc(headSize + capacity);
     if (sbuf == NULL) {
-        HDF_LOGE("Sbuf instance failure");
-        return NULL;
-    }
-
-    sbuf->data = (uint8_t *)OsalMemCalloc(capacity);
-    if (sbuf->data == NULL) {
-        OsalMemFree(sbuf);
         HDF_LOGE("sbuf obtain memory oom, size=%u", (uint32_t)capacity);
         return NULL;
     }
+    (void)memset_s(sbuf, sizeof(struct HdfSBufRaw), 0, sizeof(struct HdfSBufRaw));
+
+    sbuf->data = (uint8_t *)sbuf + headSize;
     sbuf->capacity = capacity;
     sbuf->writePos = 0;
     sbuf->readPos = 0;
     sbuf->isBind = false;
+    sbuf->isInline = true;
     SbufInterfaceAssign(&sbuf->infImpl);
     return sbuf;
 }
@@ -564,6 +831,12 @@ struct HdfSBufImpl *SbufBindRaw(uintptr_t base, size_t size)
     sbuf->writePos = size;
     sbuf->readPos = 0;
     sbuf->isBind = true;
+    sbuf->isInline = false;
+    sbuf->refs = NULL;
+    sbuf->refCount = 0;
+    sbuf->refCapacity = 0;
+    sbuf->readRef = 0;
+    sbuf->refSize = 0;
     SbufInterfaceAssign(&sbuf->infImpl);
     return &sbuf->infImpl;
 }
\ No newline at end of file
@@ -15,23 +15,45 @@ static int32_t HdfThreadTasker(void *data);
 
 #define HDF_LOG_TAG hdf_task_queue
 
+#define HDF_TASK_QUEUE_MAX_WORKERS 16
+
 static int32_t HdfCreateThread(struct HdfTaskQueue *queue)
 {
     int32_t ret;
+    uint32_t i;
 
-    ret = OsalThreadCreate(&queue->thread, (OsalThreadEntry)HdfThreadTasker, queue);
-    if (ret != HDF_SUCCESS) {
-        HDF_LOGE("HdfCreateThread: create thread fail!");
+    queue->threads = (struct OsalThread *)OsalMemCalloc(sizeof(struct OsalThread) * queue->threadCount);
+    if (queue->threads == NULL) {
+        HDF_LOGE("HdfCreateThread: malloc fail!");
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    for (i = 0; i < queue->threadCount; i++) {
+        ret = OsalThreadCreate(&queue->threads[i], (OsalThreadEntry)HdfThreadTasker, queue);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("HdfCreateThread: create thread fail!");
+            while (i > 0) {
+                (void)OsalThreadDestroy(&queue->threads[--i]);
+            }
+            OsalMemFree(queue->threads);
+            queue->threads = NULL;
+            return ret;
+        }
     }
 
-    return ret;
+    return HDF_SUCCESS;
 }
 
-struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc func, const char *name)
+struct HdfTaskQueue *HdfTaskQueueCreatePool(HdfTaskFunc func, const char *name, uint32_t workerCount)
 {
     int32_t ret;
     struct HdfTaskQueue *queue = NULL;
 
+    if (workerCount == 0 || workerCount > HDF_TASK_QUEUE_MAX_WORKERS) {
+        HDF_LOGE("%s invalid worker count %u", __func__, workerCount);
+        return NULL;
+    }
+
     queue = (struct HdfTaskQueue *)OsalMemCalloc(sizeof(*queue));
     if (queue == NULL) {
         HDF_LOGE("%s malloc fail", __func__);
@@ -39,6 +61,7 @@ struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc func, const char *name)
     }
 
     DListHeadInit(&queue->head);
+    queue->threadCount = workerCount;
 
     ret = OsalMutexInit(&queue->mutex);
     if (ret != HDF_SUCCESS) {
@@ -74,21 +97,32 @@ struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc func, const char *name)
     return queue;
 }
 
+struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc func, const char *name)
+{
+    return HdfTaskQueueCreatePool(func, name, 1);
+}
+
 static void hdfQueueStopThread(struct HdfTaskQueue *queue)
 {
     int32_t ret;
+    uint32_t i;
 
     if (queue == NULL) {
         HDF_LOGE("%s queue ptr is null", __func__);
         return;
     }
 
+    // the last worker to exit frees the queue, which it does only after taking the mutex
+    (void)OsalMutexLock(&queue->mutex);
     queue->threadRunFlag = false;
 
-    ret = OsalSemPost(&queue->sem);
-    if (ret != HDF_SUCCESS) {
-        HDF_LOGE("%s OsalSemPost fail", __func__);
+    for (i = 0; i < queue->threadCount; i++) {
+        ret = OsalSemPost(&queue->sem);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s OsalSemPost fail", __func__);
+        }
     }
+    (void)OsalMutexUnlock(&queue->mutex);
 }
 
 void HdfTaskQueueDestroy(struct HdfTaskQueue *queue)
@@ -103,6 +137,7 @@ void HdfTaskQueueDestroy(struct HdfTaskQueue *queue)
 static void hdfQueueStartThread(struct HdfTaskQueue *queue)
 {
     int32_t ret;
+    uint32_t i;
     struct OsalThreadParam param;
 
     (void)memset_s(&param, sizeof(param), 0, sizeof(param));
@@ -110,9 +145,13 @@ static void hdfQueueStartThread(struct HdfTaskQueue *queue)
     param.priority = OSAL_THREAD_PRI_HIGH;
     queue->threadRunFlag = true;
 
-    ret = OsalThreadStart(&queue->thread, &param);
-    if (ret != HDF_SUCCESS) {
-        HDF_LOGE("%s OsalThreadStart fail", __func__);
+    for (i = 0; i < queue->threadCount; i++) {
+        ret = OsalThreadStart(&queue->threads[i], &param);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s OsalThreadStart fail", __func__);
+            continue;
+        }
+        queue->aliveThreads++;
     }
 }
 
@@ -149,22 +188,64 @@ void HdfTaskEnqueue(struct HdfTaskQueue *queue, struct HdfTaskType *task)
     }
 }
 
-static struct HdfTaskType *HdfTaskDequeue(struct HdfTaskQueue *queue)
+static void HdfTaskRun(struct HdfTaskQueue *queue, struct HdfTaskType *task)
+{
+    if (task->func) {
+        task->func(task);
+    } else if (queue->queueFunc) {
+        queue->queueFunc(task);
+    } else {
+        HDF_LOGE("%s no task and queue function", __func__);
+    }
+}
+
+static struct HdfTaskType *HdfTaskDequeue(struct DListHead *head)
 {
     struct HdfTaskType *task = NULL;
 
-    if (!DListIsEmpty(&queue->head)) {
-        task = DLIST_FIRST_ENTRY(&queue->head, struct HdfTaskType, node);
+    if (!DListIsEmpty(head)) {
+        task = DLIST_FIRST_ENTRY(head, struct HdfTaskType, node);
         DListRemove(&task->node);
     }
 
     return task;
 }
 
+static void HdfTaskQueueDrain(struct HdfTaskQueue *queue)
+{
+    struct DListHead batch;
+    struct HdfTaskType *task = NULL;
+
+    DListHeadInit(&batch);
+    if (OsalMutexLock(&queue->mutex) != HDF_SUCCESS) {
+        HDF_LOGE("%s OsalMutexLock fail", __func__);
+        return;
+    }
+    if (queue->threadCount > 1) {
+        // pool workers take a single task so that the others can run the rest in parallel
+        task = HdfTaskDequeue(&queue->head);
+        if (task != NULL) {
+            DListInsertTail(&task->node, &batch);
+        }
+    } else if (!DListIsEmpty(&queue->head)) {
+        DListMerge(&queue->head, &batch);
+    }
+    if (OsalMutexUnlock(&queue->mutex) != HDF_SUCCESS) {
+        HDF_LOGE("%s OsalMutexUnlock fail", __func__);
+    }
+
+    // the task may be released by its callback, so unlink it before running
+    task = HdfTaskDequeue(&batch);
+    while (task != NULL) {
+        HdfTaskRun(queue, task);
+        task = HdfTaskDequeue(&batch);
+    }
+}
+
 static int32_t HdfThreadTasker(void *data)
 {
     int32_t ret;
-    struct HdfTaskType *task = NULL;
+    bool lastThread = false;
     struct HdfTaskQueue *queue = (struct HdfTaskQueue *)data;
 
     while (queue->threadRunFlag) {
@@ -172,31 +253,18 @@ static int32_t HdfThreadTasker(void *data)
         if (ret != HDF_SUCCESS) {
             continue;
         }
-        ret = OsalMutexLock(&queue->mutex);
-        if (ret != HDF_SUCCESS) {
-            HDF_LOGE("%s OsalMutexLock fail", __func__);
-            continue;
-        }
-        task = HdfTaskDequeue(queue);
-        while (task != NULL) {
-            if (task->func) {
-                task->func(task);
-            } else if (queue->queueFunc) {
-                queue->queueFunc(task);
-            } else {
-                HDF_LOGE("%s no task and queue function", __func__);
-            }
-            task = HdfTaskDequeue(queue);
-        }
-        ret = OsalMutexUnlock(&queue->mutex);
-        if (ret != HDF_SUCCESS) {
-            HDF_LOGE("%s OsalMutexUnlock fail", __func__);
-        }
+        HdfTaskQueueDrain(queue);
     }
 
-    (void)OsalMutexDestroy(&queue->mutex);
-    (void)OsalSemDestroy(&queue->sem);
-    OsalMemFree(queue);
+    (void)OsalMutexLock(&queue->mutex);
+    lastThread = (--queue->aliveThreads == 0);
+    (void)OsalMutexUnlock(&queue->mutex);
+    if (lastThread) {
+        (void)OsalMutexDestroy(&queue->mutex);
+        (void)OsalSemDestroy(&queue->sem);
+        OsalMemFree(queue->threads);
+        OsalMemFree(queue);
+    }
     HDF_LOGI("%s thread exit", __func__);
 
     return HDF_SUCCESS;
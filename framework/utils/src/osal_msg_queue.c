@@ -7,15 +7,106 @@
  */
 
 #include "osal_msg_queue.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
 #include "osal_message.h"
 #include "osal_time.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG osal_msg_queue
+#define MSG_QUEUE_INIT_CAPACITY 16
+#define MSG_QUEUE_MAX_WAIT_MS   (OSAL_WAIT_FOREVER - 1)
+
+static inline bool HdfMessageQueueNodeBefore(
+    const struct HdfMessageQueueNode *left, const struct HdfMessageQueueNode *right)
+{
+    if (left->timeStamp != right->timeStamp) {
+        return left->timeStamp < right->timeStamp;
+    }
+    return left->sequence < right->sequence;
+}
+
+static void HdfMessageQueueSiftUp(struct HdfMessageQueue *queue, uint32_t index)
+{
+    struct HdfMessageQueueNode node = queue->heap[index];
+    while (index > 0) {
+        uint32_t parent = (index - 1) / 2; // 2: binary heap
+        if (!HdfMessageQueueNodeBefore(&node, &queue->heap[parent])) {
+            break;
+        }
+        queue->heap[index] = queue->heap[parent];
+        index = parent;
+    }
+    queue->heap[index] = node;
+}
+
+static void HdfMessageQueueSiftDown(struct HdfMessageQueue *queue, uint32_t index)
+{
+    struct HdfMessageQueueNode node = queue->heap[index];
+    uint32_t half = queue->count / 2; // 2: binary heap
+    while (index < half) {
+        uint32_t child = index * 2 + 1; // 2: binary heap
+        if (child + 1 < queue->count && HdfMessageQueueNodeBefore(&queue->heap[child + 1], &queue->heap[child])) {
+            child++;
+        }
+        if (!HdfMessageQueueNodeBefore(&queue->heap[child], &node)) {
+            break;
+        }
+        queue->heap[index] = queue->heap[child];
+        index = child;
+    }
+    queue->heap[index] = node;
+}
+
+static int32_t HdfMessageQueueReserve(struct HdfMessageQueue *queue)
+{
+    struct HdfMessageQueueNode *newHeap = NULL;
+    uint32_t newCapacity;
+
+    if (queue->count < queue->capacity) {
+        return HDF_SUCCESS;
+    }
+    newCapacity = (queue->capacity == 0) ? MSG_QUEUE_INIT_CAPACITY : queue->capacity * 2; // 2: grow twice
+    if (newCapacity <= queue->capacity) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    newHeap = (struct HdfMessageQueueNode *)OsalMemAlloc(newCapacity * sizeof(struct HdfMessageQueueNode));
+    if (newHeap == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    if (queue->heap != NULL) {
+        if (memcpy_s(newHeap, newCapacity * sizeof(struct HdfMessageQueueNode), queue->heap,
+            queue->count * sizeof(struct HdfMessageQueueNode)) != EOK) {
+            OsalMemFree(newHeap);
+            return HDF_FAILURE;
+        }
+        OsalMemFree(queue->heap);
+    }
+    queue->heap = newHeap;
+    queue->capacity = newCapacity;
+    return HDF_SUCCESS;
+}
+
+static struct HdfMessage *HdfMessageQueuePop(struct HdfMessageQueue *queue)
+{
+    struct HdfMessage *message = queue->heap[0].message;
+    queue->count--;
+    if (queue->count > 0) {
+        queue->heap[0] = queue->heap[queue->count];
+        HdfMessageQueueSiftDown(queue, 0);
+    }
+    return message;
+}
 
 void OsalMessageQueueInit(struct HdfMessageQueue *queue)
 {
     if (queue != NULL) {
         OsalMutexInit(&queue->mutex);
         OsalSemInit(&queue->semaphore, 0);
-        HdfSListInit(&queue->list);
+        queue->heap = NULL;
+        queue->count = 0;
+        queue->capacity = 0;
+        queue->sequence = 0;
     }
 }
 
@@ -24,68 +115,78 @@ void OsalMessageQueueDestroy(struct HdfMessageQueue *queue)
     if (queue != NULL) {
         OsalMutexDestroy(&queue->mutex);
         OsalSemDestroy(&queue->semaphore);
-        HdfSListFlush(&queue->list, HdfMessageDelete);
+        while (queue->count > 0) {
+            HdfMessageRecycle(HdfMessageQueuePop(queue));
+        }
+        OsalMemFree(queue->heap);
+        queue->heap = NULL;
+        queue->capacity = 0;
     }
 }
 
 void HdfMessageQueueEnqueue(
     struct HdfMessageQueue *queue, struct HdfMessage *message, long delayed)
 {
+    struct HdfMessageQueueNode *node = NULL;
+    bool isEarliest = false;
+
     if (queue == NULL || message == NULL) {
         return;
     }
 
-    struct HdfSListIterator it;
-    (void)delayed;
-    message->timeStamp += OsalGetSysTimeMs();
+    message->timeStamp = OsalGetSysTimeMs() + ((delayed > 0) ? (uint64_t)delayed : 0);
     OsalMutexLock(&queue->mutex);
-    HdfSListIteratorInit(&it, &queue->list);
-    while (HdfSListIteratorHasNext(&it)) {
-        struct HdfMessage *next = (struct HdfMessage *)HdfSListIteratorNext(&it);
-        if (next->timeStamp > message->timeStamp) {
-            HdfSListIteratorInsert(&it, &message->entry);
-            goto COMPLETE;
-        }
+    if (HdfMessageQueueReserve(queue) != HDF_SUCCESS) {
+        OsalMutexUnlock(&queue->mutex);
+        HDF_LOGE("%s: failed to grow message queue, drop message %d", __func__, message->messageId);
+        HdfMessageRecycle(message);
+        return;
     }
-
-    HdfSListAddTail(&queue->list, &message->entry);
-COMPLETE:
+    node = &queue->heap[queue->count];
+    node->timeStamp = message->timeStamp;
+    node->sequence = queue->sequence++;
+    node->message = message;
+    HdfMessageQueueSiftUp(queue, queue->count);
+    queue->count++;
+    isEarliest = (queue->heap[0].message == message);
     OsalMutexUnlock(&queue->mutex);
-    OsalSemPost(&queue->semaphore);
+
+    // the looper only needs waking when the earliest deadline moved forward
+    if (isEarliest) {
+        OsalSemPost(&queue->semaphore);
+    }
 }
 
 struct HdfMessage* HdfMessageQueueNext(struct HdfMessageQueue *queue)
 {
-    struct HdfSListIterator it;
-    struct HdfMessage *message = NULL;
     uint64_t currentTime = OsalGetSysTimeMs();
+    uint32_t waitTime = OSAL_WAIT_FOREVER;
 
     OsalMutexLock(&queue->mutex);
-    HdfSListIteratorInit(&it, &queue->list);
-    while (HdfSListIteratorHasNext(&it)) {
-        message = (struct HdfMessage *)HdfSListIteratorNext(&it);
-        if (message->timeStamp <= currentTime) {
-            HdfSListIteratorRemove(&it);
+    if (queue->count > 0) {
+        uint64_t deadline = queue->heap[0].timeStamp;
+        if (deadline <= currentTime) {
+            struct HdfMessage *message = HdfMessageQueuePop(queue);
             OsalMutexUnlock(&queue->mutex);
             return message;
         }
+        waitTime = (deadline - currentTime > MSG_QUEUE_MAX_WAIT_MS) ?
+            MSG_QUEUE_MAX_WAIT_MS : (uint32_t)(deadline - currentTime);
     }
-
     OsalMutexUnlock(&queue->mutex);
-    OsalSemWait(&queue->semaphore, OSAL_WAIT_FOREVER);
+
+    (void)OsalSemWait(&queue->semaphore, waitTime);
     return NULL;
 }
 
 void HdfMessageQueueFlush(struct HdfMessageQueue *queue)
 {
-    struct HdfSListIterator it;
+    if (queue == NULL) {
+        return;
+    }
     OsalMutexLock(&queue->mutex);
-    HdfSListIteratorInit(&it, &queue->list);
-    while (HdfSListIteratorHasNext(&it)) {
-        struct HdfMessage *msgNode = (struct HdfMessage *)HdfSListIteratorNext(&it);
-        HdfSListIteratorRemove(&it);
-        HdfMessageRecycle(msgNode);
+    while (queue->count > 0) {
+        HdfMessageRecycle(HdfMessageQueuePop(queue));
     }
     OsalMutexUnlock(&queue->mutex);
 }
-